@@ -1,6 +1,7 @@
 #version 450
 
 #include "camera.glsl"
+#include "draws.glsl"
 
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
@@ -14,12 +15,14 @@ layout (set = 1, std430, binding = 0) buffer ModelMatrices {
     mat4 modelMatrix[];
 };
 
-layout(push_constant) uniform ModelMatrixID {
-	uint modelMatrixID;
+layout (set = 1, std430, binding = 4) buffer Draws {
+    Draw draws[];
 };
 
 void main() 
 {
+    uint modelMatrixID = draws[gl_InstanceIndex].matrixIndex;
+
 	vec4 vWorldSpace = modelMatrix[modelMatrixID] * vec4(vPosition, 1.0);
     gl_Position = camera.projView * vWorldSpace;
 }
\ No newline at end of file
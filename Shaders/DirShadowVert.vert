@@ -2,6 +2,7 @@
 
 #include "../EruptionEngine.ini"
 #include "lights.glsl"
+#include "draws.glsl"
 #include "camera.glsl"
 
 layout(location = 0) in vec3 vPosition;
@@ -32,17 +33,22 @@ layout(std430, set = 0, binding = 1) buffer Lights
 	vec4 cascadeFrustumSizeRatios[SHADOW_CASCADES];
 };
 
+layout (set = 0, std430, binding = 2) buffer Draws {
+    Draw draws[];
+};
+
 layout(set = 1, binding = 0) uniform CameraBuffer {
 	CameraBufferObject camera;
 };
 
 layout(push_constant) uniform PushConstant {
-	uint modelMatrixID;
 	uint lightID;
 	uint cascadeID;
 };
 
 void main() 
 {
+    uint modelMatrixID = draws[gl_InstanceIndex].matrixIndex;
+
     gl_Position = camera.cascadeMatrices[lightID][cascadeID] * modelMatrix[modelMatrixID] * vec4(vPosition, 1.0);
 }
\ No newline at end of file
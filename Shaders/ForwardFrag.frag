@@ -10,14 +10,14 @@ layout(location = 0) in vec4 fPosition;
 layout(location = 1) in vec3 fNormal;
 layout(location = 2) in vec2 fTexcoord;
 layout(location = 3) noperspective in vec2 fUV;
+layout(location = 4) flat in uint fMaterialID;
 
 layout(location = 0) out vec4 FragColor;
 
 layout(set = 1, binding = 1) uniform sampler2D textures[MAX_TEXTURES];
 
 layout(set = 2, binding = 0) uniform samplerCube pointShadowMaps[MAX_POINT_LIGHT_SHADOWS];
-layout(set = 2, binding = 1) uniform sampler2D spotShadowMaps[MAX_SPOT_LIGHT_SHADOWS];
-layout(set = 2, binding = 2) uniform sampler2D dirShadowMaps[MAX_DIR_LIGHT_SHADOWS*SHADOW_CASCADES];
+layout(set = 2, binding = 1) uniform sampler2D shadowAtlas;
 
 layout(set = 4, binding = 0) uniform sampler2D SSAO;
 
@@ -80,8 +80,6 @@ layout (set = 1, std430, binding = 2) buffer Materials {
 };
 
 layout(push_constant) uniform PushConstant {
-	layout(offset = 4) 
-	uint materialId;
 	float exposure;
 };
 
@@ -162,7 +160,7 @@ vec3 PBRLighting(vec3 lightDir, vec3 lightColor, vec3 albedo, float roughness, f
     return (kD * albedo / PI + specular) * radiance * NdotL;
 }
 
-float CalculateShadow(vec4 fPosLightSpace, sampler2D shadowmap, int sampleCount, float bias, float softness)
+float CalculateShadow(vec4 fPosLightSpace, vec4 atlasRect, int sampleCount, float bias, float softness)
 {
     vec3 projCoords = fPosLightSpace.xyz / fPosLightSpace.w;
 
@@ -171,13 +169,20 @@ float CalculateShadow(vec4 fPosLightSpace, sampler2D shadowmap, int sampleCount,
 
     float shadow = 0.0;
 
+    // The samples can't leave the light's tile, otherwise the filtering would pick up the neighbouring shadow maps
+    vec2 halfTexel = vec2(0.5) / textureSize(shadowAtlas, 0);
+    vec2 tileMin = atlasRect.xy + halfTexel;
+    vec2 tileMax = atlasRect.xy + atlasRect.zw - halfTexel;
+
+    projCoords.xy = atlasRect.xy + projCoords.xy * atlasRect.zw;
+
 #if SOFT_SHADOWS
-    vec2 texelSize = vec2(1.0) / textureSize(shadowmap, 0) * softness;
+    vec2 texelSize = vec2(1.0) / textureSize(shadowAtlas, 0) * softness;
     for(int x = -sampleCount; x <= sampleCount; ++x)
     {
         for(int y = -sampleCount; y <= sampleCount; ++y)
         {
-            float pcfDepth = texture(shadowmap, projCoords.xy + vec2(float(x)/sampleCount, float(y)/sampleCount) * texelSize).r; 
+            float pcfDepth = texture(shadowAtlas, clamp(projCoords.xy + vec2(float(x)/sampleCount, float(y)/sampleCount) * texelSize, tileMin, tileMax)).r; 
             shadow += projCoords.z - bias > pcfDepth ? 1.0 : 0.0;        
         }    
     }
@@ -186,7 +191,7 @@ float CalculateShadow(vec4 fPosLightSpace, sampler2D shadowmap, int sampleCount,
 
     shadow /= divider * divider;
 #else
-    float closestDepth = texture(shadowmap, projCoords.xy).r;    
+    float closestDepth = texture(shadowAtlas, clamp(projCoords.xy, tileMin, tileMax)).r;    
     shadow = projCoords.z - bias > closestDepth ? 1.0 : 0.0;
 #endif
 
@@ -268,7 +273,7 @@ float GetSSAO()
 
 void main()
 {
-	Material material = materials[materialId];
+	Material material = materials[fMaterialID];
 
     vec3  albedo    = texture(textures[material.albedoId], fTexcoord).rgb * material.color;
     vec3  normal    = NormalMapping(material.normalId, material.normalStrength);
@@ -351,8 +356,8 @@ void main()
         vec4 fPosLightSpace = biasMat * light.viewProj * vec4(position, 1.0);
         float shadow = 0.0;
 
-         if(light.shadowmapIndex != -1)
-            shadow = CalculateShadow(fPosLightSpace, spotShadowMaps[light.shadowmapIndex], light.pcfSampleRate, light.bias, light.shadowSoftness);
+         if(light.shadowmapIndex != -1 && camera.shadowAtlasRects[light.shadowmapIndex].z > 0.0)
+            shadow = CalculateShadow(fPosLightSpace, camera.shadowAtlasRects[light.shadowmapIndex], light.pcfSampleRate, light.bias, light.shadowSoftness);
 
         lighting += PBRLighting(lightToSurfaceDir, light.color, albedo, roughness, metalness, normal, position, viewDir, F0) * intensity * (1.0 - shadow);
     }
@@ -369,8 +374,10 @@ void main()
 
         float bias = light.bias;//max(light.bias * (1.0-dot(lightSurfaceDir, lightDir)), 0.0);
 
-         if(light.shadowmapIndex != -1)
-            shadow = CalculateShadow(fPosLightSpace, dirShadowMaps[light.shadowmapIndex*3+cascade], light.pcfSampleRate, bias, softness);
+        vec4 atlasRect = light.shadowmapIndex != -1 ? camera.shadowAtlasRects[MAX_SPOT_LIGHT_SHADOWS + light.shadowmapIndex*SHADOW_CASCADES + cascade] : vec4(0.0);
+
+         if(atlasRect.z > 0.0)
+            shadow = CalculateShadow(fPosLightSpace, atlasRect, light.pcfSampleRate, bias, softness);
 
         lighting += PBRLighting(lightDir, light.color, albedo, roughness, metalness, normal, position, viewDir, F0) * (1.0 - shadow);
     }
@@ -1,6 +1,7 @@
 #version 450
 
 #include "camera.glsl"
+#include "draws.glsl"
 
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
@@ -10,6 +11,7 @@ layout(location = 0) out vec4 fPosition;
 layout(location = 1) out vec3 fNormal;
 layout(location = 2) out vec2 fTexcoord;
 layout(location = 3) noperspective out vec2 fUV;
+layout(location = 4) flat out uint fMaterialID;
 
 layout(set = 0, binding = 0) uniform CameraBuffer {
 	CameraBufferObject camera;
@@ -19,8 +21,8 @@ layout (set = 1, std430, binding = 0) buffer ModelMatrices {
     mat4 modelMatrix[];
 };
 
-layout(push_constant) uniform ModelMatrixID {
-	uint modelMatrixID;
+layout (set = 1, std430, binding = 4) buffer Draws {
+    Draw draws[];
 };
 
 float LinearDepth(float d)
@@ -29,6 +31,8 @@ float LinearDepth(float d)
 }
 void main() 
 {
+    uint modelMatrixID = draws[gl_InstanceIndex].matrixIndex;
+
 	vec4 vWorldSpace = modelMatrix[modelMatrixID] * vec4(vPosition, 1.0);
 
     gl_Position = camera.projView * vWorldSpace;
@@ -43,4 +47,6 @@ void main()
     fNormal  = normalize(mat3(modelMatrix[modelMatrixID]) * vNormal);
 
     fTexcoord = vTexcoord;
+
+    fMaterialID = draws[gl_InstanceIndex].materialIndex;
 }
\ No newline at end of file
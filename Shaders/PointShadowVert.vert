@@ -1,7 +1,13 @@
 #version 450
 
+// Compiled a second time with MULTIVIEW defined, then all six cube faces are rendered in one pass and gl_ViewIndex picks the face
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#endif
+
 #include "../EruptionEngine.ini"
 #include "lights.glsl"
+#include "draws.glsl"
 
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
@@ -31,17 +37,26 @@ layout(std430, set = 0, binding = 1) buffer Lights
 	vec4 cascadeFrustumSizeRatios[SHADOW_CASCADES];
 };
 
+layout (set = 0, std430, binding = 2) buffer Draws {
+    Draw draws[];
+};
+
 layout(push_constant) uniform PushConstant {
-	uint modelMatrixID;
 	uint lightID;
 	uint shadowmapID;
 };
 
 void main() 
 {
+    uint modelMatrixID = draws[gl_InstanceIndex].matrixIndex;
+
 	vec4 vWorldSpace = modelMatrix[modelMatrixID] * vec4(vPosition, 1.0);
 
+#ifdef MULTIVIEW
+    gl_Position = pointLights[lightID].viewProj[gl_ViewIndex] * vWorldSpace;
+#else
     gl_Position = pointLights[lightID].viewProj[shadowmapID] * vWorldSpace;
+#endif
 
     fDistance = distance(pointLights[lightID].position, vWorldSpace.xyz) / pointLights[lightID].radius;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../EruptionEngine.ini"
 #include "lights.glsl"
+#include "draws.glsl"
 
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
@@ -29,12 +30,17 @@ layout(std430, set = 0, binding = 1) buffer Lights
 	vec4 cascadeFrustumSizeRatios[SHADOW_CASCADES];
 };
 
+layout (set = 0, std430, binding = 2) buffer Draws {
+    Draw draws[];
+};
+
 layout(push_constant) uniform PushConstant {
-	uint modelMatrixID;
 	uint lightID;
 };
 
 void main() 
 {
+    uint modelMatrixID = draws[gl_InstanceIndex].matrixIndex;
+
     gl_Position = spotLights[lightID].viewProj * modelMatrix[modelMatrixID] * vec4(vPosition, 1.0);
 }
\ No newline at end of file
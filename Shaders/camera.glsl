@@ -24,6 +24,8 @@ struct CameraBufferObject
 
 	mat4 cascadeMatrices[MAX_DIR_LIGHT_SHADOWS][SHADOW_CASCADES];
 
+	vec4 shadowAtlasRects[MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES];
+
 	float clusterScale;
 	float clusterBias;
 
@@ -4,12 +4,14 @@
 
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\ClusterAABB.comp -o %~dp0\ClusterAABB.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\ClusterLightCulling.comp -o %~dp0\ClusterLightCulling.spv
+%VULKAN_SDK%/Bin/glslc.exe %~dp0\DrawCulling.comp -o %~dp0\DrawCulling.spv
 
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\FullscreenTri.vert -o %~dp0\FullscreenTri.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\FXAA.frag -o %~dp0\FXAA.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\SSAO.frag -o %~dp0\SSAO.spv
 
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\PointShadowVert.vert -o %~dp0\PointShadowVert.spv
+%VULKAN_SDK%/Bin/glslc.exe -DMULTIVIEW %~dp0\PointShadowVert.vert -o %~dp0\PointShadowMultiviewVert.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\SpotShadowVert.vert -o %~dp0\SpotShadowVert.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\DirShadowVert.vert -o %~dp0\DirShadowVert.spv
 %VULKAN_SDK%/Bin/glslc.exe %~dp0\ShadowFrag.frag -o %~dp0\ShadowFrag.spv
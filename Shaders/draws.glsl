@@ -0,0 +1,20 @@
+#ifndef DRAWS_GLSL
+#define DRAWS_GLSL
+
+struct Draw
+{
+    vec4 boundingSphere;
+
+    uint matrixIndex;
+    uint materialIndex;
+    uint indexCount;
+    uint firstIndex;
+
+    int  vertexOffset;
+    uint geometryIndex;
+    uint flags;
+    uint _padding1;
+};
+
+#define DRAW_FLAG_STATIC 1
+#endif
\ No newline at end of file
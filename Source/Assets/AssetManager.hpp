@@ -3,6 +3,7 @@
 #ifndef EN_ASSETMANAGER_HPP
 #define EN_ASSETMANAGER_HPP
 
+#include <Assets/Texture.hpp>
 #include <Assets/Material.hpp>
 #include <Assets/Mesh.hpp>
 #include <Assets/MeshImporter/GLTFImporter.hpp>
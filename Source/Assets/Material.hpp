@@ -3,18 +3,23 @@
 #ifndef EN_MATERIAL_HPP
 #define EN_MATERIAL_HPP
 
-#include <Assets/Texture.hpp>
-#include <Renderer/DescriptorSet.hpp>
-#include <Renderer/DescriptorAllocator.hpp>
+#include <Core/Types.hpp>
 
 #include "Asset.hpp"
 
+#include <glm.hpp>
+
+#include <string>
+
 namespace en
 {
+	class Texture;
+
 	class Material : public Asset
 	{
 		friend class AssetManager;
 		friend class Scene;
+		friend class SceneState;
 
 	public:
 		Material(const std::string& name, const glm::vec3 color, const float metalnessVal, const float roughnessVal, const float normalStrength, Handle<Texture> albedoTexture, Handle<Texture> roughnessTexture, Handle<Texture> normalTexture, Handle<Texture> metalnessTexture)
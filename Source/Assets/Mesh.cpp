@@ -4,6 +4,8 @@ namespace en
 {
 	Handle<Mesh> g_EmptyMesh;
 
+	uint32_t g_MeshVersion = 0U;
+
 	Handle<Mesh> Mesh::GetEmptyMesh()
 	{
 		if (!g_EmptyMesh)
@@ -11,4 +13,21 @@ namespace en
 
 		return g_EmptyMesh;
 	}
+
+	void Mesh::SetActive(const bool active)
+	{
+		if (m_Active != active)
+			IncrementVersion();
+
+		m_Active = active;
+	}
+
+	uint32_t Mesh::GetVersion()
+	{
+		return g_MeshVersion;
+	}
+	void Mesh::IncrementVersion()
+	{
+		g_MeshVersion++;
+	}
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ namespace en
 	class Mesh : public Asset
 	{
 		friend class AssetManager;
+		friend class SubMesh;
 
 	public:
 		Mesh(const std::string& name, const std::string& filePath) 
@@ -24,11 +25,19 @@ namespace en
 
 		static Handle<Mesh> GetEmptyMesh();
 
-		bool m_Active = true;
+		void SetActive(const bool active);
+		const bool IsActive() const { return m_Active; };
+
+		// Incremented by every change of a Mesh or a SubMesh that affects what gets drawn, scenes compare it to know when to rebuild their draws
+		static uint32_t GetVersion();
 
 	private:
+		static void IncrementVersion();
+
 		std::string m_Name;
 		std::string m_FilePath;
+
+		bool m_Active = true;
 	};
 }
 
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef EN_GLTFDECODER_HPP
+#define EN_GLTFDECODER_HPP
+
+#include "Importer.hpp"
+#include <json.hpp>
+#include <fstream>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+#include <gtc/type_ptr.hpp>
+#include <glm.hpp>
+
+
+namespace en
+{
+	// Reads the JSON, the accessors and the materials of a glTF without touching Vulkan, what needs the GPU is left to
+	// CreateTexture() and AddSubMesh(). GLTFImporter uploads them, the headless benchmark uses a mock of both instead.
+	class GLTFDecoder : public Importer
+	{
+	public:
+		GLTFDecoder(const MeshImportProperties& properties, Handle<Material> defaultMaterial, Handle<Texture> defaultSRGBTexture, Handle<Texture> defaultNonSRGBTexture);
+
+		MeshData LoadMeshFromFile(const std::string& filePath, const std::string& name);
+
+		// The same as LoadMeshFromFile() with the contents of the .gltf and its buffer, the image URIs are relative to the working directory
+		MeshData LoadMeshFromMemory(const std::string& jsonContent, std::vector<char> binaryData, const std::string& name);
+
+	protected:
+		virtual Handle<Texture> CreateTexture(const std::string& path, const std::string& name, const bool sRGB) = 0;
+
+		virtual void AddSubMesh(Handle<Mesh> mesh, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texUVs,
+								const std::vector<uint32_t>& indices, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere) = 0;
+
+	private:
+		nlohmann::json JSON{};
+
+		std::string m_FilePath{};
+		std::string m_FileDirectory{};
+
+		std::vector<char> m_BinaryData{};
+
+		std::vector<Handle<Material>> m_Materials;
+		std::vector<Handle<Texture>> m_Textures;
+
+	private:
+		MeshData ProcessScene(Handle<Mesh> mesh);
+
+		void ProcessNode(uint32_t id, Handle<Mesh> mesh);
+		void ProcessMesh(uint32_t id, Handle<Mesh> mesh);
+
+		std::vector<float> GetFloats(const nlohmann::json& accessor);
+		std::vector<uint32_t> GetIndices(const nlohmann::json& accessor);
+
+		void GetMaterials();
+
+		nlohmann::json GetMeshJsonData();
+		std::vector<char> GetMeshBinaryData();
+	};
+}
+
+
+#endif // !EN_GLTFDECODER_HPP
\ No newline at end of file
@@ -2,48 +2,25 @@
 #ifndef EN_GLTFIMPORTER_HPP
 #define EN_GLTFIMPORTER_HPP
 
-#include "Importer.hpp"
-#include <json.hpp>
-#include <fstream>
-#include <unordered_set>
-#include <unordered_map>
-#include <vector>
+#include <Assets/Texture.hpp>
+#include <Renderer/Buffers/MemoryBuffer.hpp>
+#include <Renderer/Buffers/Vertex.hpp>
 
-#include <gtc/type_ptr.hpp>
-#include <glm.hpp>
+#include "GLTFDecoder.hpp"
 
 
 namespace en
 {
-	class GLTFImporter : public Importer
+	class GLTFImporter : public GLTFDecoder
 	{
 	public:
 		GLTFImporter(const MeshImportProperties& properties, Handle<Material> defaultMaterial, Handle<Texture> defaultSRGBTexture, Handle<Texture> defaultNonSRGBTexture);
 
-		MeshData LoadMeshFromFile(const std::string& filePath, const std::string& name);
-
-	private:
-		nlohmann::json JSON{};
-
-		std::string m_FilePath{};
-		std::string m_FileDirectory{};
-
-		std::vector<char> m_BinaryData{};
-
-		std::vector<Handle<Material>> m_Materials;
-		std::vector<Handle<Texture>> m_Textures;
-
 	private:
-		void ProcessNode(uint32_t id, Handle<Mesh> mesh);
-		void ProcessMesh(uint32_t id, Handle<Mesh> mesh);
-
-		std::vector<float> GetFloats(const nlohmann::json& accessor);
-		std::vector<uint32_t> GetIndices(const nlohmann::json& accessor);
-
-		void GetMaterials();
+		Handle<Texture> CreateTexture(const std::string& path, const std::string& name, const bool sRGB) override;
 
-		nlohmann::json GetMeshJsonData();
-		std::vector<char> GetMeshBinaryData();
+		void AddSubMesh(Handle<Mesh> mesh, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texUVs,
+						const std::vector<uint32_t>& indices, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere) override;
 	};
 }
 
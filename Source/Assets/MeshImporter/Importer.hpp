@@ -2,11 +2,15 @@
 #ifndef EN_IMPORTER_HPP
 #define EN_IMPORTER_HPP
 
+#include <Core/Log.hpp>
+
 #include <Assets/Material.hpp>
 #include <Assets/Mesh.hpp>
 
 namespace en
 {
+	class Texture;
+
 	struct MeshData
 	{
 		Handle<Mesh> mesh{};
@@ -1,28 +1,29 @@
 #include "SubMesh.hpp"
 
+#include <Assets/Mesh.hpp>
+
+#include <atomic>
+
 namespace en
 {
-	SubMesh::SubMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Handle<Material> material)
-		: m_VertexCount(vertices.size()), m_IndexCount(indices.size()), m_Material(material), Asset{AssetType::SubMesh}
-	{
-		m_VertexBuffer = MakeHandle<MemoryBuffer>(
-			m_VertexCount * sizeof(Vertex), 
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-			VMA_MEMORY_USAGE_GPU_ONLY
-		);
+	// The importer creates SubMeshes on the job system
+	std::atomic<uint32_t> g_GeometryCount = 0U;
 
-		m_IndexBuffer = MakeHandle<MemoryBuffer>(
-			m_IndexCount * sizeof(uint32_t),
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-			VMA_MEMORY_USAGE_GPU_ONLY
-		);
+	SubMesh::SubMesh(const uint32_t vertexCount, const uint32_t indexCount, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere)
+		: m_VertexCount(vertexCount), m_IndexCount(indexCount), m_GeometryID(g_GeometryCount++), m_Material(material), m_BoundingBox(boundingBox), m_BoundingSphere(boundingSphere), Asset{AssetType::SubMesh} {}
 
-		m_VertexBuffer->CopyInto(vertices.data(), m_VertexBuffer->GetSize());
-		m_IndexBuffer->CopyInto(indices.data(), m_IndexBuffer->GetSize());
+	void SubMesh::SetActive(const bool active)
+	{
+		if (m_Active != active)
+			Mesh::IncrementVersion();
+
+		m_Active = active;
 	}
 	void SubMesh::SetMaterial(Handle<Material> material)
 	{
 		m_Material = material;
 		m_MaterialChanged = true;
+
+		Mesh::IncrementVersion();
 	}
 }
\ No newline at end of file
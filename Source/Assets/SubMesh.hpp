@@ -3,21 +3,30 @@
 #ifndef EN_SUBMESH_HPP
 #define EN_SUBMESH_HPP
 
-#include <Renderer/Buffers/MemoryBuffer.hpp>
-#include <Renderer/Buffers/Vertex.hpp>
+#include <Renderer/Camera/Frustum.hpp>
 
 #include "Asset.hpp"
 
 #include <Assets/Material.hpp>
 
+#include <vector>
+
 namespace en
 {
+	class MemoryBuffer;
+	struct Vertex;
+
 	class SubMesh : public Asset
 	{
 		friend class Scene;
+		friend class SceneState;
 
 	public:
-		SubMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Handle<Material> material);
+		// Creates the buffers and uploads the geometry, defined apart from the rest (in SubMeshBuffers.cpp) since it's the only part that needs Vulkan
+		SubMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere);
+
+		// Without any buffers, for the CPU side code that only needs the counts and the bounds, e.g. the headless benchmark
+		SubMesh(const uint32_t vertexCount, const uint32_t indexCount, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere);
 
 		Handle<MemoryBuffer> m_VertexBuffer;
 		Handle<MemoryBuffer> m_IndexBuffer;
@@ -25,18 +34,31 @@ namespace en
 		const uint32_t m_VertexCount;
 		const uint32_t m_IndexCount;
 
-		bool m_Active = true;
+		// Unique to the geometry, the copies of a SubMesh share it along with its buffers
+		const uint32_t m_GeometryID;
+
+		void SetActive(const bool active);
+		const bool IsActive() const { return m_Active; };
 
 		void SetMaterial(Handle<Material> material);
 		const Handle<Material> GetMaterial() const { return m_Material; };
 
 		const uint32_t& GetMaterialIndex() const { return m_MaterialIndex; };
 
+		// Local space bounding volumes, the sphere is packed as xyz - center, w - radius
+		const AABB&		 GetBoundingBox()	 const { return m_BoundingBox;	  };
+		const glm::vec4& GetBoundingSphere() const { return m_BoundingSphere; };
+
 	private:
 		Handle<Material> m_Material;
 
+		AABB	  m_BoundingBox{};
+		glm::vec4 m_BoundingSphere{};
+
 		uint32_t m_MaterialIndex{};
 		bool m_MaterialChanged = true;
+
+		bool m_Active = true;
 	};
 }
 
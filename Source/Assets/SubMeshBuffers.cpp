@@ -0,0 +1,26 @@
+#include "SubMesh.hpp"
+
+#include <Renderer/Buffers/MemoryBuffer.hpp>
+#include <Renderer/Buffers/Vertex.hpp>
+
+namespace en
+{
+	SubMesh::SubMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Handle<Material> material, const AABB& boundingBox, const glm::vec4& boundingSphere)
+		: SubMesh(static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()), material, boundingBox, boundingSphere)
+	{
+		m_VertexBuffer = MakeHandle<MemoryBuffer>(
+			m_VertexCount * sizeof(Vertex), 
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+
+		m_IndexBuffer = MakeHandle<MemoryBuffer>(
+			m_IndexCount * sizeof(uint32_t),
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+
+		m_VertexBuffer->CopyInto(vertices.data(), m_VertexBuffer->GetSize());
+		m_IndexBuffer->CopyInto(indices.data(), m_IndexBuffer->GetSize());
+	}
+}
\ No newline at end of file
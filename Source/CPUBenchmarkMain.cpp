@@ -0,0 +1,31 @@
+#include <Core/CPUBenchmark.hpp>
+
+#include <cstring>
+#include <iostream>
+
+// Entry point of the CPUBenchmark target of CMakeLists.txt, the engine runs the same cases (and the ones that need a GPU) with --cpu-benchmark
+int main(int argc, char** argv)
+{
+	std::string benchmarkConfig;
+
+	for (int i = 1; i < argc; i++)
+	{
+		// The config path is optional
+		if (std::strncmp(argv[i], "--", 2) != 0 && benchmarkConfig.empty())
+			benchmarkConfig = argv[i];
+		else
+			std::cout << "Unknown argument \"" << argv[i] << "\" was ignored\n";
+	}
+
+	try 
+	{
+		CPUBenchmark(benchmarkConfig).RunCPU();
+	}
+	catch (const std::exception& e) 
+	{
+		std::cout << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Helpers.hpp"
 
+#include <Renderer/BarrierBatch.hpp>
+
 namespace en
 {
     namespace Helpers
@@ -39,51 +41,14 @@ namespace en
                 .pCommandBuffers    = &commandBuffer,
             };
 
-            vkQueueSubmit(ctx.m_GraphicsQueue, 1U, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(ctx.m_GraphicsQueue);
-
-            vkFreeCommandBuffers(ctx.m_LogicalDevice, ctx.m_GraphicsCommandPool, 1U, &commandBuffer);
-        }
-
-        VkCommandBuffer BeginSingleTimeTransferCommands()
-        {
-            UseContext();
-
-            VkCommandBufferAllocateInfo allocInfo {
-                .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-                .commandPool        = ctx.m_TransferCommandPool,
-                .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-                .commandBufferCount = 1U
-            };
-            
-            VkCommandBuffer commandBuffer{};
-            vkAllocateCommandBuffers(ctx.m_LogicalDevice, &allocInfo, &commandBuffer);
-
-            constexpr VkCommandBufferBeginInfo beginInfo{
-                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-                .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-            };
-
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-            return commandBuffer;
-        }
-        void EndSingleTimeTransferCommands(const VkCommandBuffer commandBuffer)
-        {
-            UseContext();
-
-            vkEndCommandBuffer(commandBuffer);
-
-            VkSubmitInfo submitInfo {
-                .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                .commandBufferCount = 1U,
-                .pCommandBuffers    = &commandBuffer,
-            };
+            {
+                std::lock_guard<std::mutex> lock(ctx.m_QueueMutex);
 
-            vkQueueSubmit(ctx.m_TransferQueue, 1U, &submitInfo, VK_NULL_HANDLE);
-            vkQueueWaitIdle(ctx.m_TransferQueue);
+                vkQueueSubmit(ctx.m_GraphicsQueue, 1U, &submitInfo, VK_NULL_HANDLE);
+                vkQueueWaitIdle(ctx.m_GraphicsQueue);
+            }
 
-            vkFreeCommandBuffers(ctx.m_LogicalDevice, ctx.m_TransferCommandPool, 1U, &commandBuffer);
+            vkFreeCommandBuffers(ctx.m_LogicalDevice, ctx.m_GraphicsCommandPool, 1U, &commandBuffer);
         }
 
         void CreateImageView(const VkImage image, VkImageView& imageView, const VkImageViewType viewType, const VkFormat format, const VkImageAspectFlags aspectFlags, const uint32_t layer, const uint32_t layerCount, const uint32_t mipLevels)
@@ -109,44 +74,13 @@ namespace en
         
         void SimpleTransitionImageLayout(const VkImage image, const VkFormat format, const VkImageAspectFlags aspectFlags, const VkImageLayout oldLayout, const VkImageLayout newLayout, const uint32_t layerCount, const uint32_t mipLevels, const VkCommandBuffer cmdBuffer)
         {
-            UseContext();
+            VkAccessFlags2 srcAccessMask = 0U;
+            VkAccessFlags2 dstAccessMask = 0U;
 
-            bool usesTransferQueue = (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            VkPipelineStageFlags2 sourceStage = 0U;
+            VkPipelineStageFlags2 destinationStage = 0U;
 
-            VkImageMemoryBarrier barrier{
-                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-
-                .oldLayout = oldLayout,
-                .newLayout = newLayout,
-
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-
-                .image = image,
-
-                .subresourceRange {
-                    .aspectMask = aspectFlags,
-                    .baseMipLevel = 0U,
-                    .levelCount = mipLevels,
-                    .baseArrayLayer = 0U,
-                    .layerCount = layerCount,
-                },
-            };
-
-            VkPipelineStageFlags sourceStage = 0U;
-            VkPipelineStageFlags destinationStage = 0U;
-
-            VkCommandBuffer commandBuffer{};
-
-            if (cmdBuffer == VK_NULL_HANDLE)
-            {
-                if (usesTransferQueue)
-                    commandBuffer = BeginSingleTimeTransferCommands();
-                else
-                    commandBuffer = BeginSingleTimeGraphicsCommands();
-            }
-            else
-                commandBuffer = cmdBuffer;
+            VkCommandBuffer commandBuffer = cmdBuffer ? cmdBuffer : BeginSingleTimeGraphicsCommands();
 
             switch(oldLayout)
             {
@@ -154,46 +88,46 @@ namespace en
                 switch (newLayout)
                 {
                 case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                    srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+                    dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
 
-                    sourceStage      = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+                    sourceStage      = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
                     break;
                 case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+                    srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                    dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
 
-                    sourceStage     = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                    sourceStage     = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
                     break;
                 case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+                    srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                    dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
 
-                    sourceStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                    sourceStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
                     break;
                 case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+                    srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+                    dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
 
-                    sourceStage      = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    sourceStage      = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
                     break;
                 case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                    srcAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+                    dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
 
-                    sourceStage      = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                    sourceStage      = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
                     break;
                 case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-                    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                    srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+                    dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
 
-                    sourceStage      = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    sourceStage      = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
                     break;
 
                 default:
@@ -206,11 +140,11 @@ namespace en
                 switch (newLayout)
                 {
                 case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                    srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                    dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
 
-                    sourceStage      = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                    destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                    sourceStage      = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                    destinationStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
                     break;
 
                 default:
@@ -224,79 +158,25 @@ namespace en
                 break;
             }
 
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                sourceStage, destinationStage,
-                0U,
-                0U, nullptr,
-                0U, nullptr,
-                1U, &barrier
-            );
+            BarrierBatch barriers;
+            barriers.Add(image, aspectFlags, oldLayout, newLayout, srcAccessMask, dstAccessMask, sourceStage, destinationStage, 0U, layerCount, mipLevels);
+            barriers.Flush(commandBuffer);
 
             if (cmdBuffer == VK_NULL_HANDLE)
-            {
-                if (usesTransferQueue)
-                    EndSingleTimeTransferCommands(commandBuffer);
-                else
-                    EndSingleTimeGraphicsCommands(commandBuffer);
-            }
+                EndSingleTimeGraphicsCommands(commandBuffer);
         }
-        void TransitionImageLayout(const VkImage image, const VkFormat format, const VkImageAspectFlags aspectFlags, const VkImageLayout oldLayout, const VkImageLayout newLayout, const VkAccessFlags srcAccessMask, const VkAccessFlags dstAccessMask, const VkPipelineStageFlags srcStage, const VkPipelineStageFlags dstStage, const uint32_t layer, const uint32_t layerCount, const uint32_t mipLevels, const VkCommandBuffer cmdBuffer)
+        void TransitionImageLayout(const VkImage image, const VkFormat format, const VkImageAspectFlags aspectFlags, const VkImageLayout oldLayout, const VkImageLayout newLayout, const VkAccessFlags2 srcAccessMask, const VkAccessFlags2 dstAccessMask, const VkPipelineStageFlags2 srcStage, const VkPipelineStageFlags2 dstStage, const uint32_t layer, const uint32_t layerCount, const uint32_t mipLevels, const VkCommandBuffer cmdBuffer)
         {
-            UseContext();
-
-            bool usesTransferQueue = (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-            const VkImageMemoryBarrier barrier {
-                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            // A batch of its own, so it's skipped when the layout stays and nothing is written
+            BarrierBatch barriers;
+            barriers.Add(image, aspectFlags, oldLayout, newLayout, srcAccessMask, dstAccessMask, srcStage, dstStage, layer, layerCount, mipLevels);
 
-                .srcAccessMask = srcAccessMask,
-                .dstAccessMask = dstAccessMask,
-
-                .oldLayout = oldLayout,
-                .newLayout = newLayout,
-
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-
-                .image = image,
-                
-                .subresourceRange {
-                    .aspectMask     = aspectFlags,
-                    .baseMipLevel   = 0U,
-                    .levelCount     = mipLevels,
-                    .baseArrayLayer = layer,
-                    .layerCount     = layerCount,
-                }
-            };
-
-            VkCommandBuffer commandBuffer{};
-            if (cmdBuffer == VK_NULL_HANDLE)
-            {
-                if (usesTransferQueue)
-                    commandBuffer = BeginSingleTimeTransferCommands();
-                else
-                    commandBuffer = BeginSingleTimeGraphicsCommands();
-            }
-            else
-                commandBuffer = cmdBuffer;
+            VkCommandBuffer commandBuffer = cmdBuffer ? cmdBuffer : BeginSingleTimeGraphicsCommands();
             
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                srcStage, dstStage,
-                0U,
-                0U, nullptr,
-                0U, nullptr,
-                1U, &barrier
-            );
+            barriers.Flush(commandBuffer);
 
             if (cmdBuffer == VK_NULL_HANDLE)
-            {
-                if (usesTransferQueue)
-                    EndSingleTimeTransferCommands(commandBuffer);
-                else
-                    EndSingleTimeGraphicsCommands(commandBuffer);
-            }
+                EndSingleTimeGraphicsCommands(commandBuffer);
         }
     }
 }
\ No newline at end of file
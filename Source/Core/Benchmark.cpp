@@ -0,0 +1,545 @@
+#include "Benchmark.hpp"
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+// Sponza's interior, the same range the random lights of the example scene used
+const en::AABB SPONZA_BOUNDS{
+	.min = glm::vec3(-12.0f, 0.2f, -5.5f),
+	.max = glm::vec3( 12.0f, 12.2f, 5.5f),
+};
+
+// Every generated object gets about this much ground space, so the procedural scene grows with the object count
+constexpr float PROCEDURAL_OBJECT_SPACING = 2.5f;
+constexpr float PROCEDURAL_SCENE_HEIGHT	  = 8.0f;
+
+constexpr uint32_t ORBIT_PATH_KEYS = 8U;
+
+static glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const float t)
+{
+	const float t2 = t * t;
+	const float t3 = t2 * t;
+
+	return 0.5f * (
+		2.0f * p1 +
+		(p2 - p0) * t +
+		(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+		(3.0f * p1 - p0 - 3.0f * p2 + p3) * t3
+	);
+}
+
+Benchmark::Benchmark(const std::string& configPath) : CPUBenchmark(configPath)
+{
+	if (m_Config.scene != "procedural" && m_Config.scene != "sponza")
+		EN_ERROR("Benchmark::Benchmark() - \"" + m_Config.scene + "\" is not a known scene, use \"procedural\" or \"sponza\"!");
+
+	if (m_Config.frames == 0U || m_Config.resolutions.empty() || m_Config.objectCounts.empty() || m_Config.pointLightCounts.empty() || m_Config.spotLightCounts.empty())
+		EN_ERROR("Benchmark::Benchmark() - The config has to contain at least one frame and one value of every sweep!");
+}
+
+void Benchmark::Run()
+{
+	Init();
+
+	// The scene is only rebuilt when the counts change, the resolutions are swept on the same scene
+	for (const uint32_t objects : m_Config.objectCounts)
+		for (const uint32_t pointLights : m_Config.pointLightCounts)
+			for (const uint32_t spotLights : m_Config.spotLightCounts)
+			{
+				BuildScene(objects, pointLights, spotLights);
+
+				for (const Resolution resolution : m_Config.resolutions)
+				{
+					RunResult& result = m_Results.emplace_back(RunOnce(VkExtent2D{ resolution.width, resolution.height }));
+
+					result.objects	   = objects;
+					result.pointLights = static_cast<uint32_t>(m_Scene->m_PointLights.size());
+					result.spotLights  = static_cast<uint32_t>(m_Scene->m_SpotLights.size());
+
+					EN_LOG(
+						"Benchmark run " + std::to_string(m_Results.size()) + " (" + std::to_string(resolution.width) + "x" + std::to_string(resolution.height) +
+						", " + std::to_string(result.objects) + " objects, " + std::to_string(result.pointLights) + " point lights, " + std::to_string(result.spotLights) + " spot lights)" +
+						" - p50: " + std::to_string(result.p50) + "ms, p95: " + std::to_string(result.p95) + "ms, p99: " + std::to_string(result.p99) + "ms"
+					);
+				}
+			}
+
+	WriteResults();
+
+	Shutdown();
+}
+
+void Benchmark::RunEngineCases()
+{
+	Init();
+
+	// Nothing is rendered, the frames in flight only have to be done with the previous scene when it's replaced
+	for (const uint32_t objects : m_Config.cpuObjectCounts)
+	{
+		RunSceneUpdateCases(objects);
+		RunObjectChurnCase(objects);
+	}
+
+	RunImportCases();
+
+	m_DeviceName = m_Context->GetPhysicalDeviceName();
+
+	Shutdown();
+}
+
+void Benchmark::Init()
+{
+	EN_LOG("Benchmark::Init() - Started");
+
+	// RunCPU() creates it earlier
+	if (!m_Profiler)
+	{
+		m_Profiler = en::MakeScope<en::Profiler>();
+		EN_PROFILE_THREAD("Main Thread");
+	}
+
+	m_JobSystem = en::MakeScope<en::JobSystem>();
+
+	m_Context = en::MakeScope<en::Context>(true);
+
+	m_Renderer = en::MakeScope<en::Renderer>();
+	m_PipelineCreationStats = m_Renderer->GetPipelineCreationStats();
+
+	m_AssetManager = en::MakeScope<en::AssetManager>();
+
+	if (m_Config.scene == "sponza")
+		m_AssetManager->LoadMesh("Sponza", "Models/Sponza/Sponza.gltf");
+
+	CreateCubeMeshes();
+
+	m_Camera = en::MakeHandle<en::Camera>(60.0f, 0.1f, 200.0f);
+
+	EN_LOG("Benchmark::Init() - Finished");
+}
+void Benchmark::Shutdown()
+{
+	m_Renderer->UnbindScene();
+
+	m_Context->WaitIdle();
+
+	m_Scene.reset();
+	m_CubeMeshes.clear();
+	m_AssetManager.reset();
+	m_Renderer.reset();
+	m_Context.reset();
+	m_JobSystem.reset();
+	m_Profiler.reset();
+}
+
+void Benchmark::CreateCubeMeshes()
+{
+	std::vector<en::Vertex> vertices;
+	std::vector<uint32_t>	indices;
+
+	// Four vertices per face so every face gets its own normal
+	for (uint32_t axis = 0U; axis < 3U; axis++)
+		for (const float sign : { -1.0f, 1.0f })
+		{
+			glm::vec3 normal(0.0f);
+			normal[axis] = sign;
+
+			const glm::vec3 u = glm::vec3(normal.y, normal.z, normal.x) * sign;
+			const glm::vec3 v = glm::cross(normal, u);
+
+			const uint32_t first = static_cast<uint32_t>(vertices.size());
+
+			for (const glm::vec2 corner : { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f) })
+				vertices.emplace_back(en::Vertex{
+					.pos	  = (normal + u * corner.x + v * corner.y) * 0.5f,
+					.normal	  = normal,
+					.texcoord = corner * 0.5f + 0.5f,
+				});
+
+			for (const uint32_t index : { 0U, 1U, 2U, 2U, 3U, 0U })
+				indices.emplace_back(first + index);
+		}
+
+	// The material belongs to the submesh, so every material gets a cube of its own
+	std::mt19937 rng(m_Config.seed);
+
+	for (uint32_t i = 0U; i < BENCHMARK_MATERIAL_COUNT; i++)
+	{
+		const std::string name = "Benchmark Cube " + std::to_string(i);
+
+		const glm::vec3 color(RandomRange(rng, 0.2f, 1.0f), RandomRange(rng, 0.2f, 1.0f), RandomRange(rng, 0.2f, 1.0f));
+
+		m_AssetManager->CreateMaterial(name, color, RandomRange(rng, 0.0f, 1.0f), RandomRange(rng, 0.1f, 0.9f));
+
+		auto& mesh = m_CubeMeshes.emplace_back(en::MakeHandle<en::Mesh>(name, ""));
+
+		mesh->m_SubMeshes.emplace_back(
+			vertices, indices,
+			m_AssetManager->GetMaterial(name),
+			en::AABB{ glm::vec3(-0.5f), glm::vec3(0.5f) },
+			glm::vec4(0.0f, 0.0f, 0.0f, std::sqrt(0.75f))
+		);
+	}
+}
+void Benchmark::BuildScene(const uint32_t objects, const uint32_t pointLights, const uint32_t spotLights)
+{
+	EN_PROFILE_FUNCTION();
+
+	// The old scene's buffers can still be used by the frames in flight
+	m_Renderer->UnbindScene();
+
+	m_Context->WaitIdle();
+
+	m_Scene = en::MakeHandle<en::Scene>();
+	m_Scene->m_MainCamera	= m_Camera;
+	m_Scene->m_AmbientColor = glm::vec3(0.042f, 0.045f, 0.074f);
+
+	if (m_Config.scene == "sponza")
+	{
+		m_SceneBounds = SPONZA_BOUNDS;
+
+		auto sponza = m_Scene->CreateSceneObject("Sponza", m_AssetManager->GetMesh("Sponza"));
+		sponza->SetScale(glm::vec3(1.2f));
+		sponza->SetStatic(true);
+	}
+	else
+	{
+		const float halfSize = std::max(std::sqrt(static_cast<float>(objects)), 1.0f) * PROCEDURAL_OBJECT_SPACING * 0.5f;
+
+		m_SceneBounds = en::AABB{
+			.min = glm::vec3(-halfSize, 0.2f, -halfSize),
+			.max = glm::vec3( halfSize, PROCEDURAL_SCENE_HEIGHT, halfSize),
+		};
+	}
+
+	// A separate generator for everything, so changing one count doesn't move the rest
+	std::mt19937 objectRng(m_Config.seed);
+	std::mt19937 pointLightRng(m_Config.seed + 1U);
+	std::mt19937 spotLightRng(m_Config.seed + 2U);
+
+	const glm::vec3& min = m_SceneBounds.min;
+	const glm::vec3& max = m_SceneBounds.max;
+
+	for (uint32_t i = 0U; i < objects; i++)
+	{
+		auto object = m_Scene->CreateSceneObject("Benchmark Object " + std::to_string(i), m_CubeMeshes[objectRng() % BENCHMARK_MATERIAL_COUNT]);
+
+		object->SetPosition(glm::vec3(RandomRange(objectRng, min.x, max.x), RandomRange(objectRng, min.y, max.y * 0.5f), RandomRange(objectRng, min.z, max.z)));
+		object->SetRotation(glm::vec3(RandomRange(objectRng, 0.0f, 360.0f), RandomRange(objectRng, 0.0f, 360.0f), 0.0f));
+		object->SetScale(glm::vec3(RandomRange(objectRng, 0.3f, 1.2f)));
+		object->SetStatic(m_Config.staticObjects);
+	}
+
+	for (uint32_t i = 0U; i < std::min(pointLights, static_cast<uint32_t>(MAX_POINT_LIGHTS - 1)); i++)
+	{
+		const glm::vec3 position(RandomRange(pointLightRng, min.x, max.x), RandomRange(pointLightRng, min.y, max.y), RandomRange(pointLightRng, min.z, max.z));
+		const glm::vec3 color(RandomRange(pointLightRng, 0.0f, 1.0f), RandomRange(pointLightRng, 0.0f, 1.0f), RandomRange(pointLightRng, 0.0f, 1.0f));
+
+		m_Scene->CreatePointLight(position, color, RandomRange(pointLightRng, 2.0f, 17.0f), RandomRange(pointLightRng, 1.0f, 3.2f));
+	}
+
+	for (uint32_t i = 0U; i < std::min(spotLights, static_cast<uint32_t>(MAX_SPOT_LIGHTS - 1)); i++)
+	{
+		const glm::vec3 position(RandomRange(spotLightRng, min.x, max.x), RandomRange(spotLightRng, min.y, max.y), RandomRange(spotLightRng, min.z, max.z));
+		const glm::vec3 direction = glm::normalize(glm::vec3(RandomRange(spotLightRng, -0.5f, 0.5f), -1.0f, RandomRange(spotLightRng, -0.5f, 0.5f)));
+		const glm::vec3 color(RandomRange(spotLightRng, 0.0f, 1.0f), RandomRange(spotLightRng, 0.0f, 1.0f), RandomRange(spotLightRng, 0.0f, 1.0f));
+
+		m_Scene->CreateSpotLight(position, direction, color, 0.2f, 0.4f, RandomRange(spotLightRng, 4.0f, 10.0f), RandomRange(spotLightRng, 2.0f, 17.0f));
+	}
+
+	if (m_Config.directionalLight)
+	{
+		auto light = m_Scene->CreateDirectionalLight(glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f)), glm::vec3(1.0f, 0.95f, 0.9f), 3.0f);
+		light->m_CastShadows = true;
+	}
+
+	m_CameraPath = m_Config.cameraPath.empty() ? CreateOrbitPath() : m_Config.cameraPath;
+
+	m_Renderer->BindScene(m_Scene);
+}
+
+Benchmark::RunResult Benchmark::RunOnce(const VkExtent2D resolution)
+{
+	m_Renderer->SetOffscreenExtent(resolution);
+
+	// Covers the resize and the first uploads of a new scene
+	for (uint32_t frame = 0U; frame < m_Config.warmupFrames; frame++)
+	{
+		const CameraKey key = SampleCameraPath(0.0f);
+
+		m_Camera->m_Position = key.position;
+		m_Camera->m_Yaw		 = key.yaw;
+		m_Camera->m_Pitch	 = key.pitch;
+
+		RenderFrame();
+	}
+
+	m_Renderer->GetGPUProfiler().ResetStats();
+
+	RunResult result{ .resolution = resolution };
+	result.frameTimes.reserve(m_Config.frames);
+
+	for (uint32_t frame = 0U; frame < m_Config.frames; frame++)
+	{
+		const CameraKey key = SampleCameraPath(static_cast<float>(frame) / m_Config.frames);
+
+		m_Camera->m_Position = key.position;
+		m_Camera->m_Yaw		 = key.yaw;
+		m_Camera->m_Pitch	 = key.pitch;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		RenderFrame();
+
+		result.frameTimes.emplace_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	std::vector<float> sorted = result.frameTimes;
+	std::sort(sorted.begin(), sorted.end());
+
+	float sum = 0.0f;
+
+	for (const float frameTime : sorted)
+		sum += frameTime;
+
+	result.avg = sum / sorted.size();
+	result.p50 = Percentile(sorted, 0.50f);
+	result.p95 = Percentile(sorted, 0.95f);
+	result.p99 = Percentile(sorted, 0.99f);
+	result.max = sorted.back();
+
+	if (m_Renderer->GetGPUProfiler().IsSupported())
+		result.gpuStats = m_Renderer->GetGPUProfiler().GetStats();
+
+	return result;
+}
+void Benchmark::RenderFrame()
+{
+	EN_PROFILE_FRAME();
+
+	m_Renderer->Update();
+	m_Renderer->PreRender();
+	m_Renderer->Render();
+}
+
+Benchmark::CameraKey Benchmark::SampleCameraPath(const float t) const
+{
+	const uint32_t keyCount = static_cast<uint32_t>(m_CameraPath.size());
+
+	if (keyCount == 1U)
+		return m_CameraPath[0];
+
+	// The path is a closed loop, the last key leads back into the first one
+	const float position = t * keyCount;
+	const uint32_t segment = static_cast<uint32_t>(position) % keyCount;
+	const float local = position - std::floor(position);
+
+	const CameraKey& k0 = m_CameraPath[(segment + keyCount - 1U) % keyCount];
+	const CameraKey& k1 = m_CameraPath[segment];
+	const CameraKey& k2 = m_CameraPath[(segment + 1U) % keyCount];
+	const CameraKey& k3 = m_CameraPath[(segment + 2U) % keyCount];
+
+	// The angles are unwrapped relative to k1, so the camera takes the short way around
+	const auto unwrap = [](const float angle, const float reference) { return reference + std::remainder(angle - reference, 360.0f); };
+
+	const glm::vec3 a0(unwrap(k0.yaw, k1.yaw), k0.pitch, 0.0f);
+	const glm::vec3 a1(k1.yaw, k1.pitch, 0.0f);
+	const glm::vec3 a2(unwrap(k2.yaw, k1.yaw), k2.pitch, 0.0f);
+	const glm::vec3 a3(unwrap(k3.yaw, a2.x), k3.pitch, 0.0f);
+
+	const glm::vec3 angles = CatmullRom(a0, a1, a2, a3, local);
+
+	return CameraKey{
+		.position = CatmullRom(k0.position, k1.position, k2.position, k3.position, local),
+		.yaw	  = angles.x,
+		.pitch	  = glm::clamp(angles.y, -89.0f, 89.0f),
+	};
+}
+std::vector<Benchmark::CameraKey> Benchmark::CreateOrbitPath() const
+{
+	const glm::vec3 center = (m_SceneBounds.min + m_SceneBounds.max) * 0.5f;
+	const glm::vec3 radius = (m_SceneBounds.max - m_SceneBounds.min) * 0.5f * 0.75f;
+
+	const glm::vec3 target(center.x, m_SceneBounds.min.y, center.z);
+
+	std::vector<CameraKey> path(ORBIT_PATH_KEYS);
+
+	for (uint32_t i = 0U; i < ORBIT_PATH_KEYS; i++)
+	{
+		const float angle = 2.0f * glm::pi<float>() * i / ORBIT_PATH_KEYS;
+
+		const glm::vec3 position = center + glm::vec3(std::cos(angle) * radius.x, -radius.y * 0.5f, std::sin(angle) * radius.z);
+
+		// Same angles as Camera::LookAt()
+		const glm::vec3 direction = glm::normalize(target - position);
+
+		path[i] = CameraKey{
+			.position = position,
+			.yaw	  = glm::degrees(std::atan2(direction.z, direction.x)),
+			.pitch	  = glm::degrees(std::atan2(direction.y, glm::length(glm::vec2(direction.x, direction.z)))),
+		};
+	}
+
+	return path;
+}
+
+void Benchmark::WriteResults() const
+{
+	nlohmann::json json;
+
+	json["device"]		 = m_Context->GetPhysicalDeviceName();
+	json["scene"]		 = m_Config.scene;
+	json["warmupFrames"] = m_Config.warmupFrames;
+	json["frames"]		 = m_Config.frames;
+	json["seed"]		 = m_Config.seed;
+	json["pipelines"]	 = {
+		{ "count",			 m_PipelineCreationStats.pipelines		  },
+		{ "deferred",		 m_PipelineCreationStats.deferredPipelines },
+		{ "creationTimeMs",  m_PipelineCreationStats.creationTime	  },
+		{ "waitTimeMs",		 m_PipelineCreationStats.waitTime		  },
+		{ "backendTimeMs",	 m_PipelineCreationStats.backendTime	  },
+		{ "warmCache",		 m_PipelineCreationStats.warmCache		  },
+	};
+	json["runs"]		 = nlohmann::json::array();
+
+	std::ofstream csv(m_Config.output + ".csv");
+
+	if (!csv.is_open())
+		EN_WARN("Benchmark::WriteResults() - Failed to open \"" + m_Config.output + ".csv\" for writing!");
+
+	csv << "width,height,objects,point_lights,spot_lights,frames,avg_ms,p50_ms,p95_ms,p99_ms,max_ms,gpu_frame_avg_ms,gpu_frame_p99_ms\n";
+
+	for (const auto& result : m_Results)
+	{
+		nlohmann::json passes = nlohmann::json::array();
+
+		std::string gpuFrameAvg, gpuFrameP99;
+
+		for (const auto& scope : result.gpuStats)
+		{
+			passes.push_back({
+				{ "name",  scope.name  },
+				{ "depth", scope.depth },
+				{ "timed", scope.timed },
+				{ "minMs", scope.min   },
+				{ "avgMs", scope.avg   },
+				{ "p99Ms", scope.p99   },
+			});
+
+			if (scope.name == "Frame")
+			{
+				gpuFrameAvg = std::to_string(scope.avg);
+				gpuFrameP99 = std::to_string(scope.p99);
+			}
+		}
+
+		json["runs"].push_back({
+			{ "width",		  result.resolution.width  },
+			{ "height",		  result.resolution.height },
+			{ "objects",	  result.objects	 },
+			{ "pointLights",  result.pointLights },
+			{ "spotLights",	  result.spotLights  },
+			{ "avgMs",		  result.avg		 },
+			{ "p50Ms",		  result.p50		 },
+			{ "p95Ms",		  result.p95		 },
+			{ "p99Ms",		  result.p99		 },
+			{ "maxMs",		  result.max		 },
+			{ "gpuPasses",	  passes			 },
+			{ "frameTimesMs", result.frameTimes	 },
+		});
+
+		csv << result.resolution.width << ',' << result.resolution.height << ','
+			<< result.objects << ',' << result.pointLights << ',' << result.spotLights << ','
+			<< result.frameTimes.size() << ','
+			<< result.avg << ',' << result.p50 << ',' << result.p95 << ',' << result.p99 << ',' << result.max << ','
+			<< gpuFrameAvg << ',' << gpuFrameP99 << '\n';
+	}
+
+	std::ofstream file(m_Config.output + ".json");
+
+	if (!file.is_open())
+	{
+		EN_WARN("Benchmark::WriteResults() - Failed to open \"" + m_Config.output + ".json\" for writing!");
+		return;
+	}
+
+	file << json.dump(4);
+
+	EN_LOG("Saved the benchmark results to \"" + m_Config.output + ".csv\" and \"" + m_Config.output + ".json\"");
+}
+
+void Benchmark::RunSceneUpdateCases(const uint32_t objects)
+{
+	BuildScene(objects, m_Config.cpuPointLights, 0U);
+
+	const CameraKey key = SampleCameraPath(0.0f);
+
+	m_Camera->m_Position = key.position;
+	m_Camera->m_Yaw		 = key.yaw;
+	m_Camera->m_Pitch	 = key.pitch;
+
+	std::vector<en::Handle<en::SceneObject>> sceneObjects(objects);
+
+	for (uint32_t i = 0U; i < objects; i++)
+		sceneObjects[i] = m_Scene->GetSceneObject("Benchmark Object " + std::to_string(i));
+
+	std::mt19937 rng(m_Config.seed);
+
+	for (const float fraction : m_Config.cpuMovedFractions)
+	{
+		const uint32_t moved = std::min(static_cast<uint32_t>(std::ceil(fraction * objects)), objects);
+
+		const auto move = [&]() {
+			for (uint32_t i = 0U; i < moved; i++)
+				sceneObjects[i]->SetPosition(sceneObjects[i]->GetPosition() + glm::vec3(RandomRange(rng, -1.0f, 1.0f), 0.0f, RandomRange(rng, -1.0f, 1.0f)) * CPU_MOVE_DISTANCE);
+		};
+
+		CPUResult& result = MeasureCPU("Scene update", m_Config.cpuIterations, move, [&]() { m_Renderer->Update(); });
+
+		result.parameters = {
+			{ "objects",	  objects },
+			{ "pointLights",  static_cast<uint32_t>(m_Scene->m_PointLights.size()) },
+			{ "movedObjects", moved	  },
+		};
+	}
+}
+void Benchmark::RunObjectChurnCase(const uint32_t objects)
+{
+	if (objects == 0U) return;
+
+	// The freed slot is in the middle, so registering the object again searches through half of the occupied ones
+	const std::string name = "Benchmark Object " + std::to_string(objects / 2U);
+	const auto& mesh = m_CubeMeshes[0];
+
+	CPUResult& result = MeasureCPU("Object create and delete", m_Config.cpuIterations, nullptr, [&]() {
+		m_Scene->DeleteSceneObject(name);
+		m_Scene->CreateSceneObject(name, mesh);
+	});
+
+	result.parameters = { { "objects", objects } };
+}
+void Benchmark::RunImportCases()
+{
+	// Only the geometry and the materials, decoding the textures would outweigh the rest of the import
+	const en::MeshImportProperties properties{
+		.importAlbedoTextures	 = false,
+		.importRoughnessTextures = false,
+		.importMetalnessTextures = false,
+		.importNormalTextures	 = false,
+	};
+
+	// Meshes can't be deleted yet, so every import needs a name of its own
+	uint32_t imports = 0U;
+
+	for (const auto& path : m_Config.importFiles)
+	{
+		// Includes staging and submitting the vertex and index buffers (as the renderer would once per frame) but not waiting for
+		// the copies, the "Upload SubMesh" zone tells it apart from the decoding
+		MeasureCPU("glTF import " + path, m_Config.importIterations, nullptr, [&]() {
+			m_AssetManager->LoadMesh("Benchmark Import " + std::to_string(imports++), path, properties);
+			m_Context->m_UploadQueue->Flush();
+		});
+	}
+}
\ No newline at end of file
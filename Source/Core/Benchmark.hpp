@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef EN_BENCHMARK_HPP
+#define EN_BENCHMARK_HPP
+
+#include <Core/CPUBenchmark.hpp>
+#include <Renderer/Context.hpp>
+#include <Renderer/Renderer.hpp>
+#include <Assets/AssetManager.hpp>
+
+#include <string>
+#include <vector>
+
+// Flies the camera along a path for a fixed amount of frames in headless mode and writes the frame time distribution of every run
+// to <output>.csv and <output>.json, together with the GPU time of every pass when timestamps are supported. Every combination
+// of the swept object counts, light counts and resolutions is a separate run.
+// RunCPU() adds the CPU cases that need the engine to the ones of CPUBenchmark.
+class Benchmark : public CPUBenchmark
+{
+public:
+	// An empty path runs with the default config
+	Benchmark(const std::string& configPath = "");
+
+	void Run();
+
+private:
+	struct RunResult
+	{
+		VkExtent2D resolution{};
+
+		uint32_t objects	 = 0U;
+		uint32_t pointLights = 0U;
+		uint32_t spotLights	 = 0U;
+
+		// In milliseconds
+		float avg = 0.0f;
+		float p50 = 0.0f;
+		float p95 = 0.0f;
+		float p99 = 0.0f;
+		float max = 0.0f;
+
+		std::vector<float> frameTimes;
+		std::vector<en::GPUProfiler::ScopeStats> gpuStats;
+	};
+
+	void Init();
+	void Shutdown();
+
+	void CreateCubeMeshes();
+	void BuildScene(const uint32_t objects, const uint32_t pointLights, const uint32_t spotLights);
+
+	RunResult RunOnce(const VkExtent2D resolution);
+	void RenderFrame();
+
+	CameraKey SampleCameraPath(const float t) const;
+	std::vector<CameraKey> CreateOrbitPath() const;
+
+	void WriteResults() const;
+
+	// The scene update (with the CSM, shadow tiles and culling) for every object count and moved fraction, object creation and
+	// deletion and glTF imports
+	void RunEngineCases() override;
+
+	void RunSceneUpdateCases(const uint32_t objects);
+	void RunObjectChurnCase(const uint32_t objects);
+	void RunImportCases();
+
+	en::Scope<en::Context>		m_Context;
+	en::Scope<en::AssetManager> m_AssetManager;
+	en::Scope<en::Renderer>		m_Renderer;
+
+	std::vector<en::Handle<en::Mesh>> m_CubeMeshes;
+
+	en::Handle<en::Camera> m_Camera;
+	en::Handle<en::Scene>  m_Scene;
+
+	// Where the objects and lights are spread, the default camera path orbits it
+	en::AABB m_SceneBounds{};
+
+	std::vector<CameraKey> m_CameraPath;
+	// Of the first backend, it's created before any of the runs
+	en::Renderer::PipelineCreationStats m_PipelineCreationStats{};
+
+	std::vector<RunResult> m_Results;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,823 @@
+#include "CPUBenchmark.hpp"
+
+#include <Core/Log.hpp>
+#include <Scene/SceneState.hpp>
+#include <Renderer/CascadedShadowMaps.hpp>
+#include <Renderer/DescriptorLayoutCache.hpp>
+#include <Assets/MeshImporter/GLTFDecoder.hpp>
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+// Every generated object gets about this much ground space, the same as in the procedural scene of Benchmark
+constexpr float HEADLESS_OBJECT_SPACING = 2.5f;
+constexpr float HEADLESS_SCENE_HEIGHT	= 8.0f;
+
+// Steps of a linear congruential generator every ParallelFor index takes
+constexpr uint32_t JOB_INDEX_WORK = 64U;
+
+// Degrees the camera turns before every cascades update, enough for every cascade to be refitted
+constexpr float CASCADES_CAMERA_TURN = 7.0f;
+
+// The renderer's defaults
+constexpr float	   CASCADES_FAR_PLANE	 = 140.0f;
+constexpr float	   CASCADES_SPLIT_WEIGHT = 0.87f;
+constexpr uint32_t CASCADES_RESOLUTION	 = 2048U;
+constexpr uint32_t SHADOW_ATLAS_SLOTS	 = MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES;
+
+constexpr uint32_t DESCRIPTOR_INFO_LOOKUPS = 4096U;
+
+// The generated glTF has a grid of GLTF_GRID_SIZE^2 vertices per mesh, every other mesh has 16 bit indices
+constexpr uint32_t GLTF_MESHES	  = 64U;
+constexpr uint32_t GLTF_GRID_SIZE = 32U;
+constexpr uint32_t GLTF_MATERIALS = 4U;
+constexpr uint32_t GLTF_TEXTURES  = 3U;
+
+// A SceneState without the GPU side, what the uploads of Scene would reset is reset right after every update instead.
+// The textures only get indices, the materials of the benchmark don't have any.
+class HeadlessScene : public en::SceneState
+{
+public:
+	using SceneState::RegisterMatrix;
+	using SceneState::RegisterMaterial;
+	using SceneState::DeregisterMatrix;
+	using SceneState::DeregisterMaterial;
+
+	void Update()
+	{
+		UpdateSceneCPU();
+
+		m_ChangedDrawIDs.clear();
+
+		m_GeometryChanged = false;
+
+		m_UploadedVertexCount = m_GeometryVertexCount;
+		m_UploadedIndexCount  = m_GeometryIndexCount;
+	}
+
+	// The i-th of them has the shadow map index i, directional lights keep their order
+	const std::vector<uint32_t>& GetDirLightShadowCasters() const { return m_ActiveDirLightsShadowIDs; }
+
+private:
+	uint32_t RegisterTexture(en::Handle<en::Texture> texture) override
+	{
+		const auto [it, inserted] = m_TextureIndices.try_emplace(texture.get(), static_cast<uint32_t>(m_TextureIndices.size()));
+
+		return it->second;
+	}
+
+	bool IsDefaultTexture(const en::Handle<en::Texture>& texture) const override { return !texture; }
+
+	std::unordered_map<const en::Texture*, uint32_t> m_TextureIndices{ { nullptr, 0U } };
+};
+
+// Decodes the glTF without the GPU side, the submeshes only get the counts and the textures aren't loaded
+class HeadlessImporter : public en::GLTFDecoder
+{
+public:
+	HeadlessImporter(const en::MeshImportProperties& properties, en::Handle<en::Material> defaultMaterial)
+		: GLTFDecoder(properties, defaultMaterial, nullptr, nullptr) {}
+
+	// Sum of every decoded index, compared against the generated ones
+	uint64_t m_IndexSum = 0U;
+
+private:
+	en::Handle<en::Texture> CreateTexture(const std::string& path, const std::string& name, const bool sRGB) override { return nullptr; }
+
+	void AddSubMesh(en::Handle<en::Mesh> mesh, const std::vector<glm::vec3>& positions, const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texUVs,
+					const std::vector<uint32_t>& indices, en::Handle<en::Material> material, const en::AABB& boundingBox, const glm::vec4& boundingSphere) override
+	{
+		for (const uint32_t index : indices)
+			m_IndexSum += index;
+
+		mesh->m_SubMeshes.emplace_back(static_cast<uint32_t>(positions.size()), static_cast<uint32_t>(indices.size()), material, boundingBox, boundingSphere);
+	}
+};
+
+// The layout cache of the DescriptorAllocator without creating the layouts, every miss is counted instead
+class HeadlessLayoutCache : public en::DescriptorLayoutCache
+{
+public:
+	uint32_t GetLayoutCount() const { return static_cast<uint32_t>(m_LayoutMap.size()); }
+
+	uint32_t m_CreatedLayouts = 0U;
+
+private:
+	VkDescriptorSetLayout CreateLayout(const en::DescriptorInfo& descriptorInfo) override
+	{
+		m_CreatedLayouts++;
+
+		return VK_NULL_HANDLE;
+	}
+};
+
+// A glTF with GLTF_MESHES grids of GLTF_GRID_SIZE^2 vertices, the i-th of them at the height i. The materials go from every
+// texture to none, the last mesh of every GLTF_MATERIALS + 1 doesn't have one and gets the default material.
+static void GenerateGLTF(std::string& jsonContent, std::vector<char>& binaryData, uint64_t& indexSum)
+{
+	nlohmann::json json;
+
+	json["asset"]["version"] = "2.0";
+
+	json["images"] = nlohmann::json::array();
+	json["textures"] = nlohmann::json::array();
+
+	for (uint32_t i = 0U; i < GLTF_TEXTURES; i++)
+	{
+		json["images"].push_back({ { "name", "Benchmark Texture " + std::to_string(i) }, { "uri", "BenchmarkTexture" + std::to_string(i) + ".png" } });
+		json["textures"].push_back({ { "source", i } });
+	}
+
+	json["materials"] = {
+		{
+			{ "name", "Benchmark Material 0" },
+			{ "pbrMetallicRoughness", {
+				{ "baseColorFactor",		  { 0.8f, 0.6f, 0.4f, 1.0f } },
+				{ "baseColorTexture",		  { { "index", 0 } } },
+				{ "metallicRoughnessTexture", { { "index", 1 } } },
+				{ "metallicFactor",			  1.0f },
+				{ "roughnessFactor",		  1.0f },
+			} },
+			{ "normalTexture", { { "index", 2 }, { "scale", 0.5f } } },
+		},
+		{
+			{ "name", "Benchmark Material 1" },
+			{ "pbrMetallicRoughness", { { "baseColorTexture", { { "index", 0 } } } } },
+		},
+		{
+			{ "name", "Benchmark Material 2" },
+			{ "pbrMetallicRoughness", { { "baseColorFactor", { 0.2f, 0.4f, 0.9f, 1.0f } }, { "roughnessFactor", 0.3f } } },
+		},
+		{
+			{ "name", "Benchmark Material 3" },
+		},
+	};
+
+	json["accessors"]	= nlohmann::json::array();
+	json["bufferViews"] = nlohmann::json::array();
+	json["meshes"]		= nlohmann::json::array();
+	json["nodes"]		= nlohmann::json::array();
+
+	constexpr uint32_t vertexCount = GLTF_GRID_SIZE * GLTF_GRID_SIZE;
+	constexpr uint32_t indexCount  = (GLTF_GRID_SIZE - 1U) * (GLTF_GRID_SIZE - 1U) * 6U;
+
+	binaryData.clear();
+	indexSum = 0U;
+
+	// Adds a buffer view with its accessor and returns the index of the accessor
+	const auto addAccessor = [&](const void* data, const size_t size, const uint32_t componentType, const uint32_t count, const std::string& type) {
+		json["bufferViews"].push_back({ { "buffer", 0 }, { "byteOffset", binaryData.size() }, { "byteLength", size } });
+		json["accessors"].push_back({ { "bufferView", json["bufferViews"].size() - 1U }, { "componentType", componentType }, { "count", count }, { "type", type } });
+
+		binaryData.insert(binaryData.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+
+		// Keeps the next view 4 byte aligned after the 16 bit indices
+		binaryData.resize((binaryData.size() + 3U) & ~size_t(3U));
+
+		return json["accessors"].size() - 1U;
+	};
+
+	std::vector<glm::vec3> positions(vertexCount);
+	std::vector<glm::vec3> normals(vertexCount, glm::vec3(0.0f, 1.0f, 0.0f));
+	std::vector<glm::vec2> texUVs(vertexCount);
+	std::vector<uint32_t>  indices;
+	std::vector<uint16_t>  shortIndices;
+
+	for (uint32_t z = 0U; z < GLTF_GRID_SIZE - 1U; z++)
+		for (uint32_t x = 0U; x < GLTF_GRID_SIZE - 1U; x++)
+		{
+			const uint32_t corner = z * GLTF_GRID_SIZE + x;
+
+			for (const uint32_t index : { corner, corner + GLTF_GRID_SIZE, corner + 1U, corner + 1U, corner + GLTF_GRID_SIZE, corner + GLTF_GRID_SIZE + 1U })
+				indices.emplace_back(index);
+		}
+
+	shortIndices.assign(indices.begin(), indices.end());
+
+	for (uint32_t mesh = 0U; mesh < GLTF_MESHES; mesh++)
+	{
+		for (uint32_t z = 0U; z < GLTF_GRID_SIZE; z++)
+			for (uint32_t x = 0U; x < GLTF_GRID_SIZE; x++)
+			{
+				positions[z * GLTF_GRID_SIZE + x] = glm::vec3(x, mesh, z);
+				texUVs[z * GLTF_GRID_SIZE + x]	  = glm::vec2(x, z) / static_cast<float>(GLTF_GRID_SIZE - 1U);
+			}
+
+		nlohmann::json primitive;
+
+		primitive["attributes"]["POSITION"]	  = addAccessor(positions.data(), positions.size() * sizeof(glm::vec3), 5126U, vertexCount, "VEC3");
+		primitive["attributes"]["NORMAL"]	  = addAccessor(normals.data(),	  normals.size() * sizeof(glm::vec3),	5126U, vertexCount, "VEC3");
+		primitive["attributes"]["TEXCOORD_0"] = addAccessor(texUVs.data(),	  texUVs.size() * sizeof(glm::vec2),	5126U, vertexCount, "VEC2");
+
+		primitive["indices"] = mesh % 2U ?
+			addAccessor(shortIndices.data(), shortIndices.size() * sizeof(uint16_t), 5123U, indexCount, "SCALAR") :
+			addAccessor(indices.data(),		 indices.size() * sizeof(uint32_t),		 5125U, indexCount, "SCALAR");
+
+		if (mesh % (GLTF_MATERIALS + 1U) != GLTF_MATERIALS)
+			primitive["material"] = mesh % (GLTF_MATERIALS + 1U);
+
+		json["meshes"].push_back({ { "primitives", { primitive } } });
+		json["nodes"].push_back({ { "mesh", mesh } });
+
+		for (const uint32_t index : indices)
+			indexSum += index;
+	}
+
+	json["buffers"] = { { { "byteLength", binaryData.size() }, { "uri", "Benchmark.bin" } } };
+
+	jsonContent = json.dump();
+}
+
+CPUBenchmark::CPUBenchmark(const std::string& configPath)
+{
+	if (configPath.empty()) return;
+
+	std::ifstream file(configPath);
+
+	if (!file.is_open())
+		EN_ERROR("CPUBenchmark::CPUBenchmark() - Failed to open the config \"" + configPath + "\"!");
+
+	const nlohmann::json json = nlohmann::json::parse(file);
+
+	m_Config.scene			  = json.value("scene",			   m_Config.scene);
+	m_Config.warmupFrames	  = json.value("warmupFrames",	   m_Config.warmupFrames);
+	m_Config.frames			  = json.value("frames",		   m_Config.frames);
+	m_Config.seed			  = json.value("seed",			   m_Config.seed);
+	m_Config.staticObjects	  = json.value("staticObjects",	   m_Config.staticObjects);
+	m_Config.directionalLight = json.value("directionalLight", m_Config.directionalLight);
+	m_Config.objectCounts	  = json.value("objectCounts",	   m_Config.objectCounts);
+	m_Config.pointLightCounts = json.value("pointLightCounts", m_Config.pointLightCounts);
+	m_Config.spotLightCounts  = json.value("spotLightCounts",  m_Config.spotLightCounts);
+	m_Config.output			  = json.value("output",		   m_Config.output);
+
+	m_Config.cpuWarmupIterations = json.value("cpuWarmupIterations", m_Config.cpuWarmupIterations);
+	m_Config.cpuIterations		 = json.value("cpuIterations",		 m_Config.cpuIterations);
+	m_Config.cpuObjectCounts	 = json.value("cpuObjectCounts",	 m_Config.cpuObjectCounts);
+	m_Config.cpuPointLights		 = json.value("cpuPointLights",		 m_Config.cpuPointLights);
+	m_Config.cpuMovedFractions	 = json.value("cpuMovedFractions",	 m_Config.cpuMovedFractions);
+	m_Config.cpuMaterialCounts	 = json.value("cpuMaterialCounts",	 m_Config.cpuMaterialCounts);
+	m_Config.importFiles		 = json.value("importFiles",		 m_Config.importFiles);
+	m_Config.importIterations	 = json.value("importIterations",	 m_Config.importIterations);
+	m_Config.descriptorInfoCount = json.value("descriptorInfoCount", m_Config.descriptorInfoCount);
+	m_Config.jobIndices			 = json.value("jobIndices",			 m_Config.jobIndices);
+	m_Config.jobChains			 = json.value("jobChains",			 m_Config.jobChains);
+	m_Config.jobChainLength		 = json.value("jobChainLength",		 m_Config.jobChainLength);
+
+	if (json.contains("resolutions"))
+	{
+		m_Config.resolutions.clear();
+
+		for (const auto& resolution : json["resolutions"])
+			m_Config.resolutions.emplace_back(Resolution{ resolution.at(0).get<uint32_t>(), resolution.at(1).get<uint32_t>() });
+	}
+
+	if (json.contains("cameraPath"))
+		for (const auto& key : json["cameraPath"])
+			m_Config.cameraPath.emplace_back(CameraKey{
+				.position = glm::vec3(key["position"].at(0).get<float>(), key["position"].at(1).get<float>(), key["position"].at(2).get<float>()),
+				.yaw	  = key.value("yaw",   0.0f),
+				.pitch	  = key.value("pitch", 0.0f),
+			});
+
+	if (m_Config.cpuIterations == 0U || m_Config.importIterations == 0U)
+		EN_ERROR("CPUBenchmark::CPUBenchmark() - The config has to contain at least one iteration of every CPU case!");
+
+	if (m_Config.jobIndices == 0U || m_Config.jobChains == 0U || m_Config.jobChainLength == 0U)
+		EN_ERROR("CPUBenchmark::CPUBenchmark() - The job system cases need at least one index and one chain with one job!");
+
+	EN_LOG("Loaded the benchmark config \"" + configPath + "\"");
+}
+
+void CPUBenchmark::RunCPU()
+{
+	m_Profiler = en::MakeScope<en::Profiler>();
+	EN_PROFILE_THREAD("Main Thread");
+
+	// Doesn't need the GPU, and the renderer keeps creating pipelines on the job system once it exists
+	RunJobSystemCases();
+
+	for (const uint32_t objects : m_Config.cpuObjectCounts)
+	{
+		RunSceneStateCases(objects);
+		RunMatrixRegisterCase(objects);
+	}
+
+	for (const uint32_t materials : m_Config.cpuMaterialCounts)
+		RunMaterialRegisterCase(materials);
+
+	RunCascadesCase();
+	RunGLTFDecodeCase();
+	RunDescriptorInfoCase();
+
+	RunEngineCases();
+
+	WriteCPUResults();
+
+	m_Profiler.reset();
+}
+
+void CPUBenchmark::RunJobSystemCases()
+{
+	const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1U);
+
+	// Doubled up to every hardware thread, the calling thread is one of them
+	std::vector<uint32_t> threadCounts;
+
+	for (uint32_t threads = 1U; threads < hardwareThreads; threads *= 2U)
+		threadCounts.emplace_back(threads);
+
+	threadCounts.emplace_back(hardwareThreads);
+
+	// Made relaxed atomic, so an index visited by two chunks is counted twice instead of being a race
+	std::vector<std::atomic<uint32_t>> visits(m_Config.jobIndices);
+	std::vector<uint32_t>			   hashes(m_Config.jobIndices);
+
+	// Every job checks that the previous one of its chain already ran
+	const uint32_t chainJobs = m_Config.jobChains * m_Config.jobChainLength;
+
+	std::vector<en::JobCounter> chainCounters(chainJobs);
+	std::vector<uint32_t>		chainProgress(m_Config.jobChains);
+	std::atomic<uint32_t>		outOfOrderJobs = 0U;
+
+	for (const uint32_t threads : threadCounts)
+	{
+		// Only one can exist at a time
+		m_JobSystem.reset();
+		m_JobSystem = en::MakeScope<en::JobSystem>(threads - 1U);
+
+		for (auto& visit : visits)
+			visit.store(0U, std::memory_order_relaxed);
+
+		CPUResult& parallelFor = MeasureCPU("Job system ParallelFor", m_Config.cpuIterations, nullptr, [&]() {
+			m_JobSystem->ParallelFor(m_Config.jobIndices, [&visits, &hashes](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++)
+				{
+					// A bit of work per index, so the chunks don't only measure the scheduling
+					uint32_t hash = i;
+
+					for (uint32_t j = 0U; j < JOB_INDEX_WORK; j++)
+						hash = hash * 1664525U + 1013904223U;
+
+					hashes[i] = hash;
+					visits[i].fetch_add(1U, std::memory_order_relaxed);
+				}
+			});
+		});
+
+		parallelFor.parameters = {
+			{ "threads", threads			  },
+			{ "indices", m_Config.jobIndices },
+		};
+		parallelFor.operations = m_Config.jobIndices;
+
+		const uint32_t expectedVisits = m_Config.cpuWarmupIterations + m_Config.cpuIterations;
+
+		for (uint32_t i = 0U; i < m_Config.jobIndices; i++)
+			if (visits[i].load(std::memory_order_relaxed) != expectedVisits)
+				EN_ERROR("CPUBenchmark::RunJobSystemCases() - ParallelFor visited index " + std::to_string(i) + " " + std::to_string(visits[i].load()) + " times instead of " + std::to_string(expectedVisits) + " with " + std::to_string(threads) + " threads!");
+
+		const auto resetChains = [&]() {
+			std::fill(chainProgress.begin(), chainProgress.end(), 0U);
+		};
+
+		CPUResult& chains = MeasureCPU("Job system dependency chains", m_Config.cpuIterations, resetChains, [&]() {
+			for (uint32_t job = 0U; job < m_Config.jobChainLength; job++)
+				for (uint32_t chain = 0U; chain < m_Config.jobChains; chain++)
+				{
+					const uint32_t index = chain * m_Config.jobChainLength + job;
+
+					m_JobSystem->Execute([&, chain, job]() {
+						if (chainProgress[chain] != job)
+							outOfOrderJobs++;
+
+						chainProgress[chain] = job + 1U;
+					}, &chainCounters[index], job > 0U ? &chainCounters[index - 1U] : nullptr);
+				}
+
+			// The earlier counters of a chain are done before its last job is even scheduled
+			for (uint32_t chain = 0U; chain < m_Config.jobChains; chain++)
+				m_JobSystem->Wait(chainCounters[(chain + 1U) * m_Config.jobChainLength - 1U]);
+		});
+
+		chains.parameters = {
+			{ "threads",	 threads				 },
+			{ "chains",		 m_Config.jobChains		 },
+			{ "chainLength", m_Config.jobChainLength },
+		};
+		chains.operations = chainJobs;
+
+		for (uint32_t i = 0U; i < chainJobs; i++)
+			if (!chainCounters[i].IsDone())
+				EN_ERROR("CPUBenchmark::RunJobSystemCases() - A dependency chain counter didn't reach zero with " + std::to_string(threads) + " threads!");
+
+		for (uint32_t chain = 0U; chain < m_Config.jobChains; chain++)
+			if (chainProgress[chain] != m_Config.jobChainLength)
+				EN_ERROR("CPUBenchmark::RunJobSystemCases() - A dependency chain ran " + std::to_string(chainProgress[chain]) + " of its " + std::to_string(m_Config.jobChainLength) + " jobs with " + std::to_string(threads) + " threads!");
+
+		if (outOfOrderJobs.load() != 0U)
+			EN_ERROR("CPUBenchmark::RunJobSystemCases() - " + std::to_string(outOfOrderJobs.load()) + " jobs ran before the previous job of their chain with " + std::to_string(threads) + " threads!");
+	}
+
+	// The engine cases create the default one
+	m_JobSystem.reset();
+}
+void CPUBenchmark::RunSceneStateCases(const uint32_t objects)
+{
+	// Cubes without any buffers, the draws only need the counts
+	std::vector<en::Handle<en::Mesh>> meshes;
+
+	std::mt19937 materialRng(m_Config.seed);
+
+	for (uint32_t i = 0U; i < BENCHMARK_MATERIAL_COUNT; i++)
+	{
+		const std::string name = "Benchmark Cube " + std::to_string(i);
+
+		const glm::vec3 color(RandomRange(materialRng, 0.2f, 1.0f), RandomRange(materialRng, 0.2f, 1.0f), RandomRange(materialRng, 0.2f, 1.0f));
+
+		auto& mesh = meshes.emplace_back(en::MakeHandle<en::Mesh>(name, ""));
+
+		mesh->m_SubMeshes.emplace_back(
+			24U, 36U,
+			en::MakeHandle<en::Material>(name, color, RandomRange(materialRng, 0.0f, 1.0f), RandomRange(materialRng, 0.1f, 0.9f), 1.0f, nullptr, nullptr, nullptr, nullptr),
+			en::AABB{ glm::vec3(-0.5f), glm::vec3(0.5f) },
+			glm::vec4(0.0f, 0.0f, 0.0f, std::sqrt(0.75f))
+		);
+	}
+
+	HeadlessScene scene;
+
+	const float halfSize = std::max(std::sqrt(static_cast<float>(objects)), 1.0f) * HEADLESS_OBJECT_SPACING * 0.5f;
+
+	const glm::vec3 min(-halfSize, 0.2f, -halfSize);
+	const glm::vec3 max( halfSize, HEADLESS_SCENE_HEIGHT, halfSize);
+
+	// A separate generator for everything, so changing one count doesn't move the rest
+	std::mt19937 objectRng(m_Config.seed);
+	std::mt19937 pointLightRng(m_Config.seed + 1U);
+
+	std::vector<en::Handle<en::SceneObject>> sceneObjects(objects);
+
+	for (uint32_t i = 0U; i < objects; i++)
+	{
+		auto& object = sceneObjects[i] = scene.CreateSceneObject("Benchmark Object " + std::to_string(i), meshes[objectRng() % BENCHMARK_MATERIAL_COUNT]);
+
+		object->SetPosition(glm::vec3(RandomRange(objectRng, min.x, max.x), RandomRange(objectRng, min.y, max.y * 0.5f), RandomRange(objectRng, min.z, max.z)));
+		object->SetRotation(glm::vec3(RandomRange(objectRng, 0.0f, 360.0f), RandomRange(objectRng, 0.0f, 360.0f), 0.0f));
+		object->SetScale(glm::vec3(RandomRange(objectRng, 0.3f, 1.2f)));
+		object->SetStatic(m_Config.staticObjects);
+	}
+
+	for (uint32_t i = 0U; i < std::min(m_Config.cpuPointLights, static_cast<uint32_t>(MAX_POINT_LIGHTS - 1)); i++)
+	{
+		const glm::vec3 position(RandomRange(pointLightRng, min.x, max.x), RandomRange(pointLightRng, min.y, max.y), RandomRange(pointLightRng, min.z, max.z));
+		const glm::vec3 color(RandomRange(pointLightRng, 0.0f, 1.0f), RandomRange(pointLightRng, 0.0f, 1.0f), RandomRange(pointLightRng, 0.0f, 1.0f));
+
+		scene.CreatePointLight(position, color, RandomRange(pointLightRng, 2.0f, 17.0f), RandomRange(pointLightRng, 1.0f, 3.2f));
+	}
+
+	if (m_Config.directionalLight)
+	{
+		auto light = scene.CreateDirectionalLight(glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f)), glm::vec3(1.0f, 0.95f, 0.9f), 3.0f);
+		light->m_CastShadows = true;
+	}
+
+	auto& camera = *scene.m_MainCamera;
+
+	camera.m_DynamicallyScaled = false;
+	camera.m_Size	  = glm::vec2(1920.0f, 1080.0f);
+	camera.m_Position = glm::vec3(-halfSize, max.y, -halfSize);
+	camera.LookAt(glm::vec3(0.0f, min.y, 0.0f));
+
+	// Appends the draws of every object
+	scene.Update();
+
+	std::mt19937 rng(m_Config.seed);
+
+	for (const float fraction : m_Config.cpuMovedFractions)
+	{
+		const uint32_t moved = std::min(static_cast<uint32_t>(std::ceil(fraction * objects)), objects);
+
+		const auto move = [&]() {
+			for (uint32_t i = 0U; i < moved; i++)
+				sceneObjects[i]->SetPosition(sceneObjects[i]->GetPosition() + glm::vec3(RandomRange(rng, -1.0f, 1.0f), 0.0f, RandomRange(rng, -1.0f, 1.0f)) * CPU_MOVE_DISTANCE);
+		};
+
+		CPUResult& result = MeasureCPU("Scene state update", m_Config.cpuIterations, move, [&]() { scene.Update(); });
+
+		result.parameters = {
+			{ "objects",	  objects },
+			{ "pointLights",  static_cast<uint32_t>(scene.m_PointLights.size()) },
+			{ "movedObjects", moved	  },
+		};
+	}
+}
+void CPUBenchmark::RunMatrixRegisterCase(const uint32_t objects)
+{
+	if (objects == 0U) return;
+
+	HeadlessScene scene;
+
+	for (uint32_t i = 0U; i < objects; i++)
+		scene.RegisterMatrix();
+
+	// The freed slot is in the middle, registering the matrix again has to take it from the free list
+	const uint32_t index = objects / 2U;
+
+	CPUResult& result = MeasureCPU("Matrix register", m_Config.cpuIterations, nullptr, [&]() {
+		scene.DeregisterMatrix(index);
+
+		if (scene.RegisterMatrix() != index)
+			EN_ERROR("CPUBenchmark::RunMatrixRegisterCase() - The matrix didn't take the freed slot!");
+	});
+
+	result.parameters = { { "matrices", objects } };
+}
+void CPUBenchmark::RunMaterialRegisterCase(const uint32_t materials)
+{
+	if (materials == 0U) return;
+
+	HeadlessScene scene;
+
+	std::vector<en::Handle<en::Material>> registered(materials);
+
+	for (uint32_t i = 0U; i < materials; i++)
+	{
+		registered[i] = en::MakeHandle<en::Material>("Benchmark Material " + std::to_string(i), glm::vec3(1.0f), 0.0f, 0.75f, 1.0f, nullptr, nullptr, nullptr, nullptr);
+
+		scene.RegisterMaterial(registered[i]);
+	}
+
+	// Same as the matrices, the middle slot is freed and taken again
+	const uint32_t index = materials / 2U;
+
+	CPUResult& result = MeasureCPU("Material register", m_Config.cpuIterations, nullptr, [&]() {
+		scene.DeregisterMaterial(index);
+
+		if (scene.RegisterMaterial(registered[index]) != index)
+			EN_ERROR("CPUBenchmark::RunMaterialRegisterCase() - The material didn't take the freed slot!");
+	});
+
+	result.parameters = { { "materials", materials } };
+}
+void CPUBenchmark::RunCascadesCase()
+{
+	HeadlessScene scene;
+
+	for (uint32_t i = 0U; i < MAX_DIR_LIGHT_SHADOWS; i++)
+	{
+		auto light = scene.CreateDirectionalLight(glm::normalize(glm::vec3(0.3f + i * 0.2f, -1.0f, 0.2f - i * 0.3f)));
+		light->m_CastShadows = true;
+	}
+
+	auto& camera = *scene.m_MainCamera;
+
+	camera.m_DynamicallyScaled = false;
+	camera.m_Size	  = glm::vec2(1920.0f, 1080.0f);
+	camera.m_Position = glm::vec3(0.0f, 2.0f, 0.0f);
+
+	// Selects the shadow casters
+	scene.Update();
+
+	const auto& casters = scene.GetDirLightShadowCasters();
+
+	en::ShadowAtlas atlas(SHADOW_ATLAS_SLOTS);
+
+	for (uint32_t i = 0U; i < casters.size(); i++)
+		for (uint32_t cascade = 0U; cascade < SHADOW_CASCADES; cascade++)
+			atlas.Request(MAX_SPOT_LIGHT_SHADOWS + i * SHADOW_CASCADES + cascade, CASCADES_RESOLUTION, 2.0f);
+
+	atlas.Pack(8192U);
+
+	// The worst case, every cascade is refitted by every update
+	std::array<uint32_t, SHADOW_CASCADES> updateIntervals{};
+	updateIntervals.fill(1U);
+
+	en::CascadedShadowMaps cascades;
+
+	const auto turn = [&]() {
+		camera.m_Yaw += CASCADES_CAMERA_TURN;
+	};
+
+	CPUResult& result = MeasureCPU("Cascades update", m_Config.cpuIterations, turn, [&]() {
+		cascades.Update(camera, scene.m_DirectionalLights, casters, atlas, CASCADES_FAR_PLANE, CASCADES_SPLIT_WEIGHT, updateIntervals, CASCADES_RESOLUTION);
+	});
+
+	result.parameters = {
+		{ "lights",	  static_cast<uint32_t>(casters.size()) },
+		{ "cascades", SHADOW_CASCADES },
+	};
+	result.operations = static_cast<uint32_t>(casters.size()) * SHADOW_CASCADES;
+}
+void CPUBenchmark::RunGLTFDecodeCase()
+{
+	std::string jsonContent;
+	std::vector<char> binaryData;
+	uint64_t indexSum = 0U;
+
+	GenerateGLTF(jsonContent, binaryData, indexSum);
+
+	const en::Handle<en::Material> defaultMaterial = en::MakeHandle<en::Material>("Benchmark Default Material", glm::vec3(1.0f), 0.0f, 0.75f, 1.0f, nullptr, nullptr, nullptr, nullptr);
+
+	// Every texture is requested, the mock only skips loading them
+	const en::MeshImportProperties properties{};
+
+	en::MeshData meshData;
+	uint64_t decodedIndexSum = 0U;
+
+	// A new importer for every decode, the same as the AssetManager does
+	CPUResult& result = MeasureCPU("glTF decode", m_Config.importIterations, nullptr, [&]() {
+		HeadlessImporter importer(properties, defaultMaterial);
+
+		meshData = importer.LoadMeshFromMemory(jsonContent, binaryData, "Benchmark Decode");
+		decodedIndexSum = importer.m_IndexSum;
+	});
+
+	result.parameters = {
+		{ "meshes",	  GLTF_MESHES },
+		{ "vertices", GLTF_GRID_SIZE * GLTF_GRID_SIZE },
+		{ "bytes",	  static_cast<uint32_t>(binaryData.size()) },
+	};
+	result.operations = GLTF_MESHES;
+
+	const auto& subMeshes = meshData.mesh->m_SubMeshes;
+
+	if (subMeshes.size() != GLTF_MESHES || meshData.materials.size() != GLTF_MATERIALS || meshData.textures.size() != GLTF_TEXTURES)
+		EN_ERROR("CPUBenchmark::RunGLTFDecodeCase() - Decoded " + std::to_string(subMeshes.size()) + " meshes, " + std::to_string(meshData.materials.size()) + " materials and " + std::to_string(meshData.textures.size()) + " textures instead of " + std::to_string(GLTF_MESHES) + ", " + std::to_string(GLTF_MATERIALS) + " and " + std::to_string(GLTF_TEXTURES) + "!");
+
+	if (decodedIndexSum != indexSum)
+		EN_ERROR("CPUBenchmark::RunGLTFDecodeCase() - The decoded indices don't match the generated ones!");
+
+	for (uint32_t i = 0U; i < GLTF_MESHES; i++)
+	{
+		const en::SubMesh& subMesh = subMeshes[i];
+		const en::AABB& box = subMesh.GetBoundingBox();
+
+		const bool hasMaterial = i % (GLTF_MATERIALS + 1U) != GLTF_MATERIALS;
+
+		if (subMesh.m_VertexCount != GLTF_GRID_SIZE * GLTF_GRID_SIZE || subMesh.m_IndexCount != (GLTF_GRID_SIZE - 1U) * (GLTF_GRID_SIZE - 1U) * 6U
+			|| box.min != glm::vec3(0.0f, i, 0.0f) || box.max != glm::vec3(GLTF_GRID_SIZE - 1U, i, GLTF_GRID_SIZE - 1U)
+			|| subMesh.GetMaterial() != (hasMaterial ? meshData.materials[i % (GLTF_MATERIALS + 1U)] : defaultMaterial))
+			EN_ERROR("CPUBenchmark::RunGLTFDecodeCase() - Mesh " + std::to_string(i) + " doesn't match the generated one!");
+	}
+}
+void CPUBenchmark::RunDescriptorInfoCase()
+{
+	std::mt19937 rng(m_Config.seed);
+
+	constexpr std::array<VkShaderStageFlags, 3> stages{ VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_COMPUTE_BIT };
+
+	// Layouts like the ones of the passes, a few buffers and images with varying types, stages and counts
+	std::vector<en::DescriptorInfo> infos(m_Config.descriptorInfoCount);
+
+	for (auto& info : infos)
+	{
+		const uint32_t bufferCount = rng() % 5U;
+		const uint32_t imageCount  = rng() % 9U;
+
+		for (uint32_t i = 0U; i < bufferCount; i++)
+			info.bufferInfos.emplace_back(en::DescriptorInfo::BufferInfo{
+				.index = i,
+				.type  = rng() % 2U ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.stage = stages[rng() % stages.size()],
+			});
+
+		for (uint32_t i = 0U; i < imageCount; i++)
+			info.imageInfos.emplace_back(en::DescriptorInfo::ImageInfo{
+				.index		 = bufferCount + i,
+				.count		 = rng() % 4U == 0U ? 1U + static_cast<uint32_t>(rng() % 8U) : 1U,
+				.contents	 = std::vector<en::DescriptorInfo::ImageInfoContent>(1U),
+				.type		 = rng() % 2U ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				.stage		 = stages[rng() % stages.size()],
+				.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			});
+	}
+
+	HeadlessLayoutCache cache;
+
+	for (const auto& info : infos)
+		cache.MakeLayout(info);
+
+	// Infos that compare equal share a layout, so the cache can end up smaller than the amount generated
+	const uint32_t uniqueInfos = cache.GetLayoutCount();
+
+	CPUResult& result = MeasureCPU("DescriptorInfo lookup", m_Config.cpuIterations, nullptr, [&]() {
+		for (uint32_t i = 0U; i < DESCRIPTOR_INFO_LOOKUPS; i++)
+			cache.MakeLayout(infos[i % infos.size()]);
+	});
+
+	result.parameters = {
+		{ "descriptorInfos", static_cast<uint32_t>(infos.size()) },
+		{ "uniqueInfos",	 uniqueInfos },
+	};
+	result.operations = DESCRIPTOR_INFO_LOOKUPS;
+
+	if (cache.m_CreatedLayouts != uniqueInfos)
+		EN_ERROR("CPUBenchmark::RunDescriptorInfoCase() - " + std::to_string(cache.m_CreatedLayouts - uniqueInfos) + " lookups missed the layout cache!");
+}
+
+CPUBenchmark::CPUResult& CPUBenchmark::MeasureCPU(const std::string& name, const uint32_t iterations, const std::function<void()>& setup, const std::function<void()>& body)
+{
+	CPUResult& result = m_CPUResults.emplace_back(CPUResult{ .name = name });
+	result.times.reserve(iterations);
+
+	for (uint32_t i = 0U; i < m_Config.cpuWarmupIterations + iterations; i++)
+	{
+		if (setup) setup();
+
+		// Ends the profiler frame before and after the body, so only its zones end up in the last frame
+		EN_PROFILE_FRAME();
+
+		const auto start = std::chrono::steady_clock::now();
+
+		body();
+
+		const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		EN_PROFILE_FRAME();
+
+		if (i < m_Config.cpuWarmupIterations) continue;
+
+		result.times.emplace_back(time);
+
+		for (const auto& zone : m_Profiler->GetLastFrame().zones)
+			result.zones[zone.name] += (zone.end - zone.start) / 1000000.0f / iterations;
+	}
+
+	std::vector<float> sorted = result.times;
+	std::sort(sorted.begin(), sorted.end());
+
+	EN_LOG("Benchmark case \"" + name + "\" - median: " + std::to_string(Percentile(sorted, 0.50f)) + "ms, min: " + std::to_string(sorted.front()) + "ms");
+
+	return result;
+}
+void CPUBenchmark::WriteCPUResults() const
+{
+	nlohmann::json json;
+
+	json["device"]			   = m_DeviceName;
+	json["seed"]			   = m_Config.seed;
+	json["warmupIterations"]   = m_Config.cpuWarmupIterations;
+	json["cpuProfilingZones"]  = static_cast<bool>(CPU_PROFILING);
+	json["cases"]			   = nlohmann::json::array();
+
+	for (const auto& result : m_CPUResults)
+	{
+		std::vector<float> sorted = result.times;
+		std::sort(sorted.begin(), sorted.end());
+
+		float sum = 0.0f;
+
+		for (const float time : sorted)
+			sum += time;
+
+		const float mean = sum / sorted.size();
+
+		json["cases"].push_back({
+			{ "name",		  result.name		},
+			{ "parameters",	  result.parameters },
+			{ "iterations",	  sorted.size()		},
+			{ "operations",	  result.operations },
+			{ "meanMs",		  mean				},
+			{ "medianMs",	  Percentile(sorted, 0.50f) },
+			{ "p95Ms",		  Percentile(sorted, 0.95f) },
+			{ "minMs",		  sorted.front()	},
+			{ "maxMs",		  sorted.back()		},
+			{ "meanNsPerOp",  mean * 1000000.0f / result.operations },
+			{ "zonesMs",	  result.zones		},
+		});
+	}
+
+	const std::string path = m_Config.output + "CPU.json";
+
+	std::ofstream file(path);
+
+	if (!file.is_open())
+	{
+		EN_WARN("CPUBenchmark::WriteCPUResults() - Failed to open \"" + path + "\" for writing!");
+		return;
+	}
+
+	file << json.dump(4);
+
+	EN_LOG("Saved the CPU benchmark results to \"" + path + "\"");
+}
+
+float CPUBenchmark::Percentile(const std::vector<float>& sorted, const float percentile)
+{
+	if (sorted.empty()) return 0.0f;
+
+	const size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+
+	return sorted[std::clamp<size_t>(rank, 1U, sorted.size()) - 1U];
+}
+float CPUBenchmark::RandomRange(std::mt19937& rng, const float min, const float max)
+{
+	return std::uniform_real_distribution<float>(min, max)(rng);
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#ifndef EN_CPUBENCHMARK_HPP
+#define EN_CPUBENCHMARK_HPP
+
+#include <Renderer/Camera/Camera.hpp>
+
+#include <Core/Types.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/Profiler.hpp>
+
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times the CPU side hot paths on their own, without rendering a frame, and writes them to <output>CPU.json. It starts with the
+// job system, which is swept from a single thread up to every hardware thread, followed by the cases that only need the CPU side
+// of a scene. None of them touch Vulkan, so it builds and runs without a GPU (see CMakeLists.txt), Benchmark adds the ones that do.
+class CPUBenchmark
+{
+public:
+	struct CameraKey
+	{
+		glm::vec3 position{};
+
+		float yaw   = 0.0f;
+		float pitch = 0.0f;
+	};
+
+	struct Resolution
+	{
+		uint32_t width  = 0U;
+		uint32_t height = 0U;
+	};
+
+	// Shared with Benchmark, so both read the same file
+	struct Config
+	{
+		// "procedural" starts from an empty scene and "sponza" loads Models/Sponza, the generated objects and lights are added to either
+		std::string scene = "procedural";
+
+		uint32_t warmupFrames = 60U;
+		uint32_t frames		  = 600U;
+
+		// The same seed places the first N objects and lights at the same spots in every run
+		uint32_t seed = 1337U;
+
+		bool staticObjects	  = true;
+		bool directionalLight = true;
+
+		std::vector<uint32_t>	objectCounts	 { 256U };
+		std::vector<uint32_t>	pointLightCounts { 0U, 256U, 1000U };
+		std::vector<uint32_t>	spotLightCounts	 { 0U };
+		std::vector<Resolution> resolutions		 { Resolution{ 1920U, 1080U } };
+
+		// Looped through once per run along a Catmull-Rom spline, an orbit around the scene is used when it's empty
+		std::vector<CameraKey> cameraPath;
+
+		std::string output = "BenchmarkResults";
+
+		// Only used by RunCPU(), the warmup iterations of every case aren't recorded
+		uint32_t cpuWarmupIterations = 3U;
+		uint32_t cpuIterations		 = 100U;
+
+		std::vector<uint32_t> cpuObjectCounts { 10000U, 100000U, 1000000U };
+		uint32_t			  cpuPointLights  = MAX_POINT_LIGHTS - 1U;
+
+		// Share of the objects moved before every scene update, 0 measures the cost of a scene that doesn't change
+		std::vector<float> cpuMovedFractions { 0.0f, 0.01f, 1.0f };
+
+		// Materials registered before the registration is timed, every one of them gets a name of its own
+		std::vector<uint32_t> cpuMaterialCounts { 1000U, 10000U };
+
+		std::vector<std::string> importFiles	  { "Models/Skull/Skull.gltf" };
+		uint32_t				 importIterations = 10U;
+
+		uint32_t descriptorInfoCount = 256U;
+
+		// Every ParallelFor iteration visits all indices once, every dependency chain runs its jobs one after the other
+		uint32_t jobIndices		= 1U << 20U;
+		uint32_t jobChains		= 64U;
+		uint32_t jobChainLength = 256U;
+	};
+
+	// An empty path runs with the default config
+	CPUBenchmark(const std::string& configPath = "");
+	virtual ~CPUBenchmark() = default;
+
+	// Times ParallelFor and dependency chains of the job system for every thread count, the CPU side of the scene update for
+	// every object count and moved fraction, the cascades, the matrix and material registration, decoding a generated glTF and the
+	// descriptor layout lookups, followed by RunEngineCases().
+	// Every case keeps the mean CPU profiler zones of its iterations too, which are only recorded with CPU_PROFILING enabled.
+	void RunCPU();
+
+protected:
+	struct CPUResult
+	{
+		std::string name;
+		std::map<std::string, uint32_t> parameters;
+
+		// Timed operations per iteration, e.g. lookups
+		uint32_t operations = 1U;
+
+		// In milliseconds per iteration
+		std::vector<float> times;
+
+		// Mean time of every zone per iteration in milliseconds
+		std::map<std::string, float> zones;
+	};
+
+	static constexpr uint32_t BENCHMARK_MATERIAL_COUNT = 8U;
+
+	// How far every moved object is pushed per scene update
+	static constexpr float CPU_MOVE_DISTANCE = 0.05f;
+
+	// The cases that need the engine itself, they run after the rest and can fill in m_DeviceName
+	virtual void RunEngineCases() {}
+
+	// The setup runs before every iteration without being timed
+	CPUResult& MeasureCPU(const std::string& name, const uint32_t iterations, const std::function<void()>& setup, const std::function<void()>& body);
+
+	// Nearest rank percentile of already sorted values
+	static float Percentile(const std::vector<float>& sorted, const float percentile);
+
+	static float RandomRange(std::mt19937& rng, const float min, const float max);
+
+	Config m_Config;
+
+	en::Scope<en::Profiler>	 m_Profiler;
+	en::Scope<en::JobSystem> m_JobSystem;
+
+	std::vector<CPUResult> m_CPUResults;
+
+	std::string m_DeviceName = "None";
+
+private:
+	// Replaces the job system for every thread count, so it has to run before anything else uses it
+	void RunJobSystemCases();
+
+	void RunSceneStateCases(const uint32_t objects);
+	void RunMatrixRegisterCase(const uint32_t objects);
+	void RunMaterialRegisterCase(const uint32_t materials);
+	void RunCascadesCase();
+	void RunGLTFDecodeCase();
+	void RunDescriptorInfoCase();
+
+	void WriteCPUResults() const;
+};
+
+#endif
\ No newline at end of file
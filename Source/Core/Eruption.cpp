@@ -1,27 +1,40 @@
 #include "Eruption.hpp"
 
-void Eruption::Init()
+void Eruption::Init(const bool headless)
 {
 	EN_LOG("Eruption::Init() - Started");
 
-	m_Window = en::MakeScope<en::Window>(
-		"Eruption Engine v0.8.0",
-		glm::ivec2(1920, 1080),
-		false, 
-		true
-	);
+	m_Profiler = en::MakeScope<en::Profiler>();
+	EN_PROFILE_THREAD("Main Thread");
 
-	m_Context = en::MakeScope<en::Context>();
+	m_JobSystem = en::MakeScope<en::JobSystem>();
+
+	// The window, the input and the editor are all left out in headless mode
+	if (!headless)
+		m_Window = en::MakeScope<en::Window>(
+			"Eruption Engine v0.8.0",
+			glm::ivec2(1920, 1080),
+			false, 
+			true
+		);
+
+	m_Context = en::MakeScope<en::Context>(headless);
 
 	m_Renderer = en::MakeScope<en::Renderer>();
 
-	m_Input = en::MakeScope<en::InputManager>();
-	m_Input->m_MouseSensitivity = 0.1f;
+	if (!headless)
+	{
+		m_Input = en::MakeScope<en::InputManager>();
+		m_Input->m_MouseSensitivity = 0.1f;
+	}
 
 	m_AssetManager = en::MakeScope<en::AssetManager>();
 
-	m_Editor = en::MakeScope<en::EditorLayer>();
-	m_Editor->AttachTo(m_Renderer.get(), m_AssetManager.get());
+	if (!headless)
+	{
+		m_Editor = en::MakeScope<en::EditorLayer>();
+		m_Editor->AttachTo(m_Renderer.get(), m_AssetManager.get());
+	}
 
 	m_Camera = en::MakeHandle<en::Camera>(60.0f, 0.1f, 200.0f, glm::vec3(6.570f, 2.214f, 0.809f));
 	m_Camera->m_Yaw = -165.6f;
@@ -35,8 +48,22 @@ void Eruption::Init()
 }
 void Eruption::Update()
 {
-	m_Window->PollEvents();
-	
+	EN_PROFILE_FUNCTION();
+
+	if (m_Window)
+	{
+		{
+			EN_PROFILE_SCOPE("Poll Events");
+			m_Window->PollEvents();
+		}
+
+		HandleInput();
+	}
+
+	m_Renderer->Update();
+}
+void Eruption::HandleInput()
+{
 	m_Input->UpdateMouse();
 
 	// Locking / Freeing the mouse
@@ -88,11 +115,11 @@ void Eruption::Update()
 	m_Camera->m_Pitch = glm::mix(m_Camera->m_Pitch, targetPitch, std::fmin(30.0 * deltaTime, 1.0));
 
 	m_Input->UpdateInput();
-	
-	m_Renderer->Update();
 }
 void Eruption::Render()
 {
+	EN_PROFILE_FUNCTION();
+
 	m_Renderer->PreRender();
 	m_Renderer->Render();
 }
@@ -154,12 +181,17 @@ void Eruption::CreateExampleScene()
 	m_Renderer->BindScene(m_ExampleScene);
 }
 
-void Eruption::Run()
+void Eruption::Run(const bool headless, const uint32_t frameCount)
 {
-	Init();
+	Init(headless);
 
-	while (m_Window->IsOpen())
+	if (headless)
+		EN_LOG("Eruption::Run() - Rendering " + (frameCount > 0U ? std::to_string(frameCount) : std::string("unlimited")) + " headless frames");
+
+	for (uint32_t frame = 0U; headless ? (frameCount == 0U || frame < frameCount) : m_Window->IsOpen(); frame++)
 	{
+		EN_PROFILE_FRAME();
+
 		Update();
 		Render();
 	}
@@ -171,4 +203,6 @@ void Eruption::Run()
 	m_Input.reset();
 	m_Window.reset();
 	m_Context.reset();
+	m_JobSystem.reset();
+	m_Profiler.reset();
 }
\ No newline at end of file
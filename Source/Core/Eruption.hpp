@@ -6,6 +6,8 @@
 #include <Renderer/Window.hpp>
 #include <Renderer/Context.hpp>
 #include <Core/Types.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/Profiler.hpp>
 #include <Renderer/Renderer.hpp>
 #include <Assets/AssetManager.hpp>
 #include <Input/InputManager.hpp>
@@ -14,15 +16,19 @@
 class Eruption
 {
 public:
-	void Run();
+	// Headless runs render into an offscreen target without a window, frameCount limits them (0 keeps going until the process is stopped)
+	void Run(const bool headless = false, const uint32_t frameCount = 0U);
 
 private:
-	void Init();
+	void Init(const bool headless);
 	void Update();
+	void HandleInput();
 	void Render();
 
 	void CreateExampleScene();
 
+	en::Scope<en::Profiler>    m_Profiler;
+	en::Scope<en::JobSystem>   m_JobSystem;
 	en::Scope<en::EditorLayer>  m_Editor;
 	en::Scope<en::Window>		m_Window;
 	en::Scope<en::Context>		m_Context;
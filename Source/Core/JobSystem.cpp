@@ -0,0 +1,243 @@
+#include "JobSystem.hpp"
+
+#include <Core/Log.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace en
+{
+	JobSystem* g_JobSystemInstance = nullptr;
+
+	// Index of the queue owned by the current thread, every thread outside of the pool shares queue 0
+	thread_local uint32_t g_QueueIndex = 0U;
+
+	bool JobCounter::IsDone() const
+	{
+		return m_Value.load() == 0U;
+	}
+
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		if (g_JobSystemInstance)
+			EN_ERROR("Failed to create the job system because there already is one created!");
+
+		if (workerCount == DEFAULT_WORKER_COUNT)
+			workerCount = std::max(std::thread::hardware_concurrency(), 2U) - 1U;
+
+		for (uint32_t i = 0U; i < workerCount + 1U; i++)
+			m_Queues.emplace_back(MakeScope<JobQueue>());
+
+		g_JobSystemInstance = this;
+
+		for (uint32_t i = 1U; i < workerCount + 1U; i++)
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+
+		EN_SUCCESS("Created the job system with " + std::to_string(workerCount) + " workers");
+	}
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Running = false;
+		}
+		m_SleepCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+
+		g_JobSystemInstance = nullptr;
+	}
+	JobSystem& JobSystem::Get()
+	{
+		return *g_JobSystemInstance;
+	}
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		return g_QueueIndex;
+	}
+
+	void JobSystem::Execute(Job job, JobCounter* counter, JobCounter* dependency)
+	{
+		if (counter)
+			counter->m_Value++;
+
+		if (dependency)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_ContinuationsMutex);
+
+			// The job gets pushed by the thread that finishes the last job of the dependency
+			if (!dependency->IsDone())
+			{
+				dependency->m_Continuations.emplace_back(std::move(job), counter);
+				return;
+			}
+		}
+
+		Push(JobEntry{ std::move(job), counter });
+	}
+	void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& function, uint32_t chunkSize)
+	{
+		if (count == 0U)
+			return;
+
+		// A few chunks per thread leave room for stealing when the iterations are uneven
+		if (chunkSize == 0U)
+			chunkSize = std::max(count / (static_cast<uint32_t>(m_Queues.size()) * 4U), 1U);
+
+		JobCounter counter;
+
+		for (uint32_t begin = chunkSize; begin < count; begin += chunkSize)
+		{
+			const uint32_t end = std::min(begin + chunkSize, count);
+
+			Execute([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+
+		// The calling thread takes the first chunk itself. The other chunks reference the function, so they have to be waited for
+		// even when it throws.
+		std::exception_ptr exception;
+
+		try
+		{
+			function(0U, std::min(chunkSize, count));
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		Wait(counter);
+
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+			if (!TryRunJob(g_QueueIndex))
+				std::this_thread::yield();
+
+		// Makes sure the thread that finished the last job is done touching the counter before it goes out of scope
+		std::lock_guard<std::mutex> lock(counter.m_ContinuationsMutex);
+
+		// Cleared, so the counter can be reused
+		if (counter.m_Exception)
+			std::rethrow_exception(std::exchange(counter.m_Exception, nullptr));
+	}
+
+	void JobSystem::Push(JobEntry entry)
+	{
+		JobQueue& queue = *m_Queues[g_QueueIndex];
+
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.emplace_back(std::move(entry));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_PendingJobs++;
+		}
+		m_SleepCondition.notify_one();
+	}
+	bool JobSystem::TryRunJob(uint32_t queueIndex)
+	{
+		if (m_PendingJobs.load() == 0U)
+			return false;
+
+		JobEntry entry{};
+		bool found = false;
+
+		const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+
+		// The own queue is processed newest first to stay cache friendly, the other ones are stolen from oldest first
+		for (uint32_t i = 0U; i < queueCount && !found; i++)
+		{
+			JobQueue& queue = *m_Queues[(queueIndex + i) % queueCount];
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+
+			if (queue.jobs.empty())
+				continue;
+
+			if (i == 0U)
+			{
+				entry = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			}
+			else
+			{
+				entry = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+
+			found = true;
+		}
+
+		if (!found)
+			return false;
+
+		m_PendingJobs--;
+
+		// Escaping the worker would terminate the program, and escaping Wait() would leave the counter above zero for good
+		std::exception_ptr exception;
+
+		try
+		{
+			entry.job();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		FinishJob(entry.counter, std::move(exception));
+
+		return true;
+	}
+	void JobSystem::FinishJob(JobCounter* counter, std::exception_ptr exception)
+	{
+		if (!counter)
+		{
+			// Nothing waits for the job, so there's no one to rethrow it to
+			if (exception)
+				EN_WARN("JobSystem::FinishJob() - A job without a counter threw an exception, it is ignored!");
+
+			return;
+		}
+
+		std::vector<std::pair<Job, JobCounter*>> continuations;
+
+		{
+			std::lock_guard<std::mutex> lock(counter->m_ContinuationsMutex);
+
+			if (exception && !counter->m_Exception)
+				counter->m_Exception = std::move(exception);
+
+			if (counter->m_Value.fetch_sub(1U) == 1U)
+				continuations.swap(counter->m_Continuations);
+		}
+
+		for (auto& [job, jobCounter] : continuations)
+			Push(JobEntry{ std::move(job), jobCounter });
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		g_QueueIndex = queueIndex;
+
+		EN_PROFILE_THREAD("Worker " + std::to_string(queueIndex));
+
+		while (m_Running)
+		{
+			if (TryRunJob(queueIndex))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_SleepCondition.wait(lock, [this]() { return m_PendingJobs.load() > 0U || !m_Running; });
+		}
+	}
+}
\ No newline at end of file
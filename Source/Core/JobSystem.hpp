@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef EN_JOBSYSTEM_HPP
+#define EN_JOBSYSTEM_HPP
+
+#include <Core/Types.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace en
+{
+	using Job = std::function<void()>;
+
+	// Counts the jobs that still have to finish. Jobs can be made dependent on a counter, they are only scheduled once it drops to zero.
+	// A job that throws still counts as finished, the first exception of the counter's jobs is rethrown by JobSystem::Wait().
+	class JobCounter
+	{
+	public:
+		bool IsDone() const;
+
+	private:
+		std::atomic<uint32_t> m_Value = 0U;
+
+		std::mutex m_ContinuationsMutex;
+		std::vector<std::pair<Job, JobCounter*>> m_Continuations;
+
+		std::exception_ptr m_Exception;
+
+		friend class JobSystem;
+	};
+
+	class JobSystem
+	{
+	public:
+		static constexpr uint32_t DEFAULT_WORKER_COUNT = UINT32_MAX;
+
+		// By default one worker per hardware thread is spawned, minus the calling thread which helps out in Wait(). Without any
+		// workers every job runs on the threads that wait for it.
+		JobSystem(uint32_t workerCount = DEFAULT_WORKER_COUNT);
+		~JobSystem();
+
+		static JobSystem& Get();
+
+		void Execute(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		// Splits [0, count) into chunks and blocks until all of them are processed. The chunk size is picked automatically when 0.
+		// Rethrows the first exception of the chunks once all of them are done.
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& function, uint32_t chunkSize = 0U);
+
+		// Runs pending jobs on the calling thread until the counter drops to zero, then rethrows the first exception of its jobs
+		void Wait(JobCounter& counter);
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+		// Index of the calling thread in [0, GetWorkerCount()], every thread outside of the pool gets 0. Useful for per thread resources.
+		static uint32_t GetThreadIndex();
+
+	private:
+		struct JobEntry
+		{
+			Job		    job;
+			JobCounter* counter = nullptr;
+		};
+		struct JobQueue
+		{
+			std::mutex			 mutex;
+			std::deque<JobEntry> jobs;
+		};
+
+		void Push(JobEntry entry);
+		bool TryRunJob(uint32_t queueIndex);
+		void FinishJob(JobCounter* counter, std::exception_ptr exception);
+
+		void WorkerLoop(uint32_t queueIndex);
+
+		// Queue 0 belongs to the threads outside of the pool, the rest to the workers
+		std::vector<Scope<JobQueue>> m_Queues;
+		std::vector<std::thread>	 m_Workers;
+
+		std::atomic<uint32_t> m_PendingJobs = 0U;
+		std::atomic<bool>	  m_Running = true;
+
+		std::mutex				m_SleepMutex;
+		std::condition_variable m_SleepCondition;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "Profiler.hpp"
+
+#include <Core/Log.hpp>
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace en
+{
+	Profiler* g_ProfilerInstance = nullptr;
+
+	std::chrono::steady_clock::time_point g_ProfilerEpoch;
+
+	// The buffer is cached per thread, together with the profiler it belongs to in case a new one gets created
+	thread_local Profiler* g_ThreadProfiler = nullptr;
+	thread_local void*	   g_ThreadBuffer	= nullptr;
+	thread_local uint32_t  g_ThreadDepth	= 0U;
+
+	Profiler::Profiler()
+	{
+		if (g_ProfilerInstance)
+			EN_ERROR("Failed to create the profiler because there already is one created!");
+
+		g_ProfilerEpoch	   = std::chrono::steady_clock::now();
+		g_ProfilerInstance = this;
+
+		m_CurrentFrame.start = Now();
+	}
+	Profiler::~Profiler()
+	{
+		g_ProfilerInstance = nullptr;
+	}
+	Profiler* Profiler::Get()
+	{
+		return g_ProfilerInstance;
+	}
+	uint64_t Profiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_ProfilerEpoch).count();
+	}
+
+	void Profiler::Submit(const char* name, const uint64_t start, const uint64_t end, const uint32_t depth)
+	{
+		if (!g_ProfilerInstance) return;
+
+		ThreadBuffer& buffer = g_ProfilerInstance->GetThreadBuffer();
+
+		// Single writer, the release store publishes the zone to the main thread
+		const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+
+		buffer.zones[index % ZONE_BUFFER_SIZE] = Zone{ name, start, end, depth };
+
+		buffer.written.store(index + 1U, std::memory_order_release);
+	}
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		if (!g_ProfilerInstance) return;
+
+		ThreadBuffer& buffer = g_ProfilerInstance->GetThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(g_ProfilerInstance->m_ThreadsMutex);
+		buffer.name = name;
+	}
+
+	void Profiler::NextFrame()
+	{
+		const uint64_t now = Now();
+
+		m_CurrentFrame.end = now;
+
+		GatherZones(m_CurrentFrame.zones);
+
+		if (m_CaptureFramesLeft > 0U)
+		{
+			m_CapturedFrames.emplace_back(m_CurrentFrame);
+
+			if (--m_CaptureFramesLeft == 0U)
+				WriteCapture();
+		}
+
+		std::swap(m_LastFrame, m_CurrentFrame);
+
+		m_CurrentFrame.start = now;
+		m_CurrentFrame.zones.clear();
+	}
+	void Profiler::CaptureFrames(const uint32_t frameCount, const std::string& path)
+	{
+		m_CapturedFrames.clear();
+		m_CapturedFrames.reserve(frameCount);
+
+		m_CaptureFramesLeft = frameCount;
+		m_CapturePath		= path;
+
+		EN_LOG("Capturing " + std::to_string(frameCount) + " frames of CPU zones");
+	}
+	std::vector<std::string> Profiler::GetThreadNames()
+	{
+		std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+
+		std::vector<std::string> names;
+		names.reserve(m_Threads.size());
+
+		for (const auto& thread : m_Threads)
+			names.emplace_back(thread->name);
+
+		return names;
+	}
+
+	Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		if (g_ThreadProfiler != this)
+		{
+			std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+
+			auto& buffer = m_Threads.emplace_back(MakeScope<ThreadBuffer>());
+			buffer->name = "Thread " + std::to_string(m_Threads.size() - 1U);
+
+			g_ThreadProfiler = this;
+			g_ThreadBuffer	 = buffer.get();
+		}
+
+		return *static_cast<ThreadBuffer*>(g_ThreadBuffer);
+	}
+	void Profiler::GatherZones(std::vector<Zone>& zones)
+	{
+		std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+
+		for (uint32_t thread = 0U; thread < m_Threads.size(); thread++)
+		{
+			ThreadBuffer& buffer = *m_Threads[thread];
+
+			const uint64_t written = buffer.written.load(std::memory_order_acquire);
+			const uint64_t first   = std::max(buffer.read, written > ZONE_BUFFER_SIZE ? written - ZONE_BUFFER_SIZE : 0U);
+
+			const size_t firstZone = zones.size();
+
+			for (uint64_t i = first; i < written; i++)
+			{
+				Zone& zone = zones.emplace_back(buffer.zones[i % ZONE_BUFFER_SIZE]);
+				zone.thread = thread;
+			}
+
+			// The thread kept writing while the zones were copied, the oldest ones could have been overwritten in the meantime
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			const uint64_t writtenAfter = buffer.written.load(std::memory_order_relaxed);
+			const uint64_t firstValid	= std::max(first, writtenAfter > ZONE_BUFFER_SIZE ? writtenAfter - ZONE_BUFFER_SIZE : 0U);
+
+			if (firstValid > first)
+				zones.erase(zones.begin() + firstZone, zones.begin() + firstZone + std::min(firstValid, written) - first);
+
+			m_DroppedZones += firstValid - buffer.read;
+
+			buffer.read = written;
+		}
+	}
+	void Profiler::WriteCapture()
+	{
+		auto threadNames = GetThreadNames();
+
+		// The frames get a row of their own after the threads, so the zones can be lined up with them
+		const uint32_t framesRow = static_cast<uint32_t>(threadNames.size());
+		threadNames.emplace_back("Frames");
+
+		nlohmann::json events = nlohmann::json::array();
+
+		for (uint32_t thread = 0U; thread < threadNames.size(); thread++)
+			events.push_back({
+				{ "name", "thread_name" },
+				{ "ph",	  "M"			},
+				{ "pid",  0				},
+				{ "tid",  thread		},
+				{ "args", { { "name", threadNames[thread] } } },
+			});
+
+		for (uint32_t frame = 0U; frame < m_CapturedFrames.size(); frame++)
+		{
+			const auto& capturedFrame = m_CapturedFrames[frame];
+
+			events.push_back({
+				{ "name", "Frame " + std::to_string(frame) },
+				{ "ph",	  "X"		},
+				{ "pid",  0			},
+				{ "tid",  framesRow },
+				{ "ts",	  capturedFrame.start / 1000.0 },
+				{ "dur",  (capturedFrame.end - capturedFrame.start) / 1000.0 },
+			});
+
+			for (const auto& zone : capturedFrame.zones)
+				events.push_back({
+					{ "name", zone.name   },
+					{ "ph",	  "X"		  },
+					{ "pid",  0			  },
+					{ "tid",  zone.thread },
+					{ "ts",	  zone.start / 1000.0 },
+					{ "dur",  (zone.end - zone.start) / 1000.0 },
+				});
+		}
+
+		nlohmann::json trace{
+			{ "traceEvents",	 events },
+			{ "displayTimeUnit", "ms"	},
+		};
+
+		m_CapturedFrames.clear();
+
+		std::ofstream file(m_CapturePath);
+
+		if (!file.is_open())
+		{
+			EN_WARN("Profiler::WriteCapture() - Failed to open \"" + m_CapturePath + "\" for writing!");
+			return;
+		}
+
+		file << trace.dump();
+
+		EN_LOG("Saved the CPU trace to \"" + m_CapturePath + "\"");
+	}
+
+	ProfileZone::ProfileZone(const char* name) : m_Name(name), m_Start(Profiler::Now()), m_Depth(g_ThreadDepth++)
+	{
+
+	}
+	ProfileZone::~ProfileZone()
+	{
+		g_ThreadDepth--;
+
+		Profiler::Submit(m_Name, m_Start, Profiler::Now(), m_Depth);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#ifndef EN_PROFILER_HPP
+#define EN_PROFILER_HPP
+
+#include "../../EruptionEngine.ini"
+
+#include <Core/Types.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace en
+{
+	// Collects scoped CPU zones from every thread. Each thread writes into its own ring buffer without locking, the main thread
+	// gathers them once per frame in NextFrame(). The last frame is kept for the editor and a range of frames can be captured
+	// to a Chrome trace (chrome://tracing, ui.perfetto.dev).
+	class Profiler
+	{
+	public:
+		static constexpr uint32_t ZONE_BUFFER_SIZE = 16384U;
+
+		struct Zone
+		{
+			const char* name = nullptr;
+
+			// Nanoseconds since the profiler was created
+			uint64_t start = 0U;
+			uint64_t end   = 0U;
+
+			uint32_t depth  = 0U;
+			uint32_t thread = 0U;
+		};
+
+		struct Frame
+		{
+			uint64_t start = 0U;
+			uint64_t end   = 0U;
+
+			std::vector<Zone> zones;
+		};
+
+		Profiler();
+		~Profiler();
+
+		static Profiler* Get();
+
+		static uint64_t Now();
+
+		// Called by ProfileZone when a zone ends
+		static void Submit(const char* name, const uint64_t start, const uint64_t end, const uint32_t depth);
+
+		static void SetThreadName(const std::string& name);
+
+		// Ends the current frame and gathers the zones that finished during it, has to be called from the main thread
+		void NextFrame();
+
+		// The trace is written once the given amount of frames was gathered
+		void CaptureFrames(const uint32_t frameCount, const std::string& path);
+		const bool IsCapturing() const { return m_CaptureFramesLeft > 0U; }
+
+		const Frame& GetLastFrame() const { return m_LastFrame; }
+
+		std::vector<std::string> GetThreadNames();
+
+		// Zones that were overwritten before the main thread got to them
+		const uint64_t GetDroppedZoneCount() const { return m_DroppedZones; }
+
+	private:
+		struct ThreadBuffer
+		{
+			std::array<Zone, ZONE_BUFFER_SIZE> zones{};
+
+			// Only the owning thread advances it, the reader remembers how far it got
+			std::atomic<uint64_t> written = 0U;
+			uint64_t			  read	  = 0U;
+
+			std::string name;
+		};
+
+		ThreadBuffer& GetThreadBuffer();
+
+		void GatherZones(std::vector<Zone>& zones);
+		void WriteCapture();
+
+		// New threads register under the lock, writing zones never takes it
+		std::mutex m_ThreadsMutex;
+		std::vector<Scope<ThreadBuffer>> m_Threads;
+
+		Frame m_CurrentFrame;
+		Frame m_LastFrame;
+
+		std::vector<Frame> m_CapturedFrames;
+		uint32_t		   m_CaptureFramesLeft = 0U;
+		std::string		   m_CapturePath;
+
+		uint64_t m_DroppedZones = 0U;
+	};
+
+	class ProfileZone
+	{
+	public:
+		ProfileZone(const char* name);
+		~ProfileZone();
+
+	private:
+		const char* m_Name;
+		uint64_t	m_Start;
+		uint32_t	m_Depth;
+	};
+}
+
+#if CPU_PROFILING
+
+	#define EN_PROFILE_CONCAT_IMPL(a, b) a##b
+	#define EN_PROFILE_CONCAT(a, b) EN_PROFILE_CONCAT_IMPL(a, b)
+
+	// The name is read back when the frame is gathered, so it has to be a string literal
+	#define EN_PROFILE_SCOPE(name) en::ProfileZone EN_PROFILE_CONCAT(profileZone, __LINE__)(name)
+	#define EN_PROFILE_FUNCTION()  EN_PROFILE_SCOPE(__FUNCTION__)
+
+	#define EN_PROFILE_THREAD(name) en::Profiler::SetThreadName(name)
+	#define EN_PROFILE_FRAME()		{ if (en::Profiler::Get()) en::Profiler::Get()->NextFrame(); }
+
+#else
+
+	#define EN_PROFILE_SCOPE(name)
+	#define EN_PROFILE_FUNCTION()
+
+	#define EN_PROFILE_THREAD(name)
+	#define EN_PROFILE_FRAME()
+
+#endif
+
+#endif
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace en
 		m_SceneHierarchyPanel = MakeScope<SceneHierarchyPanel>(m_Renderer);
 		m_InspectorPanel	  = MakeScope<InspectorPanel	 >(m_SceneHierarchyPanel.get(), m_Renderer, assetManager);
 		m_SettingsPanel  	  = MakeScope<SettingsPanel		 >(m_Renderer);
+		m_ProfilerPanel		  = MakeScope<ProfilerPanel		 >();
 
 		UpdateStyle();
 	
@@ -30,6 +31,8 @@ namespace en
 
 	void EditorLayer::OnUIDraw()
 	{
+		EN_PROFILE_FUNCTION();
+
 		BeginRender();
 
 		DrawDockspace();
@@ -52,6 +55,9 @@ namespace en
 			
 		if (m_ShowSettingsMenu)
 			m_SettingsPanel->Render();
+
+		if (m_ShowProfilerMenu)
+			m_ProfilerPanel->Render();
 			
 		EndRender();
 	}
@@ -215,6 +221,7 @@ namespace en
 			ImGui::MenuItem("Scene Menu", "", &m_ShowSceneMenu);
 			ImGui::MenuItem("Inspector", "", &m_ShowInspector);
 			ImGui::MenuItem("Settings", "", &m_ShowSettingsMenu);
+			ImGui::MenuItem("Profiler", "", &m_ShowProfilerMenu);
 
 			if (ImGui::MenuItem("Toggle UI (Shift+I)", "", &m_Visible))
 				SetVisibility(m_Visible);
@@ -270,6 +277,88 @@ namespace en
 		{
 			ImGui::Text(("FPS: " + std::to_string(1.0 / m_Renderer->GetFrameTime())).c_str());
 			ImGui::Text((std::to_string(m_Renderer->GetFrameTime()*1000.0f) + "ms/frame").c_str());
+
+			const auto& culling = m_Renderer->GetCullingStats();
+
+			if (!m_Renderer->GetGPUDrivenRenderingEnabled())
+			{
+				ImGui::Text(("Visible draws: " + std::to_string(culling.visibleDraws)).c_str());
+				ImGui::Text(("Culled draws: " + std::to_string(culling.culledDraws)).c_str());
+				ImGui::Text(("Visible shadow draws: " + std::to_string(culling.visibleShadowDraws)).c_str());
+				ImGui::Text(("Culled shadow draws: " + std::to_string(culling.culledShadowDraws)).c_str());
+			}
+
+			ImGui::Text(("Skipped point shadow faces: " + std::to_string(culling.skippedPointShadowFaces)).c_str());
+			ImGui::Text(("Cached shadow views: " + std::to_string(culling.cachedShadowViews)).c_str());
+			ImGui::Text(("Staggered shadow views: " + std::to_string(culling.staggeredShadowViews)).c_str());
+
+			const auto& pipelines = m_Renderer->GetPipelineCreationStats();
+
+			ImGui::Text("Pipelines: %u created in %.2f ms (%s cache), waited %.2f ms", pipelines.pipelines, pipelines.creationTime, pipelines.warmCache ? "warm" : "cold", pipelines.waitTime);
+			ImGui::Text("Backend creation: %.2f ms", pipelines.backendTime);
+
+			const auto& graph = m_Renderer->GetRenderGraphStats();
+
+			constexpr float MEGABYTE = 1024.0f * 1024.0f;
+
+			ImGui::Text("Render graph: %u passes (%u culled), %u barriers", graph.passes - graph.culledPasses, graph.culledPasses, graph.barriers);
+			ImGui::Text("Transient images: %u in %.2f MB instead of %.2f MB", graph.transientImages, graph.allocatedSize / MEGABYTE, graph.transientSize / MEGABYTE);
+
+			const auto& frameStaging  = m_Renderer->GetStagingStats();
+			const auto	uploadStaging = Context::Get().m_UploadQueue->GetStagingStats();
+
+			ImGui::Text("Frame staging: %.2f MB (%.2f MB peak) of %.2f MB, grew %u times", frameStaging.usedSize / MEGABYTE, frameStaging.highWaterMark / MEGABYTE, frameStaging.capacity / MEGABYTE, frameStaging.grows);
+			ImGui::Text("Upload staging: %.2f MB (%.2f MB peak) of %.2f MB, grew %u times", uploadStaging.usedSize / MEGABYTE, uploadStaging.highWaterMark / MEGABYTE, uploadStaging.capacity / MEGABYTE, uploadStaging.grows);
+
+#if BARRIER_STATS
+			const auto& barriers = m_Renderer->GetBarrierStats();
+
+			ImGui::Text("Barriers: %u in %u batches per frame", barriers.barriers, barriers.batches);
+#endif
+		}
+
+		SPACE();
+
+		if (ImGui::CollapsingHeader("GPU Timings"))
+		{
+			const auto& profiler = m_Renderer->GetGPUProfiler();
+
+			if (!profiler.IsSupported())
+				ImGui::Text("Timestamp queries are not supported by the GPU.");
+
+			else if (ImGui::BeginTable("GPU Timings", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+			{
+				ImGui::TableSetupColumn("Pass");
+				ImGui::TableSetupColumn("Last");
+				ImGui::TableSetupColumn("Min");
+				ImGui::TableSetupColumn("Avg");
+				ImGui::TableSetupColumn("P99");
+				ImGui::TableHeadersRow();
+
+				for (const auto& scope : profiler.GetStats())
+				{
+					ImGui::TableNextRow();
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%*s%s", scope.depth * 2, "", scope.name.c_str());
+
+					if (!scope.timed)
+					{
+						ImGui::TableNextColumn(); ImGui::Text("n/a (async)");
+						continue;
+					}
+
+					ImGui::TableNextColumn(); ImGui::Text("%.3f ms", scope.last);
+					ImGui::TableNextColumn(); ImGui::Text("%.3f ms", scope.min);
+					ImGui::TableNextColumn(); ImGui::Text("%.3f ms", scope.avg);
+					ImGui::TableNextColumn(); ImGui::Text("%.3f ms", scope.p99);
+				}
+
+				ImGui::EndTable();
+
+				if (ImGui::Button("Dump to JSON"))
+					profiler.DumpJSON("GPUTimings.json");
+			}
 		}
 
 		SPACE();
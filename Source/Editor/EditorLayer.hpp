@@ -9,6 +9,7 @@
 #include "UIPanels/SceneHierarchyPanel.hpp"
 #include "UIPanels/InspectorPanel.hpp"
 #include "UIPanels/SettingsPanel.hpp"
+#include "UIPanels/ProfilerPanel.hpp"
 
 #include <Editor/EditorCommons.hpp>
 #include <Renderer/Renderer.hpp>
@@ -39,6 +40,7 @@ namespace en
 		Scope<SceneHierarchyPanel> m_SceneHierarchyPanel;
 		Scope<InspectorPanel	 > m_InspectorPanel;
 		Scope<SettingsPanel      > m_SettingsPanel;
+		Scope<ProfilerPanel      > m_ProfilerPanel;
 		
 		bool m_ShowLightsMenu	= true;
 		bool m_ShowAssetMenu	= false;
@@ -47,6 +49,7 @@ namespace en
 		bool m_ShowSceneMenu	= true;
 		bool m_ShowInspector	= true;
 		bool m_ShowSettingsMenu = false;
+		bool m_ShowProfilerMenu = false;
 		
 		void BeginRender();
 		void DrawDockspace();
@@ -515,7 +515,10 @@ namespace en
 
 			SPACE();
 
-			ImGui::Checkbox("Is Active", &chosenMesh->m_Active);
+			bool meshActive = chosenMesh->IsActive();
+
+			if (ImGui::Checkbox("Is Active", &meshActive))
+				chosenMesh->SetActive(meshActive);
 
 			SPACE();
 
@@ -550,7 +553,10 @@ namespace en
 
 					SPACE();
 
-					ImGui::Checkbox("Is Active", &subMesh.m_Active);
+					bool subMeshActive = subMesh.IsActive();
+
+					if (ImGui::Checkbox("Is Active", &subMeshActive))
+						subMesh.SetActive(subMeshActive);
 
 					SPACE();
 				}
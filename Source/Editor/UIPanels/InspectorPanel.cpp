@@ -44,7 +44,7 @@ namespace en
 			const auto& meshes = m_AssetManager->GetAllMeshes();
 
 			for (int i = 0; i < meshes.size(); i++)
-				if (meshes[i]->GetName() == chosenSceneObject->m_Mesh->GetName())
+				if (meshes[i]->GetName() == chosenSceneObject->GetMesh()->GetName())
 				{
 					chosenMeshIndex = i + 1;
 					break;
@@ -87,7 +87,15 @@ namespace en
 			if (ImGui::DragFloat3("Scale", (float*)&chosenScale, 0.1f))
 				chosenSceneObject->SetScale(chosenScale);
 
-			ImGui::Checkbox("Active", &chosenSceneObject->m_Active);
+			bool active = chosenSceneObject->IsActive();
+
+			if (ImGui::Checkbox("Active", &active))
+				chosenSceneObject->SetActive(active);
+
+			bool isStatic = chosenSceneObject->IsStatic();
+
+			if (ImGui::Checkbox("Static", &isStatic))
+				chosenSceneObject->SetStatic(isStatic);
 
 			SPACE();
 
@@ -103,9 +111,9 @@ namespace en
 			if (ImGui::Combo("Mesh", &chosenMeshIndex, meshNames.data(), meshNames.size()))
 			{
 				if (chosenMeshIndex == 0)
-					chosenSceneObject->m_Mesh = Mesh::GetEmptyMesh();
+					chosenSceneObject->SetMesh(Mesh::GetEmptyMesh());
 				else
-					chosenSceneObject->m_Mesh = m_AssetManager->GetMesh(allMeshes[chosenMeshIndex - 1]->GetName());
+					chosenSceneObject->SetMesh(m_AssetManager->GetMesh(allMeshes[chosenMeshIndex - 1]->GetName()));
 			}
 
 			if (deleted)
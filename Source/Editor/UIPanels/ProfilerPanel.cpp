@@ -0,0 +1,109 @@
+#include "ProfilerPanel.hpp"
+
+#include <Editor/EditorCommons.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+namespace en
+{
+	constexpr float ZONE_ROW_HEIGHT = 20.0f;
+
+	void ProfilerPanel::Render()
+	{
+		ImGui::SetNextWindowSizeConstraints(EditorCommons::FreeWindowMinSize, EditorCommons::FreeWindowMaxSize);
+
+		ImGui::Begin("Profiler", nullptr, EditorCommons::CommonFlags);
+
+		Profiler* profiler = Profiler::Get();
+
+#if CPU_PROFILING
+		if (profiler)
+		{
+			const auto& frame = profiler->GetLastFrame();
+
+			ImGui::Text("Frame: %.3f ms", (frame.end - frame.start) / 1000000.0);
+			ImGui::Text(("Dropped zones: " + std::to_string(profiler->GetDroppedZoneCount())).c_str());
+
+			SPACE();
+
+			ImGui::DragInt("Frames to capture", &m_CaptureFrameCount, 1.0f, 1, 1000, "%d", ImGuiSliderFlags_AlwaysClamp);
+
+			if (profiler->IsCapturing())
+				ImGui::Text("Capturing...");
+			else if (ImGui::Button("Capture Chrome trace"))
+				profiler->CaptureFrames(static_cast<uint32_t>(m_CaptureFrameCount), "CPUTrace.json");
+
+			SPACE();
+
+			const auto threadNames = profiler->GetThreadNames();
+
+			for (uint32_t thread = 0U; thread < threadNames.size(); thread++)
+				DrawThread(frame, thread, threadNames[thread]);
+		}
+		else
+			ImGui::Text("The profiler was not created.");
+#else
+		ImGui::Text("The CPU zones are compiled out, CPU_PROFILING is disabled.");
+#endif
+
+		ImGui::End();
+	}
+
+	void ProfilerPanel::DrawThread(const Profiler::Frame& frame, const uint32_t thread, const std::string& threadName)
+	{
+		uint32_t maxDepth = 0U;
+		bool	 hasZones = false;
+
+		for (const auto& zone : frame.zones)
+		{
+			if (zone.thread != thread) continue;
+
+			maxDepth = std::max(maxDepth, zone.depth);
+			hasZones = true;
+		}
+
+		if (!hasZones) return;
+
+		ImGui::Text(threadName.c_str());
+
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+		const ImVec2 origin = ImGui::GetCursorScreenPos();
+		const float	 width	= std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+
+		const double frameDuration = static_cast<double>(std::max<uint64_t>(frame.end - frame.start, 1U));
+
+		const Profiler::Zone* hoveredZone = nullptr;
+
+		for (const auto& zone : frame.zones)
+		{
+			if (zone.thread != thread) continue;
+
+			// Zones that started in the previous frame are cut off at its end
+			const uint64_t start = std::max(zone.start, frame.start);
+
+			const ImVec2 min(origin.x + static_cast<float>((start - frame.start) / frameDuration) * width, origin.y + zone.depth * ZONE_ROW_HEIGHT);
+			const ImVec2 max(std::max(origin.x + static_cast<float>((zone.end - frame.start) / frameDuration) * width, min.x + 1.0f), min.y + ZONE_ROW_HEIGHT - 1.0f);
+
+			// Same color for the same zone in every frame
+			const float hue = (std::hash<std::string_view>{}(zone.name) % 360U) / 360.0f;
+
+			drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.45f, 0.65f));
+
+			if (max.x - min.x > ImGui::CalcTextSize(zone.name).x + 4.0f)
+				drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32_WHITE, zone.name);
+
+			if (ImGui::IsMouseHoveringRect(min, max) && (!hoveredZone || zone.depth > hoveredZone->depth))
+				hoveredZone = &zone;
+		}
+
+		if (hoveredZone)
+			ImGui::SetTooltip("%s\n%.3f ms", hoveredZone->name, (hoveredZone->end - hoveredZone->start) / 1000000.0);
+
+		ImGui::Dummy(ImVec2(width, (maxDepth + 1U) * ZONE_ROW_HEIGHT));
+
+		ImGui::Spacing();
+	}
+}
\ No newline at end of file
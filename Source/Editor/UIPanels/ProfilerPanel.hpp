@@ -0,0 +1,23 @@
+#pragma once
+
+#ifndef EN_PROFILERPANEL_HPP
+#define EN_PROFILERPANEL_HPP
+
+#include <Core/Profiler.hpp>
+
+namespace en
+{
+	// Flame view of the CPU zones gathered during the last frame, one band per thread
+	class ProfilerPanel
+	{
+	public:
+		void Render();
+
+	private:
+		int m_CaptureFrameCount = 60;
+
+		void DrawThread(const Profiler::Frame& frame, const uint32_t thread, const std::string& threadName);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -37,9 +37,9 @@ namespace en
 			{
 				const SceneObject* chosenObject = m_ChosenSceneMember->CastTo<SceneObject>();
 
-				Handle<SceneObject> object = m_Renderer->GetScene()->CreateSceneObject(chosenObject->GetName() + "(Copy)", chosenObject->m_Mesh);
+				Handle<SceneObject> object = m_Renderer->GetScene()->CreateSceneObject(chosenObject->GetName() + "(Copy)", chosenObject->GetMesh());
 
-				object->m_Active = chosenObject->m_Active;
+				object->SetActive(chosenObject->IsActive());
 				object->SetPosition(chosenObject->GetPosition());
 				object->SetRotation(chosenObject->GetRotation());
 				object->SetScale   (chosenObject->GetScale   ());
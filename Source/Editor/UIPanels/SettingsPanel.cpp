@@ -16,6 +16,7 @@ namespace en
 
 		static bool vSync = m_Renderer->GetVSyncEnabled();
 		static bool depthPrepass = m_Renderer->GetDepthPrepassEnabled();
+		static bool gpuDriven = m_Renderer->GetGPUDrivenRenderingEnabled();
 
 		static Renderer::AntialiasingMode antialiasingMode = m_Renderer->GetAntialiasingMode();
 		static Renderer::AmbientOcclusionMode ssaoMode = m_Renderer->GetAmbientOcclusionMode();
@@ -28,6 +29,9 @@ namespace en
 
 		if (ImGui::Checkbox("Depth Prepass", &depthPrepass))
 			m_Renderer->SetDepthPrepassEnabled(depthPrepass);
+
+		if (ImGui::Checkbox("GPU Culling", &gpuDriven))
+			m_Renderer->SetGPUDrivenRenderingEnabled(gpuDriven);
 		
 		if (ImGui::CollapsingHeader("Antialiasing"))
 		{
@@ -114,6 +118,13 @@ namespace en
 				if (ImGui::DragFloat("Shadow cascades far plane", &farPlane, 0.5f, m_Renderer->GetScene()->m_MainCamera->m_NearPlane, m_Renderer->GetScene()->m_MainCamera->m_FarPlane, "%.2f", ImGuiSliderFlags_AlwaysClamp))
 					m_Renderer->SetShadowCascadesFarPlane(farPlane);
 
+			for (uint32_t i = 0U; i < SHADOW_CASCADES; i++)
+			{
+				int interval = m_Renderer->GetShadowCascadeUpdateInterval(i);
+				if (ImGui::DragInt(("Shadow cascade " + std::to_string(i) + " update interval").c_str(), &interval, 0.05f, 1, 16, "%d frames", ImGuiSliderFlags_AlwaysClamp))
+					m_Renderer->SetShadowCascadeUpdateInterval(i, interval);
+			}
+
 			static int pRes = m_Renderer->GetPointShadowResolution();
 			static int sRes = m_Renderer->GetSpotShadowResolution();
 			static int dRes = m_Renderer->GetDirShadowResolution();
@@ -127,6 +138,16 @@ namespace en
 			if (ImGui::DragInt("Directional shadows resolution", &dRes, 2, 16, 8192, "%d", ImGuiSliderFlags_AlwaysClamp))
 				m_Renderer->SetDirShadowResolution(dRes);
 
+			static int budget = m_Renderer->GetShadowMemoryBudget();
+
+			if (ImGui::DragInt("Shadow memory budget (MB)", &budget, 1, 8, 1024, "%d", ImGuiSliderFlags_AlwaysClamp))
+				m_Renderer->SetShadowMemoryBudget(budget);
+
+			bool shadowCaching = m_Renderer->GetShadowCachingEnabled();
+
+			if (ImGui::Checkbox("Cache shadow maps", &shadowCaching))
+				m_Renderer->SetShadowCachingEnabled(shadowCaching);
+
 			bool enabled32BitShadows = (m_Renderer->GetShadowFormat() == VK_FORMAT_D32_SFLOAT);
 
 			if (ImGui::Checkbox("32 Bit Shadowmaps", &enabled32BitShadows))
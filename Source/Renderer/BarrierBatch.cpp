@@ -0,0 +1,133 @@
+#include "BarrierBatch.hpp"
+
+#include <atomic>
+
+namespace en
+{
+	constexpr VkAccessFlags2 WRITE_ACCESS =
+		VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+	// Any thread recording commands can flush a batch
+	std::atomic<uint32_t> g_FlushedBarriers = 0U;
+	std::atomic<uint32_t> g_FlushedBatches	= 0U;
+
+	bool IsReadAfterRead(const VkAccessFlags2 srcAccessMask, const VkAccessFlags2 dstAccessMask)
+	{
+		return !(srcAccessMask & WRITE_ACCESS) && !(dstAccessMask & WRITE_ACCESS);
+	}
+
+	void BarrierBatch::Add(VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage)
+	{
+		if (IsReadAfterRead(srcAccessMask, dstAccessMask))
+			return;
+
+		m_MemoryBarriers.emplace_back(VkMemoryBarrier2{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+
+			.srcStageMask  = srcStage,
+			.srcAccessMask = srcAccessMask,
+			.dstStageMask  = dstStage,
+			.dstAccessMask = dstAccessMask,
+		});
+	}
+	void BarrierBatch::Add(const MemoryBuffer& buffer, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t srcQueueFamily, uint32_t dstQueueFamily)
+	{
+		Add(buffer.GetHandle(), srcAccessMask, dstAccessMask, srcStage, dstStage, srcQueueFamily, dstQueueFamily);
+	}
+	void BarrierBatch::Add(VkBuffer buffer, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t srcQueueFamily, uint32_t dstQueueFamily)
+	{
+		// An ownership transfer is needed even when neither side writes
+		if (srcQueueFamily == dstQueueFamily && IsReadAfterRead(srcAccessMask, dstAccessMask))
+			return;
+
+		m_BufferBarriers.emplace_back(VkBufferMemoryBarrier2{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+
+			.srcStageMask  = srcStage,
+			.srcAccessMask = srcAccessMask,
+			.dstStageMask  = dstStage,
+			.dstAccessMask = dstAccessMask,
+
+			.srcQueueFamilyIndex = srcQueueFamily,
+			.dstQueueFamilyIndex = dstQueueFamily,
+
+			.buffer = buffer,
+
+			.offset = 0U,
+			.size	= VK_WHOLE_SIZE,
+		});
+	}
+	void BarrierBatch::Add(Image& image, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage)
+	{
+		Add(image.m_Image, image.m_AspectFlags, image.m_CurrentLayout, newLayout, srcAccessMask, dstAccessMask, srcStage, dstStage, 0U, image.m_LayerCount, image.m_MipLevelCount);
+
+		image.m_CurrentLayout = newLayout;
+	}
+	void BarrierBatch::Add(VkImage image, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t layer, uint32_t layerCount, uint32_t mipLevels, uint32_t baseMipLevel)
+	{
+		if (oldLayout == newLayout && IsReadAfterRead(srcAccessMask, dstAccessMask))
+			return;
+
+		m_ImageBarriers.emplace_back(VkImageMemoryBarrier2{
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+
+			.srcStageMask  = srcStage,
+			.srcAccessMask = srcAccessMask,
+			.dstStageMask  = dstStage,
+			.dstAccessMask = dstAccessMask,
+
+			.oldLayout = oldLayout,
+			.newLayout = newLayout,
+
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+
+			.image = image,
+
+			.subresourceRange {
+				.aspectMask		= aspectFlags,
+				.baseMipLevel	= baseMipLevel,
+				.levelCount		= mipLevels,
+				.baseArrayLayer = layer,
+				.layerCount		= layerCount,
+			}
+		});
+	}
+
+	void BarrierBatch::Flush(VkCommandBuffer cmd)
+	{
+		if (IsEmpty())
+			return;
+
+		const VkDependencyInfo dependencyInfo{
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+
+			.memoryBarrierCount		  = static_cast<uint32_t>(m_MemoryBarriers.size()),
+			.pMemoryBarriers		  = m_MemoryBarriers.data(),
+			.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size()),
+			.pBufferMemoryBarriers	  = m_BufferBarriers.data(),
+			.imageMemoryBarrierCount  = static_cast<uint32_t>(m_ImageBarriers.size()),
+			.pImageMemoryBarriers	  = m_ImageBarriers.data(),
+		};
+
+		vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+
+#if BARRIER_STATS
+		g_FlushedBarriers += static_cast<uint32_t>(m_MemoryBarriers.size() + m_BufferBarriers.size() + m_ImageBarriers.size());
+		g_FlushedBatches++;
+#endif
+
+		m_MemoryBarriers.clear();
+		m_BufferBarriers.clear();
+		m_ImageBarriers.clear();
+	}
+
+	BarrierBatch::Stats BarrierBatch::ResetStats()
+	{
+		return Stats{
+			.barriers = g_FlushedBarriers.exchange(0U),
+			.batches  = g_FlushedBatches.exchange(0U),
+		};
+	}
+}
\ No newline at end of file
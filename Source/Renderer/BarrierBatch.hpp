@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef EN_BARRIERBATCH_HPP
+#define EN_BARRIERBATCH_HPP
+
+#include "../../EruptionEngine.ini"
+
+#include <Renderer/Image.hpp>
+#include <Renderer/Buffers/MemoryBuffer.hpp>
+
+#include <vector>
+
+namespace en
+{
+	// Collects the barriers between two groups of commands and records them with a single vkCmdPipelineBarrier2(). The ones that
+	// only order reads after reads (in the same layout) don't do anything and are dropped.
+	class BarrierBatch
+	{
+	public:
+		struct Stats
+		{
+			uint32_t barriers = 0U;
+			uint32_t batches  = 0U;
+		};
+
+		// Without a resource, e.g. for copies that only have to wait for the reads of the memory they overwrite
+		void Add(VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage);
+
+		// The whole buffer. Different queue families make it the release (on the source queue) or the acquire (on the destination
+		// queue) half of an ownership transfer, the stage and access of the other queue's side are ignored.
+		void Add(const MemoryBuffer& buffer, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED, uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED);
+		void Add(VkBuffer buffer, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED, uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED);
+
+		// Every layer and mip level, the layout of the image changes right away
+		void Add(Image& image, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage);
+		void Add(VkImage image, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, uint32_t layer = 0U, uint32_t layerCount = 1U, uint32_t mipLevels = 1U, uint32_t baseMipLevel = 0U);
+
+		// Records the barriers (if there are any left) and empties the batch
+		void Flush(VkCommandBuffer cmd);
+
+		const bool IsEmpty() const { return m_MemoryBarriers.empty() && m_BufferBarriers.empty() && m_ImageBarriers.empty(); };
+
+		// Of every batch flushed since the last call, the counts stay empty with BARRIER_STATS disabled
+		static Stats ResetStats();
+
+	private:
+		std::vector<VkMemoryBarrier2>		m_MemoryBarriers;
+		std::vector<VkBufferMemoryBarrier2> m_BufferBarriers;
+		std::vector<VkImageMemoryBarrier2>	m_ImageBarriers;
+	};
+}
+
+#endif
\ No newline at end of file
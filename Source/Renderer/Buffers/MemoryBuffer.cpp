@@ -1,27 +1,40 @@
 #include "MemoryBuffer.hpp"
 
 #include <Common/Helpers.hpp>
+#include <Renderer/BarrierBatch.hpp>
 
 namespace en
 {
-	MemoryBuffer::MemoryBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage vmaMemoryUsage) 
-        : m_BufferSize(size), m_BufferUsage(usage), m_MemoryUsage(vmaMemoryUsage)
+	MemoryBuffer::MemoryBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage vmaMemoryUsage, bool computeShared) 
+        : m_BufferSize(size), m_BufferUsage(usage), m_MemoryUsage(vmaMemoryUsage), m_ComputeShared(computeShared)
 	{
         UseContext();
 
+        // Without a compute queue of its own there is only one family to begin with
+        const bool concurrent = m_ComputeShared && ctx.HasAsyncCompute();
+        const uint32_t queueFamilies[] = { ctx.m_QueueFamilies.graphics.value(), ctx.m_QueueFamilies.compute.value() };
+
         const VkBufferCreateInfo bufferInfo {
-            .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size        = m_BufferSize,
-            .usage       = m_BufferUsage,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+            .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size                  = m_BufferSize,
+            .usage                 = m_BufferUsage,
+            .sharingMode           = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = concurrent ? 2U : 0U,
+            .pQueueFamilyIndices   = queueFamilies
         };
 
+        // Mapped once instead of on every write
         const VmaAllocationCreateInfo allocationInfo{
+            .flags = m_MemoryUsage != VMA_MEMORY_USAGE_GPU_ONLY ? VMA_ALLOCATION_CREATE_MAPPED_BIT : 0U,
             .usage = m_MemoryUsage
         };
 
-        if (vmaCreateBuffer(ctx.m_Allocator, &bufferInfo, &allocationInfo, &m_Buffer, &m_Allocation, nullptr) != VK_SUCCESS)
+        VmaAllocationInfo allocation{};
+
+        if (vmaCreateBuffer(ctx.m_Allocator, &bufferInfo, &allocationInfo, &m_Buffer, &m_Allocation, &allocation) != VK_SUCCESS)
             EN_ERROR("MemoryBuffer::MemoryBuffer() - Failed to create a buffer!");
+
+        m_MappedData = allocation.pMappedData;
 	}
     MemoryBuffer::~MemoryBuffer()
     {
@@ -30,30 +43,38 @@ namespace en
 
     void MemoryBuffer::MapMemory(const void* memory, VkDeviceSize memorySize, VkDeviceSize srcOffset, VkDeviceSize dstOffset)
     {
-        UseContext();
-
-        void* data;
+        memcpy((void*)((VkDeviceSize)m_MappedData + dstOffset), (void*)((VkDeviceSize)memory + srcOffset), static_cast<size_t>(memorySize));
 
-        vmaMapMemory(ctx.m_Allocator, m_Allocation, &data);
-        memcpy((void*)((VkDeviceSize)data+dstOffset), (void*)((VkDeviceSize)memory + srcOffset), static_cast<size_t>(memorySize));
-        vmaUnmapMemory(ctx.m_Allocator, m_Allocation);
+        FlushMemory(memorySize, dstOffset);
+    }
+    void MemoryBuffer::FlushMemory(VkDeviceSize memorySize, VkDeviceSize offset)
+    {
+        vmaFlushAllocation(Context::Get().m_Allocator, m_Allocation, offset, memorySize);
+    }
+    void MemoryBuffer::ReadMemory(void* memory, VkDeviceSize memorySize, VkDeviceSize srcOffset)
+    {
+        vmaInvalidateAllocation(Context::Get().m_Allocator, m_Allocation, srcOffset, memorySize);
+        memcpy(memory, (void*)((VkDeviceSize)m_MappedData + srcOffset), static_cast<size_t>(memorySize));
     }
-    void MemoryBuffer::CopyInto(const void* memory, VkDeviceSize memorySize, uint32_t dstOffset, VkCommandBuffer cmd)
+    UploadQueue::Ticket MemoryBuffer::CopyInto(const void* memory, VkDeviceSize memorySize, uint32_t dstOffset)
     {
-        VkCommandBuffer commandBuffer = cmd ? cmd : Helpers::BeginSingleTimeTransferCommands();
-        
-        MemoryBuffer stagingBuffer(
-            memorySize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU
-        );
+        UploadQueue& uploads = *Context::Get().m_UploadQueue;
 
-        stagingBuffer.MapMemory(memory, memorySize);
+        uploads.Begin();
 
-        stagingBuffer.CopyTo(m_Buffer, memorySize, 0U, dstOffset, cmd);
+        const StagingRing::Allocation staging = uploads.Stage(memory, memorySize);
 
-        if (!cmd)
-            Helpers::EndSingleTimeTransferCommands(commandBuffer);
+        const VkBufferCopy copyRegion{
+            .srcOffset = staging.offset,
+            .dstOffset = dstOffset,
+            .size      = memorySize,
+        };
+
+        vkCmdCopyBuffer(uploads.GetTransferCommandBuffer(), staging.buffer, m_Buffer, 1U, &copyRegion);
+
+        uploads.Release(*this);
+
+        return uploads.End();
     }
     void MemoryBuffer::CopyTo(Handle<MemoryBuffer> dstBuffer, VkDeviceSize sizeBytes, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkCommandBuffer cmd)
     {
@@ -65,7 +86,12 @@ namespace en
     }
     void MemoryBuffer::CopyTo(VkBuffer dstBuffer, VkDeviceSize sizeBytes, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkCommandBuffer cmd)
     {
-        VkCommandBuffer commandBuffer = cmd ? cmd : Helpers::BeginSingleTimeTransferCommands();
+        UploadQueue& uploads = *Context::Get().m_UploadQueue;
+
+        if (!cmd)
+            uploads.Begin();
+
+        VkCommandBuffer commandBuffer = cmd ? cmd : uploads.GetGraphicsCommandBuffer();
 
         VkBufferCopy copyRegion{
             .srcOffset = srcOffset,
@@ -76,13 +102,16 @@ namespace en
         vkCmdCopyBuffer(commandBuffer, m_Buffer, dstBuffer, 1U, &copyRegion);
 
         if (!cmd)
-            Helpers::EndSingleTimeTransferCommands(commandBuffer);
+            uploads.End();
     }
     void MemoryBuffer::CopyTo(VkImage dstImage, VkExtent3D extent, VkCommandBuffer cmd)
     {
-        UseContext();
+        UploadQueue& uploads = *Context::Get().m_UploadQueue;
+
+        if (!cmd)
+            uploads.Begin();
 
-        VkCommandBuffer commandBuffer = cmd ? cmd : Helpers::BeginSingleTimeTransferCommands();
+        VkCommandBuffer commandBuffer = cmd ? cmd : uploads.GetGraphicsCommandBuffer();
 
         const VkBufferImageCopy region{
             .imageSubresource{
@@ -97,59 +126,55 @@ namespace en
         vkCmdCopyBufferToImage(commandBuffer, m_Buffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &region);
 
         if (!cmd)
-            Helpers::EndSingleTimeTransferCommands(commandBuffer);
+            uploads.End();
     }
-    void MemoryBuffer::PipelineBarrier(VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkCommandBuffer cmdBuffer)
+    void MemoryBuffer::PipelineBarrier(VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, VkCommandBuffer cmdBuffer)
     {
-        VkBufferMemoryBarrier barrier{
-                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-
-                .srcAccessMask = srcAccessMask,
-                .dstAccessMask = dstAccessMask,
-
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-
-                .buffer = m_Buffer,
-
-                .offset = 0U,
-                .size   = m_BufferSize,
-        };
-
-        vkCmdPipelineBarrier(
-            cmdBuffer,
-            srcStage, dstStage,
-            0U,
-            0U, nullptr,
-            1U, &barrier,
-            0U, nullptr
-        );
+        BarrierBatch barriers;
+        barriers.Add(*this, srcAccessMask, dstAccessMask, srcStage, dstStage);
+        barriers.Flush(cmdBuffer);
     }
     void MemoryBuffer::Resize(VkDeviceSize newSize, VkCommandBuffer cmd)
     {
+        UseContext();
+
         VkBuffer newBuffer = VK_NULL_HANDLE;
         VmaAllocation newAllocation = VK_NULL_HANDLE;
 
+        const bool concurrent = m_ComputeShared && ctx.HasAsyncCompute();
+        const uint32_t queueFamilies[] = { ctx.m_QueueFamilies.graphics.value(), ctx.m_QueueFamilies.compute.value() };
+
         const VkBufferCreateInfo bufferInfo{
-            .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size        = newSize,
-            .usage       = m_BufferUsage,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+            .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size                  = newSize,
+            .usage                 = m_BufferUsage,
+            .sharingMode           = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = concurrent ? 2U : 0U,
+            .pQueueFamilyIndices   = queueFamilies
         };
 
         const VmaAllocationCreateInfo allocationInfo{
+            .flags = m_MemoryUsage != VMA_MEMORY_USAGE_GPU_ONLY ? VMA_ALLOCATION_CREATE_MAPPED_BIT : 0U,
             .usage = m_MemoryUsage
         };
 
-        if (vmaCreateBuffer(Context::Get().m_Allocator, &bufferInfo, &allocationInfo, &newBuffer, &newAllocation, nullptr) != VK_SUCCESS)
+        VmaAllocationInfo allocation{};
+
+        if (vmaCreateBuffer(ctx.m_Allocator, &bufferInfo, &allocationInfo, &newBuffer, &newAllocation, &allocation) != VK_SUCCESS)
             EN_ERROR("MemoryBuffer::MemoryBuffer() - Failed to create a buffer!");
     
-        CopyTo(newBuffer, std::min(m_BufferSize, newSize), 0U, 0U, cmd);
+        VkCommandBuffer commandBuffer = cmd ? cmd : Helpers::BeginSingleTimeGraphicsCommands();
 
-        vmaDestroyBuffer(Context::Get().m_Allocator, m_Buffer, m_Allocation);
+        CopyTo(newBuffer, std::min(m_BufferSize, newSize), 0U, 0U, commandBuffer);
+
+        if (!cmd)
+            Helpers::EndSingleTimeGraphicsCommands(commandBuffer);
+
+        vmaDestroyBuffer(ctx.m_Allocator, m_Buffer, m_Allocation);
 
         m_Buffer     = newBuffer;
         m_Allocation = newAllocation;
         m_BufferSize = newSize;
+        m_MappedData = allocation.pMappedData;
     }
 }
\ No newline at end of file
@@ -10,34 +10,52 @@ namespace en
     class MemoryBuffer
     {
     public:
-        MemoryBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage vmaMemoryUsage);
+        // Buffers the compute queue reads as well are shared by both queue families, so they don't need ownership transfers
+        MemoryBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage vmaMemoryUsage, bool computeShared = false);
         ~MemoryBuffer();
 
+        // Host visible buffers stay mapped for their whole lifetime, so this is only a memcpy and a flush of the written range
         void MapMemory(const void* memory, VkDeviceSize memorySize, VkDeviceSize srcOffset = 0U, VkDeviceSize dstOffset = 0U);
 
-        void CopyInto(const void* memory, VkDeviceSize memorySize, uint32_t dstOffset = 0U, VkCommandBuffer cmd = VK_NULL_HANDLE);
+        // For writing through GetMappedData() directly, a no-op on host coherent memory
+        void FlushMemory(VkDeviceSize memorySize, VkDeviceSize offset = 0U);
 
+        // The buffer has to be host visible and the GPU has to be done writing to it
+        void ReadMemory(void* memory, VkDeviceSize memorySize, VkDeviceSize srcOffset = 0U);
+
+        // Through the staging memory of the upload batch on the transfer queue, the graphics queue owns the buffer once the ticket
+        // is done. Whatever else it held is lost when the transfer queue is from a family of its own.
+        UploadQueue::Ticket CopyInto(const void* memory, VkDeviceSize memorySize, uint32_t dstOffset = 0U);
+
+        // Without a command buffer the copy goes into the open upload batch on the graphics queue, both sides have to outlive it
         void CopyTo(Handle<MemoryBuffer> dstBuffer, VkDeviceSize sizeBytes, VkDeviceSize srcOffset = 0U, VkDeviceSize dstOffset = 0U, VkCommandBuffer cmd = VK_NULL_HANDLE);
         void CopyTo(Handle<Image> dstImage, VkCommandBuffer cmd = VK_NULL_HANDLE);
 
         void CopyTo(VkBuffer dstBuffer, VkDeviceSize sizeBytes, VkDeviceSize srcOffset = 0U, VkDeviceSize dstOffset = 0U, VkCommandBuffer cmd = VK_NULL_HANDLE);
         void CopyTo(VkImage dstImage, VkExtent3D extent, VkCommandBuffer cmd = VK_NULL_HANDLE);
 
-        void PipelineBarrier(VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkCommandBuffer cmdBuffer);
+        // A batch of its own, use a BarrierBatch to record the barriers of several buffers at once
+        void PipelineBarrier(VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, VkCommandBuffer cmdBuffer);
 
+        // The old buffer is destroyed right away, so without a command buffer the copy is submitted and waited for on its own
         void Resize(VkDeviceSize newSize, VkCommandBuffer cmd = VK_NULL_HANDLE);
 
         const VkBuffer GetHandle() const { return m_Buffer; };
 
         const VkDeviceSize GetSize() const { return m_BufferSize; };
 
+        // Null for the buffers that aren't host visible
+        void* GetMappedData() const { return m_MappedData; };
+
     private:
         VkBuffer      m_Buffer;
         VmaAllocation m_Allocation;
         VkDeviceSize  m_BufferSize;
+        void*         m_MappedData = nullptr;
 
         const VkBufferUsageFlags m_BufferUsage;
         const VmaMemoryUsage m_MemoryUsage;
+        const bool m_ComputeShared;
     };
 }
 
@@ -0,0 +1,136 @@
+#include "StagingRing.hpp"
+
+#include <Renderer/Buffers/MemoryBuffer.hpp>
+
+namespace en
+{
+	StagingRing::StagingRing(const uint32_t regions, const VkDeviceSize regionSize) : m_RegionSize(regionSize)
+	{
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(Context::Get().m_PhysicalDevice, &properties);
+
+		// The copies into images need their offsets aligned to the texel size as well
+		m_Alignment = std::max(properties.limits.nonCoherentAtomSize, MIN_ALIGNMENT);
+
+		for (uint32_t i = 0U; i < regions; i++)
+			AddRegion();
+	}
+
+	uint32_t StagingRing::AddRegion()
+	{
+		m_Regions.emplace_back(Region{
+			.buffer = CreateBuffer(m_RegionSize)
+		});
+
+		return static_cast<uint32_t>(m_Regions.size() - 1U);
+	}
+
+	void StagingRing::Begin(const uint32_t region)
+	{
+		m_Current = region;
+
+		Region& current = m_Regions[m_Current];
+
+		for (const auto& buffer : current.outgrown)
+			m_Stats.capacity -= buffer->GetSize();
+
+		current.outgrown.clear();
+		current.outgrownSize = 0U;
+
+		current.head	= 0U;
+		current.flushed = 0U;
+	}
+
+	StagingRing::Allocation StagingRing::Allocate(const VkDeviceSize size)
+	{
+		Region& region = m_Regions[m_Current];
+
+		// Keeps the head aligned, so the next allocation starts at an aligned offset too
+		const VkDeviceSize alignedSize = (size + m_Alignment - 1U) / m_Alignment * m_Alignment;
+
+		if (region.head + alignedSize > region.buffer->GetSize())
+			Grow(region, alignedSize);
+
+		const Allocation allocation{
+			.buffer = region.buffer->GetHandle(),
+			.offset = region.head,
+			.data	= static_cast<char*>(region.buffer->GetMappedData()) + region.head,
+		};
+
+		region.head += alignedSize;
+
+		return allocation;
+	}
+	StagingRing::Allocation StagingRing::Write(const void* data, const VkDeviceSize size)
+	{
+		const Allocation allocation = Allocate(size);
+
+		memcpy(allocation.data, data, static_cast<size_t>(size));
+
+		return allocation;
+	}
+
+	void StagingRing::Upload(VkCommandBuffer cmd, const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset)
+	{
+		const Allocation allocation = Write(data, size);
+
+		const VkBufferCopy copyRegion{
+			.srcOffset = allocation.offset,
+			.dstOffset = dstOffset,
+			.size	   = size,
+		};
+
+		vkCmdCopyBuffer(cmd, allocation.buffer, dstBuffer, 1U, &copyRegion);
+	}
+
+	void StagingRing::Flush()
+	{
+		Region& region = m_Regions[m_Current];
+
+		if (region.head > region.flushed)
+		{
+			region.buffer->FlushMemory(region.head - region.flushed, region.flushed);
+			region.flushed = region.head;
+		}
+
+		m_Stats.usedSize	  = GetUsedSize();
+		m_Stats.highWaterMark = std::max(m_Stats.highWaterMark, m_Stats.usedSize);
+	}
+
+	VkDeviceSize StagingRing::GetUsedSize() const
+	{
+		const Region& region = m_Regions[m_Current];
+
+		return region.outgrownSize + region.head;
+	}
+
+	Handle<MemoryBuffer> StagingRing::CreateBuffer(const VkDeviceSize size)
+	{
+		m_Stats.capacity += size;
+
+		return MakeHandle<MemoryBuffer>(
+			size,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VMA_MEMORY_USAGE_CPU_TO_GPU
+		);
+	}
+	void StagingRing::Grow(Region& region, const VkDeviceSize size)
+	{
+		const VkDeviceSize newSize = std::max(region.buffer->GetSize(), size) * GROWTH_MULTIPLIER;
+
+		EN_LOG("StagingRing::Grow() - A region outgrew " + std::to_string(region.buffer->GetSize()) + " bytes, it takes " + std::to_string(newSize) + " from now on");
+
+		// The copies recorded from it are still to be submitted
+		if (region.head > region.flushed)
+			region.buffer->FlushMemory(region.head - region.flushed, region.flushed);
+
+		region.outgrownSize += region.head;
+		region.outgrown.emplace_back(std::move(region.buffer));
+
+		region.buffer  = CreateBuffer(newSize);
+		region.head	   = 0U;
+		region.flushed = 0U;
+
+		m_Stats.grows++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef EN_STAGINGRING_HPP
+#define EN_STAGINGRING_HPP
+
+#include <Core/Types.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace en
+{
+	class MemoryBuffer;
+
+	// Persistently mapped memory the CPU writes and the GPU copies from, split into regions that are reused once the GPU is done
+	// with what they hold, e.g. one for every frame in flight. Writing into a region only bumps its offset, everything written
+	// since the last flush is flushed as a single range. A region that runs out of space grows instead of failing.
+	class StagingRing
+	{
+	public:
+		struct Allocation
+		{
+			VkBuffer	 buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0U;
+
+			void* data = nullptr;
+		};
+
+		struct Stats
+		{
+			// What the region took between being begun and its last flush, and the most any region ever took
+			VkDeviceSize usedSize	   = 0U;
+			VkDeviceSize highWaterMark = 0U;
+
+			// Of all regions together, it only changes when one of them grows
+			VkDeviceSize capacity = 0U;
+			uint32_t	 grows	  = 0U;
+		};
+
+		StagingRing(const uint32_t regions, const VkDeviceSize regionSize);
+
+		StagingRing(const StagingRing&) = delete;
+		StagingRing& operator=(const StagingRing&) = delete;
+
+		// For owners with a varying number of regions, returns the index of the new one
+		uint32_t AddRegion();
+
+		// The GPU has to be done with what the region held, everything from now on goes into it
+		void Begin(const uint32_t region);
+
+		// The offsets are aligned to nonCoherentAtomSize, so the flushed ranges of the regions never share an atom
+		Allocation Allocate(const VkDeviceSize size);
+		Allocation Write(const void* data, const VkDeviceSize size);
+
+		// Writes the data and records its copy into the buffer
+		void Upload(VkCommandBuffer cmd, const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset = 0U);
+
+		// Has to be called before the copies from the current region are submitted
+		void Flush();
+
+		// Of the current region, since it was begun
+		VkDeviceSize GetUsedSize() const;
+
+		const Stats& GetStats() const { return m_Stats; }
+
+	private:
+		static constexpr VkDeviceSize GROWTH_MULTIPLIER = 2U;
+		static constexpr VkDeviceSize MIN_ALIGNMENT		= 16U;
+
+		struct Region
+		{
+			Handle<MemoryBuffer> buffer;
+
+			VkDeviceSize head	 = 0U;
+			VkDeviceSize flushed = 0U;
+
+			// Outgrown while the GPU could still copy from them, they are released when the region is begun again
+			std::vector<Handle<MemoryBuffer>> outgrown;
+			VkDeviceSize					  outgrownSize = 0U;
+		};
+
+		std::vector<Region> m_Regions;
+		uint32_t			m_Current = 0U;
+
+		const VkDeviceSize m_RegionSize;
+		VkDeviceSize	   m_Alignment = 1U;
+
+		Stats m_Stats{};
+
+		Handle<MemoryBuffer> CreateBuffer(const VkDeviceSize size);
+
+		void Grow(Region& region, const VkDeviceSize size);
+	};
+}
+
+#endif
\ No newline at end of file
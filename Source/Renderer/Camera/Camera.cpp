@@ -25,14 +25,7 @@ namespace en
 
 	void Camera::UpdateProjMatrix()
 	{
-		if (m_DynamicallyScaled)
-		{
-			glm::ivec2 size = en::Window::Get().GetSize();
-
-			if (size.x * size.y <= 0) return;
-
-			m_Size = size;
-		}
+		if (m_Size.x * m_Size.y <= 0.0f) return;
 
 		m_Proj = glm::perspective(glm::radians(m_Fov), (float)m_Size.x / (float)m_Size.y, m_NearPlane, m_FarPlane);
 		m_Proj[1][1] *= -1;
@@ -7,9 +7,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_ENABLE_EXPERIMENTAL
 
-#include <Renderer/Window.hpp>
-#include <Common/Helpers.hpp>
-
+#include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
 
 namespace en
@@ -34,6 +32,7 @@ namespace en
 
 		float m_Exposure = 2.0f;
 
+		// The renderer keeps the size in line with the window
 		bool m_DynamicallyScaled = true;
 
 		const glm::mat4& GetProjMatrix() { UpdateProjMatrix(); return m_Proj; };
@@ -9,8 +9,9 @@ namespace en
 		{
 			buffer = MakeHandle<MemoryBuffer>(
 				sizeof(CameraBufferObject),
-				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-				VMA_MEMORY_USAGE_CPU_ONLY
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VMA_MEMORY_USAGE_GPU_ONLY,
+				true
 			);
 		}
 
@@ -29,9 +30,16 @@ namespace en
 		}
 	}
 
-	void CameraBuffer::MapBuffer(uint32_t frameIndex)
+	void CameraBuffer::UploadBuffer(uint32_t frameIndex, VkCommandBuffer cmd, StagingRing& staging)
 	{
-		m_Buffers[frameIndex]->MapMemory(&m_CBOs[frameIndex], m_Buffers[frameIndex]->GetSize());
+		staging.Upload(cmd, &m_CBOs[frameIndex], sizeof(CameraBufferObject), m_Buffers[frameIndex]->GetHandle());
+
+		// The compute queue waits for the submission of the copy, which makes it visible there as well
+		m_Buffers[frameIndex]->PipelineBarrier(
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_UNIFORM_READ_BIT,
+			VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			cmd
+		);
 	}
 
 	void CameraBuffer::UpdateBuffer(
@@ -40,6 +48,7 @@ namespace en
 		std::array<float, SHADOW_CASCADES>& cascadeSplitDistances,
 		std::array<float, SHADOW_CASCADES>& cascadeFrustumSizeRatios,
 		std::array<std::array<glm::mat4, SHADOW_CASCADES>, MAX_DIR_LIGHT_SHADOWS>& cascadeMatrices,
+		std::array<glm::vec4, MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES>& shadowAtlasRects,
 		VkExtent2D extent,
 		int debugMode
 	) {
@@ -68,6 +77,9 @@ namespace en
 				m_CBOs[frameIndex].cascadeMatrices[j][i] = cascadeMatrices[j][i];
 		}
 
+		for (uint32_t i = 0U; i < shadowAtlasRects.size(); i++)
+			m_CBOs[frameIndex].shadowAtlasRects[i] = shadowAtlasRects[i];
+
 		uint32_t sizeX = (uint32_t)std::ceilf((float)extent.width / CLUSTERED_TILES_X);
 		uint32_t sizeY = (uint32_t)std::ceilf((float)extent.height / CLUSTERED_TILES_Y);
 
@@ -4,6 +4,7 @@
 
 #include "../EruptionEngine.ini"
 #include <Renderer/Buffers/MemoryBuffer.hpp>
+#include <Renderer/Buffers/StagingRing.hpp>
 #include <Renderer/Camera/Camera.hpp>
 #include <Renderer/DescriptorSet.hpp>
 
@@ -15,7 +16,8 @@ namespace en
 		CameraBuffer();
 		~CameraBuffer(){};
 
-		void MapBuffer(uint32_t frameIndex);
+		// Copies the frame's constants through the staging ring, they are ready for every shader stage that reads them afterwards
+		void UploadBuffer(uint32_t frameIndex, VkCommandBuffer cmd, StagingRing& staging);
 
 		void UpdateBuffer(
 			uint32_t frameIndex,
@@ -23,6 +25,7 @@ namespace en
 			std::array<float, SHADOW_CASCADES>& cascadeSplitDistances,
 			std::array<float, SHADOW_CASCADES>& cascadeFrustumSizeRatios,
 			std::array<std::array<glm::mat4, SHADOW_CASCADES>, MAX_DIR_LIGHT_SHADOWS>& cascadeMatrices,
+			std::array<glm::vec4, MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES>& shadowAtlasRects,
 			VkExtent2D extent,
 			int debugMode
 		);
@@ -52,6 +55,9 @@ namespace en
 
 			glm::mat4 cascadeMatrices[MAX_DIR_LIGHT_SHADOWS][SHADOW_CASCADES]{};
 
+			// Offset (xy) and scale (zw) of the spot light tiles followed by the cascade tiles in the shadow atlas, zero for lights without a tile
+			glm::vec4 shadowAtlasRects[MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES]{};
+
 			float clusterScale = 0.0f;
 			float clusterBias = 0.0f;
 
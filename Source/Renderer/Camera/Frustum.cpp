@@ -0,0 +1,145 @@
+#include "Frustum.hpp"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+namespace en
+{
+	Frustum::Frustum(const glm::mat4& viewProj)
+	{
+		// Gribb-Hartmann plane extraction, expects a [0, 1] clip space depth range (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+		const glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+		const glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+		const glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+		const glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+		m_Planes[0] = row3 + row0;
+		m_Planes[1] = row3 - row0;
+		m_Planes[2] = row3 + row1;
+		m_Planes[3] = row3 - row1;
+		m_Planes[4] = row2;
+		m_Planes[5] = row3 - row2;
+
+		for (auto& plane : m_Planes)
+			plane /= glm::length(glm::vec3(plane));
+
+		for (uint32_t i = 0U; i < 8U; i++)
+			for (uint32_t j = 0U; j < 4U; j++)
+				m_PlanesSoA[j][i] = m_Planes[std::min(i, 5U)][j];
+
+		const glm::mat4 invViewProj = glm::inverse(viewProj);
+
+		for (uint32_t i = 0U; i < 8U; i++)
+		{
+			const glm::vec4 corner = invViewProj * glm::vec4(
+				(i & 1U) ? 1.0f : -1.0f,
+				(i & 2U) ? 1.0f : -1.0f,
+				(i & 4U) ? 1.0f :  0.0f,
+				1.0f
+			);
+
+			m_Corners[i] = glm::vec3(corner) / corner.w;
+		}
+	}
+
+	bool Frustum::IsSphereVisible(const glm::vec3& center, const float radius) const
+	{
+		for (const auto& plane : m_Planes)
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+
+		return true;
+	}
+	bool Frustum::IsAABBVisible(const AABB& box) const
+	{
+		const glm::vec3 center = (box.max + box.min) * 0.5f;
+		const glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+#if defined(__SSE__) || defined(_M_X64)
+		const __m128 cx = _mm_set1_ps(center.x);
+		const __m128 cy = _mm_set1_ps(center.y);
+		const __m128 cz = _mm_set1_ps(center.z);
+
+		const __m128 ex = _mm_set1_ps(extent.x);
+		const __m128 ey = _mm_set1_ps(extent.y);
+		const __m128 ez = _mm_set1_ps(extent.z);
+
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (uint32_t i = 0U; i < 8U; i += 4U)
+		{
+			const __m128 px = _mm_load_ps(&m_PlanesSoA[0][i]);
+			const __m128 py = _mm_load_ps(&m_PlanesSoA[1][i]);
+			const __m128 pz = _mm_load_ps(&m_PlanesSoA[2][i]);
+			const __m128 pw = _mm_load_ps(&m_PlanesSoA[3][i]);
+
+			// Signed distance of the box center to each plane
+			__m128 distance = _mm_add_ps(_mm_mul_ps(px, cx), pw);
+			distance = _mm_add_ps(_mm_mul_ps(py, cy), distance);
+			distance = _mm_add_ps(_mm_mul_ps(pz, cz), distance);
+
+			// Box extent projected onto each plane normal
+			__m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, px), ex);
+			radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, py), ey), radius);
+			radius = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, pz), ez), radius);
+
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())) != 0)
+				return false;
+		}
+#else
+		for (const auto& plane : m_Planes)
+		{
+			const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+			const float radius   = glm::dot(glm::abs(glm::vec3(plane)), extent);
+
+			if (distance + radius < 0.0f)
+				return false;
+		}
+#endif
+
+		return true;
+	}
+	bool Frustum::IntersectsFrustum(const Frustum& other) const
+	{
+		// Separating plane test, only the face planes of both frusta are checked
+		const auto AllOutside = [](const glm::vec4& plane, const std::array<glm::vec3, 8>& corners)
+		{
+			for (const auto& corner : corners)
+				if (glm::dot(glm::vec3(plane), corner) + plane.w >= 0.0f)
+					return false;
+
+			return true;
+		};
+
+		for (const auto& plane : m_Planes)
+			if (AllOutside(plane, other.m_Corners))
+				return false;
+
+		for (const auto& plane : other.m_Planes)
+			if (AllOutside(plane, m_Corners))
+				return false;
+
+		return true;
+	}
+
+	AABB AABB::Transform(const glm::mat4& matrix) const
+	{
+		const glm::vec3 center = (max + min) * 0.5f;
+		const glm::vec3 extent = (max - min) * 0.5f;
+
+		const glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+
+		const glm::mat3 absMatrix(glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])), glm::abs(glm::vec3(matrix[2])));
+		const glm::vec3 newExtent = absMatrix * extent;
+
+		return AABB{ newCenter - newExtent, newCenter + newExtent };
+	}
+	bool AABB::IntersectsSphere(const glm::vec3& center, const float radius) const
+	{
+		const glm::vec3 closest = glm::clamp(center, min, max);
+		const glm::vec3 offset = closest - center;
+
+		return glm::dot(offset, offset) <= radius * radius;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef EN_FRUSTUM_HPP
+#define EN_FRUSTUM_HPP
+
+#include <Renderer/Camera/Camera.hpp>
+
+#include <array>
+
+namespace en
+{
+	struct AABB
+	{
+		glm::vec3 min{};
+		glm::vec3 max{};
+
+		AABB Transform(const glm::mat4& matrix) const;
+
+		bool IntersectsSphere(const glm::vec3& center, const float radius) const;
+	};
+
+	struct Frustum
+	{
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProj);
+
+		// Left, right, bottom, top, near and far planes. The normals (xyz) point inwards and are normalized.
+		std::array<glm::vec4, 6> m_Planes{};
+
+		// World space corners, near plane first
+		std::array<glm::vec3, 8> m_Corners{};
+
+		bool IsSphereVisible(const glm::vec3& center, const float radius) const;
+		bool IsAABBVisible(const AABB& box) const;
+
+		// Conservative, may report an intersection for frusta that are close but do not overlap
+		bool IntersectsFrustum(const Frustum& other) const;
+
+	private:
+		// Planes transposed (x, y, z, w rows) so that four of them can be tested with one SSE instruction, the last two lanes repeat the far plane
+		alignas(16) std::array<std::array<float, 8>, 4> m_PlanesSoA{};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "CascadedShadowMaps.hpp"
+
+#include <Core/Profiler.hpp>
+
+namespace en
+{
+	// How far (relative to its radius) the camera can take a cascade before it's updated out of turn. The cascades that aren't
+	// updated every frame are made this much larger, so the part of the view they cover never leaves their shadow map.
+	constexpr float CASCADE_MAX_DRIFT = 0.05f;
+
+	void CascadedShadowMaps::Update(Camera& camera, const std::vector<DirectionalLight>& lights, const std::vector<uint32_t>& shadowCasters, const ShadowAtlas& atlas, const float cascadeFarPlane, const float splitWeight, const std::array<uint32_t, SHADOW_CASCADES>& updateIntervals, const uint32_t defaultResolution)
+	{
+		EN_PROFILE_FUNCTION();
+
+		// CSM Implementation heavily inspired with:
+		// Blaze engine by kidrigger - https://github.com/kidrigger/Blaze
+		// Flex Engine by ajweeks - https://github.com/ajweeks/FlexEngine
+
+
+		float ratio = cascadeFarPlane / camera.m_NearPlane;
+
+		for (int i = 1; i < SHADOW_CASCADES; i++)
+		{
+			float si = i / float(SHADOW_CASCADES);
+
+			float nearPlane = splitWeight * (
+				camera.m_NearPlane * powf(ratio, si)) + 
+				(1.0f - splitWeight) * (camera.m_NearPlane + 
+				(cascadeFarPlane - camera.m_NearPlane) * si
+			);
+
+			float farPlane = nearPlane * 1.005f;
+			cascadeSplitDistances[i - 1] = farPlane;
+		}
+
+		cascadeSplitDistances[SHADOW_CASCADES - 1] = cascadeFarPlane;
+
+		glm::vec4 frustumClipSpace[8]
+		{
+			{-1.0f, -1.0f, -1.0f, 1.0f},
+			{-1.0f,  1.0f, -1.0f, 1.0f},
+			{ 1.0f, -1.0f, -1.0f, 1.0f},
+			{ 1.0f,  1.0f, -1.0f, 1.0f},
+			{-1.0f, -1.0f,  1.0f, 1.0f},
+			{-1.0f,  1.0f,  1.0f, 1.0f},
+			{ 1.0f, -1.0f,  1.0f, 1.0f},
+			{ 1.0f,  1.0f,  1.0f, 1.0f},
+		};
+
+		glm::mat4 invViewProj = glm::inverse(camera.GetProjMatrix() * camera.GetViewMatrix());
+
+		for (auto& vert : frustumClipSpace)
+		{
+			vert = invViewProj * vert;
+			vert /= vert.w;
+		}
+
+		float cosine = glm::dot(glm::normalize(glm::vec3(frustumClipSpace[4]) - camera.m_Position), camera.GetFront());
+		glm::vec3 cornerRay = glm::normalize(glm::vec3(frustumClipSpace[4] - frustumClipSpace[0]));
+
+		float prevFarPlane = camera.m_NearPlane;
+
+		for (int i = 0; i < SHADOW_CASCADES; ++i)
+		{
+			float farPlane = cascadeSplitDistances[i];
+			float secTheta = 1.0f / cosine;
+			float cDist = 0.5f * (farPlane + prevFarPlane) * secTheta * secTheta;
+			cascadeCenters[i] = camera.GetFront() * cDist + camera.m_Position;
+
+			float nearRatio = prevFarPlane / cascadeFarPlane;
+			glm::vec3 corner = cornerRay * nearRatio + camera.m_Position;
+
+			// Rounded up, otherwise the precision errors would change the size of the texels (and shimmer) with every turn of the camera
+			cascadeRadiuses[i] = std::ceil(glm::distance(cascadeCenters[i], corner) * 16.0f) / 16.0f;
+
+			prevFarPlane = farPlane;
+		}
+
+		cascadeFrustumSizeRatios[0] = 1.0f;
+		for (int i = 1; i < SHADOW_CASCADES; i++)
+			cascadeFrustumSizeRatios[i] = cascadeRadiuses[i] / cascadeRadiuses[0];
+
+		frame++;
+
+		for (const auto& i : shadowCasters)
+		{
+			const DirectionalLight& light = lights[i];
+
+			const glm::vec3 lightDirection = glm::normalize(light.m_Direction + glm::vec3(0.00000127f));
+
+			for (uint32_t j = 0U; j < SHADOW_CASCADES; ++j)
+			{
+				float radius = cascadeRadiuses[j];
+				glm::vec3 center = cascadeCenters[j];
+
+				const uint32_t cascade  = light.m_ShadowmapIndex * SHADOW_CASCADES + j;
+				const uint32_t tileSize = atlas.GetTile(MAX_SPOT_LIGHT_SHADOWS + cascade).size;
+				const uint32_t interval = updateIntervals[j];
+
+				auto& state = cascadeStates[cascade];
+
+				// The cascades are due on different frames (when their interval allows it), so the far ones don't all get redrawn on the
+				// same one. In between they keep their matrix, unless it no longer fits the light, the tile or the camera.
+				state.updated = (frame + j) % interval == 0U ||
+					state.tileSize != tileSize || state.interval != interval ||
+					state.lightDirection != lightDirection || state.radius != radius ||
+					glm::distance(state.center, center) > radius * CASCADE_MAX_DRIFT;
+
+				if (!state.updated)
+					continue;
+
+				state.center		 = center;
+				state.radius		 = radius;
+				state.lightDirection = lightDirection;
+				state.tileSize		 = tileSize;
+				state.interval		 = interval;
+
+				// The camera can drift up to the margin in any direction before the cascade is redrawn, along the light too, so the
+				// depth range grows by it on both ends as well
+				const float extent = interval > 1U ? radius * (1.0f + CASCADE_MAX_DRIFT) : radius;
+				const float margin = extent - radius;
+
+				glm::mat4 lightProj = glm::ortho(-extent, extent, -extent, extent, -margin, light.m_FarPlane * radius + margin);
+				glm::mat4 lightView = glm::lookAt(center - (light.m_FarPlane - 1.0f) * -lightDirection * radius, center, glm::vec3(0, 1, 0));
+
+				// Snapped to the texels of the cascade's tile in the atlas
+				const float resolution = float(tileSize != 0U ? tileSize : defaultResolution);
+
+				glm::mat4 shadowViewProj = lightProj * lightView;
+				glm::vec4 shadowOrigin = shadowViewProj * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) * resolution / 2.0f;
+
+				glm::vec4 shadowOffset = (glm::round(shadowOrigin) - shadowOrigin) * 2.0f / resolution * glm::vec4(1, 1, 0, 0);
+
+				glm::mat4 shadowProj = lightProj;
+				shadowProj[3] += shadowOffset;
+
+				cascadeMatrices[light.m_ShadowmapIndex][j] = shadowProj * lightView;
+			}
+		}
+	}
+}
\ No newline at end of file
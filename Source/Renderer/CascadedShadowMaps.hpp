@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef EN_CASCADEDSHADOWMAPS_HPP
+#define EN_CASCADEDSHADOWMAPS_HPP
+
+#include "../../EruptionEngine.ini"
+
+#include <Renderer/Camera/Camera.hpp>
+#include <Renderer/Lights/DirectionalLight.hpp>
+#include <Renderer/ShadowAtlas.hpp>
+
+#include <array>
+#include <vector>
+
+namespace en
+{
+	// Splits the camera's view into SHADOW_CASCADES spheres and fits the matrices of every directional light that casts shadows
+	// to them. Only does the math, the renderer draws the cascades into its shadow atlas with the matrices it leaves behind.
+	class CascadedShadowMaps
+	{
+	public:
+		// The cascades of the light with m_ShadowmapIndex i take the atlas slots from MAX_SPOT_LIGHT_SHADOWS + i * SHADOW_CASCADES,
+		// the ones without a tile get the default resolution
+		void Update(Camera& camera, const std::vector<DirectionalLight>& lights, const std::vector<uint32_t>& shadowCasters, const ShadowAtlas& atlas, const float cascadeFarPlane, const float splitWeight, const std::array<uint32_t, SHADOW_CASCADES>& updateIntervals, const uint32_t defaultResolution);
+
+		std::array<std::array<glm::mat4, SHADOW_CASCADES>, MAX_DIR_LIGHT_SHADOWS> cascadeMatrices{};
+
+		std::array<float, SHADOW_CASCADES> cascadeSplitDistances{};
+		std::array<float, SHADOW_CASCADES> cascadeFrustumSizeRatios{};
+
+		std::array<glm::vec3, SHADOW_CASCADES> cascadeCenters{};
+		std::array<float, SHADOW_CASCADES> cascadeRadiuses{};
+
+		// What the matrix of every cascade was last computed from, indexed like the atlas slots of the cascades
+		struct CascadeState {
+			glm::vec3 center{};
+			float	  radius = 0.0f;
+
+			glm::vec3 lightDirection{};
+
+			uint32_t tileSize = 0U;
+			uint32_t interval = 0U;
+
+			bool updated = false; // This frame
+		};
+
+		std::array<CascadeState, MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES> cascadeStates{};
+
+		uint64_t frame = 0U;
+	};
+}
+
+#endif
\ No newline at end of file
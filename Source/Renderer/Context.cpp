@@ -1,29 +1,44 @@
 #include "Context.hpp"
 
+#include "../../EruptionEngine.ini"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
 en::Context* g_CurrentContext = nullptr;
 
+constexpr const char* PIPELINE_CACHE_PATH = "PipelineCache.bin";
+
 constexpr std::array<const char*, 1> validationLayers {
 	"VK_LAYER_KHRONOS_validation"
 };
-constexpr std::array<const char*, 2> deviceExtensions {
-	VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+constexpr std::array<const char*, 1> deviceExtensions {
 	VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME
 };
+constexpr std::array<const char*, 1> presentDeviceExtensions {
+	VK_KHR_SWAPCHAIN_EXTENSION_NAME
+};
 constexpr VkPhysicalDeviceVulkan13Features deviceFeaturesVK1_3{
 	.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
 	.pNext = (void*)nullptr,
+	.synchronization2 = VK_TRUE,
 	.dynamicRendering = VK_TRUE,
 };
 constexpr VkPhysicalDeviceVulkan12Features deviceFeaturesVK1_2{
 	.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
 	.pNext = (void*)&deviceFeaturesVK1_3,
+	.drawIndirectCount = VK_TRUE,
 	.descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+	.timelineSemaphore = VK_TRUE,
 };
 constexpr VkPhysicalDeviceVulkan11Features deviceFeaturesVK1_1{
 	.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
 	.pNext = (void*)&deviceFeaturesVK1_2,
 };
 constexpr VkPhysicalDeviceFeatures deviceFeatures {
+	.multiDrawIndirect = VK_TRUE,
+	.drawIndirectFirstInstance = VK_TRUE,
 	.samplerAnisotropy = VK_TRUE,
 };
 
@@ -35,23 +50,29 @@ constexpr bool enableValidationLayers = false;
 
 namespace en
 {
-	Context::Context()
+	Context::Context(const bool headless) : m_Headless(headless)
 	{
 		g_CurrentContext = this;
 		
 		CreateInstance();
 		CreateDebugMessenger();
-		CreateWindowSurface();
+
+		if (!m_Headless)
+			CreateWindowSurface();
+
 		PickPhysicalDevice();
 		CreateLogicalDevice();
 		InitVMA();
 		CreateCommandPool();
 		CreateDescriptorAllocator();
+		CreateUploadQueue();
+		CreatePipelineCache();
 
 		EN_SUCCESS("Created the Vulkan context");
 	}
 	Context::~Context()
 	{
+		m_UploadQueue.reset();
 		m_DescriptorAllocator.reset();
 
 		vmaDestroyAllocator(m_Allocator);
@@ -59,14 +80,20 @@ namespace en
 		vkDeviceWaitIdle(m_LogicalDevice);
 
 		vkDestroyCommandPool(m_LogicalDevice, m_GraphicsCommandPool, nullptr);
-		vkDestroyCommandPool(m_LogicalDevice, m_TransferCommandPool, nullptr);
+		vkDestroyCommandPool(m_LogicalDevice, m_ComputeCommandPool, nullptr);
+
+		SavePipelineCache();
+
+		vkDestroyPipelineCache(m_LogicalDevice, m_PipelineCache, nullptr);
 
 		vkDestroyDevice(m_LogicalDevice, nullptr);
 
 	    if constexpr (enableValidationLayers)
 			DestroyDebugUtilsMessengerEXT();
 
-		vkDestroySurfaceKHR(m_Instance, m_WindowSurface, nullptr);
+		if (!m_Headless)
+			vkDestroySurfaceKHR(m_Instance, m_WindowSurface, nullptr);
+
 		vkDestroyInstance(m_Instance, nullptr);
 		
 		glfwTerminate();
@@ -154,6 +181,23 @@ namespace en
 				m_PhysicalDevice = device;
 				m_PhysicalDeviceName = properties.deviceName;
 				EN_SUCCESS("Picked " + m_PhysicalDeviceName + " as the physical device!");
+
+				VkPhysicalDeviceVulkan11Features supportedFeaturesVK1_1{
+					.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+				};
+				VkPhysicalDeviceFeatures2 supportedFeatures{
+					.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+					.pNext = (void*)&supportedFeaturesVK1_1,
+				};
+
+				vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
+
+				// Optional, the renderer falls back to one pass per cube face without it
+				m_MultiviewSupported = supportedFeaturesVK1_1.multiview;
+
+				if (!m_MultiviewSupported)
+					EN_WARN("Context::PickPhysicalDevice() - Multiview is not supported, point light shadows will be rendered one face at a time!");
+
 				break;
 			}
 			else
@@ -171,6 +215,9 @@ namespace en
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
+		// Left over from the previous device otherwise
+		m_QueueFamilies = {};
+
 		for (uint32_t i = 0U; const auto& queueFamily : queueFamilies)
 		{
 			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
@@ -179,8 +226,16 @@ namespace en
 			if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
 				m_QueueFamilies.transfer = i;
 
-			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_WindowSurface, &presentSupport);
+#if ASYNC_COMPUTE
+			if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+				m_QueueFamilies.compute = i;
+#endif
+
+			// Nothing gets presented without a window, the graphics queue stands in for the present queue
+			VkBool32 presentSupport = m_Headless && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+
+			if (!m_Headless)
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_WindowSurface, &presentSupport);
 
 			if (presentSupport)
 				m_QueueFamilies.present = i;
@@ -193,6 +248,10 @@ namespace en
 
 		if (!m_QueueFamilies.transfer.has_value() && m_QueueFamilies.graphics.has_value())
 			m_QueueFamilies.transfer = m_QueueFamilies.graphics;
+
+		// Single queue devices and software drivers run the compute passes on the graphics queue, in the same command buffers
+		if (!m_QueueFamilies.compute.has_value() && m_QueueFamilies.graphics.has_value())
+			m_QueueFamilies.compute = m_QueueFamilies.graphics;
 	}
 	void Context::CreateLogicalDevice()
 	{
@@ -200,7 +259,8 @@ namespace en
 		std::set<uint32_t> uniqueQueueFamilies = { 
 			m_QueueFamilies.graphics.value(), 
 			m_QueueFamilies.transfer.value(), 
-			m_QueueFamilies.present.value() 
+			m_QueueFamilies.present.value(),
+			m_QueueFamilies.compute.value()
 		};
 
 		float queuePriority = 1.0f;
@@ -215,14 +275,19 @@ namespace en
 			queueCreateInfos.emplace_back(queueCreateInfo);
 		}
 
+		const auto extensions = GetRequiredDeviceExtensions();
+
+		VkPhysicalDeviceVulkan11Features featuresVK1_1 = deviceFeaturesVK1_1;
+		featuresVK1_1.multiview = m_MultiviewSupported;
+
 		VkDeviceCreateInfo createInfo{
 			.sType					 = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-			.pNext					 = &deviceFeaturesVK1_1,
+			.pNext					 = &featuresVK1_1,
 			.queueCreateInfoCount	 = static_cast<uint32_t>(queueCreateInfos.size()),
 			.pQueueCreateInfos		 = queueCreateInfos.data(),
 			.enabledLayerCount		 = 0U,
-			.enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size()),
-			.ppEnabledExtensionNames = deviceExtensions.data(),
+			.enabledExtensionCount   = static_cast<uint32_t>(extensions.size()),
+			.ppEnabledExtensionNames = extensions.data(),
 			.pEnabledFeatures		 = &deviceFeatures,
 		};
 
@@ -238,6 +303,10 @@ namespace en
 		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilies.graphics.value(), 0U, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilies.transfer.value(), 0U, &m_TransferQueue);
 		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilies.present.value(), 0U, &m_PresentQueue);
+		vkGetDeviceQueue(m_LogicalDevice, m_QueueFamilies.compute.value(), 0U, &m_ComputeQueue);
+
+		if (HasAsyncCompute())
+			EN_LOG("The compute passes run on a queue of their own (family " + std::to_string(m_QueueFamilies.compute.value()) + ")");
 	}
 
 	void Context::InitVMA()
@@ -262,19 +331,144 @@ namespace en
 		if (vkCreateCommandPool(m_LogicalDevice, &commandPoolCreateInfo, nullptr, &m_GraphicsCommandPool) != VK_SUCCESS)
 			EN_ERROR("Context::VKCreateCommandPool() - Failed to create a graphics command pool!");
 
-		const VkCommandPoolCreateInfo transferCommandPoolCreateInfo{
+		const VkCommandPoolCreateInfo computeCommandPoolCreateInfo{
 			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
 			.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-			.queueFamilyIndex = m_QueueFamilies.transfer.value(),
+			.queueFamilyIndex = m_QueueFamilies.compute.value(),
 		};
 
-		if (vkCreateCommandPool(m_LogicalDevice, &transferCommandPoolCreateInfo, nullptr, &m_TransferCommandPool) != VK_SUCCESS)
-			EN_ERROR("Context::VKCreateCommandPool() - Failed to create a transfer command pool!");
+		if (vkCreateCommandPool(m_LogicalDevice, &computeCommandPoolCreateInfo, nullptr, &m_ComputeCommandPool) != VK_SUCCESS)
+			EN_ERROR("Context::VKCreateCommandPool() - Failed to create a compute command pool!");
 	}
 	void Context::CreateDescriptorAllocator()
 	{
 		m_DescriptorAllocator = MakeScope<DescriptorAllocator>(m_LogicalDevice);
 	}
+	void Context::CreateUploadQueue()
+	{
+		m_UploadQueue = MakeScope<UploadQueue>();
+	}
+	void Context::CreatePipelineCache()
+	{
+		const std::vector<char> data = LoadPipelineCacheData();
+
+		const VkPipelineCacheCreateInfo createInfo{
+			.sType			 = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.initialDataSize = data.size(),
+			.pInitialData	 = data.data(),
+		};
+
+		if (vkCreatePipelineCache(m_LogicalDevice, &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+			EN_ERROR("Context::CreatePipelineCache() - Failed to create the pipeline cache!");
+
+		m_PipelineCacheLoaded = !data.empty();
+	}
+
+	std::vector<char> Context::LoadPipelineCacheData()
+	{
+		std::ifstream file(PIPELINE_CACHE_PATH, std::ios::ate | std::ios::binary);
+
+		if (!file.is_open())
+		{
+			EN_LOG("There is no pipeline cache on disk yet, the pipelines will be created from scratch");
+			return std::vector<char>{};
+		}
+
+		std::vector<char> data(static_cast<size_t>(file.tellg()));
+
+		file.seekg(0);
+		file.read(data.data(), data.size());
+
+		VkPipelineCacheHeaderVersionOne header{};
+
+		if (data.size() < sizeof(header))
+		{
+			EN_WARN("Context::LoadPipelineCacheData() - The pipeline cache on disk is truncated, it will be replaced!");
+			return std::vector<char>{};
+		}
+
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+
+		// Drivers should reject foreign data on their own, but not all of them do so gracefully
+		if (header.headerSize < sizeof(header) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+			header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+			std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		{
+			EN_LOG("The pipeline cache on disk was written by another device or driver, it will be replaced");
+			return std::vector<char>{};
+		}
+
+		EN_LOG("Loaded " + std::to_string(data.size()) + " bytes of pipeline cache");
+
+		return data;
+	}
+	void Context::SavePipelineCache()
+	{
+		size_t size = 0U;
+		vkGetPipelineCacheData(m_LogicalDevice, m_PipelineCache, &size, nullptr);
+
+		std::vector<char> data(size);
+
+		if (vkGetPipelineCacheData(m_LogicalDevice, m_PipelineCache, &size, data.data()) != VK_SUCCESS)
+		{
+			EN_WARN("Context::SavePipelineCache() - Failed to get the pipeline cache data!");
+			return;
+		}
+
+		std::ofstream file(PIPELINE_CACHE_PATH, std::ios::binary);
+
+		if (!file.is_open())
+		{
+			EN_WARN("Context::SavePipelineCache() - Failed to open \"" + std::string(PIPELINE_CACHE_PATH) + "\" for writing!");
+			return;
+		}
+
+		file.write(data.data(), size);
+
+		EN_LOG("Saved " + std::to_string(size) + " bytes of pipeline cache");
+	}
+
+	VkResult Context::CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline& pipeline)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const VkResult result = vkCreateGraphicsPipelines(m_LogicalDevice, m_PipelineCache, 1U, &createInfo, nullptr, &pipeline);
+
+		AddPipelineCreationTime(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		return result;
+	}
+	VkResult Context::CreateComputePipeline(const VkComputePipelineCreateInfo& createInfo, VkPipeline& pipeline)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const VkResult result = vkCreateComputePipelines(m_LogicalDevice, m_PipelineCache, 1U, &createInfo, nullptr, &pipeline);
+
+		AddPipelineCreationTime(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		return result;
+	}
+	void Context::WaitIdle()
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		vkDeviceWaitIdle(m_LogicalDevice);
+	}
+
+	Context::PipelineStats Context::GetPipelineStats()
+	{
+		std::lock_guard<std::mutex> lock(m_PipelineStatsMutex);
+		return m_PipelineStats;
+	}
+	void Context::AddPipelineCreationTime(const float time)
+	{
+		std::lock_guard<std::mutex> lock(m_PipelineStatsMutex);
+
+		m_PipelineStats.count++;
+		m_PipelineStats.creationTime += time;
+	}
 
 	bool Context::AreValidationLayerSupported()
 	{
@@ -305,16 +499,47 @@ namespace en
 	}
 	std::vector<const char*> Context::GetRequiredExtensions()
 	{
-		uint32_t glfwExtensionCount = 0U;
-		const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		std::vector<const char*> extensions;
 
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		// The surface extensions are only needed to present to the window
+		if (!m_Headless)
+		{
+			uint32_t glfwExtensionCount = 0U;
+			const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-		if constexpr (enableValidationLayers)
+			extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
+
+		m_DebugUtilsSupported = IsInstanceExtensionSupported(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+		if (enableValidationLayers || m_DebugUtilsSupported)
 			extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
 		return extensions;
 	}
+	std::vector<const char*> Context::GetRequiredDeviceExtensions()
+	{
+		std::vector<const char*> extensions(deviceExtensions.begin(), deviceExtensions.end());
+
+		if (!m_Headless)
+			extensions.insert(extensions.end(), presentDeviceExtensions.begin(), presentDeviceExtensions.end());
+
+		return extensions;
+	}
+	bool Context::IsInstanceExtensionSupported(const char* extensionName)
+	{
+		uint32_t extensionCount = 0U;
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& extension : availableExtensions)
+			if (strcmp(extensionName, extension.extensionName) == 0)
+				return true;
+
+		return false;
+	}
 
 	VkResult Context::CreateDebugUtilsMessengerEXT(const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo)
 	{
@@ -371,8 +596,8 @@ namespace en
 
 		bool extensionsSupported = CheckDeviceExtensionSupport(device);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported)
+		bool swapChainAdequate = m_Headless;
+		if (extensionsSupported && !m_Headless)
 		{
 			SwapchainSupportDetails swapChainSupport;
 
@@ -411,7 +636,9 @@ namespace en
 		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-		std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+		const auto extensions = GetRequiredDeviceExtensions();
+
+		std::set<std::string> requiredExtensions(extensions.begin(), extensions.end());
 
 		for (const auto& extension : availableExtensions)
 			requiredExtensions.erase(extension.extensionName);
@@ -440,6 +667,8 @@ namespace en
 		supportedFeatures.pNext = (void*)&supportedFeaturesVK1_3;
 		vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
 
-		return supportedFeatures.features.samplerAnisotropy && supportedFeaturesVK1_3.dynamicRendering && supportedFeaturesVK1_2.descriptorBindingUpdateUnusedWhilePending;
+		return supportedFeatures.features.samplerAnisotropy && supportedFeaturesVK1_3.dynamicRendering && supportedFeaturesVK1_3.synchronization2 && supportedFeaturesVK1_2.descriptorBindingUpdateUnusedWhilePending &&
+			   supportedFeatures.features.multiDrawIndirect && supportedFeatures.features.drawIndirectFirstInstance && supportedFeaturesVK1_2.drawIndirectCount &&
+			   supportedFeaturesVK1_2.timelineSemaphore;
 	}
 }
\ No newline at end of file
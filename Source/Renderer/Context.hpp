@@ -4,6 +4,7 @@
 #define EN_CONTEXT_HPP
 
 #include <Renderer/DescriptorAllocator.hpp>
+#include <Renderer/UploadQueue.hpp>
 #include <Renderer/Window.hpp>
 #include <Core/Types.hpp>
 
@@ -11,6 +12,7 @@
 
 #include <set>
 #include <array>
+#include <mutex>
 #include <vector>
 
 namespace en
@@ -25,7 +27,8 @@ namespace en
 	class Context
 	{
 	public:
-		Context();
+		// Without a window there is no surface and no swapchain, the renderer draws into an offscreen target instead
+		Context(const bool headless = false);
 		~Context();
 
 		VkInstance				 m_Instance;
@@ -36,13 +39,23 @@ namespace en
 		VkPhysicalDevice m_PhysicalDevice;
 
 		VkCommandPool m_GraphicsCommandPool;
-		VkCommandPool m_TransferCommandPool;
+		VkCommandPool m_ComputeCommandPool;
 
 		VkQueue	m_GraphicsQueue;
 		VkQueue	m_TransferQueue;
 		VkQueue	m_PresentQueue;
+		VkQueue	m_ComputeQueue;
+
+		// Locked around every submission, present and wait for idle, the upload queue submits from the loader threads and the
+		// queues of different families can be the same one
+		std::mutex m_QueueMutex;
 
 		Scope<DescriptorAllocator> m_DescriptorAllocator;
+		// The transfer queue is only submitted to through it
+		Scope<UploadQueue>		   m_UploadQueue;
+
+		// Shared by every pipeline, loaded from PIPELINE_CACHE_PATH and saved back when the context is destroyed
+		VkPipelineCache m_PipelineCache;
 
 		VmaAllocator m_Allocator;
 
@@ -51,17 +64,51 @@ namespace en
 			std::optional<uint32_t> graphics;
 			std::optional<uint32_t> transfer;
 			std::optional<uint32_t> present;
+			std::optional<uint32_t> compute;
 
 			bool IsComplete()
 			{
-				return graphics.has_value() && present.has_value() && transfer.has_value();
+				return graphics.has_value() && present.has_value() && transfer.has_value() && compute.has_value();
 			}
 		} m_QueueFamilies;
 
+		struct PipelineStats
+		{
+			uint32_t count = 0U;
+
+			// In milliseconds, summed over every pipeline
+			float creationTime = 0.0f;
+		};
+
 		static Context& Get();
 
+		// Create the pipeline through the cache and add its creation time to the stats, can be called from any thread
+		VkResult CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline& pipeline);
+		VkResult CreateComputePipeline (const VkComputePipelineCreateInfo&  createInfo, VkPipeline& pipeline);
+
+		void SavePipelineCache();
+
+		// vkDeviceWaitIdle() under the queue mutex
+		void WaitIdle();
+
+		PipelineStats GetPipelineStats();
+
+		// Warm once it was loaded from disk or a pipeline was created with it already
+		const bool IsPipelineCacheWarm() { return m_PipelineCacheLoaded || GetPipelineStats().count > 0U; };
+
 		const std::string& GetPhysicalDeviceName() const { return m_PhysicalDeviceName; };
 
+		const bool IsMultiviewSupported() const { return m_MultiviewSupported; };
+
+		// The compute queue is from a family without graphics, so its work can overlap the graphics queue. Otherwise the compute
+		// family falls back to the graphics one and there is nothing to overlap.
+		const bool HasAsyncCompute() const { return m_QueueFamilies.compute != m_QueueFamilies.graphics; };
+
+		const bool IsHeadless() const { return m_Headless; };
+
+		// Enabled outside of the validation layers too, so the command buffer labels show up in capture tools
+		const bool IsDebugUtilsSupported() const { return m_DebugUtilsSupported; };
+
 	private:
 		void CreateInstance();
 		void CreateDebugMessenger();
@@ -72,12 +119,29 @@ namespace en
 		void InitVMA();
 		void CreateCommandPool();
 		void CreateDescriptorAllocator();
-
+		void CreateUploadQueue();
+		void CreatePipelineCache();
 
 		std::string m_PhysicalDeviceName;
 
+		const bool m_Headless;
+
+		bool m_MultiviewSupported  = false;
+		bool m_DebugUtilsSupported = false;
+
+		bool		  m_PipelineCacheLoaded = false;
+		PipelineStats m_PipelineStats{};
+		std::mutex	  m_PipelineStatsMutex;
+
+		void AddPipelineCreationTime(const float time);
+
+		// Empty when there is no cache on disk or it was written by another device or driver
+		std::vector<char> LoadPipelineCacheData();
+
 		bool AreValidationLayerSupported();
+		bool IsInstanceExtensionSupported(const char* extensionName);
 		std::vector<const char*> GetRequiredExtensions();
+		std::vector<const char*> GetRequiredDeviceExtensions();
 
 		VkResult CreateDebugUtilsMessengerEXT(const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo);
 		VkDebugUtilsMessengerCreateInfoEXT CreateDebugMessengerCreateInfo();
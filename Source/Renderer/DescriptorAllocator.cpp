@@ -50,64 +50,55 @@ namespace en
 		vkDestroyDescriptorPool(m_LogicalDevice, m_DescriptorPool, nullptr);
 	}
 
-	VkDescriptorSetLayout DescriptorAllocator::MakeLayout(const DescriptorInfo& descriptorInfo)
+	VkDescriptorSetLayout DescriptorAllocator::CreateLayout(const DescriptorInfo& descriptorInfo)
 	{
-		if (m_LayoutMap.contains(descriptorInfo))
+		VkDescriptorSetLayout newLayout = VK_NULL_HANDLE;
+
+		std::vector<VkDescriptorSetLayoutBinding> bindings(descriptorInfo.imageInfos.size() + descriptorInfo.bufferInfos.size());
+
+		for (const auto& image : descriptorInfo.imageInfos)
 		{
-			return m_LayoutMap.at(descriptorInfo);
+			bindings[image.index] = VkDescriptorSetLayoutBinding{
+				.binding			= image.index,
+				.descriptorType		= image.type,
+				.descriptorCount	= image.count,
+				.stageFlags			= image.stage,
+				.pImmutableSamplers = nullptr
+			};
 		}
-		else
+
+		for (const auto& buffer : descriptorInfo.bufferInfos)
 		{
-			VkDescriptorSetLayout newLayout = VK_NULL_HANDLE;
-
-			std::vector<VkDescriptorSetLayoutBinding> bindings(descriptorInfo.imageInfos.size() + descriptorInfo.bufferInfos.size());
-
-			for (const auto& image : descriptorInfo.imageInfos)
-			{
-				bindings[image.index] = VkDescriptorSetLayoutBinding{
-					.binding			= image.index,
-					.descriptorType		= image.type,
-					.descriptorCount	= image.count,
-					.stageFlags			= image.stage,
-					.pImmutableSamplers = nullptr
-				};
-			}
-
-			for (const auto& buffer : descriptorInfo.bufferInfos)
-			{
-				bindings[buffer.index] = VkDescriptorSetLayoutBinding{
-					.binding			= buffer.index,
-					.descriptorType		= buffer.type,
-					.descriptorCount	= 1U,
-					.stageFlags			= buffer.stage,
-					.pImmutableSamplers = nullptr
-				};
-			}
-
-			std::vector<VkDescriptorBindingFlags> flags{};
-			flags.resize(bindings.size(), descriptorInfo.bindingFlags);
-
-			VkDescriptorSetLayoutBindingFlagsCreateInfo flagsCreateInfo {
-				.sType		   = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
-				.bindingCount  = static_cast<uint32_t>(flags.size()),
-				.pBindingFlags = flags.data(),
+			bindings[buffer.index] = VkDescriptorSetLayoutBinding{
+				.binding			= buffer.index,
+				.descriptorType		= buffer.type,
+				.descriptorCount	= 1U,
+				.stageFlags			= buffer.stage,
+				.pImmutableSamplers = nullptr
 			};
+		}
 
-			VkDescriptorSetLayoutCreateInfo layoutInfo {
-				.sType		  = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-				.pNext		  = &flagsCreateInfo,
-				.flags		  = descriptorInfo.layoutFlags,
-				.bindingCount = static_cast<uint32_t>(bindings.size()),
-				.pBindings	  = bindings.data(),
-			};
+		std::vector<VkDescriptorBindingFlags> flags{};
+		flags.resize(bindings.size(), descriptorInfo.bindingFlags);
 
-			if (vkCreateDescriptorSetLayout(m_LogicalDevice, &layoutInfo, nullptr, &newLayout) != VK_SUCCESS)
-				EN_ERROR("DescriptorAllocator::MakeLayout() - Failed to create descriptor set layout!");
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsCreateInfo {
+			.sType		   = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.bindingCount  = static_cast<uint32_t>(flags.size()),
+			.pBindingFlags = flags.data(),
+		};
 
-			m_LayoutMap[descriptorInfo] = newLayout;
+		VkDescriptorSetLayoutCreateInfo layoutInfo {
+			.sType		  = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext		  = &flagsCreateInfo,
+			.flags		  = descriptorInfo.layoutFlags,
+			.bindingCount = static_cast<uint32_t>(bindings.size()),
+			.pBindings	  = bindings.data(),
+		};
 
-			return newLayout;
-		}
+		if (vkCreateDescriptorSetLayout(m_LogicalDevice, &layoutInfo, nullptr, &newLayout) != VK_SUCCESS)
+			EN_ERROR("DescriptorAllocator::CreateLayout() - Failed to create descriptor set layout!");
+
+		return newLayout;
 	}
 
 	VkDescriptorSet DescriptorAllocator::MakeSet(const DescriptorInfo& descriptorInfo)
@@ -0,0 +1,16 @@
+#include "DescriptorLayoutCache.hpp"
+
+namespace en
+{
+	VkDescriptorSetLayout DescriptorLayoutCache::MakeLayout(const DescriptorInfo& descriptorInfo)
+	{
+		if (m_LayoutMap.contains(descriptorInfo))
+			return m_LayoutMap.at(descriptorInfo);
+
+		const VkDescriptorSetLayout newLayout = CreateLayout(descriptorInfo);
+
+		m_LayoutMap[descriptorInfo] = newLayout;
+
+		return newLayout;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef EN_DESCRIPTORLAYOUTCACHE_HPP
+#define EN_DESCRIPTORLAYOUTCACHE_HPP
+
+#include <Renderer/DescriptorInfo.hpp>
+
+#include <unordered_map>
+
+namespace en
+{
+	// Keeps one layout per DescriptorInfo, the layouts are only created through CreateLayout(). DescriptorAllocator creates them on
+	// the device, the CPU benchmark times the lookups with a mock of it.
+	class DescriptorLayoutCache
+	{
+	public:
+		virtual ~DescriptorLayoutCache() = default;
+
+		VkDescriptorSetLayout MakeLayout(const DescriptorInfo& descriptorInfo);
+
+	protected:
+		virtual VkDescriptorSetLayout CreateLayout(const DescriptorInfo& descriptorInfo) = 0;
+
+		std::unordered_map<DescriptorInfo, VkDescriptorSetLayout, DescriptorInfo::Hash> m_LayoutMap;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "GPUProfiler.hpp"
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace en
+{
+	GPUProfiler::GPUProfiler()
+	{
+		UseContext();
+
+		if (ctx.IsDebugUtilsSupported())
+		{
+			m_CmdBeginDebugUtilsLabel = (PFN_vkCmdBeginDebugUtilsLabelEXT)vkGetInstanceProcAddr(ctx.m_Instance, "vkCmdBeginDebugUtilsLabelEXT");
+			m_CmdEndDebugUtilsLabel	  = (PFN_vkCmdEndDebugUtilsLabelEXT)vkGetInstanceProcAddr(ctx.m_Instance, "vkCmdEndDebugUtilsLabelEXT");
+		}
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(ctx.m_PhysicalDevice, &properties);
+
+		uint32_t queueFamilyCount = 0U;
+		vkGetPhysicalDeviceQueueFamilyProperties(ctx.m_PhysicalDevice, &queueFamilyCount, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(ctx.m_PhysicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		const uint32_t validBits		= queueFamilies[ctx.m_QueueFamilies.graphics.value()].timestampValidBits;
+		const uint32_t computeValidBits = queueFamilies[ctx.m_QueueFamilies.compute.value()].timestampValidBits;
+
+		m_Supported = validBits > 0U && properties.limits.timestampPeriod > 0.0f;
+
+		if (!m_Supported)
+		{
+			EN_WARN("GPUProfiler::GPUProfiler() - The graphics queue doesn't support timestamps, GPU timings won't be available!");
+			return;
+		}
+
+		m_TimestampPeriod = properties.limits.timestampPeriod;
+		m_TimestampMask	  = validBits >= 64U ? UINT64_MAX : (1ULL << validBits) - 1ULL;
+
+		m_ComputeTimestampMask = computeValidBits >= 64U ? UINT64_MAX : (1ULL << computeValidBits) - 1ULL;
+
+		if (m_ComputeTimestampMask == 0U && ctx.HasAsyncCompute())
+			EN_WARN("GPUProfiler::GPUProfiler() - The compute queue doesn't support timestamps, the async compute passes won't be timed!");
+
+		const VkQueryPoolCreateInfo createInfo{
+			.sType		= VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			.queryType	= VK_QUERY_TYPE_TIMESTAMP,
+			.queryCount = MAX_SCOPES * 2U,
+		};
+
+		for (auto& frame : m_Frames)
+			if (vkCreateQueryPool(ctx.m_LogicalDevice, &createInfo, nullptr, &frame.queryPool) != VK_SUCCESS)
+				EN_ERROR("GPUProfiler::GPUProfiler() - Failed to create a timestamp query pool!");
+	}
+	GPUProfiler::~GPUProfiler()
+	{
+		for (auto& frame : m_Frames)
+			vkDestroyQueryPool(Context::Get().m_LogicalDevice, frame.queryPool, nullptr);
+	}
+
+	void GPUProfiler::BeginFrame(VkCommandBuffer cmd, const uint32_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+		m_OpenScopes.clear();
+
+		if (!m_Supported) return;
+
+		auto& frame = m_Frames[m_FrameIndex];
+
+		ReadResults(frame);
+
+		frame.scopeNames.clear();
+		frame.scopeDepths.clear();
+		frame.scopeMasks.clear();
+
+		vkCmdResetQueryPool(cmd, frame.queryPool, 0U, MAX_SCOPES * 2U);
+	}
+	void GPUProfiler::BeginScope(VkCommandBuffer cmd, const char* name, const bool label)
+	{
+		BeginQueueScope(cmd, name, label, m_TimestampMask);
+	}
+	void GPUProfiler::BeginComputeScope(VkCommandBuffer cmd, const char* name)
+	{
+		// Listed anyway, so the pass doesn't silently disappear from the stats
+		if (m_Supported && m_ComputeTimestampMask == 0U && std::none_of(m_History.begin(), m_History.end(), [&](const ScopeHistory& h) { return h.name == name; }))
+			m_History.emplace_back(ScopeHistory{ .name = name, .depth = static_cast<uint32_t>(m_OpenScopes.size()), .timed = false });
+
+		BeginQueueScope(cmd, name, true, m_ComputeTimestampMask);
+	}
+	void GPUProfiler::BeginQueueScope(VkCommandBuffer cmd, const char* name, const bool label, const uint64_t timestampMask)
+	{
+		if (label && m_CmdBeginDebugUtilsLabel)
+		{
+			const VkDebugUtilsLabelEXT debugLabel{
+				.sType		= VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+				.pLabelName = name,
+			};
+
+			m_CmdBeginDebugUtilsLabel(cmd, &debugLabel);
+		}
+
+		auto& frame = m_Frames[m_FrameIndex];
+
+		if (!m_Supported || timestampMask == 0U || frame.scopeNames.size() >= MAX_SCOPES)
+		{
+			m_OpenScopes.emplace_back(OpenScope{ UINT32_MAX, label });
+			return;
+		}
+
+		const uint32_t scope = static_cast<uint32_t>(frame.scopeNames.size());
+
+		frame.scopeNames .emplace_back(name);
+		frame.scopeDepths.emplace_back(static_cast<uint32_t>(m_OpenScopes.size()));
+		frame.scopeMasks .emplace_back(timestampMask);
+
+		m_OpenScopes.emplace_back(OpenScope{ scope, label });
+
+		vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, scope * 2U);
+	}
+	void GPUProfiler::EndScope(VkCommandBuffer cmd)
+	{
+		if (m_OpenScopes.empty())
+			EN_ERROR("GPUProfiler::EndScope() - There was no open scope to end!");
+
+		const OpenScope scope = m_OpenScopes.back();
+		m_OpenScopes.pop_back();
+
+		if (scope.index != UINT32_MAX)
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_Frames[m_FrameIndex].queryPool, scope.index * 2U + 1U);
+
+		if (scope.label && m_CmdEndDebugUtilsLabel)
+			m_CmdEndDebugUtilsLabel(cmd);
+	}
+
+	std::vector<GPUProfiler::ScopeStats> GPUProfiler::GetStats() const
+	{
+		std::vector<ScopeStats> stats;
+		stats.reserve(m_History.size());
+
+		std::vector<float> sorted;
+
+		for (const auto& history : m_History)
+		{
+			ScopeStats& scope = stats.emplace_back(ScopeStats{ .name = history.name, .depth = history.depth, .timed = history.timed });
+
+			if (history.sampleCount == 0U) continue;
+
+			sorted.assign(history.samples.begin(), history.samples.begin() + history.sampleCount);
+			std::sort(sorted.begin(), sorted.end());
+
+			float sum = 0.0f;
+
+			for (const float sample : sorted)
+				sum += sample;
+
+			const uint32_t p99Index = std::min(history.sampleCount - 1U, static_cast<uint32_t>(history.sampleCount * 0.99f));
+
+			scope.last = history.samples[(history.nextSample + HISTORY_SIZE - 1U) % HISTORY_SIZE];
+			scope.min  = sorted.front();
+			scope.avg  = sum / history.sampleCount;
+			scope.p99  = sorted[p99Index];
+		}
+
+		return stats;
+	}
+	void GPUProfiler::DumpJSON(const std::string& path) const
+	{
+		nlohmann::json json;
+
+		json["device"]			= Context::Get().GetPhysicalDeviceName();
+		json["framesInFlight"]	= FRAMES_IN_FLIGHT;
+		json["timestampPeriod"] = m_TimestampPeriod;
+
+		const auto stats = GetStats();
+
+		json["scopes"] = nlohmann::json::array();
+
+		for (uint32_t i = 0U; i < m_History.size(); i++)
+		{
+			const auto& history = m_History[i];
+
+			// Oldest sample first
+			std::vector<float> samples(history.sampleCount);
+
+			for (uint32_t sample = 0U; sample < history.sampleCount; sample++)
+				samples[sample] = history.samples[(history.nextSample + HISTORY_SIZE - history.sampleCount + sample) % HISTORY_SIZE];
+
+			json["scopes"].push_back({
+				{ "name",	   stats[i].name  },
+				{ "depth",	   stats[i].depth },
+				{ "timed",	   stats[i].timed },
+				{ "lastMs",	   stats[i].last  },
+				{ "minMs",	   stats[i].min	  },
+				{ "avgMs",	   stats[i].avg	  },
+				{ "p99Ms",	   stats[i].p99	  },
+				{ "samplesMs", samples		  },
+			});
+		}
+
+		std::ofstream file(path);
+
+		if (!file.is_open())
+		{
+			EN_WARN("GPUProfiler::DumpJSON() - Failed to open \"" + path + "\" for writing!");
+			return;
+		}
+
+		file << json.dump(4);
+
+		EN_LOG("Saved the GPU timings to \"" + path + "\"");
+	}
+
+	void GPUProfiler::ResetStats()
+	{
+		m_History.clear();
+	}
+
+	void GPUProfiler::ReadResults(FrameQueries& frame)
+	{
+		const uint32_t scopeCount = static_cast<uint32_t>(frame.scopeNames.size());
+
+		if (scopeCount == 0U) return;
+
+		// A timestamp and its availability for every query
+		std::vector<uint64_t> results(scopeCount * 4U);
+
+		vkGetQueryPoolResults(
+			Context::Get().m_LogicalDevice, frame.queryPool,
+			0U, scopeCount * 2U,
+			results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t) * 2U,
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+		);
+
+		for (uint32_t scope = 0U; scope < scopeCount; scope++)
+		{
+			const uint64_t* begin = &results[scope * 4U];
+			const uint64_t* end	  = &results[scope * 4U + 2U];
+
+			// Never waits, the results that aren't there are skipped
+			if (begin[1] == 0U || end[1] == 0U) continue;
+
+			const uint64_t mask  = frame.scopeMasks[scope];
+			const uint64_t ticks = ((end[0] & mask) - (begin[0] & mask)) & mask;
+
+			const std::string_view name = frame.scopeNames[scope];
+
+			auto history = std::find_if(m_History.begin(), m_History.end(), [&](const ScopeHistory& h) { return h.name == name; });
+
+			if (history == m_History.end())
+			{
+				m_History.emplace_back(ScopeHistory{ .name = std::string(name), .depth = frame.scopeDepths[scope] });
+				history = m_History.end() - 1;
+			}
+
+			history->samples[history->nextSample] = static_cast<float>(ticks * static_cast<double>(m_TimestampPeriod) / 1000000.0);
+
+			history->nextSample  = (history->nextSample + 1U) % HISTORY_SIZE;
+			history->sampleCount = std::min(history->sampleCount + 1U, HISTORY_SIZE);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef EN_GPUPROFILER_HPP
+#define EN_GPUPROFILER_HPP
+
+#include "../../EruptionEngine.ini"
+
+#include <Renderer/Context.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace en
+{
+	// Measures the GPU time of the render passes with timestamp queries. Every frame in flight has its own query pool that is
+	// read back (without waiting) once the frame comes around again, so the timings lag FRAMES_IN_FLIGHT frames behind.
+	// The scopes are emitted as debug utils labels too, so capture tools show the same pass names.
+	class GPUProfiler
+	{
+	public:
+		static constexpr uint32_t MAX_SCOPES   = 32U;
+		static constexpr uint32_t HISTORY_SIZE = 256U;
+
+		// In milliseconds, over the last HISTORY_SIZE frames that recorded the scope
+		struct ScopeStats
+		{
+			std::string name;
+			uint32_t	depth = 0U;
+
+			// False for the compute queue scopes when its family has no timestamps, all their timings stay zero
+			bool timed = true;
+
+			float last = 0.0f;
+			float min  = 0.0f;
+			float avg  = 0.0f;
+			float p99  = 0.0f;
+		};
+
+		GPUProfiler();
+		~GPUProfiler();
+
+		// Collects the results of the frame's previous use and resets its queries, the frame's fence has to be signaled already
+		void BeginFrame(VkCommandBuffer cmd, const uint32_t frameIndex);
+
+		// Scopes can be nested, the name is read back frames later so it has to be a string literal. A debug label has to end in
+		// the command buffer it began in, so scopes ending in a later command buffer (of the same queue) go without one.
+		void BeginScope(VkCommandBuffer cmd, const char* name, const bool label = true);
+		void EndScope(VkCommandBuffer cmd);
+
+		// For the command buffers of the async compute queue, whose family can lack timestamps even though the graphics one has
+		// them. Its timestamps are only compared with each other, the queues don't share a time domain.
+		void BeginComputeScope(VkCommandBuffer cmd, const char* name);
+
+		// In the order the scopes were first recorded
+		std::vector<ScopeStats> GetStats() const;
+
+		void DumpJSON(const std::string& path) const;
+
+		// Drops the gathered samples, so the stats only cover what is rendered from now on
+		void ResetStats();
+
+		const bool IsSupported() const { return m_Supported; }
+
+	private:
+		struct FrameQueries
+		{
+			VkQueryPool queryPool = VK_NULL_HANDLE;
+
+			std::vector<const char*> scopeNames;
+			std::vector<uint32_t>	 scopeDepths;
+			std::vector<uint64_t>	 scopeMasks;
+		};
+
+		struct ScopeHistory
+		{
+			std::string name;
+			uint32_t	depth = 0U;
+			bool		timed = true;
+
+			std::array<float, HISTORY_SIZE> samples{};
+			uint32_t sampleCount = 0U;
+			uint32_t nextSample	 = 0U;
+		};
+
+		std::array<FrameQueries, FRAMES_IN_FLIGHT> m_Frames{};
+		std::vector<ScopeHistory> m_History;
+
+		struct OpenScope
+		{
+			// UINT32_MAX for the scopes that didn't fit into the query pool
+			uint32_t index = UINT32_MAX;
+			bool	 label = false;
+		};
+
+		std::vector<OpenScope> m_OpenScopes;
+
+		uint32_t m_FrameIndex = 0U;
+
+		bool	 m_Supported	   = false;
+		float	 m_TimestampPeriod = 0.0f;
+		uint64_t m_TimestampMask   = 0U;
+
+		// Zero when the compute family has no timestamps
+		uint64_t m_ComputeTimestampMask = 0U;
+
+		PFN_vkCmdBeginDebugUtilsLabelEXT m_CmdBeginDebugUtilsLabel = nullptr;
+		PFN_vkCmdEndDebugUtilsLabelEXT	 m_CmdEndDebugUtilsLabel   = nullptr;
+
+		// The timestamps are only written when the mask isn't zero
+		void BeginQueueScope(VkCommandBuffer cmd, const char* name, const bool label, const uint64_t timestampMask);
+
+		void ReadResults(FrameQueries& frame);
+	};
+}
+
+#endif
\ No newline at end of file
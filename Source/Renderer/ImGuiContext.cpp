@@ -27,6 +27,7 @@ namespace en
 			.Device = ctx.m_LogicalDevice,
 			.QueueFamily = ctx.m_QueueFamilies.graphics.value(),
 			.Queue = ctx.m_GraphicsQueue,
+			.PipelineCache = ctx.m_PipelineCache,
 			.DescriptorPool = ctx.m_DescriptorAllocator->GetPool(),
 			.MinImageCount = static_cast<uint32_t>(imageViews.size()),
 			.ImageCount = static_cast<uint32_t>(imageViews.size()),
@@ -2,6 +2,7 @@
 
 #include "../EruptionEngine.ini"
 
+#include <Renderer/BarrierBatch.hpp>
 #include <Renderer/Buffers/MemoryBuffer.hpp>
 
 namespace en
@@ -12,7 +13,88 @@ namespace en
 		if (genMipMaps)
 			m_MipLevelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(m_Size.width, m_Size.height)))) + 1U;
 
-		VkImageCreateInfo imageInfo{
+		const VkImageCreateInfo imageInfo = GetCreateInfo(m_Size, m_Format, m_UsageFlags, createFlags, m_LayerCount, m_MipLevelCount);
+
+		const VmaAllocationCreateInfo allocationInfo{
+			.usage = VMA_MEMORY_USAGE_GPU_ONLY
+		};
+
+		if (vmaCreateImage(Context::Get().m_Allocator, &imageInfo, &allocationInfo, &m_Image, &m_Allocation, nullptr) != VK_SUCCESS)
+			EN_ERROR("Image::Image() - Failed to create an image!")
+
+		CreateViews(createFlags);
+
+		// Ahead of the frames that use it, which are submitted after the batch
+		UploadQueue& uploads = *Context::Get().m_UploadQueue;
+
+		uploads.Begin();
+		Helpers::SimpleTransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, m_InitialLayout, m_LayerCount, m_MipLevelCount, uploads.GetGraphicsCommandBuffer());
+		uploads.End();
+
+		m_CurrentLayout = m_InitialLayout;
+	}
+	Image::Image(VkImage image, VkImageView view, VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags,VkImageLayout layout, uint32_t layerCount)
+		: m_IsBorrowed(true), m_Image(image), m_ImageView(view), m_Size(size), m_Format(format), m_UsageFlags(usageFlags), m_AspectFlags(aspectFlags), m_InitialLayout(layout), m_CurrentLayout(layout), m_LayerCount(layerCount)
+	{
+	}
+	Image::Image(VmaAllocation memory, VkDeviceSize memoryOffset, VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags, uint32_t layerCount)
+		: m_IsBorrowed(false), m_Size(size), m_Format(format), m_UsageFlags(usageFlags), m_AspectFlags(aspectFlags), m_LayerCount(layerCount)
+	{
+		UseContext();
+
+		const VkImageCreateInfo imageInfo = GetCreateInfo(m_Size, m_Format, m_UsageFlags, 0U, m_LayerCount, m_MipLevelCount);
+
+		if (vkCreateImage(ctx.m_LogicalDevice, &imageInfo, nullptr, &m_Image) != VK_SUCCESS)
+			EN_ERROR("Image::Image() - Failed to create a placed image!")
+
+		if (vmaBindImageMemory2(ctx.m_Allocator, memory, memoryOffset, m_Image, nullptr) != VK_SUCCESS)
+			EN_ERROR("Image::Image() - Failed to bind a placed image to its memory!")
+
+		CreateViews(0U);
+	}
+	Image::~Image()
+	{
+		if (m_IsBorrowed)
+			return;
+
+		UseContext();
+
+		for(auto& layer : m_LayerImageViews)
+			vkDestroyImageView(ctx.m_LogicalDevice, layer, nullptr);
+
+		if (m_ImageView != VK_NULL_HANDLE)
+			vkDestroyImageView(ctx.m_LogicalDevice, m_ImageView, nullptr);
+
+		if (m_ArrayImageView != VK_NULL_HANDLE)
+			vkDestroyImageView(ctx.m_LogicalDevice, m_ArrayImageView, nullptr);
+
+		// Placed images don't own their memory
+		if (m_Allocation != VK_NULL_HANDLE && m_Image != VK_NULL_HANDLE)
+			vmaDestroyImage(ctx.m_Allocator, m_Image, m_Allocation);
+		else if (m_Image != VK_NULL_HANDLE)
+			vkDestroyImage(ctx.m_LogicalDevice, m_Image, nullptr);
+	}
+
+	VkMemoryRequirements Image::GetMemoryRequirements(VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, uint32_t layerCount)
+	{
+		const VkImageCreateInfo imageInfo = GetCreateInfo(size, format, usageFlags, 0U, layerCount, 1U);
+
+		const VkDeviceImageMemoryRequirements requirementsInfo{
+			.sType		 = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+			.pCreateInfo = &imageInfo,
+		};
+
+		VkMemoryRequirements2 requirements{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2
+		};
+
+		vkGetDeviceImageMemoryRequirements(Context::Get().m_LogicalDevice, &requirementsInfo, &requirements);
+
+		return requirements.memoryRequirements;
+	}
+	VkImageCreateInfo Image::GetCreateInfo(VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageCreateFlags createFlags, uint32_t layerCount, uint32_t mipLevelCount)
+	{
+		return VkImageCreateInfo{
 			.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
 			.flags = createFlags,
 			.imageType = VK_IMAGE_TYPE_2D,
@@ -24,22 +106,17 @@ namespace en
 				.depth = 1U,
 			},
 
-			.mipLevels = m_MipLevelCount,
-			.arrayLayers = m_LayerCount,
+			.mipLevels = mipLevelCount,
+			.arrayLayers = layerCount,
 			.samples = VK_SAMPLE_COUNT_1_BIT,
 			.tiling = VK_IMAGE_TILING_OPTIMAL,
-			.usage = m_UsageFlags,
+			.usage = usageFlags,
 			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
 			.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
 		};
-
-		const VmaAllocationCreateInfo allocationInfo{
-			.usage = VMA_MEMORY_USAGE_GPU_ONLY
-		};
-
-		if (vmaCreateImage(Context::Get().m_Allocator, &imageInfo, &allocationInfo, &m_Image, &m_Allocation, nullptr) != VK_SUCCESS)
-			EN_ERROR("Image::Image() - Failed to create an image!")
-
+	}
+	void Image::CreateViews(VkImageCreateFlags createFlags)
+	{
 		VkImageViewType imageViewType{};
 		if (createFlags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
 			imageViewType = VK_IMAGE_VIEW_TYPE_CUBE;
@@ -50,6 +127,9 @@ namespace en
 
 		Helpers::CreateImageView(m_Image, m_ImageView, imageViewType, m_Format, m_AspectFlags, 0U, m_LayerCount, m_MipLevelCount);
 
+		if (imageViewType == VK_IMAGE_VIEW_TYPE_CUBE)
+			Helpers::CreateImageView(m_Image, m_ArrayImageView, VK_IMAGE_VIEW_TYPE_2D_ARRAY, m_Format, m_AspectFlags, 0U, m_LayerCount, m_MipLevelCount);
+
 		if (m_LayerCount > 1U)
 		{
 			for (uint32_t i = 0U; i < m_LayerCount; i++)
@@ -59,56 +139,49 @@ namespace en
 				m_LayerImageViews.push_back(view);
 			}
 		}
-		
-		
-		Helpers::SimpleTransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, m_InitialLayout, m_LayerCount, m_MipLevelCount);
-		m_CurrentLayout = m_InitialLayout;
-	}
-	Image::Image(VkImage image, VkImageView view, VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags,VkImageLayout layout, uint32_t layerCount)
-		: m_IsBorrowed(true), m_Image(image), m_ImageView(view), m_Size(size), m_Format(format), m_UsageFlags(usageFlags), m_AspectFlags(aspectFlags), m_InitialLayout(layout), m_CurrentLayout(layout), m_LayerCount(layerCount)
-	{
 	}
-	Image::~Image()
+
+	UploadQueue::Ticket Image::SetData(void* data)
 	{
-		if (m_IsBorrowed)
-			return;
+		VkDeviceSize imageByteSize = m_Size.width * m_Size.height * 4U;
 
-		UseContext();
+		// The blits need the graphics queue, so the whole upload goes there instead of acquiring the image after the copy
+		UploadQueue& uploads = *Context::Get().m_UploadQueue;
 
-		for(auto& layer : m_LayerImageViews)
-			vkDestroyImageView(ctx.m_LogicalDevice, layer, nullptr);
+		uploads.Begin();
 
-		if (m_ImageView != VK_NULL_HANDLE)
-			vkDestroyImageView(ctx.m_LogicalDevice, m_ImageView, nullptr);
+		const VkCommandBuffer cmd = uploads.GetGraphicsCommandBuffer();
 
-		if (m_Allocation != VK_NULL_HANDLE && m_Image != VK_NULL_HANDLE)
-			vmaDestroyImage(ctx.m_Allocator, m_Image, m_Allocation);
-	}
+		const StagingRing::Allocation staging = uploads.Stage(data, imageByteSize);
 
-	void Image::SetData(void* data)
-	{
-		VkDeviceSize imageByteSize = m_Size.width * m_Size.height * 4U;
+		ChangeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, cmd);
 
-		ChangeLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+		const VkBufferImageCopy region{
+			.bufferOffset = staging.offset,
 
-		MemoryBuffer stagingBuffer(
-			imageByteSize, 
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-			VMA_MEMORY_USAGE_CPU_TO_GPU
-		);
-		stagingBuffer.MapMemory(data, imageByteSize);
-		stagingBuffer.CopyTo(m_Image, VkExtent3D{m_Size.width, m_Size.height, 1U});
+			.imageSubresource{
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.mipLevel	= 0U,
+				.layerCount = 1U,
+			},
+
+			.imageExtent = VkExtent3D{m_Size.width, m_Size.height, 1U}
+		};
+
+		vkCmdCopyBufferToImage(cmd, staging.buffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &region);
 
 		if(UsesMipMaps())
-			GenMipMaps();
+			GenMipMaps(cmd);
 		else
 		{
-			Helpers::SimpleTransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, m_InitialLayout, m_LayerCount, m_MipLevelCount);
+			Helpers::SimpleTransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, m_InitialLayout, m_LayerCount, m_MipLevelCount, cmd);
 			m_CurrentLayout = m_InitialLayout;
 		}
+
+		return uploads.End();
 	}
 
-	void Image::GenMipMaps()
+	void Image::GenMipMaps(VkCommandBuffer cmd)
 	{
 		UseContext();
 
@@ -118,53 +191,36 @@ namespace en
 		if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
 			throw std::runtime_error("Image::GenMipMaps() - The specified image format does not support linear blitting!");
 
-		VkCommandBuffer cmd = Helpers::BeginSingleTimeGraphicsCommands();
-
-		VkImageMemoryBarrier barrier{
-			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-
-			.image = m_Image,
-
-			.subresourceRange{
-				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-				.levelCount = 1U,
-				.baseArrayLayer = 0U,
-				.layerCount = m_LayerCount,
-			}
-		};
-
 		int32_t mipWidth  = static_cast<int32_t>(m_Size.width);
 		int32_t mipHeight = static_cast<int32_t>(m_Size.height);
 
-		VkAccessFlags accessFlags{};
-		VkPipelineStageFlags stageFlags{};
+		VkAccessFlags2 accessFlags{};
+		VkPipelineStageFlags2 stageFlags{};
 
 		switch (m_InitialLayout)
 		{
 		case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-			accessFlags = VK_ACCESS_SHADER_READ_BIT;
-			stageFlags = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			accessFlags = VK_ACCESS_2_SHADER_READ_BIT;
+			stageFlags = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
 			break;
 		default:
 			EN_ERROR("Image::GenMipMaps() - Unknown image layout in mipmap generation!");
 			break;
 		}
 
+		// The level that was blitted from is done in the same batch as the next one becomes the source
+		BarrierBatch barriers;
+
 		for (uint32_t i = 1U; i < m_MipLevelCount; i++)
 		{
-			barrier.subresourceRange.baseMipLevel = i - 1;
-			barrier.oldLayout	  = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout	  = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-			vkCmdPipelineBarrier(cmd,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0U,
-				0U, nullptr,
-				0U, nullptr,
-				1U, &barrier);
+			barriers.Add(
+				m_Image, VK_IMAGE_ASPECT_COLOR_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+				0U, m_LayerCount, 1U, i - 1U
+			);
+			barriers.Flush(cmd);
 
 			VkImageBlit blit{};
 			blit.srcOffsets[0] = { 0, 0, 0 };
@@ -186,42 +242,67 @@ namespace en
 				1U, &blit,
 				VK_FILTER_LINEAR);
 
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.newLayout = m_InitialLayout;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			barrier.dstAccessMask = accessFlags;
-
-			vkCmdPipelineBarrier(cmd,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, stageFlags, 0U,
-				0U, nullptr,
-				0U, nullptr,
-				1U, &barrier);
+			barriers.Add(
+				m_Image, VK_IMAGE_ASPECT_COLOR_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_InitialLayout,
+				VK_ACCESS_2_TRANSFER_READ_BIT, accessFlags,
+				VK_PIPELINE_STAGE_2_TRANSFER_BIT, stageFlags,
+				0U, m_LayerCount, 1U, i - 1U
+			);
 
 			if (mipWidth > 1) mipWidth /= 2;
 			if (mipHeight > 1) mipHeight /= 2;
 		}
 
-		barrier.subresourceRange.baseMipLevel = m_MipLevelCount - 1U;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = m_InitialLayout;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = accessFlags;
-
-		vkCmdPipelineBarrier(cmd,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, stageFlags, 0U,
-			0U, nullptr,
-			0U, nullptr,
-			1U, &barrier
+		barriers.Add(
+			m_Image, VK_IMAGE_ASPECT_COLOR_BIT,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_InitialLayout,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, accessFlags,
+			VK_PIPELINE_STAGE_2_TRANSFER_BIT, stageFlags,
+			0U, m_LayerCount, 1U, m_MipLevelCount - 1U
 		);
+		barriers.Flush(cmd);
 
 		m_CurrentLayout = m_InitialLayout;
-
-		Helpers::EndSingleTimeGraphicsCommands(cmd);
 	}
 
-	void Image::ChangeLayout(VkImageLayout newLayout, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkCommandBuffer cmd)
+	void Image::ChangeLayout(VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, VkCommandBuffer cmd)
 	{
-		Helpers::TransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, newLayout, srcAccessMask, dstAccessMask, srcStage, dstStage, 0U, 1U, m_MipLevelCount, cmd);
+		Helpers::TransitionImageLayout(m_Image, m_Format, m_AspectFlags, m_CurrentLayout, newLayout, srcAccessMask, dstAccessMask, srcStage, dstStage, 0U, m_LayerCount, m_MipLevelCount, cmd);
 		m_CurrentLayout = newLayout;
 	}
+	void Image::CopyTo(Handle<Image> dstImage, VkOffset2D offset, VkExtent2D extent, VkCommandBuffer cmd)
+	{
+		const VkImageSubresourceLayers subresource{
+			.aspectMask		= m_AspectFlags,
+			.mipLevel		= 0U,
+			.baseArrayLayer = 0U,
+			.layerCount		= 1U,
+		};
+
+		const VkImageCopy region{
+			.srcSubresource = subresource,
+			.srcOffset		= { offset.x, offset.y, 0 },
+			.dstSubresource = subresource,
+			.dstOffset		= { offset.x, offset.y, 0 },
+			.extent			= { extent.width, extent.height, 1U },
+		};
+
+		vkCmdCopyImage(cmd, m_Image, m_CurrentLayout, dstImage->m_Image, dstImage->m_CurrentLayout, 1U, &region);
+	}
+	void Image::CopyTo(VkBuffer dstBuffer, VkCommandBuffer cmd)
+	{
+		const VkBufferImageCopy region{
+			.imageSubresource{
+				.aspectMask		= m_AspectFlags,
+				.mipLevel		= 0U,
+				.baseArrayLayer = 0U,
+				.layerCount		= 1U,
+			},
+
+			.imageExtent = { m_Size.width, m_Size.height, 1U },
+		};
+
+		vkCmdCopyImageToBuffer(cmd, m_Image, m_CurrentLayout, dstBuffer, 1U, &region);
+	}
 }
\ No newline at end of file
@@ -11,15 +11,27 @@ namespace en
 	class Image
 	{
 		friend class Renderer;
+		friend class RenderGraph;
+		friend class BarrierBatch;
 
 	public:
 		Image(VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags, VkImageCreateFlags createFlags, VkImageLayout initialLayout, uint32_t layerCount = 1U, bool genMipMaps = false);
 		Image(VkImage image, VkImageView view, VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags, VkImageLayout layout, uint32_t layerCount = 1U);
+
+		// Placed at the offset of memory allocated by someone else, which has to outlive the image. Its contents start out undefined.
+		Image(VmaAllocation memory, VkDeviceSize memoryOffset, VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageAspectFlags aspectFlags, uint32_t layerCount = 1U);
 		~Image();
 
-		void SetData(void* data);
+		// Goes into the open upload batch together with the mipmaps, the image can be sampled once the ticket is done
+		UploadQueue::Ticket SetData(void* data);
+
+		void ChangeLayout(VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, VkCommandBuffer cmd = VK_NULL_HANDLE);
 
-		void ChangeLayout(VkImageLayout newLayout, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkCommandBuffer cmd = VK_NULL_HANDLE);
+		// Copies a region of the first layer to the same place in dstImage, both images have to be in the transfer layouts already
+		void CopyTo(Handle<Image> dstImage, VkOffset2D offset, VkExtent2D extent, VkCommandBuffer cmd);
+
+		// Copies the whole first layer into a tightly packed buffer, the image has to be in the transfer source layout already
+		void CopyTo(VkBuffer dstBuffer, VkCommandBuffer cmd);
 
 		const VkExtent2D m_Size{};
 
@@ -37,13 +49,23 @@ namespace en
 
 		const VkImageView GetLayerViewHandle(uint32_t layer) const { return m_LayerImageViews[layer]; };
 
+		// All the layers viewed as a 2D array, differs from the default view only for cube images which can't be rendered to as a whole otherwise
+		const VkImageView GetArrayViewHandle() const { return m_ArrayImageView ? m_ArrayImageView : m_ImageView; };
+
 		const VkImageLayout GetLayout()    const { return m_CurrentLayout; };
 		const uint32_t		GetMipLevels() const { return m_MipLevelCount; };
 
 		const bool UsesMipMaps() const { return m_MipLevelCount > 1U; };
 
+		// Of an image placed in shared memory with the same properties, without creating it
+		static VkMemoryRequirements GetMemoryRequirements(VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, uint32_t layerCount = 1U);
+
 	private:
-		void GenMipMaps();
+		static VkImageCreateInfo GetCreateInfo(VkExtent2D size, VkFormat format, VkImageUsageFlags usageFlags, VkImageCreateFlags createFlags, uint32_t layerCount, uint32_t mipLevelCount);
+
+		void CreateViews(VkImageCreateFlags createFlags);
+
+		void GenMipMaps(VkCommandBuffer cmd);
 
 		uint32_t m_MipLevelCount = 1U;
 
@@ -52,6 +74,7 @@ namespace en
 
 		VkImage		m_Image = VK_NULL_HANDLE;
 		VkImageView	m_ImageView = VK_NULL_HANDLE;
+		VkImageView	m_ArrayImageView = VK_NULL_HANDLE;
 		VmaAllocation m_Allocation = VK_NULL_HANDLE;
 
 		std::vector<VkImageView> m_LayerImageViews{};
@@ -4,13 +4,14 @@
 #define EN_DIRECTIONALLIGHT_HPP
 
 #include <Scene/SceneMember.hpp>
-#include <Renderer/Image.hpp>
 
 namespace en
 {
 	class DirectionalLight : public SceneMember
 	{
 	friend class Scene;
+	friend class SceneState;
+	friend class CascadedShadowMaps;
 	friend class Renderer;
 
 	public:
@@ -10,6 +10,7 @@ namespace en
 	class PointLight : public SceneMember
 	{
 	friend class Scene;
+	friend class SceneState;
 	friend class Renderer;
 
 	public:
@@ -42,6 +43,7 @@ namespace en
 
 			m_CastShadows = other.m_CastShadows;
 			m_ShadowmapIndex = other.m_ShadowmapIndex;
+			m_ViewProj = other.m_ViewProj;
 			m_ShadowSoftness = other.m_ShadowSoftness;
 			m_PCFSampleRate = other.m_PCFSampleRate;
 
@@ -66,6 +68,12 @@ namespace en
 
 	private:
 		int m_ShadowmapIndex = -1;
+
+		// Cube face matrices of the last shadow update, kept CPU side for culling
+		std::array<glm::mat4, 6> m_ViewProj{};
+
+		// Estimated screen coverage, the most important casters get the shadow maps and the biggest atlas tiles
+		float m_ShadowImportance = 0.0f;
 	};
 }
 #endif
\ No newline at end of file
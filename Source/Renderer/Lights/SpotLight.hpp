@@ -10,6 +10,7 @@ namespace en
 	class SpotLight : public SceneMember
 	{
 	friend class Scene;
+	friend class SceneState;
 	friend class Renderer;
 
 	public:
@@ -49,6 +50,7 @@ namespace en
 
 			m_CastShadows = other.m_CastShadows;
 			m_ShadowmapIndex = other.m_ShadowmapIndex;
+			m_ViewProj = other.m_ViewProj;
 			m_ShadowSoftness = other.m_ShadowSoftness;
 			m_PCFSampleRate = other.m_PCFSampleRate;
 
@@ -76,6 +78,12 @@ namespace en
 
 	private:
 		int m_ShadowmapIndex = -1;
+
+		// Light matrix of the last shadow update, kept CPU side for culling
+		glm::mat4 m_ViewProj = glm::mat4(1.0f);
+
+		// Estimated screen coverage, the most important casters get the shadow maps and the biggest atlas tiles
+		float m_ShadowImportance = 0.0f;
 	};
 }
 
@@ -34,7 +34,7 @@ namespace en
 			.layout = m_Layout,
 		};
 
-		if (vkCreateComputePipelines(ctx.m_LogicalDevice, VK_NULL_HANDLE, 1U, &pipelineCreateInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+		if (ctx.CreateComputePipeline(pipelineCreateInfo, m_Pipeline) != VK_SUCCESS)
 			EN_ERROR("ComputePass::ComputePass() - Failed to create compute pipeline!");
 		
 		DestroyShaderModule(shaderModule);
@@ -42,13 +42,11 @@ namespace en
 
 	void ComputePass::Bind(const VkCommandBuffer cmd)
 	{
-		m_BoundCommandBuffer = cmd;
-
-		vkCmdBindPipeline(m_BoundCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
 	}
 
-	void ComputePass::Dispatch(const uint32_t x, const uint32_t y, const uint32_t z)
+	void ComputePass::Dispatch(const VkCommandBuffer cmd, const uint32_t x, const uint32_t y, const uint32_t z)
 	{
-		vkCmdDispatch(m_BoundCommandBuffer, x, y, z);
+		vkCmdDispatch(cmd, x, y, z);
 	}
 }
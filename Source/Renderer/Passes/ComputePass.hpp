@@ -21,7 +21,7 @@ namespace en
 
 		void Bind(const VkCommandBuffer cmd);
 
-		void Dispatch(const uint32_t x = 1U, const uint32_t y = 1U, const uint32_t z = 1U);
+		void Dispatch(const VkCommandBuffer cmd, const uint32_t x = 1U, const uint32_t y = 1U, const uint32_t z = 1U);
 	};
 }
 #endif
\ No newline at end of file
@@ -4,7 +4,7 @@
 
 namespace en
 {
-	GraphicsPass::GraphicsPass(const CreateInfo& pipeline)
+	GraphicsPass::GraphicsPass(const CreateInfo& pipeline) : m_ColorFormat(pipeline.colorFormat), m_DepthFormat(pipeline.depthFormat), m_ViewMask(pipeline.viewMask)
 	{
 		UseContext();
 
@@ -145,6 +145,7 @@ namespace en
 
 		VkPipelineRenderingCreateInfo pipelineRenderingInfo{
 			.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+			.viewMask = pipeline.viewMask,
 			.colorAttachmentCount = static_cast<uint32_t>(pipeline.colorFormat != VK_FORMAT_UNDEFINED),
 			.pColorAttachmentFormats = &pipeline.colorFormat,
 			.depthAttachmentFormat = pipeline.depthFormat,
@@ -172,16 +173,14 @@ namespace en
 			.basePipelineIndex  = -1
 		};
 
-		if (vkCreateGraphicsPipelines(ctx.m_LogicalDevice, VK_NULL_HANDLE, 1U, &pipelineInfo, nullptr, &m_Pipeline) != VK_SUCCESS)
+		if (ctx.CreateGraphicsPipeline(pipelineInfo, m_Pipeline) != VK_SUCCESS)
 			EN_ERROR("GraphicsPass::CreatePipeline() - Failed to create pipeline!");
 	
 		DestroyShaderModule(vShaderModule);
 		DestroyShaderModule(fShaderModule);
 	}
-	void GraphicsPass::Begin(VkCommandBuffer commandBuffer, const RenderInfo& info)
+	void GraphicsPass::Begin(VkCommandBuffer commandBuffer, const RenderInfo& info, VkRenderingFlags flags)
 	{
-		m_BoundCommandBuffer = commandBuffer;
-
 		VkRenderingAttachmentInfo colorAttachmentInfo {
 			.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
 			.imageView = info.colorAttachmentView ? info.colorAttachmentView : VK_NULL_HANDLE,
@@ -204,58 +203,107 @@ namespace en
 			},
 		};
 		VkRect2D renderArea {
+			.offset = info.offset,
 			.extent = info.extent
 		};
 
 		VkRenderingInfo renderingInfo{
 			.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+			.flags = flags,
 			.renderArea = renderArea,
 			.layerCount = 1U,
+			.viewMask = m_ViewMask,
 			.colorAttachmentCount = 1U,
 			.pColorAttachments = &colorAttachmentInfo,
 			.pDepthAttachment = &depthAttachmentInfo,
 		};
+		
+		vkCmdBeginRendering(commandBuffer, &renderingInfo);
 
-		VkViewport viewport {
-			.width    = static_cast<float>(info.extent.width),
-			.height   = static_cast<float>(info.extent.height),
-			.maxDepth = 1.0f
+		if (!(flags & VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT))
+			BindState(commandBuffer, info);
+	}
+	void GraphicsPass::End(VkCommandBuffer commandBuffer)
+	{
+		vkCmdEndRendering(commandBuffer);
+	}
+	void GraphicsPass::BeginSecondary(VkCommandBuffer commandBuffer, const RenderInfo& info)
+	{
+		// Has to match the attachments passed to vkCmdBeginRendering() in Begin(), which always declares one color attachment
+		VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+			.viewMask = m_ViewMask,
+			.colorAttachmentCount = 1U,
+			.pColorAttachmentFormats = &m_ColorFormat,
+			.depthAttachmentFormat = m_DepthFormat,
+			.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
 		};
-		VkRect2D scissor {
-			.extent = info.extent
+
+		VkCommandBufferInheritanceInfo inheritanceInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+			.pNext = &inheritanceRenderingInfo
+		};
+
+		VkCommandBufferBeginInfo beginInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+			.pInheritanceInfo = &inheritanceInfo
 		};
-		
-		vkCmdBeginRendering(m_BoundCommandBuffer, &renderingInfo);
 
-		vkCmdSetCullMode(m_BoundCommandBuffer, info.cullMode);
-		vkCmdSetViewport(m_BoundCommandBuffer, 0U, 1U, &viewport);
-		vkCmdSetScissor(m_BoundCommandBuffer, 0U, 1U, &scissor);
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			EN_ERROR("GraphicsPass::BeginSecondary() - Failed to begin a secondary command buffer!");
 
-		vkCmdBindPipeline(m_BoundCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+		BindState(commandBuffer, info);
 	}
-	void GraphicsPass::End()
+	void GraphicsPass::EndSecondary(VkCommandBuffer commandBuffer)
 	{
-		vkCmdEndRendering(m_BoundCommandBuffer);
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			EN_ERROR("GraphicsPass::EndSecondary() - Failed to record a secondary command buffer!");
 	}
-	void GraphicsPass::BindVertexBuffer(Handle<MemoryBuffer> buffer, VkDeviceSize offset)
+	void GraphicsPass::BindVertexBuffer(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset)
 	{
 		VkBuffer vBuffer = buffer->GetHandle();
-		vkCmdBindVertexBuffers(m_BoundCommandBuffer, 0U, 1U, &vBuffer, &offset);
+		vkCmdBindVertexBuffers(commandBuffer, 0U, 1U, &vBuffer, &offset);
+	}
+	void GraphicsPass::BindIndexBuffer(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer)
+	{
+		vkCmdBindIndexBuffer(commandBuffer, buffer->GetHandle(), 0U, VK_INDEX_TYPE_UINT32);
+	}
+	void GraphicsPass::DrawIndexedIndirect(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	{
+		vkCmdDrawIndexedIndirect(commandBuffer, buffer->GetHandle(), offset, drawCount, stride);
 	}
-	void GraphicsPass::BindIndexBuffer(Handle<MemoryBuffer> buffer)
+	void GraphicsPass::DrawIndexedIndirectCount(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset, Handle<MemoryBuffer> countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride)
 	{
-		vkCmdBindIndexBuffer(m_BoundCommandBuffer, buffer->GetHandle(), 0U, VK_INDEX_TYPE_UINT32);
+		vkCmdDrawIndexedIndirectCount(commandBuffer, buffer->GetHandle(), offset, countBuffer->GetHandle(), countOffset, maxDrawCount, stride);
 	}
-	void GraphicsPass::DrawIndexedIndirect(Handle<MemoryBuffer> buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride)
+	void GraphicsPass::DrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
 	{
-		vkCmdDrawIndexedIndirect(m_BoundCommandBuffer, buffer->GetHandle(), offset, drawCount, stride);
+		vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 	}
-	void GraphicsPass::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t firstInstance)
+	void GraphicsPass::Draw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
 	{
-		vkCmdDrawIndexed(m_BoundCommandBuffer, indexCount, instanceCount, firstIndex, 0U, firstInstance);
+		vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
 	}
-	void GraphicsPass::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+
+	void GraphicsPass::BindState(VkCommandBuffer commandBuffer, const RenderInfo& info)
 	{
-		vkCmdDraw(m_BoundCommandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+		VkViewport viewport {
+			.x		  = static_cast<float>(info.offset.x),
+			.y		  = static_cast<float>(info.offset.y),
+			.width    = static_cast<float>(info.extent.width),
+			.height   = static_cast<float>(info.extent.height),
+			.maxDepth = 1.0f
+		};
+		VkRect2D scissor {
+			.offset = info.offset,
+			.extent = info.extent
+		};
+
+		vkCmdSetCullMode(commandBuffer, info.cullMode);
+		vkCmdSetViewport(commandBuffer, 0U, 1U, &viewport);
+		vkCmdSetScissor(commandBuffer, 0U, 1U, &scissor);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
 	}
 }
\ No newline at end of file
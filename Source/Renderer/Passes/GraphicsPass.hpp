@@ -40,6 +40,9 @@ namespace en
 
 			VkCompareOp	  compareOp	  = VK_COMPARE_OP_LESS;
 			VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+
+			// Non zero enables multiview, every set bit renders the draws into the matching layer of the attachments (gl_ViewIndex in the shaders)
+			uint32_t viewMask = 0U;
 		};
 		struct RenderInfo
 		{
@@ -49,6 +52,8 @@ namespace en
 			VkImageLayout colorAttachmentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			VkImageLayout depthAttachmentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+			// Render area inside the attachments, the clears are limited to it too
+			VkOffset2D offset{};
 			VkExtent2D extent{};
 
 			VkClearColorValue clearColor{ {0.0f, 0.0f, 0.0f, 1.0f} };
@@ -65,15 +70,29 @@ namespace en
 
 		GraphicsPass(const CreateInfo& pipeline);
 
-		void Begin(VkCommandBuffer commandBuffer, const RenderInfo& info);
-		void End();
+		// With VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT only the rendering scope is started, the state is then set by the secondary command buffers
+		void Begin(VkCommandBuffer commandBuffer, const RenderInfo& info, VkRenderingFlags flags = 0U);
+		void End(VkCommandBuffer commandBuffer);
+
+		// Starts a secondary command buffer that continues a rendering scope of this pass, only the render area and the cull mode of the info are used
+		void BeginSecondary(VkCommandBuffer commandBuffer, const RenderInfo& info);
+		void EndSecondary(VkCommandBuffer commandBuffer);
 
-		void BindVertexBuffer(Handle<MemoryBuffer> buffer, VkDeviceSize offset = 0U);
-		void BindIndexBuffer(Handle<MemoryBuffer> buffer);
+		void BindVertexBuffer(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset = 0U);
+		void BindIndexBuffer(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer);
 		
-		void DrawIndexedIndirect(Handle<MemoryBuffer> buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
-		void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1U, uint32_t firstIndex = 0U, uint32_t firstInstance = 0U);
-		void Draw(uint32_t vertexCount, uint32_t instanceCount = 1U, uint32_t firstVertex = 0U, uint32_t firstInstance = 0U);
+		void DrawIndexedIndirect(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+		void DrawIndexedIndirectCount(VkCommandBuffer commandBuffer, Handle<MemoryBuffer> buffer, VkDeviceSize offset, Handle<MemoryBuffer> countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+		void DrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount, uint32_t instanceCount = 1U, uint32_t firstIndex = 0U, int32_t vertexOffset = 0, uint32_t firstInstance = 0U);
+		void Draw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount = 1U, uint32_t firstVertex = 0U, uint32_t firstInstance = 0U);
+
+	private:
+		void BindState(VkCommandBuffer commandBuffer, const RenderInfo& info);
+
+		VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
+		VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
+
+		uint32_t m_ViewMask = 0U;
 	};
 }
 
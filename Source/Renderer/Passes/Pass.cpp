@@ -2,8 +2,22 @@
 
 #include <Renderer/Context.hpp>
 
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
 namespace en
 {
+	struct ShaderBinary
+	{
+		std::filesystem::file_time_type writeTime;
+		std::vector<char> code;
+	};
+
+	// Every SPIR-V file read so far, kept between backend reloads. Passes are created on the worker threads, hence the lock.
+	std::mutex g_ShaderCacheMutex;
+	std::unordered_map<std::string, ShaderBinary> g_ShaderCache;
+
 	Pass::~Pass()
 	{
 		UseContext();
@@ -15,18 +29,18 @@ namespace en
 			vkDestroyPipeline(ctx.m_LogicalDevice, m_Pipeline, nullptr);
 	}
 
-	void Pass::PushConstants(const void* data, uint32_t size, uint32_t offset, VkShaderStageFlags shaderStage)
+	void Pass::PushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size, uint32_t offset, VkShaderStageFlags shaderStage)
 	{
-		vkCmdPushConstants(m_BoundCommandBuffer, m_Layout, shaderStage, offset, size, data);
+		vkCmdPushConstants(commandBuffer, m_Layout, shaderStage, offset, size, data);
 	}
-	void Pass::BindDescriptorSet(Handle<DescriptorSet> descriptor, uint32_t index, VkPipelineBindPoint bindPoint)
+	void Pass::BindDescriptorSet(VkCommandBuffer commandBuffer, Handle<DescriptorSet> descriptor, uint32_t index, VkPipelineBindPoint bindPoint)
 	{
 		const VkDescriptorSet descriptorSet = descriptor->GetHandle();
-		vkCmdBindDescriptorSets(m_BoundCommandBuffer, bindPoint, m_Layout, index, 1U, &descriptorSet, 0U, nullptr);
+		vkCmdBindDescriptorSets(commandBuffer, bindPoint, m_Layout, index, 1U, &descriptorSet, 0U, nullptr);
 	}
-	void Pass::BindDescriptorSet(VkDescriptorSet descriptor, uint32_t index, VkPipelineBindPoint bindPoint)
+	void Pass::BindDescriptorSet(VkCommandBuffer commandBuffer, VkDescriptorSet descriptor, uint32_t index, VkPipelineBindPoint bindPoint)
 	{
-		vkCmdBindDescriptorSets(m_BoundCommandBuffer, bindPoint, m_Layout, index, 1U, &descriptor, 0U, nullptr);
+		vkCmdBindDescriptorSets(commandBuffer, bindPoint, m_Layout, index, 1U, &descriptor, 0U, nullptr);
 	}
 
 	VkPipelineShaderStageCreateInfo Pass::CreateShaderInfo(VkShaderModule shaderModule, VkShaderStageFlagBits stage)
@@ -65,10 +79,22 @@ namespace en
 
 	std::vector<char> Pass::ReadShaderFile(const std::string& path)
 	{
+		std::error_code error;
+		const auto writeTime = std::filesystem::last_write_time(path, error);
+
+		// Recompiled shaders are picked up by the next backend reload
+		{
+			std::lock_guard<std::mutex> lock(g_ShaderCacheMutex);
+
+			if (!error && g_ShaderCache.contains(path) && g_ShaderCache.at(path).writeTime == writeTime)
+				return g_ShaderCache.at(path).code;
+		}
+
 		std::ifstream file(path, std::ios::ate | std::ios::binary);
 
+		// The project compiles every shader it uses, Shaders/compile.bat does the same outside of a build
 		if (!file.is_open())
-			EN_ERROR("Pass::ReadShaderFile() - Failed to open shader source file!");
+			EN_ERROR("Pass::ReadShaderFile() - Failed to open \"" + path + "\", build the project or run Shaders/compile.bat to compile the shaders!");
 
 		size_t fileSize = (size_t)file.tellg();
 		std::vector<char> buffer(fileSize);
@@ -80,6 +106,12 @@ namespace en
 		if (buffer.empty())
 			EN_WARN("Pass::ReadShaderFile() - The read buffer is empty!");
 
+		if (!error)
+		{
+			std::lock_guard<std::mutex> lock(g_ShaderCacheMutex);
+			g_ShaderCache[path] = ShaderBinary{ writeTime, buffer };
+		}
+
 		return buffer;
 	}
 
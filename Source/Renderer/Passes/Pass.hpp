@@ -18,10 +18,10 @@ namespace en
 	public:
 		~Pass();
 
-		void PushConstants(const void* data, uint32_t size, uint32_t offset, VkShaderStageFlags shaderStage);
+		void PushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size, uint32_t offset, VkShaderStageFlags shaderStage);
 
-		void BindDescriptorSet(Handle<DescriptorSet> descriptor, uint32_t index = 0U, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
-		void BindDescriptorSet(VkDescriptorSet descriptor, uint32_t index = 0U, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
+		void BindDescriptorSet(VkCommandBuffer commandBuffer, Handle<DescriptorSet> descriptor, uint32_t index = 0U, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
+		void BindDescriptorSet(VkCommandBuffer commandBuffer, VkDescriptorSet descriptor, uint32_t index = 0U, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 
 		const VkPipelineLayout GetLayout() const { return m_Layout; }
 
@@ -35,8 +35,6 @@ namespace en
 
 		VkPipelineLayout m_Layout = VK_NULL_HANDLE;
 		VkPipeline		 m_Pipeline = VK_NULL_HANDLE;
-
-		VkCommandBuffer m_BoundCommandBuffer = VK_NULL_HANDLE;
 	};
 }
 
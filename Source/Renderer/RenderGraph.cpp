@@ -0,0 +1,426 @@
+#include "RenderGraph.hpp"
+
+#include <Core/Profiler.hpp>
+
+#include <algorithm>
+
+namespace en
+{
+	struct AccessInfo
+	{
+		VkImageLayout		  layout;
+		VkPipelineStageFlags2 stages;
+		VkAccessFlags2		  readAccess;
+		VkAccessFlags2		  writeAccess;
+	};
+
+	AccessInfo GetAccessInfo(const RenderGraph::Access access)
+	{
+		switch (access)
+		{
+		case RenderGraph::Access::ColorAttachment:
+			return AccessInfo{
+				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+				VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT,
+				VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+			};
+		case RenderGraph::Access::DepthAttachment:
+			return AccessInfo{
+				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+				VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+				VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+			};
+		case RenderGraph::Access::FragmentSampled:
+			return AccessInfo{
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+				VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+				0U
+			};
+		}
+
+		return AccessInfo{};
+	}
+
+	VkDeviceSize AlignUp(const VkDeviceSize offset, const VkDeviceSize alignment)
+	{
+		return (offset + alignment - 1U) / alignment * alignment;
+	}
+
+	void RenderGraph::PassBuilder::Read(const ImageID image, const Access access)
+	{
+		Use(image, access, true, false);
+	}
+	void RenderGraph::PassBuilder::Write(const ImageID image, const Access access)
+	{
+		if (access == Access::FragmentSampled)
+			EN_ERROR("RenderGraph::PassBuilder::Write() - \"" + std::string(m_Graph.m_Images[image].name) + "\" can't be written by sampling it!");
+
+		Use(image, access, false, true);
+	}
+	void RenderGraph::PassBuilder::SetSideEffects()
+	{
+		m_Graph.m_Passes[m_Pass].sideEffects = true;
+	}
+	void RenderGraph::PassBuilder::SetSubmission(const uint32_t submission)
+	{
+		// The submissions run one after another, so the passes would run out of order otherwise
+		if (m_Pass > 0U && submission < m_Graph.m_Passes[m_Pass - 1U].submission)
+			EN_ERROR("RenderGraph::PassBuilder::SetSubmission() - \"" + std::string(m_Graph.m_Passes[m_Pass].name) + "\" can't be recorded into an earlier submission than the pass before it!");
+
+		m_Graph.m_Passes[m_Pass].submission = submission;
+	}
+	void RenderGraph::PassBuilder::Use(const ImageID image, const Access access, const bool read, const bool write)
+	{
+		auto& uses = m_Graph.m_Passes[m_Pass].uses;
+
+		const auto use = std::find_if(uses.begin(), uses.end(), [image](const ImageUse& use) { return use.image == image; });
+
+		if (use == uses.end())
+		{
+			uses.emplace_back(ImageUse{ image, access, read, write });
+			return;
+		}
+
+		// An image only has one layout for the whole pass
+		if (use->access != access)
+			EN_ERROR("RenderGraph::PassBuilder::Use() - \"" + std::string(m_Graph.m_Passes[m_Pass].name) + "\" uses \"" + m_Graph.m_Images[image].name + "\" in two different ways!");
+
+		use->read  |= read;
+		use->write |= write;
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		// The images go first, they are placed in the allocations
+		for (auto& image : m_Images)
+			image.image.reset();
+
+		for (const auto& allocation : m_Allocations)
+			vmaFreeMemory(Context::Get().m_Allocator, allocation.allocation);
+	}
+
+	RenderGraph::ImageID RenderGraph::ImportImage(const char* name, const bool output)
+	{
+		m_Images.emplace_back(ImageResource{
+			.name	  = name,
+			.imported = true,
+			.output	  = output,
+		});
+
+		return static_cast<ImageID>(m_Images.size() - 1U);
+	}
+	RenderGraph::ImageID RenderGraph::CreateImage(const char* name, const TransientImageInfo& info)
+	{
+		m_Images.emplace_back(ImageResource{
+			.name = name,
+			.info = info,
+		});
+
+		return static_cast<ImageID>(m_Images.size() - 1U);
+	}
+	void RenderGraph::AddPass(const char* name, const std::function<void(PassBuilder&)>& setup, const std::function<void(VkCommandBuffer)>& execute)
+	{
+		if (m_Compiled)
+			EN_ERROR("RenderGraph::AddPass() - Failed to add \"" + std::string(name) + "\" because the graph is already compiled!");
+
+		// Stays in the submission of the pass before it unless the setup moves it on
+		m_Passes.emplace_back(Pass{
+			.name		= name,
+			.execute	= execute,
+			.submission = m_Passes.empty() ? 0U : m_Passes.back().submission,
+		});
+
+		PassBuilder builder(*this, static_cast<uint32_t>(m_Passes.size() - 1U));
+		setup(builder);
+	}
+
+	void RenderGraph::Compile()
+	{
+		EN_PROFILE_FUNCTION();
+
+		CullPasses();
+		AllocateImages();
+		ComputeBarriers();
+
+		m_Compiled = true;
+
+		constexpr float MEGABYTE = 1024.0f * 1024.0f;
+
+		EN_LOG(
+			"Compiled the render graph with " + std::to_string(m_Stats.passes - m_Stats.culledPasses) + " of " + std::to_string(m_Stats.passes) + " passes and " +
+			std::to_string(m_Stats.barriers) + " barriers, " + std::to_string(m_Stats.transientImages) + " transient images take " +
+			std::to_string(m_Stats.allocatedSize / MEGABYTE) + "MB instead of " + std::to_string(m_Stats.transientSize / MEGABYTE) + "MB"
+		);
+	}
+	void RenderGraph::Execute(const std::vector<VkCommandBuffer>& submissions, GPUProfiler& profiler)
+	{
+		if (!m_Compiled)
+			EN_ERROR("RenderGraph::Execute() - The graph has to be compiled first!");
+
+		for (const auto& pass : m_Passes)
+		{
+			if (pass.culled) continue;
+
+			if (pass.submission >= submissions.size())
+				EN_ERROR("RenderGraph::Execute() - There is no command buffer for the submission of \"" + std::string(pass.name) + "\"!");
+
+			const VkCommandBuffer cmd = submissions[pass.submission];
+
+			profiler.BeginScope(cmd, pass.name);
+
+			for (const auto& barrier : pass.barriers)
+			{
+				const auto& image = m_Images[barrier.image].image;
+
+				if (barrier.discard)
+					image->m_CurrentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+				m_Barriers.Add(*image, barrier.newLayout, barrier.srcAccess, barrier.dstAccess, barrier.srcStages, barrier.dstStages);
+			}
+
+			m_Barriers.Flush(cmd);
+
+			pass.execute(cmd);
+
+			profiler.EndScope(cmd);
+		}
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Whether the current contents of an image are used by one of the passes after the one that is visited
+		std::vector<bool> needed(m_Images.size());
+
+		for (size_t i = 0U; i < m_Images.size(); i++)
+			needed[i] = m_Images[i].output;
+
+		for (auto pass = m_Passes.rbegin(); pass != m_Passes.rend(); pass++)
+		{
+			pass->culled = !pass->sideEffects && std::none_of(pass->uses.begin(), pass->uses.end(), [&](const ImageUse& use) { return use.write && needed[use.image]; });
+
+			if (pass->culled)
+			{
+				m_Stats.culledPasses++;
+				continue;
+			}
+
+			for (const auto& use : pass->uses)
+				if (use.write)
+					needed[use.image] = false;
+
+			for (const auto& use : pass->uses)
+				if (use.read)
+					needed[use.image] = true;
+		}
+
+		m_Stats.passes = static_cast<uint32_t>(m_Passes.size());
+
+		std::vector<bool> written(m_Images.size());
+
+		for (uint32_t i = 0U; i < m_Passes.size(); i++)
+		{
+			if (m_Passes[i].culled) continue;
+
+			for (const auto& use : m_Passes[i].uses)
+			{
+				auto& image = m_Images[use.image];
+
+				if (use.read && !image.imported && !written[use.image])
+					EN_ERROR("RenderGraph::CullPasses() - \"" + std::string(m_Passes[i].name) + "\" reads \"" + image.name + "\" before any pass writes it!");
+
+				if (use.write)
+					written[use.image] = true;
+
+				image.firstPass = std::min(image.firstPass, i);
+				image.lastPass	= std::max(image.lastPass, i);
+			}
+		}
+	}
+	void RenderGraph::AllocateImages()
+	{
+		UseContext();
+
+		std::vector<ImageID> transientImages;
+
+		for (ImageID i = 0U; i < m_Images.size(); i++)
+		{
+			auto& image = m_Images[i];
+
+			if (image.imported || image.firstPass == UINT32_MAX) continue;
+
+			image.memoryRequirements = Image::GetMemoryRequirements(image.info.extent, image.info.format, image.info.usage, image.info.layers);
+
+			m_Stats.transientSize += image.memoryRequirements.size;
+
+			transientImages.emplace_back(i);
+		}
+
+		m_Stats.transientImages = static_cast<uint32_t>(transientImages.size());
+
+		// The largest images are placed first, the smaller ones fill the gaps between them
+		std::sort(transientImages.begin(), transientImages.end(), [&](const ImageID a, const ImageID b) { return m_Images[a].memoryRequirements.size > m_Images[b].memoryRequirements.size; });
+
+		for (const ImageID id : transientImages)
+		{
+			auto& image = m_Images[id];
+
+			const VkMemoryRequirements& requirements = image.memoryRequirements;
+
+			for (uint32_t i = 0U; i < m_Allocations.size() && image.allocation == UINT32_MAX; i++)
+			{
+				auto& allocation = m_Allocations[i];
+
+				if (!(allocation.requirements.memoryTypeBits & requirements.memoryTypeBits)) continue;
+
+				// The ranges of the images alive at the same time, the lowest gap that fits between them is taken
+				std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied;
+
+				for (const ImageID placedID : allocation.images)
+				{
+					const auto& placed = m_Images[placedID];
+
+					if (placed.firstPass <= image.lastPass && image.firstPass <= placed.lastPass)
+						occupied.emplace_back(placed.offset, placed.offset + placed.memoryRequirements.size);
+				}
+
+				std::sort(occupied.begin(), occupied.end());
+
+				VkDeviceSize offset = 0U;
+
+				for (const auto& [begin, end] : occupied)
+				{
+					if (AlignUp(offset, requirements.alignment) + requirements.size <= begin)
+						break;
+
+					offset = std::max(offset, end);
+				}
+
+				image.allocation = i;
+				image.offset	 = AlignUp(offset, requirements.alignment);
+
+				allocation.requirements.size		   = std::max(allocation.requirements.size, image.offset + requirements.size);
+				allocation.requirements.alignment	   = std::max(allocation.requirements.alignment, requirements.alignment);
+				allocation.requirements.memoryTypeBits &= requirements.memoryTypeBits;
+
+				allocation.images.emplace_back(id);
+			}
+
+			if (image.allocation != UINT32_MAX) continue;
+
+			image.allocation = static_cast<uint32_t>(m_Allocations.size());
+			image.offset	 = 0U;
+
+			m_Allocations.emplace_back(Allocation{
+				.requirements = requirements,
+				.images		  = { id },
+			});
+		}
+
+		constexpr VmaAllocationCreateInfo allocationInfo{
+			.usage = VMA_MEMORY_USAGE_GPU_ONLY
+		};
+
+		for (auto& allocation : m_Allocations)
+		{
+			if (vmaAllocateMemory(ctx.m_Allocator, &allocation.requirements, &allocationInfo, &allocation.allocation, nullptr) != VK_SUCCESS)
+				EN_ERROR("RenderGraph::AllocateImages() - Failed to allocate memory for the transient images!");
+
+			for (const ImageID id : allocation.images)
+			{
+				auto& image = m_Images[id];
+
+				image.image = MakeHandle<Image>(allocation.allocation, image.offset, image.info.extent, image.info.format, image.info.usage, image.info.aspect, image.info.layers);
+			}
+
+			m_Stats.allocatedSize += allocation.requirements.size;
+		}
+
+		m_Stats.allocations = static_cast<uint32_t>(m_Allocations.size());
+	}
+	void RenderGraph::ComputeBarriers()
+	{
+		// What was done to every image since its last barrier
+		struct ImageState
+		{
+			VkImageLayout		  layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags2 stages = 0U;
+			VkAccessFlags2		  writes = 0U;
+		};
+
+		std::vector<ImageState> states(m_Images.size());
+
+		for (auto& pass : m_Passes)
+		{
+			if (pass.culled) continue;
+
+			for (const auto& use : pass.uses)
+			{
+				if (m_Images[use.image].imported) continue;
+
+				const AccessInfo info = GetAccessInfo(use.access);
+
+				const VkAccessFlags2 writes	   = use.write ? info.writeAccess : 0U;
+				const VkAccessFlags2 dstAccess = (use.read ? info.readAccess : 0U) | writes;
+
+				auto& state = states[use.image];
+
+				// Reading again in the same layout doesn't have to wait for the other reads
+				if (state.layout == info.layout && state.writes == 0U && writes == 0U)
+				{
+					state.stages |= info.stages;
+					continue;
+				}
+
+				// The source of the first barrier is only known once every image has its last use
+				pass.barriers.emplace_back(Barrier{
+					.image	   = use.image,
+					.newLayout = info.layout,
+					.srcAccess = state.writes,
+					.dstAccess = dstAccess,
+					.srcStages = state.stages,
+					.dstStages = info.stages,
+					.discard   = state.layout == VK_IMAGE_LAYOUT_UNDEFINED,
+				});
+
+				state = ImageState{ info.layout, info.stages, writes };
+			}
+		}
+
+		for (ImageID i = 0U; i < m_Images.size(); i++)
+		{
+			m_Images[i].lastStages = states[i].stages;
+			m_Images[i].lastWrites = states[i].writes;
+		}
+
+		// The memory was last used by the images placed over the same bytes, either earlier in the frame or in the previous one
+		for (auto& pass : m_Passes)
+		{
+			for (auto& barrier : pass.barriers)
+			{
+				if (!barrier.discard) continue;
+
+				const auto& image = m_Images[barrier.image];
+
+				for (const auto& other : m_Images)
+				{
+					if (!other.image || !SharesMemory(image, other)) continue;
+
+					barrier.srcStages |= other.lastStages;
+					barrier.srcAccess |= other.lastWrites;
+				}
+			}
+
+			m_Stats.barriers += static_cast<uint32_t>(pass.barriers.size());
+		}
+	}
+
+	bool RenderGraph::SharesMemory(const ImageResource& a, const ImageResource& b) const
+	{
+		return a.allocation == b.allocation &&
+			a.offset < b.offset + b.memoryRequirements.size &&
+			b.offset < a.offset + a.memoryRequirements.size;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#pragma once
+
+#ifndef EN_RENDERGRAPH_HPP
+#define EN_RENDERGRAPH_HPP
+
+#include <Renderer/Context.hpp>
+#include <Renderer/Image.hpp>
+#include <Renderer/BarrierBatch.hpp>
+#include <Renderer/GPUProfiler.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace en
+{
+	// The passes of a frame, declaring the images they read and write instead of transitioning them by hand. Compile() culls the
+	// passes whose results nothing uses, works out the barriers between the rest and places the transient images that are never
+	// alive at the same time in the same memory. The passes run in the order they were added.
+	class RenderGraph
+	{
+	public:
+		using ImageID = uint32_t;
+
+		enum struct Access
+		{
+			ColorAttachment,
+			DepthAttachment,
+			FragmentSampled,
+		};
+
+		struct TransientImageInfo
+		{
+			VkExtent2D		   extent{};
+			VkFormat		   format = VK_FORMAT_UNDEFINED;
+			VkImageUsageFlags  usage  = 0U;
+			VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+
+			uint32_t layers = 1U;
+		};
+
+		class PassBuilder
+		{
+		public:
+			// Attachments that are loaded have to be read as well as written, otherwise their previous writer could be culled
+			void Read(const ImageID image, const Access access);
+			void Write(const ImageID image, const Access access);
+
+			// Keeps the pass even when nothing reads its images, for passes that write buffers or images outside of the graph
+			void SetSideEffects();
+
+			// Records the pass into the command buffer of this submission instead of the first one, see Execute(). The passes
+			// after it can't go into an earlier submission.
+			void SetSubmission(const uint32_t submission);
+
+		private:
+			friend class RenderGraph;
+
+			PassBuilder(RenderGraph& graph, const uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+			void Use(const ImageID image, const Access access, const bool read, const bool write);
+
+			RenderGraph& m_Graph;
+			uint32_t	 m_Pass;
+		};
+
+		struct Stats
+		{
+			uint32_t passes			 = 0U;
+			uint32_t culledPasses	 = 0U;
+			uint32_t barriers		 = 0U; // Recorded every frame
+			uint32_t transientImages = 0U;
+			uint32_t allocations	 = 0U;
+
+			// What the transient images would take on their own and the memory they share instead
+			VkDeviceSize transientSize = 0U;
+			VkDeviceSize allocatedSize = 0U;
+		};
+
+		RenderGraph() = default;
+		~RenderGraph();
+
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+
+		// An image the graph neither owns nor synchronizes, e.g. the swapchain image. Output images keep the passes writing them
+		// (and everything those depend on) from being culled.
+		ImageID ImportImage(const char* name, const bool output = false);
+
+		// Only allocated by Compile() when a pass that wasn't culled uses it, its contents don't outlive the frame
+		ImageID CreateImage(const char* name, const TransientImageInfo& info);
+
+		// The name is used for the GPU profiler scope too, so it has to be a string literal
+		void AddPass(const char* name, const std::function<void(PassBuilder&)>& setup, const std::function<void(VkCommandBuffer)>& execute);
+
+		void Compile();
+
+		// Records the barriers of every pass that wasn't culled (as a single batch) before running it, both into the command buffer
+		// of its submission. They have to be submitted in order to the same queue, but the later ones can wait for other queues
+		// without holding up the passes before them.
+		void Execute(const std::vector<VkCommandBuffer>& submissions, GPUProfiler& profiler);
+
+		// Null for the transient images that weren't allocated
+		Handle<Image> GetImage(const ImageID image) const { return m_Images[image].image; }
+
+		const Stats& GetStats() const { return m_Stats; }
+
+	private:
+		struct ImageResource
+		{
+			const char* name = nullptr;
+
+			bool imported = false;
+			bool output	  = false;
+
+			TransientImageInfo info{};
+
+			Handle<Image> image;
+
+			// Of the passes that weren't culled
+			uint32_t firstPass = UINT32_MAX;
+			uint32_t lastPass  = 0U;
+
+			VkMemoryRequirements memoryRequirements{};
+
+			uint32_t	 allocation = UINT32_MAX;
+			VkDeviceSize offset		= 0U;
+
+			// Of the last use in the frame, the first barrier of the images placed over it has to wait for it
+			VkPipelineStageFlags2 lastStages = 0U;
+			VkAccessFlags2		  lastWrites = 0U;
+		};
+
+		struct ImageUse
+		{
+			ImageID image  = 0U;
+			Access	access = Access::ColorAttachment;
+
+			bool read  = false;
+			bool write = false;
+		};
+
+		struct Barrier
+		{
+			ImageID image = 0U;
+
+			VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VkAccessFlags2		  srcAccess = 0U;
+			VkAccessFlags2		  dstAccess = 0U;
+			VkPipelineStageFlags2 srcStages = 0U;
+			VkPipelineStageFlags2 dstStages = 0U;
+
+			// The first use of a transient image in the frame, whatever it held is thrown away
+			bool discard = false;
+		};
+
+		struct Pass
+		{
+			const char* name = nullptr;
+
+			std::function<void(VkCommandBuffer)> execute;
+
+			std::vector<ImageUse> uses;
+			std::vector<Barrier>  barriers;
+
+			uint32_t submission = 0U;
+
+			bool sideEffects = false;
+			bool culled		 = false;
+		};
+
+		struct Allocation
+		{
+			VmaAllocation		 allocation = VK_NULL_HANDLE;
+			VkMemoryRequirements requirements{};
+
+			std::vector<ImageID> images;
+		};
+
+		std::vector<ImageResource> m_Images;
+		std::vector<Pass>		   m_Passes;
+		std::vector<Allocation>	   m_Allocations;
+
+		Stats m_Stats{};
+
+		// Kept so its storage is reused by every pass
+		BarrierBatch m_Barriers;
+
+		bool m_Compiled = false;
+
+		void CullPasses();
+		void ComputeBarriers();
+		void AllocateImages();
+
+		// Whether both images are placed over some of the same bytes, no matter when they are alive
+		bool SharesMemory(const ImageResource& a, const ImageResource& b) const;
+	};
+}
+
+#endif
\ No newline at end of file
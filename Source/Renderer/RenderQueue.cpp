@@ -0,0 +1,80 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace en
+{
+	// Below this many packets the histograms cost more than a comparison sort
+	constexpr size_t RADIX_SORT_THRESHOLD = 64U;
+
+	uint64_t RenderQueue::MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t geometry, float depth, bool depthFirst)
+	{
+		const uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * 16777215.0f);
+
+		uint64_t key = (static_cast<uint64_t>(pass & 0xFU) << 60U) | (static_cast<uint64_t>(pipeline & 0xFU) << 56U);
+
+		if (depthFirst)
+			key |= (quantizedDepth << 32U) | (static_cast<uint64_t>(material & 0xFFFFU) << 16U) | static_cast<uint64_t>(geometry & 0xFFFFU);
+		else
+			key |= (static_cast<uint64_t>(material & 0xFFFFU) << 40U) | (static_cast<uint64_t>(geometry & 0xFFFFU) << 24U) | quantizedDepth;
+
+		return key;
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Packets.clear();
+		m_Draws.clear();
+	}
+	void RenderQueue::Push(uint64_t key, uint32_t drawIndex)
+	{
+		m_Packets.emplace_back(Packet{ key, drawIndex });
+	}
+	void RenderQueue::Sort()
+	{
+		const size_t count = m_Packets.size();
+
+		if (count <= RADIX_SORT_THRESHOLD)
+			std::stable_sort(m_Packets.begin(), m_Packets.end(), [](const Packet& a, const Packet& b) { return a.key < b.key; });
+		else
+		{
+			// LSD radix sort, one pass per byte with all the histograms gathered up front
+			std::array<std::array<uint32_t, 256>, 8> histograms{};
+
+			for (const auto& packet : m_Packets)
+				for (uint32_t byte = 0U; byte < 8U; byte++)
+					histograms[byte][(packet.key >> (byte * 8U)) & 0xFFU]++;
+
+			m_SortBuffer.resize(count);
+
+			for (uint32_t byte = 0U; byte < 8U; byte++)
+			{
+				auto& histogram = histograms[byte];
+
+				// Every key has the same value in this byte, so the pass wouldn't change anything
+				if (histogram[(m_Packets[0].key >> (byte * 8U)) & 0xFFU] == count)
+					continue;
+
+				uint32_t offset = 0U;
+
+				for (auto& bucket : histogram)
+				{
+					const uint32_t bucketSize = bucket;
+					bucket = offset;
+					offset += bucketSize;
+				}
+
+				for (const auto& packet : m_Packets)
+					m_SortBuffer[histogram[(packet.key >> (byte * 8U)) & 0xFFU]++] = packet;
+
+				m_Packets.swap(m_SortBuffer);
+			}
+		}
+
+		m_Draws.resize(count);
+
+		for (size_t i = 0U; i < count; i++)
+			m_Draws[i] = m_Packets[i].drawIndex;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifndef EN_RENDERQUEUE_HPP
+#define EN_RENDERQUEUE_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace en
+{
+	class RenderQueue
+	{
+	public:
+		// Bits from the most significant: pass (4), pipeline (4), material (16), geometry (16) and depth (24).
+		// With depthFirst the depth goes right after the pipeline, which gives front to back order for the depth only passes.
+		static uint64_t MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t geometry, float depth, bool depthFirst = false);
+
+		void Clear();
+		void Push(uint64_t key, uint32_t drawIndex);
+
+		// Stable, so draws with equal keys keep the order they were pushed in
+		void Sort();
+
+		// Draw indices in the sorted order, valid after Sort()
+		const std::vector<uint32_t>& GetDraws() const { return m_Draws; }
+		const uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_Draws.size()); }
+
+	private:
+		struct Packet
+		{
+			uint64_t key;
+			uint32_t drawIndex;
+			uint32_t _padding0;
+		};
+
+		std::vector<Packet> m_Packets;
+		std::vector<Packet> m_SortBuffer;
+
+		std::vector<uint32_t> m_Draws;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,35 +1,115 @@
 #include "Renderer.hpp"
 
+#include <Core/Profiler.hpp>
+
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <utility>
+
 namespace en
 {
 	Renderer* g_CurrentBackend{};
 	Context*  g_Ctx{};
 
+	constexpr uint32_t DRAW_CULLING_GROUP_SIZE = 64U;
+
+	constexpr float DRAW_COMMANDS_OVERFLOW_MULTIPLIER = 1.2f;
+
+	constexpr uint32_t DRAWS_PER_COMMAND_BUFFER = 256U;
+
+	// Of every frame's staging region to begin with, enough for the camera and a few changed lights and matrices
+	constexpr VkDeviceSize FRAME_STAGING_SIZE = 1024U * 1024U;
+
+	// Pass IDs in the render queue keys
+	constexpr uint32_t SHADOW_QUEUE_PASS  = 0U;
+	constexpr uint32_t DEPTH_QUEUE_PASS   = 1U;
+	constexpr uint32_t FORWARD_QUEUE_PASS = 2U;
+
+	// CullingView::drawMask bits, same as in DrawCulling.comp
+	constexpr uint32_t VIEW_DRAWS_STATIC  = 1U;
+	constexpr uint32_t VIEW_DRAWS_DYNAMIC = 2U;
+	constexpr uint32_t VIEW_DRAWS_ALL	  = VIEW_DRAWS_STATIC | VIEW_DRAWS_DYNAMIC;
+
+	constexpr VkFormat SSAO_FORMAT = VK_FORMAT_R8_UNORM;
+
+	// The parts every backend part takes down with it, in an order where a single pass covers the whole chain
+	constexpr std::array<std::pair<uint32_t, uint32_t>, 2> BACKEND_DEPENDENTS{{
+		{ Renderer::BACKEND_SHADOW_RESOURCES, Renderer::BACKEND_SHADOW_MAPS },
+		{ Renderer::BACKEND_OUTPUT,			  Renderer::BACKEND_RENDER_GRAPH },
+	}};
+
+	// A single combined image sampler, the fullscreen passes read the targets of the previous ones through it
+	DescriptorInfo FullscreenImageInfo(const VkImageView imageView, const VkSampler sampler)
+	{
+		return DescriptorInfo{
+			std::vector<DescriptorInfo::ImageInfo>{
+				DescriptorInfo::ImageInfo {
+					.contents {{
+						.imageView = imageView,
+						.imageSampler = sampler
+					}}
+				}
+			},
+			std::vector<DescriptorInfo::BufferInfo>{},
+		};
+	}
+
 	Renderer::Renderer()
 	{
 		g_Ctx = &Context::Get();
 
 		g_CurrentBackend = this;
 
-		Window::Get().SetResizeCallback(Renderer::FramebufferResizeCallback);
+		if (!g_Ctx->IsHeadless())
+			Window::Get().SetResizeCallback(Renderer::FramebufferResizeCallback);
+
+		m_GPUProfiler = MakeScope<GPUProfiler>();
+		m_StagingRing = MakeScope<StagingRing>(FRAMES_IN_FLIGHT, FRAME_STAGING_SIZE);
 
 		CreateBackend();
 	}
 	Renderer::~Renderer()
 	{
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+		// The jobs write into the passes, the errors don't matter anymore at this point
+		JobSystem::Get().Wait(m_RequiredPipelines);
+		JobSystem::Get().Wait(m_DeferredPipelines);
+
+		if (m_BackendBuild)
+			JobSystem::Get().Wait(m_BackendBuild->pipelines);
+
+		g_Ctx->WaitIdle();
 
 		DestroyPerFrameData();
 	}
 
 	void Renderer::Update()
 	{
+		EN_PROFILE_FUNCTION();
+
 		m_ClusterFrustumChanged = false;
 
 		if (m_Scene)
 		{
+			// There is no window to scale the camera with, it follows the offscreen target instead
+			if (m_OffscreenTarget)
+			{
+				m_Scene->m_MainCamera->m_DynamicallyScaled = false;
+				m_Scene->m_MainCamera->m_Size = glm::vec2(m_OffscreenExtent.width, m_OffscreenExtent.height);
+			}
+			else if (m_Scene->m_MainCamera->m_DynamicallyScaled)
+			{
+				// A minimized window keeps the last size
+				const glm::ivec2 size = Window::Get().GetSize();
+
+				if (size.x * size.y > 0)
+					m_Scene->m_MainCamera->m_Size = size;
+			}
+
 			m_Scene->UpdateSceneCPU();
+			AllocateShadowTiles();
 			UpdateCSM();
+			CullScene();
 
 			glm::mat4 oldInvProj = m_CameraBuffer->m_CBOs[m_FrameIndex].invProj;
 
@@ -39,7 +119,8 @@ namespace en
 				m_CSM.cascadeSplitDistances,
 				m_CSM.cascadeFrustumSizeRatios,
 				m_CSM.cascadeMatrices,
-				m_Swapchain->GetExtent(),
+				m_ShadowAtlasRects,
+				GetOutputExtent(),
 				m_DebugMode
 			);
 
@@ -49,37 +130,77 @@ namespace en
 	}
 	void Renderer::PreRender()
 	{
+		EN_PROFILE_FUNCTION();
+
 		if (m_Scene)
 		{
-			if (m_Scene->m_GlobalDescriptorChanged)
+			const bool drawCommandsOverflow = m_Scene->GetDrawCount() > m_DrawCulling.capacity;
+			const bool shadowMapsOutdated   = ShadowMapsOutdated();
+
+			// The old shadow maps are retired, so they don't need the frames in flight to finish
+			if (m_Scene->m_GlobalDescriptorChanged || drawCommandsOverflow)
 				ResetAllFrames();
 			else
 				WaitForActiveFrame();
 
-			m_CameraBuffer->MapBuffer(m_FrameIndex);
+			if (drawCommandsOverflow)
+				CreateDrawCullingBuffers(m_Scene->GetDrawCount() * DRAW_COMMANDS_OVERFLOW_MULTIPLIER);
+
+			if (shadowMapsOutdated)
+				UpdateShadowMaps();
 		}
 		else 
 			WaitForActiveFrame();
 	}
 	void Renderer::Render()
 	{
+		EN_PROFILE_FUNCTION();
+
 		MeasureFrameTime();
 
 		BeginRender();
 
-		m_Scene->UpdateSceneGPU(m_Frames[m_FrameIndex].commandBuffer);
+		if (m_SkipFrame) return;
+
+		const auto& frame = m_Frames[m_FrameIndex];
+
+		const VkCommandBuffer uploadCmd = frame.commandBuffers[UPLOAD_SUBMISSION];
+		const VkCommandBuffer cmd		= frame.commandBuffers[MAIN_SUBMISSION];
+
+		// Ends in another command buffer than it begins in, so it goes without a debug label
+		m_GPUProfiler->BeginScope(uploadCmd, "Frame", false);
 
 		if (m_Scene)
 		{
-			ShadowPass();
-			ClusterComputePass();
-			DepthPass();
-			SSAOPass();
-			ForwardPass();
-			AntialiasingPass();
+			m_GPUProfiler->BeginScope(uploadCmd, "Scene Upload");
+				m_CameraBuffer->UploadBuffer(m_FrameIndex, uploadCmd, *m_StagingRing);
+				m_Scene->UpdateSceneGPU(uploadCmd, *m_StagingRing);
+			m_GPUProfiler->EndScope(uploadCmd);
+
+			for (auto& buffer : m_Scene->m_RetiredBuffers)
+				Retire(buffer);
+
+			m_Scene->m_RetiredBuffers.clear();
+
+			RecordSecondaryCommandBuffers();
+
+			// Overlaps the early submission on the compute queue, without one it's a pass of the graph instead
+			if (g_Ctx->HasAsyncCompute())
+			{
+				m_GPUProfiler->BeginComputeScope(frame.computeCommandBuffer, "Cluster Culling");
+					ClusterComputePass(frame.computeCommandBuffer);
+				m_GPUProfiler->EndScope(frame.computeCommandBuffer);
+			}
+
+			// Every pass gets a profiler scope of its own
+			m_RenderGraph->Execute(frame.commandBuffers, *m_GPUProfiler);
 		}
 
-		ImGuiPass();
+		m_GPUProfiler->BeginScope(cmd, "ImGui");
+			ImGuiPass();
+		m_GPUProfiler->EndScope(cmd);
+
+		m_GPUProfiler->EndScope(cmd);
 
 		EndRender();
 	}
@@ -87,6 +208,10 @@ namespace en
 	void Renderer::BindScene(en::Handle<Scene> scene)
 	{
 		m_Scene = scene;
+
+		// The cached shadow maps were rendered with the previous scene's casters
+		for (auto& cache : m_ShadowCaches)
+			cache.Invalidate();
 	}
 	void Renderer::UnbindScene()
 	{
@@ -95,6 +220,8 @@ namespace en
 
 	void Renderer::WaitForActiveFrame()
 	{
+		EN_PROFILE_FUNCTION();
+
 		vkWaitForFences(
 			g_Ctx->m_LogicalDevice, 
 			1U, &m_Frames[m_FrameIndex].submitFence, 
@@ -103,6 +230,8 @@ namespace en
 	}
 	void Renderer::ResetAllFrames()
 	{
+		EN_PROFILE_FUNCTION();
+
 		for (const auto& frame : m_Frames)
 		{
 			vkWaitForFences(
@@ -111,8 +240,15 @@ namespace en
 				VK_TRUE, UINT64_MAX
 			);
 
-			vkResetCommandBuffer(frame.commandBuffer, 0U);
+			for (const VkCommandBuffer cmd : frame.commandBuffers)
+				vkResetCommandBuffer(cmd, 0U);
+
+			if (frame.computeCommandBuffer)
+				vkResetCommandBuffer(frame.computeCommandBuffer, 0U);
 		}
+
+		for (auto& frame : m_Frames)
+			frame.retiredObjects.clear();
 	}
 
 	void Renderer::MeasureFrameTime()
@@ -127,730 +263,1741 @@ namespace en
 	}
 	void Renderer::BeginRender()
 	{
-		VkResult result = vkAcquireNextImageKHR(g_Ctx->m_LogicalDevice, m_Swapchain->m_Swapchain, UINT64_MAX, m_Frames[m_FrameIndex].mainSemaphore, VK_NULL_HANDLE, &m_Swapchain->m_ImageIndex);
+		EN_PROFILE_FUNCTION();
 
 		m_SkipFrame = false;
 
-		if (result == VK_ERROR_OUT_OF_DATE_KHR)
+		if (m_Swapchain)
 		{
-			RecreateFramebuffer();
-			m_SkipFrame = true;
-			return;
+			VkResult result{};
+
+			{
+				EN_PROFILE_SCOPE("vkAcquireNextImageKHR");
+				result = vkAcquireNextImageKHR(g_Ctx->m_LogicalDevice, m_Swapchain->m_Swapchain, UINT64_MAX, m_Frames[m_FrameIndex].mainSemaphore, VK_NULL_HANDLE, &m_Swapchain->m_ImageIndex);
+			}
+
+			if (result == VK_ERROR_OUT_OF_DATE_KHR)
+			{
+				ReloadBackend(BACKEND_OUTPUT);
+				ReloadBackendImpl();
+				m_SkipFrame = true;
+				return;
+			}
+			else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+				EN_ERROR("Renderer::BeginRender() - Failed to acquire swap chain image!");
+		}
+		else
+		{
+			// Nothing is acquired in headless mode, so the frame's fence is the only thing that keeps the CPU from running ahead
+			WaitForActiveFrame();
+			ReadbackFrame();
 		}
-		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
-			EN_ERROR("Renderer::BeginRender() - Failed to acquire swap chain image!");
 
 		vkResetFences(g_Ctx->m_LogicalDevice, 1U, &m_Frames[m_FrameIndex].submitFence);
 
-		vkResetCommandBuffer(m_Frames[m_FrameIndex].commandBuffer, 0U);
+		m_Frames[m_FrameIndex].retiredObjects.clear();
+
+		// The copies from the region were submitted with the frame, so they're done as well
+		m_StagingRing->Begin(m_FrameIndex);
+
+		for (auto& pool : m_Frames[m_FrameIndex].secondaryPools)
+		{
+			vkResetCommandPool(g_Ctx->m_LogicalDevice, pool.commandPool, 0U);
+			pool.usedCount = 0U;
+		}
 
 		constexpr VkCommandBufferBeginInfo beginInfo{
 			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
 		};
 
-		if (vkBeginCommandBuffer(m_Frames[m_FrameIndex].commandBuffer, &beginInfo) != VK_SUCCESS)
-			EN_ERROR("Renderer::BeginRender() - Failed to begin recording command buffer!");
-	}
-	void Renderer::ShadowPass()
-	{
-		if (m_SkipFrame) return;
-		
-		for (const auto& i : m_Scene->m_ActivePointLightsShadowIDs)
-		{
-			const auto& light = m_Scene->m_PointLights[i];
+		const auto beginCommandBuffer = [&beginInfo](VkCommandBuffer cmd) {
+			vkResetCommandBuffer(cmd, 0U);
 
-			m_PointShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
+			if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS)
+				EN_ERROR("Renderer::BeginRender() - Failed to begin recording command buffer!");
+		};
+
+		for (const VkCommandBuffer cmd : m_Frames[m_FrameIndex].commandBuffers)
+			beginCommandBuffer(cmd);
+
+		// It's done once the frame's fence is signaled as well, the main submission waits for it
+		if (g_Ctx->HasAsyncCompute())
+			beginCommandBuffer(m_Frames[m_FrameIndex].computeCommandBuffer);
+
+		// Everything recorded since the last frame began, one-time commands included
+		m_BarrierStats = BarrierBatch::ResetStats();
+
+		// The frame's fence was waited on in PreRender(), so its previous timestamps are ready. The upload is submitted first.
+		m_GPUProfiler->BeginFrame(m_Frames[m_FrameIndex].commandBuffers[UPLOAD_SUBMISSION], m_FrameIndex);
+
+		if (m_OffscreenTarget)
+			m_OffscreenTarget->ChangeLayout(
 				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
+				VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+				m_Frames[m_FrameIndex].commandBuffers[MAIN_SUBMISSION]
 			);
+	}
+	void Renderer::RecordSecondaryCommandBuffers()
+	{
+		if (m_SkipFrame) return;
 
-			for (uint32_t cubeSide = 0U; cubeSide < 6U; cubeSide++)
-			{
-				GraphicsPass::RenderInfo renderInfo{
-					.colorAttachmentView = m_PointShadowMaps[light.m_ShadowmapIndex]->GetLayerViewHandle(cubeSide),
-					.depthAttachmentView = m_PointShadowDepthBuffer->GetViewHandle(),
+		EN_PROFILE_FUNCTION();
 
-					.colorAttachmentLayout = m_PointShadowMaps[light.m_ShadowmapIndex]->GetLayout(),
-					.depthAttachmentLayout = m_PointShadowDepthBuffer->GetLayout(),
+		struct SecondaryRecording {
+			VkCommandBuffer*		 commandBuffer;
+			Handle<GraphicsPass>	 pass;
+			GraphicsPass::RenderInfo renderInfo;
 
-					.extent = m_PointShadowMaps[light.m_ShadowmapIndex]->m_Size,
+			std::function<void(VkCommandBuffer)> record;
+		};
 
-					.cullMode = VK_CULL_MODE_FRONT_BIT
-				};
+		std::vector<SecondaryRecording> recordings;
 
-				m_PointShadowPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
+		for (const auto& i : m_Scene->m_ActivePointLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_PointLights[i];
 
-				m_PointShadowPass->BindDescriptorSet(m_Scene->m_LightingDescriptorSet->GetHandle());
+			// The multiview shader ignores the cube side and takes it from gl_ViewIndex instead
+			for (uint32_t cubeSide = 0U; cubeSide < (m_PointShadowMultiview ? 1U : 6U); cubeSide++)
+			{
+				const uint32_t view = POINT_CULLING_VIEWS + light.m_ShadowmapIndex * 6U + cubeSide;
 
-				for (const auto& [name, sceneObject] : m_Scene->m_SceneObjects)
-				{
-					if (!sceneObject->m_Active || !sceneObject->m_Mesh->m_Active) continue;
+				if (!m_CullingViewActive[view]) continue;
 
-					uint32_t pushConstant[3]{ sceneObject->GetMatrixIndex(), light.m_ShadowmapIndex, cubeSide };
+				const uint32_t shadowmapIndex = light.m_ShadowmapIndex;
 
-					m_PointShadowPass->PushConstants(
-						pushConstant,
-						sizeof(uint32_t) * 3,
-						0U,
-						VK_SHADER_STAGE_VERTEX_BIT
-					);
+				recordings.emplace_back(SecondaryRecording{
+					.commandBuffer = &m_ShadowCommandBuffers[view],
+					.pass = m_PointShadowPass,
+					.renderInfo = {
+						.extent = m_PointShadowMaps[shadowmapIndex]->m_Size,
+						.cullMode = VK_CULL_MODE_FRONT_BIT
+					},
+					.record = [this, shadowmapIndex, cubeSide, view](VkCommandBuffer cmd) {
+						m_PointShadowPass->BindDescriptorSet(cmd, m_Scene->m_LightingDescriptorSet->GetHandle());
 
-					for (const auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
-					{
-						if (!subMesh.m_Active) continue;
+						uint32_t pushConstant[2]{ shadowmapIndex, cubeSide };
 
-						m_PointShadowPass->BindVertexBuffer(subMesh.m_VertexBuffer);
-						m_PointShadowPass->BindIndexBuffer(subMesh.m_IndexBuffer);
+						m_PointShadowPass->PushConstants(cmd, pushConstant, sizeof(uint32_t) * 2, 0U, VK_SHADER_STAGE_VERTEX_BIT);
 
-						m_PointShadowPass->DrawIndexed(subMesh.m_IndexCount);
+						DrawScene(cmd, m_PointShadowPass, view, m_RenderQueues[view]);
 					}
-				}
-
-				m_PointShadowPass->End();
+				});
 			}
-
-			m_PointShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-			);
 		}
-		
 		for (const auto& i : m_Scene->m_ActiveSpotLightsShadowIDs)
 		{
-			const auto& light = m_Scene->m_SpotLights[i];
-
-			m_SpotShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
-				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-				VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-			);
-
-			GraphicsPass::RenderInfo renderInfo{
-				.depthAttachmentView = m_SpotShadowMaps[light.m_ShadowmapIndex]->GetViewHandle(),
-				.depthAttachmentLayout = m_SpotShadowMaps[light.m_ShadowmapIndex]->GetLayout(),
-
-				.extent = m_SpotShadowMaps[light.m_ShadowmapIndex]->m_Size,
+			const uint32_t shadowmapIndex = m_Scene->m_SpotLights[i].m_ShadowmapIndex;
+			const uint32_t slot = shadowmapIndex;
 
-				.cullMode = VK_CULL_MODE_FRONT_BIT
-			};
-
-			m_SpotShadowPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
-
-			m_SpotShadowPass->BindDescriptorSet(m_Scene->m_LightingDescriptorSet->GetHandle());
+			const auto& tile = m_ShadowAtlasLayout.GetTile(slot);
 
-			for (const auto& [name, sceneObject] : m_Scene->m_SceneObjects)
+			// The tile itself and its static cache, both are drawn at the same place
+			for (const uint32_t view : { SPOT_CULLING_VIEWS + slot, STATIC_CULLING_VIEWS + slot })
 			{
-				if (!sceneObject->m_Active || !sceneObject->m_Mesh->m_Active) continue;
-
-				uint32_t pushConstant[2]{ sceneObject->GetMatrixIndex(), light.m_ShadowmapIndex };
-
-				m_SpotShadowPass->PushConstants(
-					pushConstant,
-					sizeof(uint32_t) * 2,
-					0U,
-					VK_SHADER_STAGE_VERTEX_BIT
-				);
-
-				for (const auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
-				{
-					if (!subMesh.m_Active) continue;
-
-					m_SpotShadowPass->BindVertexBuffer(subMesh.m_VertexBuffer);
-					m_SpotShadowPass->BindIndexBuffer(subMesh.m_IndexBuffer);
-
-					m_SpotShadowPass->DrawIndexed(subMesh.m_IndexCount);
-				}
+				if (!m_CullingViewActive[view]) continue;
+
+				recordings.emplace_back(SecondaryRecording{
+					.commandBuffer = &m_ShadowCommandBuffers[view],
+					.pass = m_SpotShadowPass,
+					.renderInfo = {
+						.offset = { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) },
+						.extent = { tile.size, tile.size },
+						.cullMode = VK_CULL_MODE_FRONT_BIT
+					},
+					.record = [this, shadowmapIndex, view](VkCommandBuffer cmd) {
+						m_SpotShadowPass->BindDescriptorSet(cmd, m_Scene->m_LightingDescriptorSet->GetHandle());
+
+						m_SpotShadowPass->PushConstants(cmd, &shadowmapIndex, sizeof(uint32_t), 0U, VK_SHADER_STAGE_VERTEX_BIT);
+
+						DrawScene(cmd, m_SpotShadowPass, view, m_RenderQueues[view]);
+					}
+				});
 			}
-
-			m_SpotShadowPass->End();
-
-			m_SpotShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-				VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-			);
 		}
-		
 		for (const auto& i : m_Scene->m_ActiveDirLightsShadowIDs)
 		{
-			const auto& light = m_Scene->m_DirectionalLights[i];
+			const uint32_t shadowmapIndex = m_Scene->m_DirectionalLights[i].m_ShadowmapIndex;
 
 			for (uint32_t cascadeIndex = 0U; cascadeIndex < SHADOW_CASCADES; cascadeIndex++)
 			{
-				m_DirShadowMaps[light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex]->ChangeLayout(
-					VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-					VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-					m_Frames[m_FrameIndex].commandBuffer
-				);
+				const uint32_t slot = MAX_SPOT_LIGHT_SHADOWS + shadowmapIndex * SHADOW_CASCADES + cascadeIndex;
 
-				GraphicsPass::RenderInfo renderInfo{
-					.depthAttachmentView = m_DirShadowMaps[light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex]->GetViewHandle(),
-					.depthAttachmentLayout = m_DirShadowMaps[light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex]->GetLayout(),
+				const auto& tile = m_ShadowAtlasLayout.GetTile(slot);
 
-					.extent = m_DirShadowMaps[light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex]->m_Size,
+				for (const uint32_t view : { SPOT_CULLING_VIEWS + slot, STATIC_CULLING_VIEWS + slot })
+				{
+					if (!m_CullingViewActive[view]) continue;
+
+					recordings.emplace_back(SecondaryRecording{
+						.commandBuffer = &m_ShadowCommandBuffers[view],
+						.pass = m_DirShadowPass,
+						.renderInfo = {
+							.offset = { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) },
+							.extent = { tile.size, tile.size },
+							.cullMode = VK_CULL_MODE_FRONT_BIT
+						},
+						.record = [this, shadowmapIndex, cascadeIndex, view](VkCommandBuffer cmd) {
+							m_DirShadowPass->BindDescriptorSet(cmd, m_Scene->m_LightingDescriptorSet->GetHandle(), 0U);
+							m_DirShadowPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U);
+
+							uint32_t pushConstant[2]{ shadowmapIndex, cascadeIndex };
+
+							m_DirShadowPass->PushConstants(cmd, pushConstant, sizeof(uint32_t) * 2, 0U, VK_SHADER_STAGE_VERTEX_BIT);
+
+							DrawScene(cmd, m_DirShadowPass, view, m_RenderQueues[view]);
+						}
+					});
+				}
+			}
+		}
 
-					.cullMode = VK_CULL_MODE_FRONT_BIT
-				};
+		// The camera view is split into ranges of draws so that big scenes are spread over all threads, the indirect draw is a single command anyway
+		const uint32_t rangeCount = m_Settings.gpuDrivenRendering ? 1U : std::max((m_RenderQueues[CAMERA_CULLING_VIEW].GetDrawCount() + DRAWS_PER_COMMAND_BUFFER - 1U) / DRAWS_PER_COMMAND_BUFFER, 1U);
 
-				m_DirShadowPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
+		m_DepthCommandBuffers.resize(m_Settings.depthPrePass ? rangeCount : 0U);
+		m_ForwardCommandBuffers.resize(rangeCount);
 
-				m_DirShadowPass->BindDescriptorSet(m_Scene->m_LightingDescriptorSet->GetHandle(), 0U);
-				m_DirShadowPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U);
+		for (uint32_t range = 0U; range < m_DepthCommandBuffers.size(); range++)
+			recordings.emplace_back(SecondaryRecording{
+				.commandBuffer = &m_DepthCommandBuffers[range],
+				.pass = m_DepthPass,
+				.renderInfo = {
+					.extent = m_DepthBuffer->m_Size
+				},
+				.record = [this, range](VkCommandBuffer cmd) {
+					m_DepthPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
+					m_DepthPass->BindDescriptorSet(cmd, m_Scene->m_GlobalDescriptorSet, 1U);
 
-				for (const auto& [name, sceneObject] : m_Scene->m_SceneObjects)
-				{
-					if (!sceneObject->m_Active || !sceneObject->m_Mesh->m_Active) continue;
+					DrawScene(cmd, m_DepthPass, CAMERA_CULLING_VIEW, m_DepthPrepassQueue, range * DRAWS_PER_COMMAND_BUFFER, (range + 1U) * DRAWS_PER_COMMAND_BUFFER);
+				}
+			});
 
-					uint32_t pushConstant[3] { sceneObject->GetMatrixIndex(), light.m_ShadowmapIndex, cascadeIndex };
+		for (uint32_t range = 0U; range < m_ForwardCommandBuffers.size(); range++)
+			recordings.emplace_back(SecondaryRecording{
+				.commandBuffer = &m_ForwardCommandBuffers[range],
+				.pass = m_ForwardPass,
+				.renderInfo = {
+					.extent = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->m_Size : GetOutputExtent()
+				},
+				.record = [this, range](VkCommandBuffer cmd) {
+					m_ForwardPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
+					m_ForwardPass->BindDescriptorSet(cmd, m_Scene->m_GlobalDescriptorSet, 1U);
+					m_ForwardPass->BindDescriptorSet(cmd, m_ShadowMapsDescriptor, 2U);
+					m_ForwardPass->BindDescriptorSet(cmd, m_ClusterDescriptor, 3U);
+					m_ForwardPass->BindDescriptorSet(cmd, m_SSAODescriptor, 4U);
 
-					m_DirShadowPass->PushConstants(
-						pushConstant,
-						sizeof(uint32_t)*3,
-						0U,
-						VK_SHADER_STAGE_VERTEX_BIT
-					);
+					m_ForwardPass->PushConstants(cmd, &m_Scene->m_MainCamera->m_Exposure, sizeof(float), 0U, VK_SHADER_STAGE_FRAGMENT_BIT);
 
-					for (const auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
-					{
-						if (!subMesh.m_Active) continue;
+					DrawScene(cmd, m_ForwardPass, CAMERA_CULLING_VIEW, m_RenderQueues[CAMERA_CULLING_VIEW], range * DRAWS_PER_COMMAND_BUFFER, (range + 1U) * DRAWS_PER_COMMAND_BUFFER);
+				}
+			});
 
-						m_DirShadowPass->BindVertexBuffer(subMesh.m_VertexBuffer);
-						m_DirShadowPass->BindIndexBuffer(subMesh.m_IndexBuffer);
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(recordings.size()), [&](uint32_t begin, uint32_t end)
+		{
+			EN_PROFILE_SCOPE("Record Secondary Command Buffers");
 
-						m_DirShadowPass->DrawIndexed(subMesh.m_IndexCount);
-					}
-				}
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const auto& recording = recordings[i];
 
-				m_DirShadowPass->End();
+				const VkCommandBuffer cmd = AcquireSecondaryCommandBuffer();
 
-				m_DirShadowMaps[light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex]->ChangeLayout(
-					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-					VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-					m_Frames[m_FrameIndex].commandBuffer
-				);
+				recording.pass->BeginSecondary(cmd, recording.renderInfo);
+				recording.record(cmd);
+				recording.pass->EndSecondary(cmd);
+
+				*recording.commandBuffer = cmd;
 			}
-		}
+		}, 1U);
 	}
-	void Renderer::ClusterComputePass()
-	{
-		if (m_SkipFrame)
-			return;
-		
-		if (m_ClusterFrustumChanged)
-		{
-			uint32_t sizeX = (uint32_t)std::ceilf((float)m_Swapchain->GetExtent().width / CLUSTERED_TILES_X);
-			uint32_t sizeY = (uint32_t)std::ceilf((float)m_Swapchain->GetExtent().height / CLUSTERED_TILES_Y);
 
-			glm::uvec4 screenSize(m_Swapchain->GetExtent().width, m_Swapchain->GetExtent().height, sizeX, sizeY);
+	void Renderer::DrawCullingPass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame || !m_Settings.gpuDrivenRendering) return;
 
-			m_ClusterAABBCreationPass->Bind(m_Frames[m_FrameIndex].commandBuffer);
-			m_ClusterAABBCreationPass->PushConstants(&screenSize, sizeof(glm::uvec4), 0U, VK_SHADER_STAGE_COMPUTE_BIT);
-			m_ClusterAABBCreationPass->BindDescriptorSet(m_ClusterSSBOs.aabbClustersDescriptor, 0U, VK_PIPELINE_BIND_POINT_COMPUTE);
-			m_ClusterAABBCreationPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U, VK_PIPELINE_BIND_POINT_COMPUTE);
-			m_ClusterAABBCreationPass->Dispatch(CLUSTERED_TILES_X, CLUSTERED_TILES_Y, CLUSTERED_TILES_Z);
+		// The frusta come from CullScene(), the GPU only takes over the per draw tests
+		std::array<CullingView, MAX_CULLING_VIEWS> views{};
 
-			m_ClusterFrustumChanged = false;
-		}
-		
-		m_ClusterLightCullingPass->Bind(m_Frames[m_FrameIndex].commandBuffer);
+		for (uint32_t view = 0U; view < MAX_CULLING_VIEWS; view++)
+			views[view] = CullingView{
+				.planes = m_CullingFrustums[view].m_Planes,
+				.enabled = m_CullingViewActive[view],
+				.drawMask = m_CullingViewDrawMask[view]
+			};
 
-		m_ClusterLightCullingPass->BindDescriptorSet(m_ClusterSSBOs.clusterLightCullingDescriptor, 0U, VK_PIPELINE_BIND_POINT_COMPUTE);
-		m_ClusterLightCullingPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U, VK_PIPELINE_BIND_POINT_COMPUTE);
-		m_ClusterLightCullingPass->BindDescriptorSet(m_Scene->m_LightsBufferDescriptorSet, 2U, VK_PIPELINE_BIND_POINT_COMPUTE);
+		BarrierBatch barriers;
 
-		m_ClusterLightCullingPass->Dispatch(1U, 1U, CLUSTERED_BATCHES);
-	}
-	void Renderer::DepthPass()
-	{
-		if (m_SkipFrame || !m_Settings.depthPrePass) return;
+		// The previous frame has to be done reading the commands before they get overwritten
+		barriers.Add(*m_DrawCulling.counts,
+			VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_2_CLEAR_BIT
+		);
+		barriers.Add(*m_DrawCulling.views,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_CLEAR_BIT
+		);
+		barriers.Add(*m_DrawCulling.commands,
+			VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+		);
+		barriers.Flush(cmd);
 
-		GraphicsPass::RenderInfo renderInfo {
-			.depthAttachmentView = m_DepthBuffer->GetViewHandle(),
-			.depthAttachmentLayout = m_DepthBuffer->GetLayout(),
-			.extent = m_DepthBuffer->m_Size
-		};
+		// Both count as clear commands
+		vkCmdUpdateBuffer(cmd, m_DrawCulling.views->GetHandle(), 0U, sizeof(CullingView) * views.size(), views.data());
+		vkCmdFillBuffer(cmd, m_DrawCulling.counts->GetHandle(), 0U, VK_WHOLE_SIZE, 0U);
 
-		m_DepthPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
+		barriers.Add(*m_DrawCulling.views,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+			VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+		);
+		barriers.Add(*m_DrawCulling.counts,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+		);
+		barriers.Flush(cmd);
 
-		m_DepthPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
-		m_DepthPass->BindDescriptorSet(m_Scene->m_GlobalDescriptorSet, 1U);
+		const uint32_t drawCount = m_Scene->GetDrawCount();
 
-		for (const auto& [name, sceneObject] : m_Scene->m_SceneObjects)
+		if (drawCount > 0U)
 		{
-			if (!sceneObject->m_Active || !sceneObject->m_Mesh->m_Active) continue;
+			const uint32_t pushConstant[2]{ drawCount, m_DrawCulling.capacity };
 
-			m_DepthPass->PushConstants(&sceneObject->GetMatrixIndex(), sizeof(uint32_t), 0U, VK_SHADER_STAGE_VERTEX_BIT);
+			m_DrawCullingPass->Bind(cmd);
 
-			for (const auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
-			{
-				if (!subMesh.m_Active) continue;
+			m_DrawCullingPass->BindDescriptorSet(cmd, m_Scene->m_DrawsDescriptorSet, 0U, VK_PIPELINE_BIND_POINT_COMPUTE);
+			m_DrawCullingPass->BindDescriptorSet(cmd, m_DrawCulling.descriptor, 1U, VK_PIPELINE_BIND_POINT_COMPUTE);
 
-				m_DepthPass->BindVertexBuffer(subMesh.m_VertexBuffer);
-				m_DepthPass->BindIndexBuffer(subMesh.m_IndexBuffer);
+			m_DrawCullingPass->PushConstants(cmd, pushConstant, sizeof(uint32_t) * 2, 0U, VK_SHADER_STAGE_COMPUTE_BIT);
 
-				m_DepthPass->DrawIndexed(subMesh.m_IndexCount);
-			}
+			m_DrawCullingPass->Dispatch(cmd, (drawCount + DRAW_CULLING_GROUP_SIZE - 1U) / DRAW_CULLING_GROUP_SIZE, MAX_CULLING_VIEWS);
 		}
 
-		m_DepthPass->End();
-		
-		if (m_Settings.ambientOcclusionMode == AmbientOcclusionMode::None)
-			m_DepthBuffer->ChangeLayout(m_DepthBuffer->GetLayout(),
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-			);
-		else
-			m_DepthBuffer->ChangeLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-				VK_ACCESS_SHADER_READ_BIT,
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-			);
+		barriers.Add(*m_DrawCulling.commands,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT
+		);
+		barriers.Add(*m_DrawCulling.counts,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT
+		);
+		barriers.Flush(cmd);
 	}
-	void Renderer::SSAOPass()
+	void Renderer::ShadowPass(VkCommandBuffer cmd)
 	{
 		if (m_SkipFrame) return;
 
-		m_SSAOTarget->ChangeLayout(
-			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-			VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-			m_Frames[m_FrameIndex].commandBuffer
-		);
-
-		m_Settings.ambientOcclusion.screenWidth = m_SSAOTarget->m_Size.width;
-		m_Settings.ambientOcclusion.screenHeight = m_SSAOTarget->m_Size.height;
-
-		switch (m_Settings.ambientOcclusionQuality)
+		for (const auto& i : m_Scene->m_ActivePointLightsShadowIDs)
 		{
-		case QualityLevel::Low:
-			m_Settings.ambientOcclusion._samples = 8U;
-			m_Settings.ambientOcclusion._noiseScale = 2.0f;
-			break;
-		case QualityLevel::Medium:
-			m_Settings.ambientOcclusion._samples = 16U;
-			m_Settings.ambientOcclusion._noiseScale = 2.0f;
-			break;
-		case QualityLevel::High:
-			m_Settings.ambientOcclusion._samples = 16U;
-			m_Settings.ambientOcclusion._noiseScale = 1.0f;
-			break;
-		case QualityLevel::Ultra:
-			m_Settings.ambientOcclusion._samples = 32U;
-			m_Settings.ambientOcclusion._noiseScale = 1.0f;
-			break;
-		}
+			const auto& light = m_Scene->m_PointLights[i];
 
-		GraphicsPass::RenderInfo renderInfo {
-			.colorAttachmentView = m_SSAOTarget->GetViewHandle(),
-			.colorAttachmentLayout = m_SSAOTarget->GetLayout(),
-			.extent = m_SSAOTarget->m_Size,
-			.clearColor = { 1.0f, 1.0f, 1.0f, 1.0f },
-			.cullMode = VK_CULL_MODE_FRONT_BIT,
-		};
+			const uint32_t firstView = POINT_CULLING_VIEWS + light.m_ShadowmapIndex * 6U;
 
-		m_SSAOPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
-		if (m_Settings.ambientOcclusionMode != AmbientOcclusionMode::None && m_Settings.depthPrePass)
-		{
-			m_SSAOPass->PushConstants(&m_Settings.ambientOcclusion, sizeof(m_Settings.ambientOcclusion), 0U, VK_SHADER_STAGE_FRAGMENT_BIT);
-			m_SSAOPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
-			m_SSAOPass->BindDescriptorSet(m_DepthBufferDescriptor, 1U);
-			m_SSAOPass->Draw(3U);
-		}
-		m_SSAOPass->End();
-
-		m_DepthBuffer->ChangeLayout(
-			VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-			VK_ACCESS_SHADER_READ_BIT,
-			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
-			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-			m_Frames[m_FrameIndex].commandBuffer
-		);
+			// Every face is either hidden or reused from the cache
+			if (std::none_of(m_CullingViewActive.begin() + firstView, m_CullingViewActive.begin() + firstView + 6U, [](bool active) { return active; }))
+				continue;
 
-		m_SSAOTarget->ChangeLayout(
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-			m_Frames[m_FrameIndex].commandBuffer
-		);
-	}
-	void Renderer::ForwardPass()
-	{
-		if (m_SkipFrame) return;
-		
-		if(m_Settings.antialiasingMode != AntialiasingMode::None)
-			m_AliasedImage->ChangeLayout(
+			m_PointShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
 				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
 				VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
 				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-				m_Frames[m_FrameIndex].commandBuffer
-		);
+				cmd
+			);
 
-		GraphicsPass::RenderInfo renderInfo{
-			.colorAttachmentView = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->GetViewHandle() : m_Swapchain->m_ImageViews[m_Swapchain->m_ImageIndex],
-			.depthAttachmentView = m_DepthBuffer->GetViewHandle(),
+			for (uint32_t cubeSide = 0U; cubeSide < (m_PointShadowMultiview ? 1U : 6U); cubeSide++)
+			{
+				const uint32_t view = firstView + cubeSide;
 
-			.colorAttachmentLayout = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->GetLayout() : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-			.depthAttachmentLayout = m_DepthBuffer->GetLayout(),
+				if (!m_CullingViewActive[view]) continue;
 
-			.extent = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->m_Size : m_Swapchain->GetExtent(),
+				GraphicsPass::RenderInfo renderInfo{
+					.colorAttachmentView = m_PointShadowMultiview ? m_PointShadowMaps[light.m_ShadowmapIndex]->GetArrayViewHandle() : m_PointShadowMaps[light.m_ShadowmapIndex]->GetLayerViewHandle(cubeSide),
+					.depthAttachmentView = m_PointShadowDepthBuffer->GetViewHandle(),
 
-			.clearColor{
-				m_Scene->m_AmbientColor.r, m_Scene->m_AmbientColor.g, m_Scene->m_AmbientColor.b, 1.0f
-			},
+					.colorAttachmentLayout = m_PointShadowMaps[light.m_ShadowmapIndex]->GetLayout(),
+					.depthAttachmentLayout = m_PointShadowDepthBuffer->GetLayout(),
 
-			.depthLoadOp = m_Settings.depthPrePass ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
-			.depthStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-		};
+					.extent = m_PointShadowMaps[light.m_ShadowmapIndex]->m_Size,
 
-		m_ForwardPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
+					.cullMode = VK_CULL_MODE_FRONT_BIT
+				};
+
+				m_PointShadowPass->Begin(cmd, renderInfo, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+					vkCmdExecuteCommands(cmd, 1U, &m_ShadowCommandBuffers[view]);
+				m_PointShadowPass->End(cmd);
+
+				m_ShadowCaches[view].valid = true;
+				m_ShadowCaches[view].drawn = true;
+			}
+
+			m_PointShadowMaps[light.m_ShadowmapIndex]->ChangeLayout(
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				cmd
+			);
+		}
+
+		// Nothing was placed in the atlas or all of its tiles are reused
+		if (!m_ShadowAtlas || std::none_of(m_CullingViewActive.begin() + SPOT_CULLING_VIEWS, m_CullingViewActive.begin() + STATIC_CULLING_VIEWS, [](bool active) { return active; }))
+			return;
+
+		// The atlas slots are in the same order as their culling views, spot lights first and the cascades after them
+		const auto renderTile = [&](const uint32_t view, const uint32_t slot, const Handle<Image>& atlas, const VkAttachmentLoadOp loadOp) {
+			const auto& tile = m_ShadowAtlasLayout.GetTile(slot);
+
+			const Handle<GraphicsPass>& pass = slot < MAX_SPOT_LIGHT_SHADOWS ? m_SpotShadowPass : m_DirShadowPass;
+
+			GraphicsPass::RenderInfo renderInfo{
+				.depthAttachmentView = atlas->GetViewHandle(),
+				.depthAttachmentLayout = atlas->GetLayout(),
+
+				.offset = { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) },
+				.extent = { tile.size, tile.size },
+
+				.depthLoadOp = loadOp,
+
+				.cullMode = VK_CULL_MODE_FRONT_BIT
+			};
+
+			pass->Begin(cmd, renderInfo, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+				vkCmdExecuteCommands(cmd, 1U, &m_ShadowCommandBuffers[view]);
+			pass->End(cmd);
+		};
+
+		if (m_StaticShadowAtlas)
+		{
+			// The static casters of the outdated tiles go into the cache first...
+			if (std::any_of(m_CullingViewActive.begin() + STATIC_CULLING_VIEWS, m_CullingViewActive.end(), [](bool active) { return active; }))
+			{
+				m_StaticShadowAtlas->ChangeLayout(
+					VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+					VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+					VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+					cmd
+				);
+
+				for (uint32_t slot = 0U; slot < SHADOW_ATLAS_SLOTS; slot++)
+				{
+					if (!m_CullingViewActive[STATIC_CULLING_VIEWS + slot]) continue;
+
+					renderTile(STATIC_CULLING_VIEWS + slot, slot, m_StaticShadowAtlas, VK_ATTACHMENT_LOAD_OP_CLEAR);
+
+					m_ShadowCaches[SPOT_CULLING_VIEWS + slot].staticValid = true;
+				}
+
+				m_StaticShadowAtlas->ChangeLayout(
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+					VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+					cmd
+				);
+			}
+
+			m_ShadowAtlas->ChangeLayout(
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				cmd
+			);
+
+			// ...then they are copied to the tiles that get redrawn, which only need their dynamic casters on top
+			for (uint32_t slot = 0U; slot < SHADOW_ATLAS_SLOTS; slot++)
+			{
+				if (!m_CullingViewActive[SPOT_CULLING_VIEWS + slot]) continue;
+
+				const auto& tile = m_ShadowAtlasLayout.GetTile(slot);
+
+				m_StaticShadowAtlas->CopyTo(m_ShadowAtlas, { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) }, { tile.size, tile.size }, cmd);
+			}
+
+			m_ShadowAtlas->ChangeLayout(
+				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				cmd
+			);
+		}
+		else
+		{
+			// The spot lights and the cascades render into their own tiles of the atlas, so it only changes layout once
+			m_ShadowAtlas->ChangeLayout(
+				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+				VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				cmd
+			);
+		}
+
+		for (uint32_t slot = 0U; slot < SHADOW_ATLAS_SLOTS; slot++)
+		{
+			if (!m_CullingViewActive[SPOT_CULLING_VIEWS + slot]) continue;
+
+			renderTile(SPOT_CULLING_VIEWS + slot, slot, m_ShadowAtlas, m_StaticShadowAtlas ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR);
+
+			m_ShadowCaches[SPOT_CULLING_VIEWS + slot].valid = true;
+			m_ShadowCaches[SPOT_CULLING_VIEWS + slot].drawn = true;
+		}
+
+		m_ShadowAtlas->ChangeLayout(
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			cmd
+		);
+	}
+	void Renderer::ClusterComputePass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame)
+			return;
+
+		const bool asyncCompute = g_Ctx->HasAsyncCompute();
+
+		const uint32_t graphicsFamily = g_Ctx->m_QueueFamilies.graphics.value();
+		const uint32_t computeFamily  = g_Ctx->m_QueueFamilies.compute.value();
+
+		BarrierBatch barriers;
+
+		// The clusters are overwritten after the last frame's forward pass read them and the global index counts after the last
+		// culling wrote them. On the compute queue the semaphores already order the forward pass before this.
+		barriers.Add(
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			asyncCompute ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+		);
+		barriers.Flush(cmd);
+		
+		if (m_ClusterFrustumChanged)
+		{
+			uint32_t sizeX = (uint32_t)std::ceilf((float)GetOutputExtent().width / CLUSTERED_TILES_X);
+			uint32_t sizeY = (uint32_t)std::ceilf((float)GetOutputExtent().height / CLUSTERED_TILES_Y);
+
+			glm::uvec4 screenSize(GetOutputExtent().width, GetOutputExtent().height, sizeX, sizeY);
+
+			m_ClusterAABBCreationPass->Bind(cmd);
+			m_ClusterAABBCreationPass->PushConstants(cmd, &screenSize, sizeof(glm::uvec4), 0U, VK_SHADER_STAGE_COMPUTE_BIT);
+			m_ClusterAABBCreationPass->BindDescriptorSet(cmd, m_ClusterSSBOs.aabbClustersDescriptor, 0U, VK_PIPELINE_BIND_POINT_COMPUTE);
+			m_ClusterAABBCreationPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U, VK_PIPELINE_BIND_POINT_COMPUTE);
+			m_ClusterAABBCreationPass->Dispatch(cmd, CLUSTERED_TILES_X, CLUSTERED_TILES_Y, CLUSTERED_TILES_Z);
+
+			barriers.Add(
+				*m_ClusterSSBOs.aabbClusters,
+				VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+				VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+			);
+			barriers.Flush(cmd);
+
+			m_ClusterFrustumChanged = false;
+		}
+		
+		m_ClusterLightCullingPass->Bind(cmd);
+
+		m_ClusterLightCullingPass->BindDescriptorSet(cmd, m_ClusterSSBOs.clusterLightCullingDescriptor, 0U, VK_PIPELINE_BIND_POINT_COMPUTE);
+		m_ClusterLightCullingPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 1U, VK_PIPELINE_BIND_POINT_COMPUTE);
+		m_ClusterLightCullingPass->BindDescriptorSet(cmd, m_Scene->m_LightsBufferDescriptorSet, 2U, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+		m_ClusterLightCullingPass->Dispatch(cmd, 1U, 1U, CLUSTERED_BATCHES);
+
+		// Only the grids and the index lists are read by the forward pass, the rest never leaves the compute queue
+		BarrierBatch acquireBarriers;
+
+		for (const auto& buffer : { m_ClusterSSBOs.pointLightGrid, m_ClusterSSBOs.pointLightIndices, m_ClusterSSBOs.spotLightGrid, m_ClusterSSBOs.spotLightIndices })
+		{
+			if (asyncCompute)
+			{
+				// Released by the compute queue and acquired at the start of the main submission, which waits for this one at
+				// the fragment shader stage. Their contents are overwritten every frame, so they are never transferred back.
+				barriers.Add(
+					*buffer,
+					VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_NONE,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_NONE,
+					computeFamily, graphicsFamily
+				);
+				acquireBarriers.Add(
+					*buffer,
+					VK_ACCESS_2_NONE, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+					VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+					computeFamily, graphicsFamily
+				);
+			}
+			else
+				barriers.Add(
+					*buffer,
+					VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+					VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
+				);
+		}
+
+		barriers.Flush(cmd);
+		acquireBarriers.Flush(m_Frames[m_FrameIndex].commandBuffers[MAIN_SUBMISSION]);
+	}
+	void Renderer::DepthPass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame) return;
+
+		GraphicsPass::RenderInfo renderInfo {
+			.depthAttachmentView = m_DepthBuffer->GetViewHandle(),
+			.depthAttachmentLayout = m_DepthBuffer->GetLayout(),
+			.extent = m_DepthBuffer->m_Size
+		};
+
+		m_DepthPass->Begin(cmd, renderInfo, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+			vkCmdExecuteCommands(cmd, static_cast<uint32_t>(m_DepthCommandBuffers.size()), m_DepthCommandBuffers.data());
+		m_DepthPass->End(cmd);
+	}
+	void Renderer::SSAOPass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame) return;
+
+		m_Settings.ambientOcclusion.screenWidth = m_SSAOTarget->m_Size.width;
+		m_Settings.ambientOcclusion.screenHeight = m_SSAOTarget->m_Size.height;
+
+		switch (m_Settings.ambientOcclusionQuality)
+		{
+		case QualityLevel::Low:
+			m_Settings.ambientOcclusion._samples = 8U;
+			m_Settings.ambientOcclusion._noiseScale = 2.0f;
+			break;
+		case QualityLevel::Medium:
+			m_Settings.ambientOcclusion._samples = 16U;
+			m_Settings.ambientOcclusion._noiseScale = 2.0f;
+			break;
+		case QualityLevel::High:
+			m_Settings.ambientOcclusion._samples = 16U;
+			m_Settings.ambientOcclusion._noiseScale = 1.0f;
+			break;
+		case QualityLevel::Ultra:
+			m_Settings.ambientOcclusion._samples = 32U;
+			m_Settings.ambientOcclusion._noiseScale = 1.0f;
+			break;
+		}
+
+		GraphicsPass::RenderInfo renderInfo {
+			.colorAttachmentView = m_SSAOTarget->GetViewHandle(),
+			.colorAttachmentLayout = m_SSAOTarget->GetLayout(),
+			.extent = m_SSAOTarget->m_Size,
+			.clearColor = { 1.0f, 1.0f, 1.0f, 1.0f },
+			.cullMode = VK_CULL_MODE_FRONT_BIT,
+		};
+
+		m_SSAOPass->Begin(cmd, renderInfo);
+			m_SSAOPass->PushConstants(cmd, &m_Settings.ambientOcclusion, sizeof(m_Settings.ambientOcclusion), 0U, VK_SHADER_STAGE_FRAGMENT_BIT);
+			m_SSAOPass->BindDescriptorSet(cmd, m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
+			m_SSAOPass->BindDescriptorSet(cmd, m_DepthBufferDescriptor, 1U);
+			m_SSAOPass->Draw(cmd, 3U);
+		m_SSAOPass->End(cmd);
+	}
+	void Renderer::ForwardPass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame) return;
+
+		GraphicsPass::RenderInfo renderInfo{
+			.colorAttachmentView = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->GetViewHandle() : GetOutputView(),
+			.depthAttachmentView = m_DepthBuffer->GetViewHandle(),
+
+			.colorAttachmentLayout = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->GetLayout() : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			.depthAttachmentLayout = m_DepthBuffer->GetLayout(),
+
+			.extent = m_Settings.antialiasingMode != AntialiasingMode::None ? m_AliasedImage->m_Size : GetOutputExtent(),
+
+			.clearColor{
+				m_Scene->m_AmbientColor.r, m_Scene->m_AmbientColor.g, m_Scene->m_AmbientColor.b, 1.0f
+			},
+
+			.depthLoadOp = m_Settings.depthPrePass ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+			.depthStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+		};
+
+		m_ForwardPass->Begin(cmd, renderInfo, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+			vkCmdExecuteCommands(cmd, static_cast<uint32_t>(m_ForwardCommandBuffers.size()), m_ForwardCommandBuffers.data());
+		m_ForwardPass->End(cmd);
+	}
+	void Renderer::AntialiasingPass(VkCommandBuffer cmd)
+	{
+		if (m_SkipFrame) return;
+
+		m_Settings.antialiasing.texelSizeX = 1.0f / GetOutputExtent().width;
+		m_Settings.antialiasing.texelSizeY = 1.0f / GetOutputExtent().height;
+
+		GraphicsPass::RenderInfo renderInfo{
+			.colorAttachmentView = GetOutputView(),
+			.colorAttachmentLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+
+			.extent = GetOutputExtent(),
+
+			.cullMode = VK_CULL_MODE_FRONT_BIT,
+		};
+
+		m_AntialiasingPass->Begin(cmd, renderInfo);
+			m_AntialiasingPass->BindDescriptorSet(cmd, m_AntialiasingDescriptor);
+			m_AntialiasingPass->PushConstants(cmd, &m_Settings.antialiasing, sizeof(m_Settings.antialiasing), 0U, VK_SHADER_STAGE_FRAGMENT_BIT);
+			m_AntialiasingPass->Draw(cmd, 3U);
+		m_AntialiasingPass->End(cmd);
+	}
+	void Renderer::ImGuiPass()
+	{
+		if (m_SkipFrame || m_ImGuiRenderCallback == nullptr || !m_ImGuiContext) return;
+
+		EN_PROFILE_FUNCTION();
+		
+		m_ImGuiRenderCallback();
+
+		m_ImGuiContext->Render(m_Frames[m_FrameIndex].commandBuffers[MAIN_SUBMISSION], m_Swapchain->m_ImageIndex);
+	}
+	void Renderer::EndRender()
+	{
+		if (m_SkipFrame) return;
+
+		EN_PROFILE_FUNCTION();
+
+		if (m_OffscreenTarget)
+			CopyOffscreenTarget();
+
+		const auto& frame = m_Frames[m_FrameIndex];
+
+		const bool asyncCompute = g_Ctx->HasAsyncCompute();
+
+		for (const VkCommandBuffer cmd : frame.commandBuffers)
+			if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+				EN_ERROR("Renderer::EndRender() - Failed to record command buffer!");
+
+		if (asyncCompute && vkEndCommandBuffer(frame.computeCommandBuffer) != VK_SUCCESS)
+			EN_ERROR("Renderer::EndRender() - Failed to record the compute command buffer!");
+
+		VkPipelineStageFlags waitStages[2]{};
+		VkSemaphore			 waitSemaphores[2]{};
+		uint32_t			 waitCount = 0U;
+
+		// Without a swapchain there is nothing to wait for and nothing to present
+		if (m_Swapchain)
+		{
+			waitStages[waitCount]	  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			waitSemaphores[waitCount] = frame.mainSemaphore;
+			waitCount++;
+		}
+
+		// Only the forward pass reads the light clusters, from the fragment shader
+		if (asyncCompute)
+		{
+			waitStages[waitCount]	  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			waitSemaphores[waitCount] = frame.computeSemaphore;
+			waitCount++;
+		}
+
+		const VkSemaphore signalSemaphores[] = { frame.presentSemaphore };
+
+		// Without async compute every command buffer goes into a single batch
+		VkSubmitInfo submitInfo{
+			.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.waitSemaphoreCount = waitCount,
+			.pWaitSemaphores	= waitSemaphores,
+			.pWaitDstStageMask  = waitStages,
+
+			.commandBufferCount = static_cast<uint32_t>(frame.commandBuffers.size()),
+			.pCommandBuffers	= frame.commandBuffers.data(),
+
+			.signalSemaphoreCount = m_Swapchain ? 1U : 0U,
+			.pSignalSemaphores	  = signalSemaphores,
+		};
+
+		{
+			EN_PROFILE_SCOPE("vkQueueSubmit");
+
+			// Everything the frame staged at once
+			m_StagingRing->Flush();
+
+			// Ahead of the frame, so the assets loaded while it was recorded are ready when it runs
+			g_Ctx->m_UploadQueue->Flush();
+
+			std::lock_guard<std::mutex> lock(g_Ctx->m_QueueMutex);
+
+			if (asyncCompute)
+			{
+				submitInfo.commandBufferCount = 1U;
+				submitInfo.pCommandBuffers	  = &frame.commandBuffers[MAIN_SUBMISSION];
+
+				const VkPipelineStageFlags computeWaitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+				// The upload is submitted on its own so the cluster culling only has to wait for it, the early passes (the shadows
+				// among them) don't wait for anything and overlap the culling
+				const VkSubmitInfo uploadSubmitInfo{
+					.sType				  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+					.commandBufferCount	  = 1U,
+					.pCommandBuffers	  = &frame.commandBuffers[UPLOAD_SUBMISSION],
+					.signalSemaphoreCount = 1U,
+					.pSignalSemaphores	  = &frame.uploadSemaphore,
+				};
+				const VkSubmitInfo computeSubmitInfo{
+					.sType				  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+					.waitSemaphoreCount	  = 1U,
+					.pWaitSemaphores	  = &frame.uploadSemaphore,
+					.pWaitDstStageMask	  = &computeWaitStage,
+					.commandBufferCount	  = 1U,
+					.pCommandBuffers	  = &frame.computeCommandBuffer,
+					.signalSemaphoreCount = 1U,
+					.pSignalSemaphores	  = &frame.computeSemaphore,
+				};
+				const VkSubmitInfo graphicsSubmitInfos[] = {
+					VkSubmitInfo{
+						.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO,
+						.commandBufferCount = 1U,
+						.pCommandBuffers	= &frame.commandBuffers[EARLY_SUBMISSION],
+					},
+					submitInfo
+				};
+
+				// A semaphore has to be signaled by an earlier submission than the one waiting for it
+				if (vkQueueSubmit(g_Ctx->m_GraphicsQueue, 1U, &uploadSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+					EN_ERROR("Renderer::EndRender() - Failed to submit the scene upload!");
+
+				if (vkQueueSubmit(g_Ctx->m_ComputeQueue, 1U, &computeSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+					EN_ERROR("Renderer::EndRender() - Failed to submit the compute command buffer!");
+
+				if (vkQueueSubmit(g_Ctx->m_GraphicsQueue, 2U, graphicsSubmitInfos, frame.submitFence) != VK_SUCCESS)
+					EN_ERROR("Renderer::EndRender() - Failed to submit command buffer!");
+			}
+			else if (vkQueueSubmit(g_Ctx->m_GraphicsQueue, 1U, &submitInfo, frame.submitFence) != VK_SUCCESS)
+				EN_ERROR("Renderer::EndRender() - Failed to submit command buffer!");
+		}
+
+		VkResult result = VK_SUCCESS;
+
+		if (m_Swapchain)
+		{
+			VkPresentInfoKHR presentInfo{
+				.sType				= VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+				.waitSemaphoreCount = 1U,
+				.pWaitSemaphores	= signalSemaphores,
+
+				.swapchainCount = 1U,
+				.pSwapchains	= &m_Swapchain->m_Swapchain,
+				.pImageIndices  = &m_Swapchain->m_ImageIndex,
+				.pResults	    = nullptr,
+			};
+
+			EN_PROFILE_SCOPE("vkQueuePresentKHR");
+
+			std::lock_guard<std::mutex> lock(g_Ctx->m_QueueMutex);
+			result = vkQueuePresentKHR(g_Ctx->m_PresentQueue, &presentInfo);
+		}
+
+		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+			ReloadBackend(BACKEND_OUTPUT);
+		else if (result != VK_SUCCESS)
+			EN_ERROR("Renderer::EndRender() - Failed to present swap chain image!");
+
+		if (m_QueuedBackendParts != 0U)
+			ReloadBackendImpl();
+
+		// Every frame from the next one on renders with the new parts
+		if (m_BackendBuild && m_BackendBuild->pipelines.IsDone() && m_DeferredPipelines.IsDone())
+			SwitchBackend();
+
+		m_FrameIndex = (m_FrameIndex + 1) % FRAMES_IN_FLIGHT;
+	}
+	void Renderer::CopyOffscreenTarget()
+	{
+		auto& frame = m_Frames[m_FrameIndex];
+
+		m_OffscreenTarget->ChangeLayout(
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			frame.commandBuffers[MAIN_SUBMISSION]
+		);
+
+		if (!m_ReadbackEnabled) return;
+
+		const VkDeviceSize size = static_cast<VkDeviceSize>(m_OffscreenExtent.width) * m_OffscreenExtent.height * 4U;
+
+		// The previous copy was already read back in BeginRender(), so the buffer is free to be replaced
+		if (!frame.readbackBuffer || frame.readbackBuffer->GetSize() < size)
+			frame.readbackBuffer = MakeHandle<MemoryBuffer>(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+
+		m_OffscreenTarget->CopyTo(frame.readbackBuffer->GetHandle(), frame.commandBuffers[MAIN_SUBMISSION]);
+
+		frame.readbackExtent = m_OffscreenExtent;
+	}
+	void Renderer::ReadbackFrame()
+	{
+		auto& frame = m_Frames[m_FrameIndex];
+
+		if (frame.readbackExtent.width == 0U) return;
+
+		EN_PROFILE_FUNCTION();
+
+		m_ReadbackExtent = frame.readbackExtent;
+		m_ReadbackPixels.resize(static_cast<size_t>(m_ReadbackExtent.width) * m_ReadbackExtent.height * 4U);
+
+		frame.readbackBuffer->ReadMemory(m_ReadbackPixels.data(), m_ReadbackPixels.size());
+
+		frame.readbackExtent = {};
+	}
+
+	void Renderer::DrawScene(VkCommandBuffer commandBuffer, Handle<GraphicsPass> pass, const uint32_t viewIndex, const RenderQueue& queue, const uint32_t firstDraw, const uint32_t lastDraw)
+	{
+		pass->BindVertexBuffer(commandBuffer, m_Scene->m_GeometryVertexBuffer);
+		pass->BindIndexBuffer(commandBuffer, m_Scene->m_GeometryIndexBuffer);
+
+		if (m_Settings.gpuDrivenRendering)
+		{
+			pass->DrawIndexedIndirectCount(
+				commandBuffer,
+				m_DrawCulling.commands, sizeof(VkDrawIndexedIndirectCommand) * m_DrawCulling.capacity * viewIndex,
+				m_DrawCulling.counts, sizeof(uint32_t) * viewIndex,
+				m_DrawCulling.capacity
+			);
+		}
+		else
+		{
+			const auto& sortedDraws = queue.GetDraws();
+
+			const uint32_t end = std::min(lastDraw, queue.GetDrawCount());
+
+			// The draw index is passed through firstInstance just like in the indirect commands
+			for (uint32_t j = firstDraw; j < end; j++)
+			{
+				const uint32_t i = sortedDraws[j];
+
+				const auto& draw = m_Scene->m_Draws[i];
+
+				pass->DrawIndexed(commandBuffer, draw.indexCount, 1U, draw.firstIndex, draw.vertexOffset, i);
+			}
+		}
+	}
+
+	VkCommandBuffer Renderer::AcquireSecondaryCommandBuffer()
+	{
+		auto& pool = m_Frames[m_FrameIndex].secondaryPools[JobSystem::GetThreadIndex()];
+
+		// Command buffers are kept between frames and only allocated when a thread needs more than ever before
+		if (pool.usedCount == pool.commandBuffers.size())
+		{
+			VkCommandBufferAllocateInfo allocInfo{
+				.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.commandPool		= pool.commandPool,
+				.level				= VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+				.commandBufferCount = 1U
+			};
+
+			VkCommandBuffer commandBuffer{};
+
+			if (vkAllocateCommandBuffers(g_Ctx->m_LogicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS)
+				EN_ERROR("Renderer::AcquireSecondaryCommandBuffer() - Failed to allocate a secondary command buffer!");
+
+			pool.commandBuffers.emplace_back(commandBuffer);
+		}
+
+		return pool.commandBuffers[pool.usedCount++];
+	}
+
+	void Renderer::SetVSyncEnabled(const bool enabled)
+	{
+		m_RequestedSettings.vSync = enabled;
+		ReloadBackend(BACKEND_OUTPUT);
+	}
+	void Renderer::SetOffscreenExtent(const VkExtent2D extent)
+	{
+		if (!g_Ctx->IsHeadless())
+		{
+			EN_WARN("Renderer::SetOffscreenExtent() - The renderer isn't headless, the output follows the window size!");
+			return;
+		}
+
+		m_OffscreenExtent = extent;
+		ReloadBackend(BACKEND_OUTPUT);
+	}
+	void Renderer::SetReadbackEnabled(const bool enabled)
+	{
+		if (enabled && !g_Ctx->IsHeadless())
+		{
+			EN_WARN("Renderer::SetReadbackEnabled() - Only the offscreen target of the headless mode can be read back!");
+			return;
+		}
+
+		m_ReadbackEnabled = enabled;
+	}
+	void Renderer::SetDepthPrepassEnabled(const bool enabled)
+	{
+		// Changes the depth test of the forward pass, the depth pass itself already exists either way
+		m_RequestedSettings.depthPrePass = enabled;
+		ReloadBackend(BACKEND_FORWARD_PASS | BACKEND_RENDER_GRAPH);
+	}
+	void Renderer::SetGPUDrivenRenderingEnabled(const bool enabled)
+	{
+		// Doesn't reload the backend, the draw culling pass could still be created in the background
+		if (enabled)
+			WaitForPipelines(m_DeferredPipelines);
+
+		m_Settings.gpuDrivenRendering = enabled;
+	}
+
+	// The cascades are recomputed by UpdateCSM(), which updates the resized ones out of turn, and the moved ones lose their cached
+	// shadows on their own
+	void Renderer::SetShadowCascadesWeight(const float weight)
+	{
+		m_Settings.cascadeSplitWeight = weight;
+	}
+	void Renderer::SetShadowCascadesFarPlane(const float farPlane)
+	{
+		m_Settings.cascadeFarPlane = farPlane;
+	}
+	void Renderer::SetShadowCascadeUpdateInterval(const uint32_t cascade, const uint32_t interval)
+	{
+		if (cascade >= SHADOW_CASCADES)
+		{
+			EN_WARN("Renderer::SetShadowCascadeUpdateInterval() - Cascade " + std::to_string(cascade) + " doesn't exist, there are only " + std::to_string(SHADOW_CASCADES) + " cascades!");
+			return;
+		}
+
+		m_Settings.cascadeUpdateIntervals[cascade] = std::max(interval, 1U);
+	}
+
+	void Renderer::SetPointShadowResolution(const uint32_t resolution)
+	{
+		// The point lights share a depth buffer of the same size
+		m_RequestedSettings.pointLightShadowResolution = resolution;
+		ReloadBackend(BACKEND_SHADOW_MAPS | BACKEND_RENDER_GRAPH);
+	}
+	void Renderer::SetSpotShadowResolution(const uint32_t resolution)
+	{
+		m_RequestedSettings.spotLightShadowResolution = resolution;
+		ReloadBackend(BACKEND_SHADOW_MAPS);
+	}
+	void Renderer::SetDirShadowResolution(const uint32_t resolution)
+	{
+		m_RequestedSettings.dirLightShadowResolution = resolution;
+		ReloadBackend(BACKEND_SHADOW_MAPS);
+	}
+	void Renderer::SetShadowFormat(const VkFormat format)
+	{
+		m_RequestedSettings.shadowsFormat = format;
+		ReloadBackend(BACKEND_SHADOW_RESOURCES | BACKEND_SHADOW_PASSES | BACKEND_RENDER_GRAPH);
+	}
+	void Renderer::SetShadowCachingEnabled(const bool enabled)
+	{
+		// The static cache is created (or dropped) together with the atlas
+		m_RequestedSettings.shadowCaching = enabled;
+		ReloadBackend(BACKEND_SHADOW_MAPS);
+	}
+	void Renderer::SetShadowMemoryBudget(const uint32_t budget)
+	{
+		// Picked up by the next AllocateShadowTiles(), the atlas is resized if it no longer fits
+		m_Settings.shadowMemoryBudget = budget;
+	}
+
+	void Renderer::SetAntialiasingMode(const AntialiasingMode antialiasingMode)
+	{
+		m_RequestedSettings.antialiasingMode = antialiasingMode;
+		ReloadBackend(BACKEND_RENDER_GRAPH);
+	}
+	void Renderer::SetAmbientOcclusionMode(const AmbientOcclusionMode aoMode)
+	{
+		m_RequestedSettings.ambientOcclusionMode = aoMode;
+		ReloadBackend(BACKEND_RENDER_GRAPH);
+	}
+
+	//void Renderer::SetAntialaliasingQuality(const QualityLevel quality)
+	//{
+	//	m_Settings.antialiasingQuality = quality;
+	//	ReloadBackend();
+	//}
+	void Renderer::SetAmbientOcclusionQuality(const QualityLevel quality)
+	{
+		// Only changes the push constants of the SSAO pass
+		m_Settings.ambientOcclusionQuality = quality;
+	}
+
+	void Renderer::AllocateShadowTiles()
+	{
+		EN_PROFILE_FUNCTION();
+
+		const uint64_t texelBytes = m_Settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? 4U : 2U;
+
+		// Every point light caster takes a whole cube map (and they share the depth buffer), the atlas gets what's left of the budget
+		const uint64_t pointCasters	  = m_Scene->m_ActivePointLightsShadowIDs.size();
+		const uint64_t pointLayers	  = pointCasters == 0U ? 0U : pointCasters * 6U + (m_PointShadowMultiview ? 6U : 1U);
+		const uint64_t pointBytes	  = static_cast<uint64_t>(m_Settings.pointLightShadowResolution) * m_Settings.pointLightShadowResolution * texelBytes * pointLayers;
+		const uint64_t budgetBytes	  = static_cast<uint64_t>(m_Settings.shadowMemoryBudget) * 1024U * 1024U;
+		const uint64_t atlasCopies	  = m_Settings.shadowCaching ? 2U : 1U; // The static cache is as big as the atlas
+		const uint64_t atlasTexels	  = budgetBytes > pointBytes ? (budgetBytes - pointBytes) / (texelBytes * atlasCopies) : 0U;
+
+		const uint32_t maxResolution = std::clamp(std::bit_floor(static_cast<uint32_t>(std::sqrt(static_cast<double>(atlasTexels)))), ShadowAtlas::MIN_TILE_SIZE, MAX_SHADOW_ATLAS_RESOLUTION);
+
+		m_ShadowAtlasLayout.Clear();
+
+		// The cascades cover everything around the camera, so they are placed before any of the spot lights
+		for (const auto& i : m_Scene->m_ActiveDirLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_DirectionalLights[i];
+
+			for (uint32_t cascadeIndex = 0U; cascadeIndex < SHADOW_CASCADES; cascadeIndex++)
+				m_ShadowAtlasLayout.Request(MAX_SPOT_LIGHT_SHADOWS + light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex, m_Settings.dirLightShadowResolution, 2.0f);
+		}
+		for (const auto& i : m_Scene->m_ActiveSpotLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_SpotLights[i];
+
+			m_ShadowAtlasLayout.Request(light.m_ShadowmapIndex, static_cast<uint32_t>(m_Settings.spotLightShadowResolution * light.m_ShadowImportance), light.m_ShadowImportance);
+		}
+
+		const uint32_t resolution = m_ShadowAtlasLayout.Pack(maxResolution);
+
+		// Resizing means recreating the atlas, so it keeps the biggest size needed so far and only shrinks to fit the budget
+		m_ShadowAtlasResolution = resolution == 0U ? 0U : std::min(std::max(m_ShadowAtlasResolution, resolution), maxResolution);
+
+		for (uint32_t slot = 0U; slot < SHADOW_ATLAS_SLOTS; slot++)
+		{
+			const auto& tile = m_ShadowAtlasLayout.GetTile(slot);
+
+			glm::vec4 rect(0.0f);
+
+			if (tile.size != 0U)
+				rect = glm::vec4(tile.x, tile.y, tile.size, tile.size) / float(m_ShadowAtlasResolution);
+
+			// A tile that moved or got resized has nothing cached yet
+			if (rect != m_ShadowAtlasRects[slot])
+			{
+				m_ShadowCaches[SPOT_CULLING_VIEWS + slot].Invalidate();
+				m_ShadowAtlasRects[slot] = rect;
+			}
+		}
+	}
+	bool Renderer::ShadowMapsOutdated() const
+	{
+		const uint32_t atlasResolution = m_ShadowAtlas ? m_ShadowAtlas->m_Size.width : 0U;
+
+		if (atlasResolution != m_ShadowAtlasResolution)
+			return true;
+
+		const uint32_t pointCasters = static_cast<uint32_t>(m_Scene->m_ActivePointLightsShadowIDs.size());
+
+		// The cube maps of the point lights are only freed once none of them cast shadows
+		if (pointCasters == 0U)
+			return m_PointShadowDepthBuffer != nullptr;
+
+		return !m_PointShadowDepthBuffer || std::any_of(m_PointShadowMaps.begin(), m_PointShadowMaps.begin() + pointCasters, [](const Handle<Image>& shadowMap) { return !shadowMap; });
+	}
+	void Renderer::UpdateShadowMaps()
+	{
+		const uint32_t pointCasters = static_cast<uint32_t>(m_Scene->m_ActivePointLightsShadowIDs.size());
+
+		// The frames in flight can still render into and sample the old shadow maps
+		if (pointCasters == 0U)
+		{
+			for (auto& shadowMap : m_PointShadowMaps)
+				Retire(shadowMap);
+		}
+		else
+		{
+			for (uint32_t i = 0U; i < pointCasters; i++)
+			{
+				if (m_PointShadowMaps[i]) continue;
+
+				m_PointShadowMaps[i] = MakeHandle<Image>(
+					VkExtent2D{
+						m_Settings.pointLightShadowResolution,
+						m_Settings.pointLightShadowResolution
+					},
+					m_Settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? VK_FORMAT_R32_SFLOAT : VK_FORMAT_R16_SFLOAT,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+					VK_IMAGE_ASPECT_COLOR_BIT,
+					VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					6U
+				);
+			}
+		}
+
+		// The depth buffer of the point lights is a transient image of the graph, it's only allocated while the shadow pass uses it
+		if ((pointCasters > 0U) != (m_PointShadowDepthBuffer != nullptr))
+			CreateRenderGraph();
+
+		if (m_ShadowAtlasResolution == 0U)
+		{
+			Retire(m_ShadowAtlas);
+			Retire(m_StaticShadowAtlas);
+		}
+		else if (!m_ShadowAtlas || m_ShadowAtlas->m_Size.width != m_ShadowAtlasResolution)
+		{
+			// Both the old and the new atlases take memory until the frames in flight finish
+			Retire(m_ShadowAtlas);
+			Retire(m_StaticShadowAtlas);
+
+			m_ShadowAtlas = MakeHandle<Image>(
+				VkExtent2D{
+					m_ShadowAtlasResolution,
+					m_ShadowAtlasResolution
+				},
+				m_Settings.shadowsFormat,
+				VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+				VK_IMAGE_ASPECT_DEPTH_BIT,
+				0U,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+			);
+
+			if (m_Settings.shadowCaching)
+			{
+				m_StaticShadowAtlas = MakeHandle<Image>(
+					VkExtent2D{
+						m_ShadowAtlasResolution,
+						m_ShadowAtlasResolution
+					},
+					m_Settings.shadowsFormat,
+					VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+					VK_IMAGE_ASPECT_DEPTH_BIT,
+					0U,
+					VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+				);
+			}
+		}
+
+		// Whatever got recreated starts out empty
+		for (auto& cache : m_ShadowCaches)
+			cache.Invalidate();
+
+		// The set of the frames in flight can't be updated, they get a new one
+		Retire(m_ShadowMapsDescriptor);
+		m_ShadowMapsDescriptor = MakeHandle<DescriptorSet>(GetShadowMapsDescriptorInfo());
+	}
+	DescriptorInfo Renderer::GetShadowMapsDescriptorInfo() const
+	{
+		std::vector<DescriptorInfo::ImageInfoContent> pointShadowMaps{};
+
+		for (const auto& shadowMap : m_PointShadowMaps)
+		{
+			pointShadowMaps.emplace_back(DescriptorInfo::ImageInfoContent{
+				.imageView = shadowMap ? shadowMap->GetViewHandle() : m_EmptyPointShadowMap->GetViewHandle(),
+				.imageSampler = m_ShadowSampler->GetHandle()
+			});
+		}
+
+		return DescriptorInfo{
+			std::vector<DescriptorInfo::ImageInfo>{
+				DescriptorInfo::ImageInfo {
+					.index = 0U,
+					.count = static_cast<uint32_t>(pointShadowMaps.size()),
+
+					.contents = pointShadowMaps,
+
+					.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+					.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				},
+				DescriptorInfo::ImageInfo {
+					.index = 1U,
+
+					.contents {{
+						.imageView = m_ShadowAtlas ? m_ShadowAtlas->GetViewHandle() : m_EmptyShadowAtlas->GetViewHandle(),
+						.imageSampler = m_ShadowSampler->GetHandle()
+					}},
+
+					.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+					.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				},
+			}
+		};
+	}
+
+	void Renderer::UpdateCSM()
+	{
+		m_CSM.Update(
+			*m_Scene->m_MainCamera,
+			m_Scene->m_DirectionalLights,
+			m_Scene->m_ActiveDirLightsShadowIDs,
+			m_ShadowAtlasLayout,
+			m_Settings.cascadeFarPlane,
+			m_Settings.cascadeSplitWeight,
+			m_Settings.cascadeUpdateIntervals,
+			m_Settings.dirLightShadowResolution
+		);
+	}
+	
+	void Renderer::CullScene()
+	{
+		EN_PROFILE_FUNCTION();
+
+		m_CullingStats = CullingStats{};
+		m_CullingViewActive.fill(false);
+		m_CullingViewDrawMask.fill(VIEW_DRAWS_ALL);
+
+		for (auto& cache : m_ShadowCaches)
+			cache.tracked = false;
+
+		for (auto& queue : m_RenderQueues)
+			queue.Clear();
+
+		m_DepthPrepassQueue.Clear();
+
+		m_CullingFrustums[CAMERA_CULLING_VIEW] = Frustum(m_Scene->m_MainCamera->GetProjMatrix() * m_Scene->m_MainCamera->GetViewMatrix());
+		m_CullingViewActive[CAMERA_CULLING_VIEW] = true;
+
+		const Frustum& cameraFrustum = m_CullingFrustums[CAMERA_CULLING_VIEW];
+
+		for (const auto& i : m_Scene->m_ActivePointLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_PointLights[i];
+
+			const uint32_t firstView = POINT_CULLING_VIEWS + light.m_ShadowmapIndex * 6U;
+
+			for (uint32_t cubeSide = 0U; cubeSide < 6U; cubeSide++)
+			{
+				const uint32_t view = firstView + cubeSide;
+
+				m_CullingFrustums[view] = Frustum(light.m_ViewProj[cubeSide]);
+
+				// A face that does not overlap the camera frustum can't contain any visible receiver, so it is never sampled
+				if (m_CullingFrustums[view].IntersectsFrustum(cameraFrustum))
+					m_CullingViewActive[view] = true;
+				else
+					m_CullingStats.skippedPointShadowFaces++;
+			}
+
+			if (m_PointShadowMultiview)
+			{
+				// Every draw goes to all six faces, so the whole light is culled as one view with the box around its radius as the frustum.
+				// It's only skipped when none of the faces are needed.
+				const bool anyFaceActive = std::any_of(m_CullingViewActive.begin() + firstView, m_CullingViewActive.begin() + firstView + 6U, [](bool active) { return active; });
+
+				std::fill(m_CullingViewActive.begin() + firstView, m_CullingViewActive.begin() + firstView + 6U, false);
+
+				const float radius = light.m_Radius;
+
+				const glm::mat4 box = glm::ortho(-radius, radius, -radius, radius, -radius, radius) * glm::translate(glm::mat4(1.0f), -light.m_Position);
+
+				m_CullingFrustums[firstView] = Frustum(box);
+				m_CullingViewActive[firstView] = anyFaceActive;
+
+				TrackShadowCache(firstView, box);
+			}
+			else
+			{
+				for (uint32_t cubeSide = 0U; cubeSide < 6U; cubeSide++)
+					TrackShadowCache(firstView + cubeSide, light.m_ViewProj[cubeSide]);
+			}
+		}
+		for (const auto& i : m_Scene->m_ActiveSpotLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_SpotLights[i];
+
+			const uint32_t view = SPOT_CULLING_VIEWS + light.m_ShadowmapIndex;
+
+			m_CullingFrustums[view] = Frustum(light.m_ViewProj);
+
+			// Lights that didn't fit into the atlas have nothing to render into
+			m_CullingViewActive[view] = m_ShadowAtlasLayout.GetTile(view - SPOT_CULLING_VIEWS).size != 0U;
+
+			TrackShadowCache(view, light.m_ViewProj);
+		}
+		for (const auto& i : m_Scene->m_ActiveDirLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_DirectionalLights[i];
+
+			for (uint32_t cascadeIndex = 0U; cascadeIndex < SHADOW_CASCADES; cascadeIndex++)
+			{
+				const uint32_t view = DIR_CULLING_VIEWS + light.m_ShadowmapIndex * SHADOW_CASCADES + cascadeIndex;
+
+				m_CullingFrustums[view] = Frustum(m_CSM.cascadeMatrices[light.m_ShadowmapIndex][cascadeIndex]);
+				m_CullingViewActive[view] = m_ShadowAtlasLayout.GetTile(view - SPOT_CULLING_VIEWS).size != 0U;
+
+				TrackShadowCache(view, m_CSM.cascadeMatrices[light.m_ShadowmapIndex][cascadeIndex]);
+			}
+		}
+
+		ApplyShadowCaches();
+
+		if (m_Settings.gpuDrivenRendering)
+			return;
+
+		const auto& draws	   = m_Scene->m_Draws;
+		const auto& drawBounds = m_Scene->m_DrawBounds;
+		const uint32_t drawCount = m_Scene->GetDrawCount();
+
+		const auto& camera = m_Scene->m_MainCamera;
+
+		// Point light casters outside of the light's radius can't be in any of its faces, views without a light get a zero radius
+		std::vector<std::pair<uint32_t, glm::vec4>> activeViews;
+
+		activeViews.emplace_back(CAMERA_CULLING_VIEW, glm::vec4(0.0f));
+
+		for (const auto& i : m_Scene->m_ActivePointLightsShadowIDs)
+		{
+			const auto& light = m_Scene->m_PointLights[i];
+
+			const uint32_t firstView = POINT_CULLING_VIEWS + light.m_ShadowmapIndex * 6U;
+
+			for (uint32_t view = firstView; view < firstView + 6U; view++)
+				if (m_CullingViewActive[view])
+					activeViews.emplace_back(view, glm::vec4(light.m_Position, light.m_Radius));
+		}
+
+		for (uint32_t view = SPOT_CULLING_VIEWS; view < MAX_CULLING_VIEWS; view++)
+			if (m_CullingViewActive[view])
+				activeViews.emplace_back(view, glm::vec4(0.0f));
+
+		// Every view writes only to its own queues, so they can be culled and sorted in parallel
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(activeViews.size()), [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const auto& [view, lightSphere] = activeViews[i];
 
-			m_ForwardPass->BindDescriptorSet(m_CameraBuffer->GetDescriptorHandle(m_FrameIndex), 0U);
-			m_ForwardPass->BindDescriptorSet(m_Scene->m_GlobalDescriptorSet, 1U);
-			m_ForwardPass->BindDescriptorSet(m_ShadowMapsDescriptor, 2U);
-			m_ForwardPass->BindDescriptorSet(m_ClusterDescriptor, 3U);
-			m_ForwardPass->BindDescriptorSet(m_SSAODescriptor, 4U);
+				const Frustum& frustum = m_CullingFrustums[view];
 
-			m_ForwardPass->PushConstants(&m_Scene->m_MainCamera->m_Exposure, sizeof(float), sizeof(uint32_t)*2, VK_SHADER_STAGE_FRAGMENT_BIT);
+				auto& queue = m_RenderQueues[view];
 
-			for (const auto& [name, sceneObject] : m_Scene->m_SceneObjects)
-			{
-				if(!sceneObject->m_Active || !sceneObject->m_Mesh->m_Active) continue;
+				const bool cameraView = view == CAMERA_CULLING_VIEW;
 
-				m_ForwardPass->PushConstants(&sceneObject->GetMatrixIndex(), sizeof(uint32_t), 0U, VK_SHADER_STAGE_VERTEX_BIT);
+				// The static cache views are drawn with the pipeline of their atlas tile
+				const uint32_t pipelineView	  = view >= STATIC_CULLING_VIEWS ? view - STATIC_CULLING_VIEWS + SPOT_CULLING_VIEWS : view;
+				const uint32_t shadowPipeline = pipelineView < SPOT_CULLING_VIEWS ? 0U : pipelineView < DIR_CULLING_VIEWS ? 1U : 2U;
 
-				for (const auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
+				const uint32_t drawMask = m_CullingViewDrawMask[view];
+
+				for (uint32_t j = 0U; j < drawCount; j++)
 				{
-					if (!subMesh.m_Active) continue;
+					// Hidden, the draw only keeps its slot
+					if (draws[j].indexCount == 0U)
+						continue;
 
-					m_ForwardPass->PushConstants(&subMesh.GetMaterialIndex(), sizeof(uint32_t), sizeof(uint32_t), VK_SHADER_STAGE_FRAGMENT_BIT);
+					if (!(drawMask & ((draws[j].flags & Scene::DRAW_FLAG_STATIC) ? VIEW_DRAWS_STATIC : VIEW_DRAWS_DYNAMIC)))
+						continue;
 
-					m_ForwardPass->BindVertexBuffer(subMesh.m_VertexBuffer);
-					m_ForwardPass->BindIndexBuffer(subMesh.m_IndexBuffer);
+					if (lightSphere.w > 0.0f && !drawBounds[j].IntersectsSphere(glm::vec3(lightSphere), lightSphere.w))
+						continue;
 
-					m_ForwardPass->DrawIndexed(subMesh.m_IndexCount);
-				}
-			}
+					if (!frustum.IsAABBVisible(drawBounds[j]))
+						continue;
 
-		m_ForwardPass->End();
+					if (cameraView)
+					{
+						const float depth = glm::distance((drawBounds[j].min + drawBounds[j].max) * 0.5f, camera->m_Position) / camera->m_FarPlane;
 
-	}
-	void Renderer::AntialiasingPass()
-	{
-		if (m_SkipFrame || m_Settings.antialiasingMode == AntialiasingMode::None) return;
+						// Front to back when the forward pass has to do the early-Z rejection itself, by material otherwise
+						queue.Push(RenderQueue::MakeKey(FORWARD_QUEUE_PASS, 0U, draws[j].materialIndex, draws[j].geometryIndex, depth, !m_Settings.depthPrePass), j);
 
-		m_AliasedImage->ChangeLayout(
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-			m_Frames[m_FrameIndex].commandBuffer
-		);
+						if (m_Settings.depthPrePass)
+							m_DepthPrepassQueue.Push(RenderQueue::MakeKey(DEPTH_QUEUE_PASS, 0U, 0U, draws[j].geometryIndex, depth, true), j);
+					}
+					else
+					{
+						// The shadow shaders don't read materials and the order doesn't matter much for depth only targets, so only the geometry is grouped
+						queue.Push(RenderQueue::MakeKey(SHADOW_QUEUE_PASS, shadowPipeline, 0U, draws[j].geometryIndex, 0.0f), j);
+					}
+				}
 
-		m_Settings.antialiasing.texelSizeX = 1.0f / m_Swapchain->GetExtent().width;
-		m_Settings.antialiasing.texelSizeY = 1.0f / m_Swapchain->GetExtent().height;
+				queue.Sort();
 
-		GraphicsPass::RenderInfo renderInfo{
-			.colorAttachmentView = m_Swapchain->m_ImageViews[m_Swapchain->m_ImageIndex],
-			.colorAttachmentLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				if (cameraView)
+					m_DepthPrepassQueue.Sort();
+			}
+		}, 1U);
 
-			.extent = m_Swapchain->GetExtent(),
+		m_CullingStats.visibleDraws = m_RenderQueues[CAMERA_CULLING_VIEW].GetDrawCount();
+		m_CullingStats.culledDraws  = drawCount - m_CullingStats.visibleDraws;
 
-			.cullMode = VK_CULL_MODE_FRONT_BIT,
-		};
+		for (uint32_t view = POINT_CULLING_VIEWS; view < MAX_CULLING_VIEWS; view++)
+		{
+			if (!m_CullingViewActive[view])
+				continue;
 
-		m_AntialiasingPass->Begin(m_Frames[m_FrameIndex].commandBuffer, renderInfo);
-			m_AntialiasingPass->BindDescriptorSet(m_AntialiasingDescriptor);
-			m_AntialiasingPass->PushConstants(&m_Settings.antialiasing, sizeof(m_Settings.antialiasing), 0U, VK_SHADER_STAGE_FRAGMENT_BIT);
-			m_AntialiasingPass->Draw(3U);
-		m_AntialiasingPass->End();
+			m_CullingStats.visibleShadowDraws += m_RenderQueues[view].GetDrawCount();
+			m_CullingStats.culledShadowDraws  += drawCount - m_RenderQueues[view].GetDrawCount();
+		}
 	}
-	void Renderer::ImGuiPass()
+	
+	void Renderer::TrackShadowCache(const uint32_t view, const glm::mat4& viewProj)
 	{
-		if (m_SkipFrame || m_ImGuiRenderCallback == nullptr) return;
-		
-		m_ImGuiRenderCallback();
+		auto& cache = m_ShadowCaches[view];
 
-		m_ImGuiContext->Render(m_Frames[m_FrameIndex].commandBuffer, m_Swapchain->m_ImageIndex);
-	}
-	void Renderer::EndRender()
-	{
-		if (m_SkipFrame) return;
+		cache.tracked = true;
 
-		if (vkEndCommandBuffer(m_Frames[m_FrameIndex].commandBuffer) != VK_SUCCESS)
-			EN_ERROR("Renderer::EndRender() - Failed to record command buffer!");
+		if (cache.viewProj != viewProj)
+		{
+			cache.viewProj = viewProj;
+			cache.Invalidate();
 
-		const VkPipelineStageFlags waitStages[]     = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		const VkSemaphore		   waitSemaphores[] = { m_Frames[m_FrameIndex].mainSemaphore };
-		
-		const VkCommandBuffer commandBuffers[] = { m_Frames[m_FrameIndex].commandBuffer };
+			return;
+		}
 
-		const VkSemaphore signalSemaphores[] = { m_Frames[m_FrameIndex].presentSemaphore };
+		const Frustum& frustum = m_CullingFrustums[view];
 
-		VkSubmitInfo submitInfo{
-			.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO,
-			.waitSemaphoreCount = 1U,
-			.pWaitSemaphores	= waitSemaphores,
-			.pWaitDstStageMask  = waitStages,
+		// The bounds from before the move count too, the caster could have just left the view
+		for (const auto& bounds : m_Scene->m_MovedStaticBounds)
+		{
+			if (frustum.IsAABBVisible(bounds))
+			{
+				cache.Invalidate();
+				return;
+			}
+		}
 
-			.commandBufferCount = 1U,
-			.pCommandBuffers	= commandBuffers,
+		if (!cache.valid)
+			return;
 
-			.signalSemaphoreCount = 1U,
-			.pSignalSemaphores	  = signalSemaphores,
-		};
+		for (const auto& bounds : m_Scene->m_MovedDynamicBounds)
+		{
+			if (frustum.IsAABBVisible(bounds))
+			{
+				cache.valid = false;
+				return;
+			}
+		}
+	}
+	void Renderer::ApplyShadowCaches()
+	{
+		for (uint32_t view = POINT_CULLING_VIEWS; view < STATIC_CULLING_VIEWS; view++)
+		{
+			auto& cache = m_ShadowCaches[view];
 
+			// Nothing kept track of the view while it had no light, so its contents can't be trusted anymore
+			if (!cache.tracked)
+				cache.Invalidate();
 
-		if (vkQueueSubmit(g_Ctx->m_GraphicsQueue, 1U, &submitInfo, m_Frames[m_FrameIndex].submitFence) != VK_SUCCESS)
-			EN_ERROR("Renderer::EndRender() - Failed to submit command buffer!");
+			if (!m_CullingViewActive[view])
+				continue;
 
-		VkPresentInfoKHR presentInfo{
-			.sType				= VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-			.waitSemaphoreCount = 1U,
-			.pWaitSemaphores	= signalSemaphores,
+			if (m_Settings.shadowCaching && cache.valid)
+			{
+				m_CullingViewActive[view] = false;
+				m_CullingStats.cachedShadowViews++;
 
-			.swapchainCount = 1U,
-			.pSwapchains	= &m_Swapchain->m_Swapchain,
-			.pImageIndices  = &m_Swapchain->m_ImageIndex,
-			.pResults	    = nullptr,
-		};
+				continue;
+			}
 
-		VkResult result = vkQueuePresentKHR(g_Ctx->m_PresentQueue, &presentInfo);
+			// The cascades that aren't due keep their shadow map, even when their dynamic casters moved
+			if (view >= DIR_CULLING_VIEWS && cache.drawn && !m_CSM.cascadeStates[view - DIR_CULLING_VIEWS].updated)
+			{
+				m_CullingViewActive[view] = false;
+				m_CullingStats.staggeredShadowViews++;
 
-		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_FramebufferResized)
-			RecreateFramebuffer();
-		else if (m_ReloadQueued)
-			ReloadBackendImpl();
-		else if (result != VK_SUCCESS)
-			EN_ERROR("Renderer::EndRender() - Failed to present swap chain image!");
+				continue;
+			}
 
-		m_FrameIndex = (m_FrameIndex + 1) % FRAMES_IN_FLIGHT;
-	}
+			// Point lights are always redrawn as a whole
+			if (!m_Settings.shadowCaching || view < SPOT_CULLING_VIEWS)
+				continue;
 
-	void Renderer::SetVSyncEnabled(const bool enabled)
-	{
-		m_Settings.vSync = enabled;
-		m_FramebufferResized = true;
-	}
-	void Renderer::SetDepthPrepassEnabled(const bool enabled)
-	{
-		m_Settings.depthPrePass = enabled;
-		m_ReloadQueued = true;
-	}
+			// The tile gets a copy of the static cache and only the dynamic casters are drawn over it
+			m_CullingViewDrawMask[view] = VIEW_DRAWS_DYNAMIC;
 
-	void Renderer::SetShadowCascadesWeight(const float weight)
-	{
-		m_Settings.cascadeSplitWeight = weight;
-		ReloadBackend();
-	}
-	void Renderer::SetShadowCascadesFarPlane(const float farPlane)
-	{
-		m_Settings.cascadeFarPlane = farPlane;
-		ReloadBackend();
-	}
+			if (!cache.staticValid)
+			{
+				const uint32_t staticView = STATIC_CULLING_VIEWS + view - SPOT_CULLING_VIEWS;
 
-	void Renderer::SetPointShadowResolution(const uint32_t resolution)
-	{
-		m_Settings.pointLightShadowResolution = resolution;
-		ReloadBackend();
-	}
-	void Renderer::SetSpotShadowResolution(const uint32_t resolution)
-	{
-		m_Settings.spotLightShadowResolution = resolution;
-		ReloadBackend();
-	}
-	void Renderer::SetDirShadowResolution(const uint32_t resolution)
-	{
-		m_Settings.dirLightShadowResolution = resolution;
-		ReloadBackend();
-	}
-	void Renderer::SetShadowFormat(const VkFormat format)
-	{
-		m_Settings.shadowsFormat = format;
-		ReloadBackend();
+				m_CullingFrustums[staticView]	  = m_CullingFrustums[view];
+				m_CullingViewActive[staticView]	  = true;
+				m_CullingViewDrawMask[staticView] = VIEW_DRAWS_STATIC;
+			}
+		}
 	}
 
-	void Renderer::SetAntialiasingMode(const AntialiasingMode antialiasingMode)
-	{
-		m_Settings.antialiasingMode = antialiasingMode;
-		ReloadBackend();
-	}
-	void Renderer::SetAmbientOcclusionMode(const AmbientOcclusionMode aoMode)
+	void Renderer::FramebufferResizeCallback(GLFWwindow* window, int width, int height)
 	{
-		m_Settings.ambientOcclusionMode = aoMode;
-		ReloadBackend();
+		g_CurrentBackend->ReloadBackend(BACKEND_OUTPUT);
 	}
-
-	//void Renderer::SetAntialaliasingQuality(const QualityLevel quality)
-	//{
-	//	m_Settings.antialiasingQuality = quality;
-	//	ReloadBackend();
-	//}
-	void Renderer::SetAmbientOcclusionQuality(const QualityLevel quality)
+	void Renderer::ReloadBackend(const uint32_t parts)
 	{
-		m_Settings.ambientOcclusionQuality = quality;
-		ReloadBackend();
+		m_QueuedBackendParts |= parts;
 	}
-
-	void Renderer::UpdateCSM()
+	void Renderer::ReloadBackendImpl()
 	{
-		// CSM Implementation heavily inspired with:
-		// Blaze engine by kidrigger - https://github.com/kidrigger/Blaze
-		// Flex Engine by ajweeks - https://github.com/ajweeks/FlexEngine
+		EN_PROFILE_FUNCTION();
 
+		uint32_t parts = m_QueuedBackendParts;
 
-		float ratio = m_Settings.cascadeFarPlane / m_Scene->m_MainCamera->m_NearPlane;
+		for (const auto& [part, dependents] : BACKEND_DEPENDENTS)
+			if (parts & part)
+				parts |= dependents;
 
-		for (int i = 1; i < SHADOW_CASCADES; i++)
+		// A new swapchain can't be built next to the one that is presented from, so only the rest is built in the background
+		if (!(parts & BACKEND_OUTPUT))
 		{
-			float si = i / float(SHADOW_CASCADES);
-
-			float nearPlane = m_Settings.cascadeSplitWeight * (
-				m_Scene->m_MainCamera->m_NearPlane * powf(ratio, si)) + 
-				(1.0f - m_Settings.cascadeSplitWeight) * (m_Scene->m_MainCamera->m_NearPlane + 
-				(m_Settings.cascadeFarPlane - m_Scene->m_MainCamera->m_NearPlane) * si
-			);
+			// One build at a time, what was requested in the meantime starts once it's switched in
+			if (!m_BackendBuild)
+			{
+				m_QueuedBackendParts = 0U;
+				BeginBackendBuild(parts);
+			}
 
-			float farPlane = nearPlane * 1.005f;
-			m_CSM.cascadeSplitDistances[i - 1] = farPlane;
+			return;
 		}
 
-		m_CSM.cascadeSplitDistances[SHADOW_CASCADES - 1] = m_Settings.cascadeFarPlane;
+		m_QueuedBackendParts = 0U;
 
-		glm::vec4 frustumClipSpace[8]
+		// The settings of the build are superseded by the requested ones anyway
+		if (m_BackendBuild)
 		{
-			{-1.0f, -1.0f, -1.0f, 1.0f},
-			{-1.0f,  1.0f, -1.0f, 1.0f},
-			{ 1.0f, -1.0f, -1.0f, 1.0f},
-			{ 1.0f,  1.0f, -1.0f, 1.0f},
-			{-1.0f, -1.0f,  1.0f, 1.0f},
-			{-1.0f,  1.0f,  1.0f, 1.0f},
-			{ 1.0f, -1.0f,  1.0f, 1.0f},
-			{ 1.0f,  1.0f,  1.0f, 1.0f},
-		};
+			JobSystem::Get().Wait(m_BackendBuild->pipelines);
+
+			parts |= m_BackendBuild->parts;
+			m_BackendBuild.reset();
+		}
 
-		glm::mat4 invViewProj = glm::inverse(m_Scene->m_MainCamera->GetProjMatrix() * m_Scene->m_MainCamera->GetViewMatrix());
+		CopyBackendSettings(m_Settings, m_RequestedSettings);
 
-		for (auto& vert : frustumClipSpace)
+		// Waits until the window isn't minimized anymore
+		if (!g_Ctx->IsHeadless())
 		{
-			vert = invViewProj * vert;
-			vert /= vert.w;
+			glm::ivec2 size{};
+			while (size.x == 0 || size.y == 0)
+				size = Window::Get().GetFramebufferSize();
 		}
 
-		float cosine = glm::dot(glm::normalize(glm::vec3(frustumClipSpace[4]) - m_Scene->m_MainCamera->m_Position), m_Scene->m_MainCamera->GetFront());
-		glm::vec3 cornerRay = glm::normalize(glm::vec3(frustumClipSpace[4] - frustumClipSpace[0]));
+		ResetAllFrames();
+		
+		g_Ctx->WaitIdle();
 
-		float prevFarPlane = m_Scene->m_MainCamera->m_NearPlane;
+		// The passes the previous backend didn't need could still be in the making
+		WaitForPipelines(m_DeferredPipelines);
 
-		for (int i = 0; i < SHADOW_CASCADES; ++i)
+		if (parts == BACKEND_ALL)
 		{
-			float farPlane = m_CSM.cascadeSplitDistances[i];
-			float secTheta = 1.0f / cosine;
-			float cDist = 0.5f * (farPlane + prevFarPlane) * secTheta * secTheta;
-			m_CSM.cascadeCenters[i] = m_Scene->m_MainCamera->GetFront() * cDist + m_Scene->m_MainCamera->m_Position;
-
-			float nearRatio = prevFarPlane / m_Settings.cascadeFarPlane;
-			glm::vec3 corner = cornerRay * nearRatio + m_Scene->m_MainCamera->m_Position;
+			DestroyPerFrameData();
 
-			m_CSM.cascadeRadiuses[i] = glm::distance(m_CSM.cascadeCenters[i], corner);
+			CreateBackend(false);
 
-			prevFarPlane = farPlane;
+			return;
 		}
 
-		m_CSM.cascadeFrustumSizeRatios[0] = 1.0f;
-		for (int i = 1; i < SHADOW_CASCADES; i++)
-			m_CSM.cascadeFrustumSizeRatios[i] = m_CSM.cascadeRadiuses[i] / m_CSM.cascadeRadiuses[0];
+		const VkFormat oldFormat = GetOutputFormat();
 
-		for (const auto& i : m_Scene->m_ActiveDirLightsShadowIDs)
-		{
-			const DirectionalLight& light = m_Scene->m_DirectionalLights[i];
+		CreateOutput();
 
-			for (uint32_t j = 0U; j < SHADOW_CASCADES; ++j)
-			{
-				float radius = m_CSM.cascadeRadiuses[j];
-				glm::vec3 center = m_CSM.cascadeCenters[j];
+		// Everything that renders straight into the output was created for its format
+		if (GetOutputFormat() != oldFormat)
+			parts |= BACKEND_FORWARD_PASS | BACKEND_AA_PASS;
 
-				glm::mat4 lightProj = glm::ortho(-radius, radius, -radius, radius, 0.0f, light.m_FarPlane * radius);
-				glm::mat4 lightView = glm::lookAt(center - (light.m_FarPlane - 1.0f) * -glm::normalize(light.m_Direction + glm::vec3(0.00000127f)) * radius, center, glm::vec3(0, 1, 0));
+		if (m_ImGuiContext)
+			m_ImGuiContext->UpdateFramebuffers(m_Swapchain->GetExtent(), m_Swapchain->m_ImageViews);
 
-				glm::mat4 shadowViewProj = lightProj * lightView;
-				glm::vec4 shadowOrigin = shadowViewProj * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) * float(m_Settings.dirLightShadowResolution) / 2.0f;
+		EN_LOG("Resized to (" + std::to_string(GetOutputExtent().width) + ", " + std::to_string(GetOutputExtent().height) + ")");
 
-				glm::vec4 shadowOffset = (glm::round(shadowOrigin) - shadowOrigin) * 2.0f / float(m_Settings.dirLightShadowResolution) * glm::vec4(1, 1, 0, 0);
+		if (parts & BACKEND_SHADOW_RESOURCES)
+			CreateShadowResources();
+		else if (parts & BACKEND_SHADOW_MAPS)
+		{
+			ReleaseShadowMaps();
+			m_ShadowMapsDescriptor->Update(GetShadowMapsDescriptorInfo());
+		}
 
-				glm::mat4 shadowProj = lightProj;
-				shadowProj[3] += shadowOffset;
+		if (parts & BACKEND_SHADOW_PASSES)
+			CreateShadowPasses(m_Settings, m_DirShadowPass, m_SpotShadowPass, m_PointShadowPass);
 
-				m_CSM.cascadeMatrices[i][j] = shadowProj * lightView;
-			}
-		}
+		if (parts & BACKEND_RENDER_GRAPH)
+			CreateRenderGraph();
+
+		if (parts & BACKEND_FORWARD_PASS)
+			CreateForwardPass(m_Settings, m_ForwardPass);
+		if (parts & BACKEND_AA_PASS)
+			CreateAntialiasingPass();
+
+		WaitForPipelines(m_RequiredPipelines);
+
+		// The creation stats are only kept for whole backends
+		std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+		m_PipelineTimings.clear();
 	}
-	
-	void Renderer::FramebufferResizeCallback(GLFWwindow* window, int width, int height)
+	void Renderer::BeginBackendBuild(const uint32_t parts)
 	{
-		g_CurrentBackend->m_FramebufferResized = true;
+		EN_PROFILE_FUNCTION();
+
+		m_BackendBuild = MakeScope<BackendBuild>();
+		m_BackendBuild->parts = parts;
+		m_BackendBuild->start = std::chrono::steady_clock::now();
+
+		m_BackendBuild->settings = m_Settings;
+		CopyBackendSettings(m_BackendBuild->settings, m_RequestedSettings);
+
+		// Only the pipelines take long enough to be worth building on the workers, the images and descriptors are created when switching
+		if (parts & BACKEND_SHADOW_PASSES)
+			CreateShadowPasses(m_BackendBuild->settings, m_BackendBuild->dirShadowPass, m_BackendBuild->spotShadowPass, m_BackendBuild->pointShadowPass, &m_BackendBuild->pipelines);
+
+		if (parts & BACKEND_FORWARD_PASS)
+			CreateForwardPass(m_BackendBuild->settings, m_BackendBuild->forwardPass, &m_BackendBuild->pipelines);
 	}
-	void Renderer::RecreateFramebuffer()
+	void Renderer::SwitchBackend()
 	{
-		glm::ivec2 size{};
-		while (size.x == 0 || size.y == 0)
-			size = Window::Get().GetFramebufferSize();
-		
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+		EN_PROFILE_FUNCTION();
 
-		m_Swapchain.reset(); // It is critical to reset before creating a new one
-		m_Swapchain = MakeHandle<Swapchain>(m_Settings.vSync);
+		const Scope<BackendBuild> build = std::move(m_BackendBuild);
 
-		CreateDepthBuffer();
-		CreateAATarget();
-		CreateSSAOTarget();
+		// Both are done already, the errors of their jobs are rethrown here
+		WaitForPipelines(build->pipelines);
+		WaitForPipelines(m_DeferredPipelines);
 
-		m_ImGuiContext->UpdateFramebuffers(m_Swapchain->GetExtent(), m_Swapchain->m_ImageViews);
+		CopyBackendSettings(m_Settings, build->settings);
 
-		m_FramebufferResized = false;
+		// The frames in flight still use the replaced parts, they are retired instead of destroyed
+		if (build->parts & BACKEND_SHADOW_RESOURCES)
+			CreateShadowResources();
+		else if (build->parts & BACKEND_SHADOW_MAPS)
+		{
+			ReleaseShadowMaps();
 
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+			Retire(m_ShadowMapsDescriptor);
+			m_ShadowMapsDescriptor = MakeHandle<DescriptorSet>(GetShadowMapsDescriptorInfo());
+		}
 
-		EN_LOG("Resized to (" + std::to_string(m_Swapchain->GetExtent().width) + ", " + std::to_string(m_Swapchain->GetExtent().height) + ")");
-	}
-	void Renderer::ReloadBackend()
-	{
-		m_ReloadQueued = true;
+		if (build->parts & BACKEND_SHADOW_PASSES)
+		{
+			Retire(m_DirShadowPass);
+			Retire(m_SpotShadowPass);
+			Retire(m_PointShadowPass);
+
+			m_DirShadowPass	  = build->dirShadowPass;
+			m_SpotShadowPass  = build->spotShadowPass;
+			m_PointShadowPass = build->pointShadowPass;
+		}
+
+		if (build->parts & BACKEND_RENDER_GRAPH)
+			CreateRenderGraph();
+
+		if (build->parts & BACKEND_FORWARD_PASS)
+		{
+			Retire(m_ForwardPass);
+			m_ForwardPass = build->forwardPass;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+			m_PipelineTimings.clear();
+		}
+
+		EN_LOG("Switched to the rebuilt backend parts " + std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - build->start).count()) + "ms after the request");
 	}
-	void Renderer::ReloadBackendImpl()
+	void Renderer::CopyBackendSettings(Settings& settings, const Settings& from)
 	{
-		ResetAllFrames();
-		
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+		settings.vSync		  = from.vSync;
+		settings.depthPrePass = from.depthPrePass;
 
-		DestroyPerFrameData();
+		settings.pointLightShadowResolution = from.pointLightShadowResolution;
+		settings.spotLightShadowResolution	= from.spotLightShadowResolution;
+		settings.dirLightShadowResolution	= from.dirLightShadowResolution;
 
-		CreateBackend(false);
+		settings.shadowsFormat = from.shadowsFormat;
+		settings.shadowCaching = from.shadowCaching;
 
-		m_ReloadQueued = false;
+		settings.antialiasingMode	  = from.antialiasingMode;
+		settings.ambientOcclusionMode = from.ambientOcclusionMode;
 	}
 	void Renderer::CreateBackend(bool newImGui)
 	{
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+		g_Ctx->WaitIdle();
+
+		const auto backendStart = std::chrono::steady_clock::now();
+
+		const bool warmPipelineCache = g_Ctx->IsPipelineCacheWarm();
+
+		m_DeferredPipelineCount = 0U;
 
 		EN_SUCCESS("Init began!")
 
-			m_Swapchain.reset();
-		m_Swapchain = MakeHandle<Swapchain>(m_Settings.vSync);
+			CreateOutput();
 
-		EN_SUCCESS("Created swapchain!")
+		EN_SUCCESS("Created the output target!")
 
 			m_CameraBuffer = MakeHandle<CameraBuffer>();
 
@@ -868,21 +2015,13 @@ namespace en
 
 		EN_SUCCESS("Created shadow resources!")
 
-			CreateShadowPasses();
+			CreateShadowPasses(m_Settings, m_DirShadowPass, m_SpotShadowPass, m_PointShadowPass);
 
 		EN_SUCCESS("Created shadow passes!")
 
-			CreateDepthBuffer();
-
-		EN_SUCCESS("Created depth buffer!")
-
-			CreateAATarget();
+			CreateRenderGraph();
 
-		EN_SUCCESS("Created the antialiasing target!")
-
-			CreateSSAOTarget();
-
-		EN_SUCCESS("Created the SSAO target!")
+		EN_SUCCESS("Created the render graph!")
 
 			CreateDepthPass();
 
@@ -896,11 +2035,19 @@ namespace en
 
 		EN_SUCCESS("Created the cluster pass!")
 
+			CreateDrawCullingBuffers(std::max(m_DrawCulling.capacity, 256U));
+
+		EN_SUCCESS("Created the draw culling buffers!")
+
+			CreateDrawCullingPass();
+
+		EN_SUCCESS("Created the draw culling pass!")
+
 			CreateSSAOPass();
 
 		EN_SUCCESS("Created the SSAO pass!")
 
-			CreateForwardPass();
+			CreateForwardPass(m_Settings, m_ForwardPass);
 
 		EN_SUCCESS("Created the forward pass!")
 
@@ -908,147 +2055,163 @@ namespace en
 
 		EN_SUCCESS("Created the antialiasing pass!")
 
-			if (newImGui)
+			// The editor needs a window, so there is no ImGui in headless mode
+			if (g_Ctx->IsHeadless())
+				m_ImGuiContext.reset();
+			else if (newImGui)
 				m_ImGuiContext = MakeHandle<ImGuiContext>(m_Swapchain->GetFormat(), m_Swapchain->GetExtent(), m_Swapchain->m_ImageViews);
 			else
 				m_ImGuiContext->UpdateFramebuffers(m_Swapchain->GetExtent(), m_Swapchain->m_ImageViews);
 
 		EN_SUCCESS("Created the ImGui context!")
+
+		// Everything else was created while the pipelines compiled on the workers
+		const auto waitStart = std::chrono::steady_clock::now();
+
+		WaitForPipelines(m_RequiredPipelines);
+
+		const auto backendEnd = std::chrono::steady_clock::now();
+
+		m_PipelineCreationStats = PipelineCreationStats{
+			.deferredPipelines = m_DeferredPipelineCount,
+
+			.waitTime	 = std::chrono::duration<float, std::milli>(backendEnd - waitStart).count(),
+			.backendTime = std::chrono::duration<float, std::milli>(backendEnd - backendStart).count(),
+			.warmCache	 = warmPipelineCache,
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+
+			for (const auto& timing : m_PipelineTimings)
+			{
+				m_PipelineCreationStats.pipelines++;
+				m_PipelineCreationStats.creationTime += timing.time;
+
+				EN_LOG("    " + std::string(timing.name) + ": " + std::to_string(timing.time) + "ms");
+			}
+
+			m_PipelineTimings.clear();
+		}
+
+		EN_LOG(
+			"Created the backend in " + std::to_string(m_PipelineCreationStats.backendTime) + "ms, " + std::to_string(m_PipelineCreationStats.waitTime) +
+			"ms of it waiting for " + std::to_string(m_PipelineCreationStats.pipelines) + " pipelines (" + std::to_string(m_PipelineCreationStats.creationTime) +
+			"ms summed over the workers) with a " + (warmPipelineCache ? "warm" : "cold") + " pipeline cache, " +
+			std::to_string(m_DeferredPipelineCount) + " unused ones are created in the background"
+		);
 		
 		EN_SUCCESS("Created the renderer Vulkan backend");
 
-		vkDeviceWaitIdle(g_Ctx->m_LogicalDevice);
+		g_Ctx->WaitIdle();
 	}
 
 	void Renderer::CreateShadowResources()
 	{
-		m_PointShadowDepthBuffer = MakeHandle<Image>(
-			VkExtent2D{
-				m_Settings.pointLightShadowResolution,
-				m_Settings.pointLightShadowResolution
-			},
+		m_PointShadowMultiview = g_Ctx->IsMultiviewSupported();
+
+		// A build without the multiview variant still renders the six faces one by one
+		if (m_PointShadowMultiview && !std::filesystem::exists("Shaders/PointShadowMultiviewVert.spv"))
+		{
+			EN_WARN("Renderer::CreateShadowResources() - \"Shaders/PointShadowMultiviewVert.spv\" is missing, the point light shadows are rendered without multiview!");
+			m_PointShadowMultiview = false;
+		}
+
+		// Could be in use by the frames in flight when the shadow format changes in the background
+		Retire(m_ShadowSampler);
+		Retire(m_EmptyPointShadowMap);
+		Retire(m_EmptyShadowAtlas);
+		Retire(m_ShadowMapsDescriptor);
+
+		m_ShadowSampler = MakeHandle<Sampler>(VK_FILTER_LINEAR);
+
+		ReleaseShadowMaps();
+
+		// Bound in place of the shadow maps that don't exist, they are never sampled
+		m_EmptyPointShadowMap = MakeHandle<Image>(
+			VkExtent2D{ 1U, 1U },
+			m_Settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? VK_FORMAT_R32_SFLOAT : VK_FORMAT_R16_SFLOAT,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT,
+			VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			6U
+		);
+		m_EmptyShadowAtlas = MakeHandle<Image>(
+			VkExtent2D{ 1U, 1U },
 			m_Settings.shadowsFormat,
-			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
 			VK_IMAGE_ASPECT_DEPTH_BIT,
 			0U,
-			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
 		);
 
-		m_ShadowSampler = MakeHandle<Sampler>(VK_FILTER_LINEAR);
-
+		m_ShadowMapsDescriptor = MakeHandle<DescriptorSet>(GetShadowMapsDescriptorInfo());
+	}
+	void Renderer::ReleaseShadowMaps()
+	{
+		// The shadow maps themselves are created on demand by UpdateShadowMaps(), the atlas gets packed from scratch
 		for (auto& shadowMap : m_PointShadowMaps)
-		{
-			shadowMap = MakeHandle<Image>(
-				VkExtent2D{
-					m_Settings.pointLightShadowResolution,
-					m_Settings.pointLightShadowResolution
-				},
-				m_Settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? VK_FORMAT_R32_SFLOAT : VK_FORMAT_R16_SFLOAT,
-				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-				VK_IMAGE_ASPECT_COLOR_BIT,
-				VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				6U
-			);
-		}
-		for (auto& shadowMap : m_SpotShadowMaps)
-		{
-			shadowMap = MakeHandle<Image>(
-				VkExtent2D{
-					m_Settings.spotLightShadowResolution,
-					m_Settings.spotLightShadowResolution
-				},
-				m_Settings.shadowsFormat,
-				VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-				VK_IMAGE_ASPECT_DEPTH_BIT,
-				0U,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-			);
-		}
-		for (auto& shadowMap : m_DirShadowMaps)
-		{
-			shadowMap = MakeHandle<Image>(
-				VkExtent2D{
-					m_Settings.dirLightShadowResolution,
-					m_Settings.dirLightShadowResolution
-				},
-				m_Settings.shadowsFormat,
-				VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-				VK_IMAGE_ASPECT_DEPTH_BIT,
-				0U,
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-			);
-		}
+			Retire(shadowMap);
 
-		std::vector<DescriptorInfo::ImageInfoContent> pointShadowMaps{};
-		std::vector<DescriptorInfo::ImageInfoContent> spotShadowMaps{};
-		std::vector<DescriptorInfo::ImageInfoContent> dirShadowMaps{};
+		Retire(m_ShadowAtlas);
+		Retire(m_StaticShadowAtlas);
 
-		for (const auto& shadowMap : m_PointShadowMaps)
-		{
-			pointShadowMaps.emplace_back(DescriptorInfo::ImageInfoContent{
-				.imageView = shadowMap->GetViewHandle(),
-				.imageSampler = m_ShadowSampler->GetHandle()
-			});
-		}
-		for (const auto& shadowMap : m_SpotShadowMaps)
-		{
-			spotShadowMaps.emplace_back(DescriptorInfo::ImageInfoContent{
-				.imageView = shadowMap->GetViewHandle(),
-				.imageSampler = m_ShadowSampler->GetHandle()
-			});
-		}
-		for (const auto& shadowMap : m_DirShadowMaps)
-		{
-			dirShadowMaps.emplace_back(DescriptorInfo::ImageInfoContent{
-				.imageView = shadowMap->GetViewHandle(),
-				.imageSampler = m_ShadowSampler->GetHandle()
-			});
-		}
+		m_ShadowAtlasResolution = 0U;
 
-		m_ShadowMapsDescriptor = MakeHandle<DescriptorSet>(DescriptorInfo{
-			std::vector<DescriptorInfo::ImageInfo>{
-			DescriptorInfo::ImageInfo {
-					.index = 0U,
-					.count = static_cast<uint32_t>(pointShadowMaps.size()),
+		for (auto& cache : m_ShadowCaches)
+			cache.Invalidate();
+	}
+
+	template<typename PassType>
+	void Renderer::CreatePassAsync(Handle<PassType>& pass, const typename PassType::CreateInfo& info, const char* name, const bool required, JobCounter* pipelines)
+	{
+		if (!required)
+			m_DeferredPipelineCount++;
+
+		JobSystem::Get().Execute([this, &pass, info, name, required]() {
+			EN_PROFILE_SCOPE(name);
+
+			const auto start = std::chrono::steady_clock::now();
+
+			try
+			{
+				pass = MakeHandle<PassType>(info);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
 
-					.contents = pointShadowMaps,
+				if (!m_PipelineError)
+					m_PipelineError = std::current_exception();
 
-					.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-					.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				},
-				DescriptorInfo::ImageInfo {
-					.index = 1U,
-					.count = static_cast<uint32_t>(spotShadowMaps.size()),
+				return;
+			}
 
-					.contents = spotShadowMaps,
+			if (!required) return;
 
-					.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-					.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				},
-				DescriptorInfo::ImageInfo {
-					.index = 2U,
-					.count = static_cast<uint32_t>(dirShadowMaps.size()),
+			const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-					.contents = dirShadowMaps,
+			std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
+			m_PipelineTimings.emplace_back(PipelineTiming{ name, time });
+		}, pipelines ? pipelines : required ? &m_RequiredPipelines : &m_DeferredPipelines);
+	}
+	void Renderer::WaitForPipelines(JobCounter& pipelines)
+	{
+		JobSystem::Get().Wait(pipelines);
 
-					.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-					.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-				},
-			}
-			});
+		std::lock_guard<std::mutex> lock(m_PipelineJobsMutex);
 
+		if (m_PipelineError)
+			std::rethrow_exception(std::exchange(m_PipelineError, nullptr));
 	}
 
-	void Renderer::CreateShadowPasses()
+	void Renderer::CreateShadowPasses(const Settings& settings, Handle<GraphicsPass>& dirPass, Handle<GraphicsPass>& spotPass, Handle<GraphicsPass>& pointPass, JobCounter* pipelines)
 	{
-		constexpr VkPushConstantRange model_lightIndex_cascadeIndex{
+		constexpr VkPushConstantRange lightIndex_cascadeIndex{
 			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
 			.offset = 0U,
-			.size = sizeof(uint32_t) * 3,
+			.size = sizeof(uint32_t) * 2,
 		};
 
 		GraphicsPass::CreateInfo dirInfo{
@@ -1056,9 +2219,9 @@ namespace en
 			//.fShader = "Shaders/ShadowFrag.spv",
 
 			.descriptorLayouts  {Scene::GetLightingDescriptorLayout(), CameraBuffer::GetLayout()},
-			.pushConstantRanges {model_lightIndex_cascadeIndex},
+			.pushConstantRanges {lightIndex_cascadeIndex},
 
-			.depthFormat = m_Settings.shadowsFormat,
+			.depthFormat = settings.shadowsFormat,
 
 			.useVertexBindings = true,
 			.enableDepthTest = true,
@@ -1069,12 +2232,12 @@ namespace en
 			.polygonMode = VK_POLYGON_MODE_FILL,
 		};
 
-		m_DirShadowPass = MakeHandle<GraphicsPass>(dirInfo);
+		CreatePassAsync(dirPass, dirInfo, "Directional Shadow Pass", true, pipelines);
 
-		constexpr VkPushConstantRange model_lightIndex{
+		constexpr VkPushConstantRange lightIndex{
 			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
 			.offset = 0U,
-			.size = sizeof(uint32_t) * 2,
+			.size = sizeof(uint32_t),
 		};
 
 		GraphicsPass::CreateInfo spotInfo{
@@ -1082,9 +2245,9 @@ namespace en
 			//.fShader = "Shaders/ShadowFrag.spv",
 
 			.descriptorLayouts  {Scene::GetLightingDescriptorLayout()},
-			.pushConstantRanges {model_lightIndex},
+			.pushConstantRanges {lightIndex},
 
-			.depthFormat = m_Settings.shadowsFormat,
+			.depthFormat = settings.shadowsFormat,
 
 			.useVertexBindings = true,
 			.enableDepthTest = true,
@@ -1095,23 +2258,23 @@ namespace en
 			.polygonMode = VK_POLYGON_MODE_FILL,
 		};
 
-		m_SpotShadowPass = MakeHandle<GraphicsPass>(spotInfo);
+		CreatePassAsync(spotPass, spotInfo, "Spot Shadow Pass", true, pipelines);
 
-		constexpr VkPushConstantRange model_lightIndex_shadowmapIndex{
+		constexpr VkPushConstantRange lightIndex_shadowmapIndex{
 			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
 			.offset = 0U,
-			.size = sizeof(uint32_t) * 3,
+			.size = sizeof(uint32_t) * 2,
 		};
 
 		GraphicsPass::CreateInfo pointInfo{
-			.vShader = "Shaders/PointShadowVert.spv",
+			.vShader = m_PointShadowMultiview ? "Shaders/PointShadowMultiviewVert.spv" : "Shaders/PointShadowVert.spv",
 			.fShader = "Shaders/ShadowFrag.spv",
 
 			.descriptorLayouts  {Scene::GetLightingDescriptorLayout()},
-			.pushConstantRanges {model_lightIndex_shadowmapIndex},
+			.pushConstantRanges {lightIndex_shadowmapIndex},
 
-			.colorFormat = m_Settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? VK_FORMAT_R32_SFLOAT : VK_FORMAT_R16_SFLOAT,
-			.depthFormat = m_Settings.shadowsFormat,
+			.colorFormat = settings.shadowsFormat == VK_FORMAT_D32_SFLOAT ? VK_FORMAT_R32_SFLOAT : VK_FORMAT_R16_SFLOAT,
+			.depthFormat = settings.shadowsFormat,
 
 			.useVertexBindings = true,
 			.enableDepthTest = true,
@@ -1120,9 +2283,11 @@ namespace en
 
 			.compareOp = VK_COMPARE_OP_LESS,
 			.polygonMode = VK_POLYGON_MODE_FILL,
+
+			.viewMask = m_PointShadowMultiview ? 0b111111U : 0U,
 		};
 
-		m_PointShadowPass = MakeHandle<GraphicsPass>(pointInfo);
+		CreatePassAsync(pointPass, pointInfo, "Point Shadow Pass", true, pipelines);
 	}
 	void Renderer::CreateSSAOPass()
 	{
@@ -1139,24 +2304,17 @@ namespace en
 			.descriptorLayouts {CameraBuffer::GetLayout(), m_DepthBufferDescriptor->GetLayout()},
 			.pushConstantRanges {ao},
 
-			.colorFormat = m_SSAOTarget->m_Format,
+			.colorFormat = SSAO_FORMAT,
 		};
 
-		m_SSAOPass = MakeHandle<GraphicsPass>(info);
+		CreatePassAsync(m_SSAOPass, info, "SSAO Pass", IsAmbientOcclusionEnabled());
 	}
 	void Renderer::CreateDepthPass()
 	{
-		constexpr VkPushConstantRange model{
-			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-			.offset = 0U,
-			.size = sizeof(uint32_t),
-		};
-
 		GraphicsPass::CreateInfo info{
 			.vShader = "Shaders/Depth.spv",
 
 			.descriptorLayouts {CameraBuffer::GetLayout(), Scene::GetGlobalDescriptorLayout()},
-			.pushConstantRanges {model},
 
 			.depthFormat = m_DepthBuffer->m_Format,
 
@@ -1169,53 +2327,14 @@ namespace en
 			.polygonMode = VK_POLYGON_MODE_FILL,
 		};
 
-		m_DepthPass = MakeHandle<GraphicsPass>(info);
+		CreatePassAsync(m_DepthPass, info, "Depth Pass", m_Settings.depthPrePass);
 	}
-	void Renderer::CreateForwardPass()
+	void Renderer::CreateForwardPass(const Settings& settings, Handle<GraphicsPass>& pass, JobCounter* pipelines)
 	{
-		m_ClusterDescriptor = MakeHandle<DescriptorSet>(DescriptorInfo{
-			std::vector<DescriptorInfo::ImageInfo>{},
-			std::vector<DescriptorInfo::BufferInfo>{
-				DescriptorInfo::BufferInfo {
-					.index = 0U,
-					.buffer = m_ClusterSSBOs.pointLightIndices->GetHandle(),
-					.size = m_ClusterSSBOs.pointLightIndices->GetSize(),
-
-					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				},
-				DescriptorInfo::BufferInfo {
-					.index = 1U,
-					.buffer = m_ClusterSSBOs.pointLightGrid->GetHandle(),
-					.size = m_ClusterSSBOs.pointLightGrid->GetSize(),
-
-					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				},
-				DescriptorInfo::BufferInfo {
-					.index = 2U,
-					.buffer = m_ClusterSSBOs.spotLightIndices->GetHandle(),
-					.size = m_ClusterSSBOs.spotLightIndices->GetSize(),
-
-					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				},
-				DescriptorInfo::BufferInfo {
-					.index = 3U,
-					.buffer = m_ClusterSSBOs.spotLightGrid->GetHandle(),
-					.size = m_ClusterSSBOs.spotLightGrid->GetSize(),
-
-					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				},
-			},
-		});
-
-		constexpr VkPushConstantRange model {
-			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-			.offset		= 0U,
-			.size		= sizeof(uint32_t),
-		};
-		constexpr VkPushConstantRange material_postprocessing {
+		constexpr VkPushConstantRange postprocessing {
 			.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-			.offset		= sizeof(uint32_t),
-			.size		= sizeof(uint32_t)+sizeof(float),
+			.offset		= 0U,
+			.size		= sizeof(float),
 		};
 
 		GraphicsPass::CreateInfo info{
@@ -1229,21 +2348,22 @@ namespace en
 				m_ClusterDescriptor->GetLayout(),
 				m_SSAODescriptor->GetLayout(),
 			},
-			.pushConstantRanges {model, material_postprocessing},
+			.pushConstantRanges {postprocessing},
 
-			.colorFormat = m_Settings.antialiasingMode == AntialiasingMode::None ? m_Swapchain->GetFormat() : m_AliasedImage->m_Format,
+			// The antialiasing target has the same format, so the pass doesn't depend on the mode
+			.colorFormat = GetOutputFormat(),
 			.depthFormat = m_DepthBuffer->m_Format,
 
 			.useVertexBindings = true,
 			.enableDepthTest   = true,
-			.enableDepthWrite  = !m_Settings.depthPrePass,
+			.enableDepthWrite  = !settings.depthPrePass,
 			.blendEnable	   = false,
 
-			.compareOp	 = m_Settings.depthPrePass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS,
+			.compareOp	 = settings.depthPrePass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS,
 			.polygonMode = VK_POLYGON_MODE_FILL,
 		};
 
-		m_ForwardPass = MakeHandle<GraphicsPass>(info);
+		CreatePassAsync(pass, info, "Forward Pass", true, pipelines);
 	}
 	void Renderer::CreateAntialiasingPass()
 	{
@@ -1257,13 +2377,14 @@ namespace en
 			.vShader = "Shaders/FullscreenTri.spv",
 			.fShader = "Shaders/FXAA.spv",
 
-			.descriptorLayouts {m_AntialiasingDescriptor->GetLayout()},
+			// The descriptor only exists while the mode isn't None, the layout doesn't depend on the image
+			.descriptorLayouts {DescriptorAllocator::Get().MakeLayout(FullscreenImageInfo(VK_NULL_HANDLE, VK_NULL_HANDLE))},
 			.pushConstantRanges {antialiasing},
 
-			.colorFormat = m_Swapchain->GetFormat(),
+			.colorFormat = GetOutputFormat(),
 		};
 
-		m_AntialiasingPass = MakeHandle<GraphicsPass>(info);
+		CreatePassAsync(m_AntialiasingPass, info, "Antialiasing Pass", m_Settings.antialiasingMode != AntialiasingMode::None);
 	}
 
 	void Renderer::CreateClusterBuffers()
@@ -1311,6 +2432,40 @@ namespace en
 			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 			VMA_MEMORY_USAGE_GPU_ONLY
 		);
+
+		m_ClusterDescriptor = MakeHandle<DescriptorSet>(DescriptorInfo{
+			std::vector<DescriptorInfo::ImageInfo>{},
+			std::vector<DescriptorInfo::BufferInfo>{
+				DescriptorInfo::BufferInfo {
+					.index = 0U,
+					.buffer = m_ClusterSSBOs.pointLightIndices->GetHandle(),
+					.size = m_ClusterSSBOs.pointLightIndices->GetSize(),
+
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				},
+				DescriptorInfo::BufferInfo {
+					.index = 1U,
+					.buffer = m_ClusterSSBOs.pointLightGrid->GetHandle(),
+					.size = m_ClusterSSBOs.pointLightGrid->GetSize(),
+
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				},
+				DescriptorInfo::BufferInfo {
+					.index = 2U,
+					.buffer = m_ClusterSSBOs.spotLightIndices->GetHandle(),
+					.size = m_ClusterSSBOs.spotLightIndices->GetSize(),
+
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				},
+				DescriptorInfo::BufferInfo {
+					.index = 3U,
+					.buffer = m_ClusterSSBOs.spotLightGrid->GetHandle(),
+					.size = m_ClusterSSBOs.spotLightGrid->GetSize(),
+
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				},
+			},
+		});
 	}
 	void Renderer::CreateClusterPasses()
 	{
@@ -1402,7 +2557,7 @@ namespace en
 			.pushConstantRanges = { stvPushConstant },
 		};
 
-		m_ClusterAABBCreationPass = MakeHandle<ComputePass>(aabbInfo);
+		CreatePassAsync(m_ClusterAABBCreationPass, aabbInfo, "Cluster AABB Pass");
 
 		ComputePass::CreateInfo lightCullInfo{
 			.sourcePath = "Shaders/ClusterLightCulling.spv",
@@ -1413,92 +2568,263 @@ namespace en
 			},
 		};
 
-		m_ClusterLightCullingPass = MakeHandle<ComputePass>(lightCullInfo);
+		CreatePassAsync(m_ClusterLightCullingPass, lightCullInfo, "Cluster Light Culling Pass");
 	}
 
-	void Renderer::CreateAATarget()
+	void Renderer::CreateDrawCullingBuffers(const uint32_t capacity)
 	{
-		m_AliasedImage = MakeHandle<Image>(
-			m_Swapchain->GetExtent(),
-			m_Swapchain->GetFormat(),
-			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_IMAGE_ASPECT_COLOR_BIT,
-			0U,
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		m_DrawCulling.capacity = capacity;
+
+		m_DrawCulling.views = MakeHandle<MemoryBuffer>(
+			sizeof(CullingView) * MAX_CULLING_VIEWS,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
 		);
 
-		DescriptorInfo info {
-			std::vector<DescriptorInfo::ImageInfo>{
-				DescriptorInfo::ImageInfo {
-					.contents {{
-						.imageView = m_AliasedImage->GetViewHandle(),
-						.imageSampler = m_FullscreenSampler->GetHandle()
-					}}
-				}
-			},
-			std::vector<DescriptorInfo::BufferInfo>{},
+		m_DrawCulling.commands = MakeHandle<MemoryBuffer>(
+			sizeof(VkDrawIndexedIndirectCommand) * m_DrawCulling.capacity * MAX_CULLING_VIEWS,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+
+		m_DrawCulling.counts = MakeHandle<MemoryBuffer>(
+			sizeof(uint32_t) * MAX_CULLING_VIEWS,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VMA_MEMORY_USAGE_GPU_ONLY
+		);
+
+		DescriptorInfo info{
+			std::vector<DescriptorInfo::ImageInfo>{},
+			std::vector<DescriptorInfo::BufferInfo>{
+				DescriptorInfo::BufferInfo {
+					.index = 0U,
+					.buffer = m_DrawCulling.views->GetHandle(),
+					.size = m_DrawCulling.views->GetSize(),
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+					.stage = VK_SHADER_STAGE_COMPUTE_BIT
+				},
+				DescriptorInfo::BufferInfo {
+					.index = 1U,
+					.buffer = m_DrawCulling.commands->GetHandle(),
+					.size = m_DrawCulling.commands->GetSize(),
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+					.stage = VK_SHADER_STAGE_COMPUTE_BIT
+				},
+				DescriptorInfo::BufferInfo {
+					.index = 2U,
+					.buffer = m_DrawCulling.counts->GetHandle(),
+					.size = m_DrawCulling.counts->GetSize(),
+					.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+					.stage = VK_SHADER_STAGE_COMPUTE_BIT
+				},
+			}
 		};
 
-		if (m_AntialiasingDescriptor)
-			m_AntialiasingDescriptor->Update(info);
+		if (m_DrawCulling.descriptor)
+			m_DrawCulling.descriptor->Update(info);
 		else
-			m_AntialiasingDescriptor = MakeHandle<DescriptorSet>(info);
+			m_DrawCulling.descriptor = MakeHandle<DescriptorSet>(info);
 	}
-	void Renderer::CreateSSAOTarget()
+	void Renderer::CreateDrawCullingPass()
 	{
-		m_SSAOTarget = MakeHandle<Image>(
-			m_Swapchain->GetExtent(),
-			VK_FORMAT_R8_UNORM,
-			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_IMAGE_ASPECT_COLOR_BIT, 
-			0U,
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-		);
+		constexpr VkPushConstantRange drawCount_drawCapacity{
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0U,
+			.size = sizeof(uint32_t) * 2
+		};
 
-		DescriptorInfo info{
-			std::vector<DescriptorInfo::ImageInfo>{
-				DescriptorInfo::ImageInfo {
-					.contents {{
-						.imageView = m_SSAOTarget->GetViewHandle(),
-						.imageSampler = m_FullscreenSampler->GetHandle()
-					}},
-				}
+		ComputePass::CreateInfo info{
+			.sourcePath = "Shaders/DrawCulling.spv",
+			.descriptorLayouts = {
+				Scene::GetDrawsDescriptorLayout(),
+				m_DrawCulling.descriptor->GetLayout()
 			},
-			std::vector<DescriptorInfo::BufferInfo>{},
+			.pushConstantRanges = { drawCount_drawCapacity },
 		};
 
-		if (m_SSAODescriptor)
-			m_SSAODescriptor->Update(info);
-		else
-			m_SSAODescriptor = MakeHandle<DescriptorSet>(info);
+		CreatePassAsync(m_DrawCullingPass, info, "Draw Culling Pass", m_Settings.gpuDrivenRendering);
 	}
-	void Renderer::CreateDepthBuffer()
+
+	void Renderer::CreateOutput()
 	{
-		m_DepthBuffer = MakeHandle<Image>(
-			m_Swapchain->GetExtent(),
-			VK_FORMAT_D32_SFLOAT,
-			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_IMAGE_ASPECT_DEPTH_BIT,
-			0U,
-			VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL
+		if (g_Ctx->IsHeadless())
+		{
+			m_OffscreenTarget = MakeHandle<Image>(
+				m_OffscreenExtent,
+				VK_FORMAT_B8G8R8A8_SRGB,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+				VK_IMAGE_ASPECT_COLOR_BIT,
+				0U,
+				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+			);
+
+			return;
+		}
+
+		m_Swapchain.reset(); // It is critical to reset before creating a new one
+		m_Swapchain = MakeHandle<Swapchain>(m_Settings.vSync);
+	}
+	VkExtent2D Renderer::GetOutputExtent() const
+	{
+		return m_OffscreenTarget ? m_OffscreenTarget->m_Size : m_Swapchain->GetExtent();
+	}
+	VkFormat Renderer::GetOutputFormat() const
+	{
+		return m_OffscreenTarget ? m_OffscreenTarget->m_Format : m_Swapchain->GetFormat();
+	}
+	VkImageView Renderer::GetOutputView() const
+	{
+		return m_OffscreenTarget ? m_OffscreenTarget->GetViewHandle() : m_Swapchain->m_ImageViews[m_Swapchain->m_ImageIndex];
+	}
+
+	void Renderer::CreateRenderGraph()
+	{
+		// The frames in flight still render with the old graph and its images
+		Retire(m_RenderGraph);
+		Retire(m_DepthBufferDescriptor);
+		Retire(m_SSAODescriptor);
+		Retire(m_AntialiasingDescriptor);
+
+		m_RenderGraph = MakeHandle<RenderGraph>();
+
+		RenderGraph& graph = *m_RenderGraph;
+
+		const VkExtent2D extent = GetOutputExtent();
+
+		const RenderGraph::ImageID output = graph.ImportImage("Output", true);
+
+		const RenderGraph::ImageID depthBuffer = graph.CreateImage("Depth Buffer", {
+			.extent = extent,
+			.format = VK_FORMAT_D32_SFLOAT,
+			.usage	= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.aspect = VK_IMAGE_ASPECT_DEPTH_BIT,
+		});
+		const RenderGraph::ImageID ssaoTarget = graph.CreateImage("SSAO Target", {
+			.extent = extent,
+			.format = SSAO_FORMAT,
+			.usage	= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+		});
+		const RenderGraph::ImageID aaTarget = graph.CreateImage("Antialiasing Target", {
+			.extent = extent,
+			.format = GetOutputFormat(),
+			.usage	= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+		});
+
+		// Multiview renders into all the faces at once, so each of them needs its own depth layer
+		const RenderGraph::ImageID pointShadowDepthBuffer = graph.CreateImage("Point Shadow Depth Buffer", {
+			.extent = { m_Settings.pointLightShadowResolution, m_Settings.pointLightShadowResolution },
+			.format = m_Settings.shadowsFormat,
+			.usage	= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+			.aspect = VK_IMAGE_ASPECT_DEPTH_BIT,
+			.layers = m_PointShadowMultiview ? 6U : 1U,
+		});
+
+		const bool pointShadows = m_Scene && !m_Scene->m_ActivePointLightsShadowIDs.empty();
+		const bool antialiasing = m_Settings.antialiasingMode != AntialiasingMode::None;
+
+		// The draw commands, the shadow maps and the light clusters are kept outside of the graph. The scene upload has a submission
+		// of its own, the passes start in the next one.
+		graph.AddPass("Draw Culling",
+			[](RenderGraph::PassBuilder& builder) {
+				builder.SetSideEffects();
+				builder.SetSubmission(EARLY_SUBMISSION);
+			},
+			[this](VkCommandBuffer cmd) { DrawCullingPass(cmd); }
 		);
 
-		DescriptorInfo info{
-			std::vector<DescriptorInfo::ImageInfo>{
-				DescriptorInfo::ImageInfo {
-					.contents {{
-						.imageView = m_DepthBuffer->GetViewHandle(),
-						.imageSampler = m_FullscreenSampler->GetHandle()
-					}}
-				}
+		graph.AddPass("Shadows",
+			[&](RenderGraph::PassBuilder& builder) {
+				builder.SetSideEffects();
+
+				if (pointShadows)
+					builder.Write(pointShadowDepthBuffer, RenderGraph::Access::DepthAttachment);
 			},
-			std::vector<DescriptorInfo::BufferInfo>{},
-		};
+			[this](VkCommandBuffer cmd) { ShadowPass(cmd); }
+		);
 
-		if (m_DepthBufferDescriptor)
-			m_DepthBufferDescriptor->Update(info);
-		else
-			m_DepthBufferDescriptor = MakeHandle<DescriptorSet>(info);
+		// Recorded on the compute queue by Render() when there is one
+		if (!g_Ctx->HasAsyncCompute())
+			graph.AddPass("Cluster Culling",
+				[](RenderGraph::PassBuilder& builder) {
+					builder.SetSideEffects();
+				},
+				[this](VkCommandBuffer cmd) { ClusterComputePass(cmd); }
+			);
+
+		// Both are culled when their results aren't used, the depth prepass is only loaded by the forward pass when it's enabled
+		graph.AddPass("Depth Prepass",
+			[&](RenderGraph::PassBuilder& builder) {
+				builder.Write(depthBuffer, RenderGraph::Access::DepthAttachment);
+			},
+			[this](VkCommandBuffer cmd) { DepthPass(cmd); }
+		);
+
+		graph.AddPass("SSAO",
+			[&](RenderGraph::PassBuilder& builder) {
+				builder.Read(depthBuffer, RenderGraph::Access::FragmentSampled);
+				builder.Write(ssaoTarget, RenderGraph::Access::ColorAttachment);
+			},
+			[this](VkCommandBuffer cmd) { SSAOPass(cmd); }
+		);
+
+		// Waits for the light clusters when they are culled on the compute queue
+		graph.AddPass("Forward",
+			[&](RenderGraph::PassBuilder& builder) {
+				builder.SetSubmission(MAIN_SUBMISSION);
+
+				if (m_Settings.depthPrePass)
+					builder.Read(depthBuffer, RenderGraph::Access::DepthAttachment);
+
+				builder.Write(depthBuffer, RenderGraph::Access::DepthAttachment);
+
+				if (IsAmbientOcclusionEnabled())
+					builder.Read(ssaoTarget, RenderGraph::Access::FragmentSampled);
+
+				builder.Write(antialiasing ? aaTarget : output, RenderGraph::Access::ColorAttachment);
+			},
+			[this](VkCommandBuffer cmd) { ForwardPass(cmd); }
+		);
+
+		if (antialiasing)
+			graph.AddPass("Antialiasing",
+				[&](RenderGraph::PassBuilder& builder) {
+					builder.Read(aaTarget, RenderGraph::Access::FragmentSampled);
+					builder.Write(output, RenderGraph::Access::ColorAttachment);
+				},
+				[this](VkCommandBuffer cmd) { AntialiasingPass(cmd); }
+			);
+
+		graph.Compile();
+
+		m_DepthBuffer			 = graph.GetImage(depthBuffer);
+		m_SSAOTarget			 = graph.GetImage(ssaoTarget);
+		m_AliasedImage			 = graph.GetImage(aaTarget);
+		m_PointShadowDepthBuffer = graph.GetImage(pointShadowDepthBuffer);
+
+		m_DepthBufferDescriptor = MakeHandle<DescriptorSet>(FullscreenImageInfo(m_DepthBuffer->GetViewHandle(), m_FullscreenSampler->GetHandle()));
+
+		if (!m_SSAOTarget && !m_SSAOPlaceholder)
+		{
+			m_SSAOPlaceholder = MakeHandle<Image>(
+				VkExtent2D{ 1U, 1U },
+				SSAO_FORMAT,
+				VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				VK_IMAGE_ASPECT_COLOR_BIT,
+				0U,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+			);
+
+			// SetData() copies four bytes per texel, only the first one ends up in the image
+			uint32_t white = UINT32_MAX;
+			m_SSAOPlaceholder->SetData(&white);
+		}
+
+		m_SSAODescriptor = MakeHandle<DescriptorSet>(FullscreenImageInfo((m_SSAOTarget ? m_SSAOTarget : m_SSAOPlaceholder)->GetViewHandle(), m_FullscreenSampler->GetHandle()));
+
+		if (m_AliasedImage)
+			m_AntialiasingDescriptor = MakeHandle<DescriptorSet>(FullscreenImageInfo(m_AliasedImage->GetViewHandle(), m_FullscreenSampler->GetHandle()));
 	}
 
 	void Renderer::CreatePerFrameData()
@@ -1523,15 +2849,50 @@ namespace en
 			if (vkCreateSemaphore(g_Ctx->m_LogicalDevice, &semaphoreInfo, nullptr, &frame.presentSemaphore) != VK_SUCCESS)
 				EN_ERROR("GraphicsPass::CreatePerFrameData - Failed to create a present semaphore!");
 		
+			frame.commandBuffers.resize(GRAPHICS_SUBMISSIONS);
+
 			VkCommandBufferAllocateInfo allocInfo{
 				.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
 				.commandPool		= g_Ctx->m_GraphicsCommandPool,
 				.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-				.commandBufferCount = 1U
+				.commandBufferCount = GRAPHICS_SUBMISSIONS
 			};
 
-			if (vkAllocateCommandBuffers(g_Ctx->m_LogicalDevice, &allocInfo, &frame.commandBuffer) != VK_SUCCESS)
-				EN_ERROR("Renderer::CreatePerFrameData() - Failed to allocate a command buffer!");
+			if (vkAllocateCommandBuffers(g_Ctx->m_LogicalDevice, &allocInfo, frame.commandBuffers.data()) != VK_SUCCESS)
+				EN_ERROR("Renderer::CreatePerFrameData() - Failed to allocate the command buffers!");
+
+			if (g_Ctx->HasAsyncCompute())
+			{
+				const VkCommandBufferAllocateInfo computeAllocInfo{
+					.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+					.commandPool		= g_Ctx->m_ComputeCommandPool,
+					.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+					.commandBufferCount = 1U
+				};
+
+				if (vkAllocateCommandBuffers(g_Ctx->m_LogicalDevice, &computeAllocInfo, &frame.computeCommandBuffer) != VK_SUCCESS)
+					EN_ERROR("Renderer::CreatePerFrameData() - Failed to allocate a compute command buffer!");
+
+				if (vkCreateSemaphore(g_Ctx->m_LogicalDevice, &semaphoreInfo, nullptr, &frame.uploadSemaphore) != VK_SUCCESS)
+					EN_ERROR("Renderer::CreatePerFrameData() - Failed to create an upload semaphore!");
+
+				if (vkCreateSemaphore(g_Ctx->m_LogicalDevice, &semaphoreInfo, nullptr, &frame.computeSemaphore) != VK_SUCCESS)
+					EN_ERROR("Renderer::CreatePerFrameData() - Failed to create a compute semaphore!");
+			}
+
+			frame.secondaryPools.resize(JobSystem::Get().GetWorkerCount() + 1U);
+
+			for (auto& pool : frame.secondaryPools)
+			{
+				const VkCommandPoolCreateInfo commandPoolInfo{
+					.sType			  = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+					.flags			  = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+					.queueFamilyIndex = g_Ctx->m_QueueFamilies.graphics.value()
+				};
+
+				if (vkCreateCommandPool(g_Ctx->m_LogicalDevice, &commandPoolInfo, nullptr, &pool.commandPool) != VK_SUCCESS)
+					EN_ERROR("Renderer::CreatePerFrameData() - Failed to create a secondary command pool!");
+			}
 		}	
 	}
 	void Renderer::DestroyPerFrameData()
@@ -1542,7 +2903,29 @@ namespace en
 			vkDestroySemaphore(g_Ctx->m_LogicalDevice, frame.mainSemaphore, nullptr);
 			vkDestroySemaphore(g_Ctx->m_LogicalDevice, frame.presentSemaphore, nullptr);
 
-			vkFreeCommandBuffers(g_Ctx->m_LogicalDevice, g_Ctx->m_GraphicsCommandPool, 1U, &frame.commandBuffer);
+			vkFreeCommandBuffers(g_Ctx->m_LogicalDevice, g_Ctx->m_GraphicsCommandPool, GRAPHICS_SUBMISSIONS, frame.commandBuffers.data());
+			frame.commandBuffers.clear();
+
+			// Null without async compute
+			if (frame.computeCommandBuffer)
+				vkFreeCommandBuffers(g_Ctx->m_LogicalDevice, g_Ctx->m_ComputeCommandPool, 1U, &frame.computeCommandBuffer);
+
+			vkDestroySemaphore(g_Ctx->m_LogicalDevice, frame.uploadSemaphore, nullptr);
+			vkDestroySemaphore(g_Ctx->m_LogicalDevice, frame.computeSemaphore, nullptr);
+
+			frame.computeCommandBuffer = VK_NULL_HANDLE;
+			frame.uploadSemaphore	   = VK_NULL_HANDLE;
+			frame.computeSemaphore	   = VK_NULL_HANDLE;
+
+			for (const auto& pool : frame.secondaryPools)
+				vkDestroyCommandPool(g_Ctx->m_LogicalDevice, pool.commandPool, nullptr);
+
+			frame.secondaryPools.clear();
+
+			frame.readbackBuffer.reset();
+			frame.readbackExtent = {};
+
+			frame.retiredObjects.clear();
 		}
 	}
 }
\ No newline at end of file
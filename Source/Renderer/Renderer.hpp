@@ -7,6 +7,8 @@
 
 #include <Common/Helpers.hpp>
 
+#include <Core/JobSystem.hpp>
+
 #include <Scene/Scene.hpp>
 
 #include <Renderer/Window.hpp>
@@ -16,6 +18,7 @@
 #include <Renderer/Passes/ComputePass.hpp>
 
 #include <Renderer/Sampler.hpp>
+#include <Renderer/Buffers/StagingRing.hpp>
 
 #include <Renderer/Lights/PointLight.hpp>
 #include <Renderer/Lights/DirectionalLight.hpp>
@@ -23,12 +26,22 @@
 
 #include <Renderer/Camera/Camera.hpp>
 #include <Renderer/Camera/CameraBuffer.hpp>
+#include <Renderer/Camera/Frustum.hpp>
 
 #include <Renderer/DescriptorSet.hpp>
+#include <Renderer/RenderQueue.hpp>
+#include <Renderer/ShadowAtlas.hpp>
+#include <Renderer/CascadedShadowMaps.hpp>
+#include <Renderer/GPUProfiler.hpp>
+#include <Renderer/RenderGraph.hpp>
 
 #include <Renderer/ImGuiContext.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <functional>
+#include <mutex>
 #include <random>
 
 #include <Renderer/Swapchain.hpp>
@@ -37,6 +50,29 @@ namespace en
 {
 	class Renderer
 	{
+		// Spot light tiles come first in the shadow atlas, followed by the cascades of every directional light
+		static constexpr uint32_t SHADOW_ATLAS_SLOTS = MAX_SPOT_LIGHT_SHADOWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES;
+		static constexpr uint32_t MAX_SHADOW_ATLAS_RESOLUTION = 8192U;
+
+		// Cascade 0 is updated every frame, the next one every second frame and the ones after it every fourth
+		static constexpr std::array<uint32_t, SHADOW_CASCADES> DEFAULT_CASCADE_UPDATE_INTERVALS = [] {
+			std::array<uint32_t, SHADOW_CASCADES> intervals{};
+
+			for (uint32_t i = 0U; i < SHADOW_CASCADES; i++)
+				intervals[i] = 1U << std::min(i, 2U);
+
+			return intervals;
+		}();
+
+		// Every shadow map (and the main camera) gets its own culling view and its own slice of the draw commands buffer.
+		// The atlas tiles get a second one for their static casters, which are rendered into the static shadow cache.
+		static constexpr uint32_t CAMERA_CULLING_VIEW  = 0U;
+		static constexpr uint32_t POINT_CULLING_VIEWS  = CAMERA_CULLING_VIEW + 1U;
+		static constexpr uint32_t SPOT_CULLING_VIEWS   = POINT_CULLING_VIEWS + MAX_POINT_LIGHT_SHADOWS * 6U;
+		static constexpr uint32_t DIR_CULLING_VIEWS	   = SPOT_CULLING_VIEWS + MAX_SPOT_LIGHT_SHADOWS;
+		static constexpr uint32_t STATIC_CULLING_VIEWS = DIR_CULLING_VIEWS + MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES;
+		static constexpr uint32_t MAX_CULLING_VIEWS	   = STATIC_CULLING_VIEWS + SHADOW_ATLAS_SLOTS;
+
 	public:
 		Renderer();
 		~Renderer();
@@ -88,11 +124,26 @@ namespace en
 			float _noiseScale = 2.0f;
 		};
 
+		// Only used in headless mode, where the frames are rendered into an offscreen target of this size instead of the swapchain
+		void SetOffscreenExtent(const VkExtent2D extent);
+		const VkExtent2D GetOffscreenExtent() const { return m_OffscreenExtent; };
+
+		// Copies every frame of the offscreen target back to the CPU, the pixels lag FRAMES_IN_FLIGHT frames behind
+		void SetReadbackEnabled(const bool enabled);
+		const bool GetReadbackEnabled() const { return m_ReadbackEnabled; };
+
+		// Tightly packed BGRA8 (sRGB) pixels of the last frame that was read back
+		const std::vector<uint8_t>& GetReadbackPixels() const { return m_ReadbackPixels; };
+		const VkExtent2D GetReadbackExtent() const { return m_ReadbackExtent; };
+
 		void SetVSyncEnabled(const bool enabled);
-		const bool GetVSyncEnabled() const { return m_Settings.vSync; };
+		const bool GetVSyncEnabled() const { return m_RequestedSettings.vSync; };
 
 		void SetDepthPrepassEnabled(const bool enabled);
-		const bool GetDepthPrepassEnabled() const { return m_Settings.depthPrePass; };
+		const bool GetDepthPrepassEnabled() const { return m_RequestedSettings.depthPrePass; };
+
+		void SetGPUDrivenRenderingEnabled(const bool enabled);
+		const bool GetGPUDrivenRenderingEnabled() const { return m_Settings.gpuDrivenRendering; };
 
 		void SetShadowCascadesWeight(const float weight);
 		const float GetShadowCascadesWeight() const { return m_Settings.cascadeSplitWeight; };
@@ -100,23 +151,35 @@ namespace en
 		void SetShadowCascadesFarPlane(const float farPlane);
 		const float GetShadowCascadesFarPlane() const { return m_Settings.cascadeFarPlane; };
 
+		// In frames, the cascade is sampled with its last matrix and shadow map in between
+		void SetShadowCascadeUpdateInterval(const uint32_t cascade, const uint32_t interval);
+		const uint32_t GetShadowCascadeUpdateInterval(const uint32_t cascade) const { return m_Settings.cascadeUpdateIntervals[cascade]; };
+
 		void SetPointShadowResolution(const uint32_t resolution);
-		const float GetPointShadowResolution() const { return m_Settings.pointLightShadowResolution; };
+		const float GetPointShadowResolution() const { return m_RequestedSettings.pointLightShadowResolution; };
 
 		void SetSpotShadowResolution(const uint32_t resolution);
-		const float GetSpotShadowResolution() const { return m_Settings.spotLightShadowResolution; };
+		const float GetSpotShadowResolution() const { return m_RequestedSettings.spotLightShadowResolution; };
 
 		void SetDirShadowResolution(const uint32_t resolution);
-		const float GetDirShadowResolution() const { return m_Settings.dirLightShadowResolution; };
+		const float GetDirShadowResolution() const { return m_RequestedSettings.dirLightShadowResolution; };
 
 		void SetShadowFormat(const VkFormat format);
-		const VkFormat GetShadowFormat() const { return m_Settings.shadowsFormat; };
+		const VkFormat GetShadowFormat() const { return m_RequestedSettings.shadowsFormat; };
+
+		// In megabytes, shared by the shadow atlas and the point light cube maps
+		void SetShadowMemoryBudget(const uint32_t budget);
+		const uint32_t GetShadowMemoryBudget() const { return m_Settings.shadowMemoryBudget; };
+
+		// Reuses the shadow maps that didn't change, the atlas keeps a second copy with only the static casters for that
+		void SetShadowCachingEnabled(const bool enabled);
+		const bool GetShadowCachingEnabled() const { return m_RequestedSettings.shadowCaching; };
 
 		void SetAntialiasingMode(const AntialiasingMode antialiasingMode);
-		const AntialiasingMode GetAntialiasingMode() const { return m_Settings.antialiasingMode; };
+		const AntialiasingMode GetAntialiasingMode() const { return m_RequestedSettings.antialiasingMode; };
 
 		void SetAmbientOcclusionMode(const AmbientOcclusionMode aoMode);
-		const AmbientOcclusionMode GetAmbientOcclusionMode() const { return m_Settings.ambientOcclusionMode; };
+		const AmbientOcclusionMode GetAmbientOcclusionMode() const { return m_RequestedSettings.ambientOcclusionMode; };
 
 		AntialiasingProperties& GetAntialiasingProperties() { return m_Settings.antialiasing; };
 		AmbientOcclusionProperties& GetAmbientOcclusionProperties() { return m_Settings.ambientOcclusion; };
@@ -127,7 +190,63 @@ namespace en
 		void SetAmbientOcclusionQuality(const QualityLevel quality);
 		const QualityLevel GetAmbientOcclusionQuality() const { return m_Settings.ambientOcclusionQuality; };
 
-		void ReloadBackend();
+		struct CullingStats
+		{
+			uint32_t visibleDraws = 0U;
+			uint32_t culledDraws  = 0U;
+
+			// Summed over all shadow views
+			uint32_t visibleShadowDraws = 0U;
+			uint32_t culledShadowDraws  = 0U;
+
+			uint32_t skippedPointShadowFaces = 0U;
+			uint32_t cachedShadowViews		 = 0U;
+			uint32_t staggeredShadowViews	 = 0U; // Cascades that kept their shadow map because they weren't due
+		};
+
+		// Draw counts stay empty while GPU culling is enabled, skipped faces are counted either way
+		const CullingStats& GetCullingStats() const { return m_CullingStats; };
+
+		struct PipelineCreationStats
+		{
+			// The ones the next frame needs, the rest is created in the background
+			uint32_t pipelines		   = 0U;
+			uint32_t deferredPipelines = 0U;
+
+			// In milliseconds, the creation time is summed over the worker threads
+			float creationTime = 0.0f;
+			float waitTime	   = 0.0f;
+			float backendTime  = 0.0f;
+
+			// Whether the pipeline cache already held pipelines when the backend was created
+			bool warmCache = false;
+		};
+
+		// Of the last backend creation, the first one shows the difference between a cold and a warm pipeline cache on disk
+		const PipelineCreationStats& GetPipelineCreationStats() const { return m_PipelineCreationStats; };
+
+		// Of the render graph the current frames are recorded with
+		const RenderGraph::Stats& GetRenderGraphStats() const { return m_RenderGraph->GetStats(); };
+
+		// Of the previous frame, empty with BARRIER_STATS disabled
+		const BarrierBatch::Stats& GetBarrierStats() const { return m_BarrierStats; };
+
+		// Of the per frame constants, the asset uploads stage through the upload queue instead
+		const StagingRing::Stats& GetStagingStats() const { return m_StagingRing->GetStats(); };
+
+		// Parts of the backend a reload can recreate on their own, whatever depends on a recreated part is recreated along with it
+		static constexpr uint32_t BACKEND_OUTPUT		   = 1U << 0U; // The swapchain or the offscreen target
+		static constexpr uint32_t BACKEND_RENDER_GRAPH	   = 1U << 1U; // The passes of a frame and the transient images they render into
+		static constexpr uint32_t BACKEND_SHADOW_MAPS	   = 1U << 2U; // Only released, UpdateShadowMaps() creates them again
+		static constexpr uint32_t BACKEND_SHADOW_RESOURCES = 1U << 3U;
+		static constexpr uint32_t BACKEND_SHADOW_PASSES	   = 1U << 4U;
+		static constexpr uint32_t BACKEND_FORWARD_PASS	   = 1U << 5U;
+		static constexpr uint32_t BACKEND_AA_PASS		   = 1U << 6U;
+		static constexpr uint32_t BACKEND_ALL			   = UINT32_MAX;
+
+		// The parts are gathered until the end of the frame, everything recreates the whole backend with new per frame data. Reloads
+		// without the output are built in the background while the current parts keep rendering, the rest stops the frame loop.
+		void ReloadBackend(const uint32_t parts = BACKEND_ALL);
 
 		void Update();
 		void PreRender();
@@ -137,6 +256,9 @@ namespace en
 
 		const double GetFrameTime() const { return m_FrameTime; }
 
+		GPUProfiler& GetGPUProfiler() { return *m_GPUProfiler; }
+		const GPUProfiler& GetGPUProfiler() const { return *m_GPUProfiler; }
+
 		int m_DebugMode = 0;
 
 		std::function<void()> m_ImGuiRenderCallback;
@@ -144,7 +266,17 @@ namespace en
 	private:
 		Handle<Scene> m_Scene;
 
+		// Either the swapchain or the offscreen target of the headless mode is created, never both
 		Handle<Swapchain> m_Swapchain;
+		Handle<Image>	  m_OffscreenTarget;
+
+		VkExtent2D m_OffscreenExtent{ 1920U, 1080U };
+
+		bool m_ReadbackEnabled = false;
+
+		std::vector<uint8_t> m_ReadbackPixels;
+		VkExtent2D			 m_ReadbackExtent{};
+
 		Handle<CameraBuffer> m_CameraBuffer;
 
 		Handle<GraphicsPass> m_SSAOPass;
@@ -156,9 +288,14 @@ namespace en
 		Handle<GraphicsPass> m_SpotShadowPass;
 		Handle<GraphicsPass> m_DirShadowPass;
 
+		// All six faces of a point light are rendered in one multiview pass and share the culling view of the first face
+		bool m_PointShadowMultiview = false;
+
 		Handle<ComputePass> m_ClusterAABBCreationPass;
 		Handle<ComputePass> m_ClusterLightCullingPass;
 
+		Handle<ComputePass> m_DrawCullingPass;
+
 		Handle<Sampler> m_ShadowSampler;
 		Handle<Sampler> m_FullscreenSampler;
 
@@ -168,9 +305,39 @@ namespace en
 		Handle<DescriptorSet> m_SSAODescriptor;
 		Handle<DescriptorSet> m_DepthBufferDescriptor;
 
+		// Only created for the slots that are in use, the descriptor gets the empty maps in place of the missing ones
 		std::array<Handle<Image>, MAX_POINT_LIGHT_SHADOWS> m_PointShadowMaps;
-		std::array<Handle<Image>, MAX_SPOT_LIGHT_SHADOWS> m_SpotShadowMaps;
-		std::array<Handle<Image>, MAX_DIR_LIGHT_SHADOWS * SHADOW_CASCADES> m_DirShadowMaps;
+		Handle<Image> m_ShadowAtlas;
+		Handle<Image> m_StaticShadowAtlas;
+
+		Handle<Image> m_EmptyPointShadowMap;
+		Handle<Image> m_EmptyShadowAtlas;
+
+		// A white texel the forward pass samples instead of the SSAO target while there is none
+		Handle<Image> m_SSAOPlaceholder;
+
+		// Tiles of the current frame, the atlas is only recreated when it has to grow (or shrink to fit the budget)
+		ShadowAtlas m_ShadowAtlasLayout{ SHADOW_ATLAS_SLOTS };
+		std::array<glm::vec4, SHADOW_ATLAS_SLOTS> m_ShadowAtlasRects{};
+		uint32_t m_ShadowAtlasResolution = 0U;
+
+		// What every shadow view was last rendered with, indexed by the culling view. Point lights are either reused or fully redrawn,
+		// the atlas tiles are redrawn from the static cache when only dynamic casters moved.
+		struct ShadowCache {
+			glm::mat4 viewProj{};
+
+			bool tracked	 = false; // The view belonged to a shadow caster this frame
+			bool valid		 = false;
+			bool staticValid = false;
+			bool drawn		 = false; // Rendered with viewProj, even if the casters moved since
+
+			void Invalidate() { valid = false; staticValid = false; drawn = false; }
+		};
+
+		std::array<ShadowCache, MAX_CULLING_VIEWS> m_ShadowCaches{};
+
+		// Everything after the scene upload, the images below are its transient ones and only exist while a pass uses them
+		Handle<RenderGraph> m_RenderGraph;
 
 		Handle<Image> m_DepthBuffer;
 		Handle<Image> m_SSAOTarget;
@@ -180,20 +347,33 @@ namespace en
 
 		Handle<ImGuiContext> m_ImGuiContext;
 
+		Scope<GPUProfiler> m_GPUProfiler;
+
+		// A region for every frame in flight, begun once the frame's fence is signaled
+		Scope<StagingRing> m_StagingRing;
+
 		struct Settings {
 			bool vSync = true;
 
 			bool depthPrePass = true;
 
+			bool gpuDrivenRendering = true;
+
 			float cascadeSplitWeight = 0.87f;
 			float cascadeFarPlane = 140.0f;
 
+			std::array<uint32_t, SHADOW_CASCADES> cascadeUpdateIntervals = DEFAULT_CASCADE_UPDATE_INTERVALS;
+
 			uint32_t pointLightShadowResolution = 512U;
 			uint32_t spotLightShadowResolution = 1024U;
 			uint32_t dirLightShadowResolution = 2048U;
 
 			VkFormat shadowsFormat = VK_FORMAT_D32_SFLOAT;
 
+			uint32_t shadowMemoryBudget = 64U;
+
+			bool shadowCaching = true;
+
 			AntialiasingMode antialiasingMode = AntialiasingMode::FXAA;
 			AntialiasingProperties antialiasing{};
 
@@ -202,15 +382,17 @@ namespace en
 			QualityLevel ambientOcclusionQuality = QualityLevel::High;
 		} m_Settings;
 
-		struct CSM {
-			std::array<std::array<glm::mat4, SHADOW_CASCADES>, MAX_DIR_LIGHT_SHADOWS> cascadeMatrices{};
+		// The getters of the settings the backend parts are created with return these, they are only copied into m_Settings
+		// once the affected parts are recreated
+		Settings m_RequestedSettings;
+
+		// Copies the settings the backend parts are created with, the rest is used as soon as it's set
+		static void CopyBackendSettings(Settings& settings, const Settings& from);
 
-			std::array<float, SHADOW_CASCADES> cascadeSplitDistances{};
-			std::array<float, SHADOW_CASCADES> cascadeFrustumSizeRatios{};
+		// SSAO reads the depth of the prepass, so it's off without it too
+		bool IsAmbientOcclusionEnabled() const { return m_Settings.ambientOcclusionMode != AmbientOcclusionMode::None && m_Settings.depthPrePass; }
 
-			std::array<glm::vec3, SHADOW_CASCADES> cascadeCenters{};
-			std::array<float, SHADOW_CASCADES> cascadeRadiuses{};
-		} m_CSM;
+		CascadedShadowMaps m_CSM;
 
 		struct ClusterSSBOs {
 			Handle<MemoryBuffer> aabbClusters;
@@ -227,19 +409,120 @@ namespace en
 			Handle<DescriptorSet> clusterLightCullingDescriptor;
 		} m_ClusterSSBOs;
 
+		struct CullingView {
+			std::array<glm::vec4, 6> planes{};
+
+			uint32_t enabled{};
+			uint32_t drawMask{};
+			uint32_t _padding1{};
+			uint32_t _padding2{};
+		};
+
+		struct DrawCulling {
+			Handle<MemoryBuffer> views;
+			Handle<MemoryBuffer> commands;
+			Handle<MemoryBuffer> counts;
+
+			Handle<DescriptorSet> descriptor;
+
+			// Maximum amount of draw commands per view
+			uint32_t capacity{};
+		} m_DrawCulling;
+
+		// Command pools can't be used from several threads at once, so every thread of the job system records into its own one
+		struct SecondaryCommandPool {
+			VkCommandPool commandPool = VK_NULL_HANDLE;
+
+			std::vector<VkCommandBuffer> commandBuffers;
+			uint32_t usedCount = 0U;
+		};
+
+		// The graphics command buffers of a frame, in the order they are submitted in. With async compute they are submitted
+		// separately, so the cluster culling only waits for the scene upload and only the passes reading its results wait for it.
+		static constexpr uint32_t UPLOAD_SUBMISSION	   = 0U;
+		static constexpr uint32_t EARLY_SUBMISSION	   = 1U; // The passes that don't need the light clusters
+		static constexpr uint32_t MAIN_SUBMISSION	   = 2U; // From the forward pass to the end of the frame
+		static constexpr uint32_t GRAPHICS_SUBMISSIONS = 3U;
+
 		struct Frame {
-			VkCommandBuffer commandBuffer;
+			// One for every submission, the render graph records its passes into them as well
+			std::vector<VkCommandBuffer> commandBuffers;
 			VkFence submitFence;
 
 			VkSemaphore mainSemaphore;
 			VkSemaphore presentSemaphore;
+
+			// Only used with async compute, the cluster culling waits for the scene upload and the main submission for the culling
+			VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE;
+			VkSemaphore		uploadSemaphore		 = VK_NULL_HANDLE;
+			VkSemaphore		computeSemaphore	 = VK_NULL_HANDLE;
+
+			std::vector<SecondaryCommandPool> secondaryPools;
+
+			// The copy of the offscreen target, read back once the frame comes around again. A zero extent means there is none.
+			Handle<MemoryBuffer> readbackBuffer;
+			VkExtent2D			 readbackExtent{};
+
+			// Replaced while the frame was in flight, released once its fence is signaled
+			std::vector<std::shared_ptr<void>> retiredObjects;
 		} m_Frames[FRAMES_IN_FLIGHT];
 	
 		uint32_t m_FrameIndex = 0U;
+
+		std::array<Frustum, MAX_CULLING_VIEWS> m_CullingFrustums{};
+		std::array<bool,	MAX_CULLING_VIEWS> m_CullingViewActive{};
+		std::array<uint32_t, MAX_CULLING_VIEWS> m_CullingViewDrawMask{};
+
+		// Visible draws of every view sorted for the CPU culling path, the depth prepass gets its own front to back order of the camera view
+		std::array<RenderQueue, MAX_CULLING_VIEWS> m_RenderQueues;
+		RenderQueue m_DepthPrepassQueue;
+
+		// Recorded in parallel by RecordSecondaryCommandBuffers() and executed by the passes
+		std::array<VkCommandBuffer, MAX_CULLING_VIEWS> m_ShadowCommandBuffers{};
+		std::vector<VkCommandBuffer> m_DepthCommandBuffers;
+		std::vector<VkCommandBuffer> m_ForwardCommandBuffers;
+
+		CullingStats m_CullingStats{};
+		BarrierBatch::Stats m_BarrierStats{};
+
+		PipelineCreationStats m_PipelineCreationStats{};
+
+		struct PipelineTiming
+		{
+			const char* name = nullptr;
+			float		time = 0.0f;
+		};
+
+		// The passes are created on the worker threads, CreateBackend() only waits for the ones the next frame needs
+		JobCounter m_RequiredPipelines;
+		JobCounter m_DeferredPipelines;
+		uint32_t   m_DeferredPipelineCount = 0U;
+
+		std::mutex					m_PipelineJobsMutex;
+		std::vector<PipelineTiming> m_PipelineTimings;
+		std::exception_ptr			m_PipelineError;
 			
-		bool m_ReloadQueued		  = false;
-		bool m_FramebufferResized = false;
-		bool m_SkipFrame		  = false;
+		uint32_t m_QueuedBackendParts = 0U;
+
+		// Parts of the backend built in the background, switched in at the end of the first frame their pipelines are done
+		struct BackendBuild
+		{
+			uint32_t parts = 0U;
+			Settings settings{};
+
+			Handle<GraphicsPass> forwardPass;
+			Handle<GraphicsPass> dirShadowPass;
+			Handle<GraphicsPass> spotShadowPass;
+			Handle<GraphicsPass> pointShadowPass;
+
+			JobCounter pipelines;
+
+			std::chrono::steady_clock::time_point start;
+		};
+
+		Scope<BackendBuild> m_BackendBuild;
+
+		bool m_SkipFrame = false;
 
 		bool m_ClusterFrustumChanged = false;
 
@@ -250,37 +533,84 @@ namespace en
 
 		void MeasureFrameTime();
 		void BeginRender();
-		void ShadowPass();
-		void ClusterComputePass();
-		void DepthPass();
-		void SSAOPass();
-		void ForwardPass();
-		void AntialiasingPass();
+		void RecordSecondaryCommandBuffers();
+		void DrawCullingPass(VkCommandBuffer cmd);
+		void ShadowPass(VkCommandBuffer cmd);
+		void ClusterComputePass(VkCommandBuffer cmd);
+		void DepthPass(VkCommandBuffer cmd);
+		void SSAOPass(VkCommandBuffer cmd);
+		void ForwardPass(VkCommandBuffer cmd);
+		void AntialiasingPass(VkCommandBuffer cmd);
 		void ImGuiPass();
 		void EndRender();
 
+		void CopyOffscreenTarget();
+		void ReadbackFrame();
+
+		// On the CPU culling path only the sorted draws in [firstDraw, lastDraw) of the queue are drawn
+		void DrawScene(VkCommandBuffer commandBuffer, Handle<GraphicsPass> pass, const uint32_t viewIndex, const RenderQueue& queue, const uint32_t firstDraw = 0U, const uint32_t lastDraw = UINT32_MAX);
+
+		VkCommandBuffer AcquireSecondaryCommandBuffer();
+
+		void AllocateShadowTiles();
+		bool ShadowMapsOutdated() const;
+		void UpdateShadowMaps();
+		DescriptorInfo GetShadowMapsDescriptorInfo() const;
+
 		void UpdateCSM();
 
+		void CullScene();
+		void TrackShadowCache(const uint32_t view, const glm::mat4& viewProj);
+		void ApplyShadowCaches();
+
 		void CreateShadowResources();
+		void ReleaseShadowMaps();
 
-		void CreateShadowPasses();
+		// Only read the given settings, so the passes of a background build can be created next to the ones in use
+		void CreateShadowPasses(const Settings& settings, Handle<GraphicsPass>& dirPass, Handle<GraphicsPass>& spotPass, Handle<GraphicsPass>& pointPass, JobCounter* pipelines = nullptr);
 		void CreateSSAOPass();
 		void CreateDepthPass();
-		void CreateForwardPass();
+		void CreateForwardPass(const Settings& settings, Handle<GraphicsPass>& pass, JobCounter* pipelines = nullptr);
 		void CreateAntialiasingPass();
 
 		void CreateClusterBuffers();
 		void CreateClusterPasses();
 
+		void CreateDrawCullingBuffers(const uint32_t capacity);
+		void CreateDrawCullingPass();
+
+		// The name is used for the profiler zone too, so it has to be a string literal. Background builds count their pipelines separately.
+		template<typename PassType>
+		void CreatePassAsync(Handle<PassType>& pass, const typename PassType::CreateInfo& info, const char* name, const bool required = true, JobCounter* pipelines = nullptr);
+
+		// Rethrows the first error of the finished pipeline jobs
+		void WaitForPipelines(JobCounter& pipelines);
+
 		static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
-		void RecreateFramebuffer();
 		void ReloadBackendImpl();
 
+		void BeginBackendBuild(const uint32_t parts);
+		void SwitchBackend();
+
+		// Keeps the object alive until the frames in flight that could still use it are finished
+		template<typename T>
+		void Retire(Handle<T>& object)
+		{
+			if (object)
+				m_Frames[m_FrameIndex].retiredObjects.emplace_back(std::move(object));
+		}
+
 		void CreateBackend(bool newImGui = true);
 
-		void CreateAATarget();
-		void CreateSSAOTarget();
-		void CreateDepthBuffer();
+		void CreateOutput();
+
+		// The swapchain image that was acquired or the offscreen target
+		VkExtent2D  GetOutputExtent() const;
+		VkFormat	GetOutputFormat() const;
+		VkImageView GetOutputView() const;
+
+		// Adds the passes the settings need, the point shadow depth buffer is only allocated while there are point shadows to render
+		void CreateRenderGraph();
 
 		void CreatePerFrameData();
 		void DestroyPerFrameData();
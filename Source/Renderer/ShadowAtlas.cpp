@@ -0,0 +1,82 @@
+#include "ShadowAtlas.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace en
+{
+	// Every other bit of the Morton code, gives the x (or with the code shifted by one, the y) coordinate
+	uint32_t CompactBits(uint32_t code)
+	{
+		code &= 0x55555555U;
+		code = (code | (code >> 1U)) & 0x33333333U;
+		code = (code | (code >> 2U)) & 0x0F0F0F0FU;
+		code = (code | (code >> 4U)) & 0x00FF00FFU;
+		code = (code | (code >> 8U)) & 0x0000FFFFU;
+
+		return code;
+	}
+
+	ShadowAtlas::ShadowAtlas(uint32_t slotCount) : m_Tiles(slotCount)
+	{
+
+	}
+
+	void ShadowAtlas::Clear()
+	{
+		m_Requests.clear();
+
+		std::fill(m_Tiles.begin(), m_Tiles.end(), Tile{});
+	}
+	void ShadowAtlas::Request(uint32_t slot, uint32_t size, float importance)
+	{
+		m_Requests.emplace_back(TileRequest{ slot, std::bit_ceil(std::max(size, MIN_TILE_SIZE)), importance });
+	}
+	uint32_t ShadowAtlas::Pack(uint32_t maxResolution)
+	{
+		if (m_Requests.empty())
+			return 0U;
+
+		maxResolution = std::max(std::bit_floor(maxResolution), MIN_TILE_SIZE);
+
+		std::stable_sort(m_Requests.begin(), m_Requests.end(), [](const TileRequest& a, const TileRequest& b) { return a.importance > b.importance; });
+
+		// A less important tile never gets bigger than a more important one. With the sizes not increasing every tile starts at a
+		// multiple of its own area in Morton order, so the tiles fill the atlas without gaps and never overlap.
+		const uint64_t capacity = (static_cast<uint64_t>(maxResolution) / MIN_TILE_SIZE) * (maxResolution / MIN_TILE_SIZE);
+
+		uint64_t usedCells = 0U;
+		uint32_t sizeLimit = maxResolution;
+		uint32_t resolution = MIN_TILE_SIZE;
+
+		for (const auto& request : m_Requests)
+		{
+			uint32_t size = std::min(request.size, sizeLimit);
+
+			while (size > MIN_TILE_SIZE && usedCells + (size / MIN_TILE_SIZE) * (size / MIN_TILE_SIZE) > capacity)
+				size /= 2U;
+
+			const uint64_t cells = (size / MIN_TILE_SIZE) * (size / MIN_TILE_SIZE);
+
+			// Even the smallest tile does not fit, which holds for all the remaining requests too
+			if (usedCells + cells > capacity)
+				break;
+
+			const uint32_t cellX = CompactBits(static_cast<uint32_t>(usedCells));
+			const uint32_t cellY = CompactBits(static_cast<uint32_t>(usedCells >> 1U));
+
+			Tile& tile = m_Tiles[request.slot];
+
+			tile.x	  = cellX * MIN_TILE_SIZE;
+			tile.y	  = cellY * MIN_TILE_SIZE;
+			tile.size = size;
+
+			resolution = std::max({ resolution, tile.x + size, tile.y + size });
+
+			usedCells += cells;
+			sizeLimit  = size;
+		}
+
+		return std::bit_ceil(resolution);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#ifndef EN_SHADOWATLAS_HPP
+#define EN_SHADOWATLAS_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace en
+{
+	// Packs square power of two shadow map tiles into a single texture, the most important requests are placed first and
+	// get their full size, the rest is shrunk or dropped once the resolution limit is reached
+	class ShadowAtlas
+	{
+	public:
+		static constexpr uint32_t MIN_TILE_SIZE = 128U;
+
+		struct Tile
+		{
+			uint32_t x	  = 0U;
+			uint32_t y	  = 0U;
+			uint32_t size = 0U; // Zero when the request did not fit
+		};
+
+		ShadowAtlas(uint32_t slotCount);
+
+		void Clear();
+
+		// The size is rounded up to a power of two, a slot can only be requested once per Pack()
+		void Request(uint32_t slot, uint32_t size, float importance);
+
+		// Returns the smallest resolution that holds all the placed tiles, 0 when nothing was requested
+		uint32_t Pack(uint32_t maxResolution);
+
+		const Tile& GetTile(uint32_t slot) const { return m_Tiles[slot]; }
+
+	private:
+		struct TileRequest
+		{
+			uint32_t slot;
+			uint32_t size;
+			float	 importance;
+		};
+
+		std::vector<TileRequest> m_Requests;
+		std::vector<Tile>		 m_Tiles;
+	};
+}
+
+#endif
\ No newline at end of file
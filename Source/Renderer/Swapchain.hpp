@@ -20,7 +20,7 @@ namespace en
 
 		uint32_t m_ImageIndex{};
 
-		void ChangeLayout(uint32_t index, VkImageLayout newLayout, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, VkCommandBuffer cmd = VK_NULL_HANDLE);
+		void ChangeLayout(uint32_t index, VkImageLayout newLayout, VkAccessFlags2 srcAccessMask, VkAccessFlags2 dstAccessMask, VkPipelineStageFlags2 srcStage, VkPipelineStageFlags2 dstStage, VkCommandBuffer cmd = VK_NULL_HANDLE);
 
 		const VkImageLayout const GetLayout(uint32_t i) { return m_CurrentLayouts[i]; };
 		const VkFormat		const GetFormat()			{ return m_ImageFormat;		  };
@@ -0,0 +1,319 @@
+#include "UploadQueue.hpp"
+
+#include <Renderer/Context.hpp>
+#include <Renderer/BarrierBatch.hpp>
+#include <Renderer/Buffers/MemoryBuffer.hpp>
+
+namespace en
+{
+	UploadQueue::UploadQueue() : m_Staging(0U, BATCH_STAGING_SIZE)
+	{
+		UseContext();
+
+		m_SeparateTransfer = ctx.m_QueueFamilies.transfer != ctx.m_QueueFamilies.graphics;
+
+		// Not shared with the frames, the uploads can be recorded from other threads
+		VkCommandPoolCreateInfo commandPoolCreateInfo{
+			.sType			  = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags			  = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+			.queueFamilyIndex = ctx.m_QueueFamilies.transfer.value(),
+		};
+
+		if (vkCreateCommandPool(ctx.m_LogicalDevice, &commandPoolCreateInfo, nullptr, &m_TransferCommandPool) != VK_SUCCESS)
+			EN_ERROR("UploadQueue::UploadQueue() - Failed to create a transfer command pool!");
+
+		m_Semaphore = CreateTimelineSemaphore();
+
+		if (m_SeparateTransfer)
+		{
+			commandPoolCreateInfo.queueFamilyIndex = ctx.m_QueueFamilies.graphics.value();
+
+			if (vkCreateCommandPool(ctx.m_LogicalDevice, &commandPoolCreateInfo, nullptr, &m_GraphicsCommandPool) != VK_SUCCESS)
+				EN_ERROR("UploadQueue::UploadQueue() - Failed to create a graphics command pool!");
+
+			m_TransferSemaphore = CreateTimelineSemaphore();
+		}
+	}
+	UploadQueue::~UploadQueue()
+	{
+		UseContext();
+
+		ctx.WaitIdle();
+
+		// A batch that was never submitted is thrown away together with its pool
+		m_Open = {};
+		m_Submitted.clear();
+		m_FreeBatches.clear();
+
+		vkDestroyCommandPool(ctx.m_LogicalDevice, m_TransferCommandPool, nullptr);
+		vkDestroySemaphore(ctx.m_LogicalDevice, m_Semaphore, nullptr);
+
+		if (m_SeparateTransfer)
+		{
+			vkDestroyCommandPool(ctx.m_LogicalDevice, m_GraphicsCommandPool, nullptr);
+			vkDestroySemaphore(ctx.m_LogicalDevice, m_TransferSemaphore, nullptr);
+		}
+	}
+
+	void UploadQueue::Begin()
+	{
+		m_Mutex.lock();
+
+		if (m_Open.transferCommandBuffer == VK_NULL_HANDLE)
+			OpenBatch();
+	}
+	UploadQueue::Ticket UploadQueue::End()
+	{
+		const Ticket ticket = m_Open.ticket;
+
+		if (m_Staging.GetUsedSize() >= MAX_BATCH_STAGING_SIZE)
+			Submit();
+
+		m_Mutex.unlock();
+
+		return ticket;
+	}
+
+	void UploadQueue::Release(const MemoryBuffer& buffer)
+	{
+		// The batch ends with a memory barrier for everything otherwise, see Submit()
+		if (m_SeparateTransfer)
+			m_Open.releasedBuffers.emplace_back(buffer.GetHandle());
+	}
+	StagingRing::Allocation UploadQueue::Stage(const void* data, const VkDeviceSize size)
+	{
+		return m_Staging.Write(data, size);
+	}
+
+	void UploadQueue::Flush()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (m_Open.transferCommandBuffer != VK_NULL_HANDLE)
+			Submit();
+
+		CollectBatches();
+	}
+
+	bool UploadQueue::IsDone(const Ticket ticket) const
+	{
+		uint64_t value = 0U;
+		vkGetSemaphoreCounterValue(Context::Get().m_LogicalDevice, m_Semaphore, &value);
+
+		return value >= ticket;
+	}
+	void UploadQueue::Wait(const Ticket ticket)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+
+			// The tickets are handed out when a batch is opened, so a newer one can only be from the open batch
+			if (ticket > m_SubmittedTicket)
+				Submit();
+		}
+
+		const VkSemaphoreWaitInfo waitInfo{
+			.sType			= VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.semaphoreCount = 1U,
+			.pSemaphores	= &m_Semaphore,
+			.pValues		= &ticket,
+		};
+
+		vkWaitSemaphores(Context::Get().m_LogicalDevice, &waitInfo, UINT64_MAX);
+	}
+
+	StagingRing::Stats UploadQueue::GetStagingStats()
+	{
+		std::lock_guard lock(m_Mutex);
+
+		return m_Staging.GetStats();
+	}
+
+	VkSemaphore UploadQueue::CreateTimelineSemaphore() const
+	{
+		const VkSemaphoreTypeCreateInfo typeInfo{
+			.sType		   = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+			.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+			.initialValue  = 0U,
+		};
+
+		const VkSemaphoreCreateInfo semaphoreInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			.pNext = &typeInfo,
+		};
+
+		VkSemaphore semaphore = VK_NULL_HANDLE;
+
+		if (vkCreateSemaphore(Context::Get().m_LogicalDevice, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+			EN_ERROR("UploadQueue::CreateTimelineSemaphore() - Failed to create a timeline semaphore!");
+
+		return semaphore;
+	}
+
+	void UploadQueue::OpenBatch()
+	{
+		UseContext();
+
+		CollectBatches();
+
+		if (!m_FreeBatches.empty())
+		{
+			m_Open = std::move(m_FreeBatches.back());
+			m_FreeBatches.pop_back();
+		}
+		else
+		{
+			VkCommandBufferAllocateInfo allocInfo{
+				.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.commandPool		= m_TransferCommandPool,
+				.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				.commandBufferCount = 1U,
+			};
+
+			if (vkAllocateCommandBuffers(ctx.m_LogicalDevice, &allocInfo, &m_Open.transferCommandBuffer) != VK_SUCCESS)
+				EN_ERROR("UploadQueue::OpenBatch() - Failed to allocate a transfer command buffer!");
+
+			if (m_SeparateTransfer)
+			{
+				allocInfo.commandPool = m_GraphicsCommandPool;
+
+				if (vkAllocateCommandBuffers(ctx.m_LogicalDevice, &allocInfo, &m_Open.graphicsCommandBuffer) != VK_SUCCESS)
+					EN_ERROR("UploadQueue::OpenBatch() - Failed to allocate a graphics command buffer!");
+			}
+			else
+				m_Open.graphicsCommandBuffer = m_Open.transferCommandBuffer;
+
+			m_Open.stagingRegion = m_Staging.AddRegion();
+		}
+
+		// The GPU is done with the batch it was recycled from
+		m_Staging.Begin(m_Open.stagingRegion);
+
+		constexpr VkCommandBufferBeginInfo beginInfo{
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+		};
+
+		// Beginning them resets them too
+		vkBeginCommandBuffer(m_Open.transferCommandBuffer, &beginInfo);
+
+		if (m_SeparateTransfer)
+			vkBeginCommandBuffer(m_Open.graphicsCommandBuffer, &beginInfo);
+
+		m_Open.ticket = ++m_LastTicket;
+	}
+	void UploadQueue::Submit()
+	{
+		UseContext();
+
+		BarrierBatch barriers;
+
+		if (m_SeparateTransfer)
+		{
+			const uint32_t transferFamily = ctx.m_QueueFamilies.transfer.value();
+			const uint32_t graphicsFamily = ctx.m_QueueFamilies.graphics.value();
+
+			// The stage and access of the other queue's half are ignored
+			for (const VkBuffer buffer : m_Open.releasedBuffers)
+				barriers.Add(buffer, VK_ACCESS_TRANSFER_WRITE_BIT, 0U, VK_PIPELINE_STAGE_TRANSFER_BIT, 0U, transferFamily, graphicsFamily);
+
+			barriers.Flush(m_Open.transferCommandBuffer);
+
+			for (const VkBuffer buffer : m_Open.releasedBuffers)
+				barriers.Add(buffer, 0U, VK_ACCESS_MEMORY_READ_BIT, 0U, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, transferFamily, graphicsFamily);
+		}
+
+		// Whatever the frames submitted after the batch do with what it wrote, it's visible to them
+		barriers.Add(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_MEMORY_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+		barriers.Flush(m_Open.graphicsCommandBuffer);
+
+		if (vkEndCommandBuffer(m_Open.transferCommandBuffer) != VK_SUCCESS)
+			EN_ERROR("UploadQueue::Submit() - Failed to record a transfer command buffer!");
+
+		if (m_SeparateTransfer && vkEndCommandBuffer(m_Open.graphicsCommandBuffer) != VK_SUCCESS)
+			EN_ERROR("UploadQueue::Submit() - Failed to record a graphics command buffer!");
+
+		m_Staging.Flush();
+
+		const VkCommandBufferSubmitInfo transferCommandBufferInfo{
+			.sType		   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+			.commandBuffer = m_Open.transferCommandBuffer,
+		};
+		const VkSemaphoreSubmitInfo transferSignalInfo{
+			.sType	   = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+			.semaphore = m_SeparateTransfer ? m_TransferSemaphore : m_Semaphore,
+			.value	   = m_Open.ticket,
+			.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+		};
+		const VkSubmitInfo2 transferSubmitInfo{
+			.sType					  = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+			.commandBufferInfoCount	  = 1U,
+			.pCommandBufferInfos	  = &transferCommandBufferInfo,
+			.signalSemaphoreInfoCount = 1U,
+			.pSignalSemaphoreInfos	  = &transferSignalInfo,
+		};
+
+		// The render thread submits to the graphics queue at the same time
+		std::lock_guard<std::mutex> lock(ctx.m_QueueMutex);
+
+		if (vkQueueSubmit2(ctx.m_TransferQueue, 1U, &transferSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+			EN_ERROR("UploadQueue::Submit() - Failed to submit the copies of a batch!");
+
+		if (m_SeparateTransfer)
+		{
+			const VkCommandBufferSubmitInfo graphicsCommandBufferInfo{
+				.sType		   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+				.commandBuffer = m_Open.graphicsCommandBuffer,
+			};
+			const VkSemaphoreSubmitInfo graphicsWaitInfo{
+				.sType	   = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+				.semaphore = m_TransferSemaphore,
+				.value	   = m_Open.ticket,
+				.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+			};
+			const VkSemaphoreSubmitInfo graphicsSignalInfo{
+				.sType	   = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+				.semaphore = m_Semaphore,
+				.value	   = m_Open.ticket,
+				.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+			};
+
+			// The buffers can only be acquired once they were released
+			const VkSubmitInfo2 graphicsSubmitInfo{
+				.sType					  = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+				.waitSemaphoreInfoCount	  = 1U,
+				.pWaitSemaphoreInfos	  = &graphicsWaitInfo,
+				.commandBufferInfoCount	  = 1U,
+				.pCommandBufferInfos	  = &graphicsCommandBufferInfo,
+				.signalSemaphoreInfoCount = 1U,
+				.pSignalSemaphoreInfos	  = &graphicsSignalInfo,
+			};
+
+			if (vkQueueSubmit2(ctx.m_GraphicsQueue, 1U, &graphicsSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+				EN_ERROR("UploadQueue::Submit() - Failed to submit the graphics commands of a batch!");
+		}
+
+		m_SubmittedTicket = m_Open.ticket;
+
+		m_Submitted.emplace_back(std::move(m_Open));
+		m_Open = {};
+	}
+	void UploadQueue::CollectBatches()
+	{
+		uint64_t completed = 0U;
+		vkGetSemaphoreCounterValue(Context::Get().m_LogicalDevice, m_Semaphore, &completed);
+
+		// Submitted and signaled in order
+		size_t count = 0U;
+		for (; count < m_Submitted.size() && m_Submitted[count].ticket <= completed; count++)
+		{
+			Batch& batch = m_Submitted[count];
+
+			batch.releasedBuffers.clear();
+
+			m_FreeBatches.emplace_back(std::move(batch));
+		}
+
+		m_Submitted.erase(m_Submitted.begin(), m_Submitted.begin() + count);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef EN_UPLOADQUEUE_HPP
+#define EN_UPLOADQUEUE_HPP
+
+#include <Core/Types.hpp>
+#include <Renderer/Buffers/StagingRing.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <mutex>
+#include <vector>
+
+namespace en
+{
+	class MemoryBuffer;
+
+	// Collects the uploads of the assets into batches instead of submitting every copy on its own and waiting for the queue to
+	// go idle. The copies into buffers run on the transfer queue, everything that needs the graphics queue (layout transitions,
+	// mipmap blits and acquiring the buffers) runs on the graphics queue afterwards, which waits for the copies through a
+	// timeline semaphore. Without a transfer queue of its own both go into the same command buffer.
+	class UploadQueue
+	{
+	public:
+		// The value the timeline semaphore reaches once the batch is done, 0 is always done
+		using Ticket = uint64_t;
+
+		UploadQueue();
+		~UploadQueue();
+
+		UploadQueue(const UploadQueue&) = delete;
+		UploadQueue& operator=(const UploadQueue&) = delete;
+
+		// Everything recorded in between goes into the open batch, the other threads wait in Begin() until End() is called
+		void Begin();
+		Ticket End();
+
+		// Only valid between Begin() and End()
+		VkCommandBuffer GetTransferCommandBuffer() const { return m_Open.transferCommandBuffer; };
+		VkCommandBuffer GetGraphicsCommandBuffer() const { return m_Open.graphicsCommandBuffer; };
+
+		// Hands a buffer written in the transfer command buffer over to the graphics queue once the copies are done. Whatever it
+		// held before the batch is lost when the queue families differ.
+		void Release(const MemoryBuffer& buffer);
+
+		// Only valid between Begin() and End(), the memory is reused once the batch is done
+		StagingRing::Allocation Stage(const void* data, const VkDeviceSize size);
+
+		// Submits the open batch if anything was recorded into it. The graphics queue is submitted to as well, so it has to be
+		// called from the thread that submits the frames. The renderer flushes before every frame.
+		void Flush();
+
+		// Doesn't block, so it can be polled from any thread
+		bool IsDone(const Ticket ticket) const;
+
+		// Flushes the open batch first when the ticket is from it
+		void Wait(const Ticket ticket);
+
+		// Every batch stages into a region of its own
+		StagingRing::Stats GetStagingStats();
+
+	private:
+		// End() submits the batch early when its staging memory takes more than this, so loading a lot at once between two
+		// frames doesn't hold on to all of it
+		static constexpr VkDeviceSize MAX_BATCH_STAGING_SIZE = 64U * 1024U * 1024U;
+
+		// Of the staging region of a new batch, it grows when the batch needs more
+		static constexpr VkDeviceSize BATCH_STAGING_SIZE = 4U * 1024U * 1024U;
+
+		struct Batch
+		{
+			// The same command buffer without a transfer queue of its own
+			VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+			VkCommandBuffer graphicsCommandBuffer = VK_NULL_HANDLE;
+
+			Ticket ticket = 0U;
+
+			std::vector<VkBuffer> releasedBuffers;
+
+			// Kept by the batch when it's recycled, so is the memory it grew to
+			uint32_t stagingRegion = 0U;
+		};
+
+		// Separate families need ownership transfers and two submissions per batch
+		bool m_SeparateTransfer = false;
+
+		VkCommandPool m_TransferCommandPool = VK_NULL_HANDLE;
+		VkCommandPool m_GraphicsCommandPool = VK_NULL_HANDLE;
+
+		// Signaled with the ticket of every batch, by the transfer queue once its copies are done and by the queue of its last
+		// submission once the whole batch is
+		VkSemaphore m_TransferSemaphore = VK_NULL_HANDLE;
+		VkSemaphore m_Semaphore			= VK_NULL_HANDLE;
+
+		Ticket m_LastTicket		 = 0U;
+		Ticket m_SubmittedTicket = 0U;
+
+		// Its command buffers are null until something is recorded
+		Batch			   m_Open{};
+		std::vector<Batch> m_Submitted;
+		std::vector<Batch> m_FreeBatches;
+
+		StagingRing m_Staging;
+
+		std::mutex m_Mutex;
+
+		VkSemaphore CreateTimelineSemaphore() const;
+
+		// All of them expect the mutex to be locked
+		void OpenBatch();
+		void Submit();
+
+		// Recycles the batches the GPU is done with
+		void CollectBatches();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef EN_VULKANTYPES_HPP
+#define EN_VULKANTYPES_HPP
+
+// For the Vulkan-free code that still stores a few plain Vulkan types, e.g. DescriptorInfo. CMakeLists.txt builds it without the
+// Vulkan SDK, then only the types and values it uses are declared here, the same as in vulkan_core.h so the hashes don't change.
+#if __has_include(<vulkan/vulkan.h>)
+#include <vulkan/vulkan.h>
+#else
+#include <cstdint>
+
+#define VK_NULL_HANDLE nullptr
+
+typedef uint32_t VkFlags;
+typedef uint64_t VkDeviceSize;
+
+typedef struct VkBuffer_T*				VkBuffer;
+typedef struct VkImageView_T*			VkImageView;
+typedef struct VkSampler_T*				VkSampler;
+typedef struct VkDescriptorSetLayout_T* VkDescriptorSetLayout;
+
+typedef enum VkDescriptorType {
+	VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER = 1,
+	VK_DESCRIPTOR_TYPE_STORAGE_IMAGE		  = 3,
+	VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER		  = 6,
+	VK_DESCRIPTOR_TYPE_STORAGE_BUFFER		  = 7,
+} VkDescriptorType;
+
+typedef enum VkImageLayout {
+	VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL = 5,
+} VkImageLayout;
+
+typedef enum VkShaderStageFlagBits {
+	VK_SHADER_STAGE_VERTEX_BIT	 = 0x00000001,
+	VK_SHADER_STAGE_FRAGMENT_BIT = 0x00000010,
+	VK_SHADER_STAGE_COMPUTE_BIT	 = 0x00000020,
+} VkShaderStageFlagBits;
+
+typedef VkFlags VkShaderStageFlags;
+typedef VkFlags VkDescriptorSetLayoutCreateFlags;
+typedef VkFlags VkDescriptorBindingFlags;
+#endif
+
+#endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Scene.hpp"
 
+#include <Core/Profiler.hpp>
+
 namespace en
 {
     constexpr float MATRICES_UPDATE_THRESHOLD  = 0.25f;
@@ -9,54 +11,75 @@ namespace en
     constexpr float SPOT_LIGHTS_UPDATE_THRESHOLD  = 0.25f;
     constexpr float DIR_LIGHTS_UPDATE_THRESHOLD   = 0.25f;
 
+    constexpr float DRAWS_UPDATE_THRESHOLD = 0.25f;
+
     constexpr float MATRICES_OVERFLOW_MULTIPLIER = 1.2f;
     constexpr float MATERIALS_OVERFLOW_MULTIPLIER = 1.2f;
+    constexpr float DRAWS_OVERFLOW_MULTIPLIER = 1.2f;
+    constexpr float GEOMETRY_OVERFLOW_MULTIPLIER = 1.5f;
 
     Scene::Scene()
     {
-        m_SceneObjects     .reserve(64);
-        m_PointLights      .reserve(64);
-        m_SpotLights       .reserve(64);
-        m_DirectionalLights.reserve(64);
-
-        m_Matrices    .resize(64);
-        m_Textures    .resize(64);
-        m_Materials   .resize(64);
-        m_GPUMaterials.resize(64);
+        m_Textures.resize(64);
 
         m_GlobalMatricesBuffer = MakeHandle<MemoryBuffer>(
             256U * sizeof(glm::mat4),
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
            VMA_MEMORY_USAGE_GPU_ONLY
         );
-        m_GlobalMatricesStagingBuffer = MakeHandle<MemoryBuffer>(
-            m_GlobalMatricesBuffer->GetSize(),
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU
-        );
 
         m_GlobalMaterialsBuffer = MakeHandle<MemoryBuffer>(
             256U * sizeof(GPUMaterial),
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY
         );
-        m_GlobalMaterialsStagingBuffer = MakeHandle<MemoryBuffer>(
-            m_GlobalMaterialsBuffer->GetSize(),
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU
-        );
 
+        // The light clusters are culled on the compute queue
         m_LightsBuffer = MakeHandle<MemoryBuffer>(
             sizeof(GPULights),
             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            true
+        );
+
+        m_DrawsBuffer = MakeHandle<MemoryBuffer>(
+            256U * sizeof(GPUDraw),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY
+        );
+
+        // Copied from when they grow
+        m_GeometryVertexBuffer = MakeHandle<MemoryBuffer>(
+            sizeof(Vertex),
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY
         );
-        m_LightsStagingBuffer = MakeHandle<MemoryBuffer>(
-            m_LightsBuffer->GetSize(),
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU  
+        m_GeometryIndexBuffer = MakeHandle<MemoryBuffer>(
+            sizeof(uint32_t),
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY
         );
 
+        m_DrawsDescriptorSet = MakeHandle<DescriptorSet>(DescriptorInfo{
+            std::vector<DescriptorInfo::ImageInfo>{},
+            std::vector<DescriptorInfo::BufferInfo>{
+                DescriptorInfo::BufferInfo {
+                    .index = 0U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size = m_DrawsBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
+                DescriptorInfo::BufferInfo {
+                    .index = 1U,
+                    .buffer = m_GlobalMatricesBuffer->GetHandle(),
+                    .size = m_GlobalMatricesBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
+            }
+        });
+
         m_LightingDescriptorSet = MakeHandle<DescriptorSet>(DescriptorInfo{
             std::vector<DescriptorInfo::ImageInfo>{},
             std::vector<DescriptorInfo::BufferInfo>{
@@ -73,6 +96,13 @@ namespace en
                     .size = m_LightsBuffer->GetSize(),
                     .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                },
+                DescriptorInfo::BufferInfo {
+                    .index = 2U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size = m_DrawsBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
                 }
             },
         });
@@ -133,494 +163,63 @@ namespace en
                     .type   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage  = VK_SHADER_STAGE_FRAGMENT_BIT,
                 },
+                DescriptorInfo::BufferInfo {
+                    .index  = 4U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size   = m_DrawsBuffer->GetSize(),
+                    .type   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage  = VK_SHADER_STAGE_VERTEX_BIT,
+                },
             },
         });
-        
-        m_MainCamera = MakeHandle<Camera>();
     }
-    
-    Handle<SceneObject> Scene::CreateSceneObject(const std::string& name, Handle<Mesh> mesh)
-    {
-        std::string finalName = name;
-
-        if (m_SceneObjects.contains(finalName))
-        {
-            EN_WARN("Scene::CreateSceneObject() - Failed to create a SceneObject because a SceneObject called \"" + name + "\" already exists!");
-            return nullptr;
-        }
 
-        m_SceneObjects[finalName] = MakeHandle<SceneObject>(mesh, finalName);
-        
-        auto& newSceneObject = m_SceneObjects.at(finalName);
-
-        newSceneObject->m_MatrixIndex = RegisterMatrix();
-        for (auto& subMesh : newSceneObject->m_Mesh->m_SubMeshes)
-            subMesh.m_MaterialIndex = RegisterMaterial(subMesh.m_Material);
-
-        EN_LOG("Created a SceneObject called \"" + finalName + "\"");
-
-        return m_SceneObjects.at(finalName);
-    }
-    void Scene::DeleteSceneObject(const std::string& name)
-    {
-        if (!m_SceneObjects.contains(name))
-        {
-            EN_WARN("Scene::DeleteSceneObject() - Failed to delete a SceneObject because a SceneObject called \"" + name + "\" doesn't exist!");
-            return;
-        }
-
-        EN_LOG("Deleted a SceneObject called \"" + name + "\"");
-
-        DeregisterMatrix(m_SceneObjects.at(name)->GetMatrixIndex());
-        m_SceneObjects.erase(name);
-    }
-
-    Handle<SceneObject> Scene::GetSceneObject(const std::string& name)
-    {
-        if (!m_SceneObjects.contains(name))
-        {
-            EN_WARN("Scene::GetSceneObject() - Failed to find a SceneObject named " + name + "!");
-
-            return nullptr;
-        }
-
-        return m_SceneObjects.at(name);
-    }
-    /*
-    void Scene::RenameSceneObject(const std::string& oldName, const std::string& newName)
-    {
-        if (m_SceneObjects.contains(newName))
-            EN_WARN("Failed to rename " + oldName + " because a SceneObject with a name " + newName + " already exists!")
-        else
-        {
-            if (m_SceneObjects.contains(oldName))
-            {
-                m_SceneObjects[newName].swap(m_SceneObjects.at(oldName));
-                m_SceneObjects.at(newName)->m_Name = newName;
-                m_SceneObjects.erase(oldName);
-            }
-            else
-                EN_WARN("Failed to rename " + oldName + " because a SceneObject with that name doesn't exist!")
-        }
-    }
-    */
-    PointLight* Scene::CreatePointLight(const glm::vec3 position, const glm::vec3 color, const float intensity, const float radius, const bool active)
-    {
-        if (m_PointLights.size() + 1 >= MAX_POINT_LIGHTS)
-        {
-            EN_WARN("Failed to create a new PointLight because you've reached the MAX_POINT_LIGHTS limit (" + std::to_string(MAX_POINT_LIGHTS) + ")!")
-            return nullptr;
-        }
-
-        m_PointLights.emplace_back(position, color, intensity, radius, active);
-
-        return &m_PointLights.at(m_PointLights.size()-1);
-    }
-    void Scene::DeletePointLight(const uint32_t index)
-    {
-        m_PointLights.erase(m_PointLights.begin() + index);
-    }
-
-    SpotLight* Scene::CreateSpotLight(const glm::vec3 position, const glm::vec3 direction, const glm::vec3 color, const float innerCutoff, const float outerCutoff, const float range, const float intensity, const bool active)
-    {
-        if (m_SpotLights.size() + 1 >= MAX_SPOT_LIGHTS)
-        {
-            EN_WARN("Failed to create a new SpotLight because you've reached the MAX_SPOT_LIGHTS limit (" + std::to_string(MAX_SPOT_LIGHTS) + ")!")
-            return nullptr;
-        }
-
-        m_SpotLights.emplace_back(position, direction, color, innerCutoff, outerCutoff, range, intensity, active);
-
-        return &m_SpotLights.at(m_SpotLights.size()-1);
-    }
-    void Scene::DeleteSpotLight(const uint32_t index)
-    {
-        m_SpotLights.erase(m_SpotLights.begin() + index);
-    }
-
-    DirectionalLight* Scene::CreateDirectionalLight(const glm::vec3 direction, const glm::vec3 color, const float intensity, const bool active)
+    void Scene::UpdateSceneCPU()
     {
-        if (m_DirectionalLights.size() + 1 >= MAX_DIR_LIGHTS)
-        {
-            EN_WARN("Failed to create a new DirectionalLight because you've reached the MAX_DIR_LIGHTS limit (" + std::to_string(MAX_DIR_LIGHTS) + ")!")
-            return nullptr;
-        }
-
-        m_DirectionalLights.emplace_back(direction, color, intensity, active);
+        SceneState::UpdateSceneCPU();
 
-        return &m_DirectionalLights.back();
-    }
-    void Scene::DeleteDirectionalLight(const uint32_t index)
-    {
-        m_DirectionalLights.erase(m_DirectionalLights.begin() + index);
+        // The draws buffer is going to be recreated
+        if (sizeof(GPUDraw) * m_Draws.size() > m_DrawsBuffer->GetSize())
+            m_GlobalDescriptorChanged = true;
     }
-
-    void Scene::UpdateSceneCPU()
+    
+    void Scene::UpdateSceneGPU(const VkCommandBuffer cmd, StagingRing& staging)
     {
-        m_ActivePointLightsShadowIDs.clear();
-        m_ActiveSpotLightsShadowIDs.clear();
-        m_ActiveDirLightsShadowIDs.clear();
-
-        m_ChangedMatrixIDs.clear();
-        m_ChangedMaterialIDs.clear();
-
-        for (auto& [name, sceneObject] : m_SceneObjects)
-        {
-            for (auto& subMesh : sceneObject->m_Mesh->m_SubMeshes)
-            {
-                if (subMesh.m_MaterialChanged)
-                {
-                    if (m_RegisteredMaterials.contains(subMesh.m_Material->m_Name))
-                        subMesh.m_MaterialIndex = m_RegisteredMaterials.at(subMesh.m_Material->m_Name);
-                    else
-                        subMesh.m_MaterialIndex = RegisterMaterial(subMesh.m_Material);
-
-                    subMesh.m_MaterialChanged = false;
-                }  
-            }
-
-            if (sceneObject->m_TransformChanged)
-            {
-                glm::mat4 newMatrix = glm::translate(glm::mat4(1.0f), sceneObject->m_Position);
-                uint32_t changedMatrixId = sceneObject->m_MatrixIndex;
-
-                if (sceneObject->m_Rotation != glm::vec3(0.0f))
-                {
-                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.y), glm::vec3(0, 1, 0));
-                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.z), glm::vec3(0, 0, 1));
-                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.x), glm::vec3(1, 0, 0));
-                }
-
-                newMatrix = glm::scale(newMatrix, sceneObject->m_Scale);
-
-                m_Matrices[changedMatrixId] = newMatrix;
-
-                m_ChangedMatrixIDs.push_back(changedMatrixId);
-                sceneObject->m_TransformChanged = false;
-            }
-        }
-
-        for (const auto& i : m_OccupiedMaterials)
-        {
-            auto& cpuMat = m_Materials[i];
-            auto& gpuMat = m_GPUMaterials[i];
-
-            if (cpuMat->m_Changed)
-            {
-                gpuMat.color = cpuMat->m_Color;
-
-                const std::string& albedoName = cpuMat->GetAlbedoTexture()->GetName();
-                const std::string& roughnessName = cpuMat->GetRoughnessTexture()->GetName();
-                const std::string& metalnessName = cpuMat->GetMetalnessTexture()->GetName();
-                const std::string& normalName = cpuMat->GetNormalTexture()->GetName();
-                const std::string& defaultSRGBName = AssetManager::Get().GetWhiteSRGBTexture()->GetName();
-                const std::string& defaultNonSRGBName = AssetManager::Get().GetWhiteNonSRGBTexture()->GetName();
-
-                gpuMat.metalnessVal = metalnessName == defaultNonSRGBName ? cpuMat->GetMetalness() : 1.0f;
-                gpuMat.roughnessVal = roughnessName == defaultNonSRGBName ? cpuMat->GetRoughness() : 1.0f;
-                gpuMat.normalStrength = normalName != defaultNonSRGBName ? cpuMat->GetNormalStrength() : 0.0f;
-
-                if (!m_RegisteredTextures.contains(albedoName))
-                    RegisterTexture(cpuMat->GetAlbedoTexture());
-                if (!m_RegisteredTextures.contains(roughnessName))
-                    RegisterTexture(cpuMat->GetRoughnessTexture());
-                if (!m_RegisteredTextures.contains(metalnessName))
-                    RegisterTexture(cpuMat->GetMetalnessTexture());
-                if (!m_RegisteredTextures.contains(normalName))
-                    RegisterTexture(cpuMat->GetNormalTexture());
-
-                cpuMat->m_AlbedoIndex = m_RegisteredTextures.at(albedoName);
-                cpuMat->m_RoughnessIndex = m_RegisteredTextures.at(roughnessName);
-                cpuMat->m_MetalnessIndex = m_RegisteredTextures.at(metalnessName);
-                cpuMat->m_NormalIndex = m_RegisteredTextures.at(normalName);
-
-                gpuMat.albedoId = cpuMat->GetAlbedoIndex();
-                gpuMat.roughnessId = cpuMat->GetRoughnessIndex();
-                gpuMat.metalnessId = cpuMat->GetMetalnessIndex();
-                gpuMat.normalId = cpuMat->GetNormalIndex();
-
-                m_ChangedMaterialIDs.push_back(i);
-                cpuMat->m_Changed = false;
-            }
-        }
-
-        m_SceneLightingChanged = false;
-        m_ChangedPointLightsIDs.clear();
-        m_ChangedSpotLightsIDs .clear();
-        m_ChangedDirLightsIDs  .clear();
-
-        uint32_t oldActivePointLights = m_GPULights.activePointLights;
-        uint32_t oldActiveSpotLights  = m_GPULights.activeSpotLights;
-        uint32_t oldActiveDirLights   = m_GPULights.activeDirLights;
-
-        m_GPULights.activePointLights = 0U;
-        m_GPULights.activeSpotLights  = 0U;
-        m_GPULights.activeDirLights   = 0U;
-
-        if (m_GPULights.ambientLight != m_AmbientColor)
-        {
-            m_GPULights.ambientLight = m_AmbientColor;
-            m_SceneLightingChanged = true;
-        }
-
-        for (auto& l : m_PointLights)
-            l.m_ShadowmapIndex = -1;
-        for (auto& l : m_SpotLights)
-            l.m_ShadowmapIndex = -1;
-        for (auto& l : m_DirectionalLights)
-            l.m_ShadowmapIndex = -1;
-
-        uint32_t pointShadowCasters = 0U;
-        uint32_t spotShadowCasters = 0U;
-        uint32_t dirShadowCasters = 0U;
-
-        for (uint32_t i = 0U; auto& light : m_PointLights)
-        {
-            PointLight::Buffer& buffer = m_GPULights.pointLights[m_GPULights.activePointLights];
-
-            glm::vec3 lightCol = light.m_Color * (float)light.m_Active * light.m_Intensity;
-            float     lightRad = light.m_Radius * (float)light.m_Active;
-
-            i++;
-
-            if (lightCol == glm::vec3(0.0) || lightRad <= 0.0f)
-                continue;
-
-            if (pointShadowCasters < MAX_POINT_LIGHT_SHADOWS && light.m_CastShadows)
-            {
-                light.m_ShadowmapIndex = pointShadowCasters++;
-                m_ActivePointLightsShadowIDs.push_back(i - 1);
-            }
-
-
-            if (buffer.position != light.m_Position ||
-                buffer.color != lightCol ||
-                buffer.radius != lightRad ||
-                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
-                buffer.shadowSoftness != light.m_ShadowSoftness ||
-                buffer.pcfSampleRate != light.m_PCFSampleRate ||
-                buffer.bias != light.m_ShadowBias
-            ) {
-                m_ChangedPointLightsIDs.push_back(m_GPULights.activePointLights);
-
-                buffer.position = light.m_Position;
-                buffer.color = lightCol;
-                buffer.radius = lightRad;
-                buffer.shadowmapIndex = light.m_ShadowmapIndex;
-                buffer.shadowSoftness = light.m_ShadowSoftness;
-                buffer.pcfSampleRate = light.m_PCFSampleRate;
-                buffer.bias = light.m_ShadowBias;
-
-                if (light.m_ShadowmapIndex != -1)
-                {
-                    const glm::mat4 proj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, light.m_Radius);
-
-                    buffer.viewProj[0] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 1.0,  0.0,  0.0), glm::vec3(0.0, -1.0,  0.0));
-                    buffer.viewProj[1] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3(-1.0,  0.0,  0.0), glm::vec3(0.0, -1.0,  0.0));
-                    buffer.viewProj[2] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  1.0,  0.0), glm::vec3(0.0,  0.0,  1.0));
-                    buffer.viewProj[3] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0, -1.0,  0.0), glm::vec3(0.0,  0.0, -1.0));
-                    buffer.viewProj[4] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  0.0,  1.0), glm::vec3(0.0, -1.0,  0.0));
-                    buffer.viewProj[5] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  0.0, -1.0), glm::vec3(0.0, -1.0,  0.0)); 
-                }
-            }
-
-            m_GPULights.activePointLights++;
-        }
-        for (uint32_t i = 0U; auto& light : m_SpotLights)
-        {
-            SpotLight::Buffer& buffer = m_GPULights.spotLights[m_GPULights.activeSpotLights];
+        EN_PROFILE_FUNCTION();
 
-            glm::vec3 lightColor = light.m_Color * (float)light.m_Active * light.m_Intensity;
+        const bool matricesChanged  = !m_Matrices.empty() && (!m_ChangedMatrixIDs.empty() || sizeof(glm::mat4) * m_Matrices.size() > m_GlobalMatricesBuffer->GetSize());
+        const bool materialsChanged = !m_Materials.empty() && (!m_ChangedMaterialIDs.empty() || sizeof(GPUMaterial) * m_Materials.size() > m_GlobalMaterialsBuffer->GetSize());
+        const bool lightsChanged    = !m_ChangedPointLightsIDs.empty() || !m_ChangedSpotLightsIDs.empty() || !m_ChangedDirLightsIDs.empty() || m_SceneLightingChanged;
+        const bool drawsChanged     = !m_ChangedDrawIDs.empty() && !m_Draws.empty();
 
-            i++;
+        BarrierBatch barriers;
 
-            if (light.m_Range == 0.0f || lightColor == glm::vec3(0.0) || light.m_OuterCutoff == 0.0f)
-                continue;
-
-            if (spotShadowCasters < MAX_SPOT_LIGHT_SHADOWS && light.m_CastShadows)
-            {
-                light.m_ShadowmapIndex = spotShadowCasters++;
-                m_ActiveSpotLightsShadowIDs.push_back(i - 1);
-            }
-
-            if (buffer.color != lightColor ||
-                buffer.range != light.m_Range ||
-                buffer.outerCutoff != light.m_OuterCutoff ||
-                buffer.position != light.m_Position ||
-                buffer.innerCutoff != light.m_InnerCutoff ||
-                buffer.direction != -glm::normalize(light.m_Direction) ||
-                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
-                buffer.shadowSoftness != light.m_ShadowSoftness ||
-                buffer.pcfSampleRate != light.m_PCFSampleRate ||
-                buffer.bias != light.m_ShadowBias
-            ) {
-                m_ChangedSpotLightsIDs.push_back(m_GPULights.activeSpotLights);
-
-                buffer.color          = lightColor;
-                buffer.range          = light.m_Range;
-                buffer.outerCutoff    = light.m_OuterCutoff;
-                buffer.position       = light.m_Position;
-                buffer.innerCutoff    = light.m_InnerCutoff;
-                buffer.direction      = -glm::normalize(light.m_Direction);
-                buffer.shadowmapIndex = light.m_ShadowmapIndex;
-                buffer.shadowSoftness = light.m_ShadowSoftness;
-                buffer.pcfSampleRate  = light.m_PCFSampleRate;
-                buffer.bias           = light.m_ShadowBias;
-
-                if (light.m_ShadowmapIndex != -1)
-                {
-                    glm::mat4 view = glm::lookAt(light.m_Position, light.m_Position + light.m_Direction + glm::vec3(0.00000127f), glm::vec3(0.0, 1.0, 0.0));
-                    glm::mat4 proj = glm::perspective((light.m_OuterCutoff + 0.02f) * glm::pi<float>(), 1.0f, 0.01f, light.m_Range);
-                    buffer.lightMat = proj * view;
-                }
-            }
-
-            m_GPULights.activeSpotLights++;
-        }
-        for (uint32_t i = 0U; auto& light : m_DirectionalLights)
+        // The copies only have to wait for the previous frames to be done reading what they overwrite, so a single execution
+        // dependency covers the buffers that change. Nothing is recorded when none of them do.
+        if (matricesChanged || materialsChanged || lightsChanged || drawsChanged)
         {
-            DirectionalLight::Buffer& buffer = m_GPULights.dirLights[m_GPULights.activeDirLights];
-
-            glm::vec3 lightCol = light.m_Color * (float)light.m_Active * light.m_Intensity;
-
-            i++;
-
-            if (lightCol == glm::vec3(0.0f))
-                continue;
-
-            if (dirShadowCasters < MAX_DIR_LIGHT_SHADOWS && light.m_CastShadows)
-            {
-                light.m_ShadowmapIndex = dirShadowCasters++;
-                m_ActiveDirLightsShadowIDs.push_back(i - 1);
-            }
-
-            if (buffer.color != lightCol ||
-                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
-                buffer.direction != glm::normalize(light.m_Direction) ||
-                buffer.shadowSoftness != light.m_ShadowSoftness ||
-                buffer.pcfSampleRate != light.m_PCFSampleRate ||
-                buffer.bias != light.m_ShadowBias
-            ) {
-                m_ChangedDirLightsIDs.push_back(m_GPULights.activeDirLights);
-
-                buffer.color          = lightCol;
-                buffer.shadowmapIndex = light.m_ShadowmapIndex;
-                buffer.direction      = glm::normalize(light.m_Direction);
-                buffer.shadowSoftness = light.m_ShadowSoftness;
-                buffer.pcfSampleRate  = light.m_PCFSampleRate;
-                buffer.bias           = light.m_ShadowBias;
-            }
-                
-            m_GPULights.activeDirLights++;
-        }
-
-        if (oldActivePointLights != m_GPULights.activePointLights ||
-            oldActiveSpotLights != m_GPULights.activeSpotLights ||
-            oldActiveDirLights != m_GPULights.activeDirLights
-        ) {
-            if(m_GPULights.activePointLights < oldActivePointLights)
-                m_ChangedPointLightsIDs.push_back(m_GPULights.activePointLights);
-
-            if (m_GPULights.activeSpotLights < oldActiveSpotLights)
-                m_ChangedSpotLightsIDs.push_back(m_GPULights.activeSpotLights);
-
-            m_SceneLightingChanged = true;
-        }
-
-        // Reset last (point/spot)light for clustered rendering
-        m_GPULights.pointLights[m_GPULights.activePointLights].color  = glm::vec3(0.0f);
-        m_GPULights.pointLights[m_GPULights.activePointLights].radius = 0.0f;
-
-        m_GPULights.spotLights[m_GPULights.activeSpotLights].color      = glm::vec3(0.0f);
-        m_GPULights.spotLights[m_GPULights.activeSpotLights].range      = 0.0f;
-        m_GPULights.spotLights[m_GPULights.activeSpotLights].direction  = glm::vec3(0.0f);
-        m_GPULights.spotLights[m_GPULights.activeSpotLights].outerCutoff = 0.0f; 
-
-
-        if ((float)m_ChangedPointLightsIDs.size() / MAX_POINT_LIGHTS > POINT_LIGHTS_UPDATE_THRESHOLD)
-        {
-            VkDeviceSize offset = (size_t)&m_GPULights.pointLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->MapMemory(m_GPULights.pointLights.data(), sizeof(m_GPULights.pointLights), 0U, offset);
-        }
-        else
-        {
-            for (const auto& changedId : m_ChangedPointLightsIDs)
-            {
-                VkDeviceSize offset = (size_t)&m_GPULights.pointLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->MapMemory(&m_GPULights.pointLights[changedId], sizeof(PointLight::Buffer), 0U, offset);
-            }
+            barriers.Add(
+                VK_ACCESS_2_NONE, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COPY_BIT
+            );
+            barriers.Flush(cmd);
         }
 
-        if ((float)m_ChangedSpotLightsIDs.size() / MAX_SPOT_LIGHTS > SPOT_LIGHTS_UPDATE_THRESHOLD)
-        {
-            VkDeviceSize offset = (size_t)&m_GPULights.spotLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->MapMemory(m_GPULights.spotLights.data(), sizeof(m_GPULights.spotLights), 0U, offset);
-        }
-        else
-        {
-            for (const auto& changedId : m_ChangedSpotLightsIDs)
-            {
-                VkDeviceSize offset = (size_t)&m_GPULights.spotLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->MapMemory(&m_GPULights.spotLights[changedId], sizeof(SpotLight::Buffer), 0U, offset);
-            }
-        }
+        if (matricesChanged)
+            UpdateMatrixBuffer(cmd, staging, m_ChangedMatrixIDs, barriers);
 
-        if ((float)m_ChangedDirLightsIDs.size() / MAX_DIR_LIGHTS > DIR_LIGHTS_UPDATE_THRESHOLD)
-        {
-            VkDeviceSize offset = (size_t)&m_GPULights.dirLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->MapMemory(m_GPULights.dirLights.data(), sizeof(m_GPULights.dirLights), 0U, offset);
-        }
-        else
-        {
-            for (const auto& changedId : m_ChangedDirLightsIDs)
-            {
-                VkDeviceSize offset = (size_t)&m_GPULights.dirLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->MapMemory(&m_GPULights.dirLights[changedId], sizeof(DirectionalLight::Buffer), 0U, offset);
-            }
-        }
+        if (lightsChanged)
+            UpdateLightsBuffer(cmd, staging, m_ChangedPointLightsIDs, m_ChangedSpotLightsIDs, m_ChangedDirLightsIDs, barriers);
 
-        constexpr VkDeviceSize pointLightsSize = sizeof(m_GPULights.pointLights);
-        constexpr VkDeviceSize spotLightsSize = sizeof(m_GPULights.spotLights);
-        constexpr VkDeviceSize dirLightsSize = sizeof(m_GPULights.dirLights);
-        constexpr VkDeviceSize allLightsSize = pointLightsSize + spotLightsSize + dirLightsSize;
+        if (materialsChanged)
+            UpdateMaterialBuffer(cmd, staging, m_ChangedMaterialIDs, barriers);
 
-        if (m_SceneLightingChanged)
-            m_LightsStagingBuffer->MapMemory(&m_GPULights.activePointLights, sizeof(GPULights) - allLightsSize, 0U, allLightsSize);
-    
-        // If more than MATRICES_UPDATE_THRESHOLD percent of matrices have changed, do a whole copy
-        if ((float)(m_ChangedMaterialIDs.size() / m_Materials.size()) > MATERIALS_UPDATE_THRESHOLD)
-        {
-            m_GlobalMaterialsStagingBuffer->MapMemory(m_GPUMaterials.data(), sizeof(GPUMaterial) * m_Materials.size());
-        }
-        else
-        {
-            for (const auto& changedMaterialId : m_ChangedMaterialIDs)
-            {
-                VkDeviceSize offset = changedMaterialId * sizeof(GPUMaterial);
-                m_GlobalMaterialsStagingBuffer->MapMemory(&m_GPUMaterials[changedMaterialId], sizeof(GPUMaterial), 0U, offset);
-            }
-        }
-
-        if ((float)m_ChangedMatrixIDs.size() / m_Matrices.size() > MATRICES_UPDATE_THRESHOLD)
-        {
-            m_GlobalMatricesStagingBuffer->MapMemory(m_Matrices.data(), sizeof(glm::mat4) * m_Matrices.size());
-        }
-        else
-        {
-            for (const auto& changedMatrixId : m_ChangedMatrixIDs)
-            {
-                VkDeviceSize offset = changedMatrixId * sizeof(glm::mat4);
-                m_GlobalMatricesStagingBuffer->MapMemory(&m_Matrices[changedMatrixId], sizeof(glm::mat4), 0U, offset);
-            }
-        }
-    }
-    void Scene::UpdateSceneGPU(const VkCommandBuffer cmd)
-    {
-        UpdateMatrixBuffer(cmd, m_ChangedMatrixIDs);
+        UpdateGeometryBuffers(cmd, barriers);
 
-        UpdateLightsBuffer(cmd, m_ChangedPointLightsIDs, m_ChangedSpotLightsIDs, m_ChangedDirLightsIDs);
+        UpdateDrawBuffer(cmd, staging, barriers);
 
-        UpdateMaterialBuffer(cmd, m_ChangedMaterialIDs);
+        // The writes of every copy are made visible to their readers at once
+        barriers.Flush(cmd);
 
         if (m_GlobalDescriptorChanged)
         {
@@ -662,6 +261,11 @@ namespace en
                     .type  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
                 },
+                DescriptorInfo::BufferInfo {
+                    .index = 4U,
+                    .type  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                },
             },
             //0,
             //VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
@@ -681,6 +285,11 @@ namespace en
                     .index = 1U,
                     .type  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                },
+                DescriptorInfo::BufferInfo {
+                    .index = 2U,
+                    .type  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
                 }
             },
         });
@@ -698,50 +307,25 @@ namespace en
             }
         });
     }
-
-    uint32_t Scene::RegisterMatrix(const glm::mat4& matrix)
-    {
-        uint32_t index = 0U;
-        while (m_OccupiedMatrices.contains(index))
-            index++;
-
-        if (index > m_Matrices.size() - 1)
-            m_Matrices.resize(m_Matrices.size() * 2);
-
-        m_OccupiedMatrices.insert(index);
-        m_Matrices[index] = matrix;
-
-        return index;
-    }
-    uint32_t Scene::RegisterMaterial(Handle<Material> material)
+    VkDescriptorSetLayout Scene::GetDrawsDescriptorLayout()
     {
-        if (!m_RegisteredMaterials.contains(material->GetName()))
-        {
-            uint32_t index = 0U;
-            while (m_OccupiedMaterials.contains(index))
-                index++;
-
-            if (index > m_Materials.size() - 1)
-            {
-                m_Materials.resize(m_Materials.size() * 2);
-                m_GPUMaterials.resize(m_GPUMaterials.size() * 2);
+        return DescriptorAllocator::Get().MakeLayout(DescriptorInfo{
+            std::vector<DescriptorInfo::ImageInfo>{},
+            std::vector<DescriptorInfo::BufferInfo>{
+                DescriptorInfo::BufferInfo {
+                    .index = 0U,
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
+                DescriptorInfo::BufferInfo {
+                    .index = 1U,
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
             }
-
-            m_OccupiedMaterials.insert(index);
-
-            material->m_AlbedoIndex    = RegisterTexture(material->GetAlbedoTexture());
-            material->m_RoughnessIndex = RegisterTexture(material->GetRoughnessTexture());
-            material->m_MetalnessIndex = RegisterTexture(material->GetMetalnessTexture());
-            material->m_NormalIndex    = RegisterTexture(material->GetNormalTexture());
-
-            m_GPUMaterials[index] = GPUMaterial{};
-            m_Materials[index] = material;
-
-            m_RegisteredMaterials[material->GetName()] = index;
-        }
-
-        return m_RegisteredMaterials.at(material->GetName());
+        });
     }
+
     uint32_t Scene::RegisterTexture(Handle<Texture> texture)
     {
         if (!m_RegisteredTextures.contains(texture->GetName()))
@@ -762,37 +346,25 @@ namespace en
 
         return m_RegisteredTextures.at(texture->GetName());
     }
-
-    void Scene::DeregisterMatrix(uint32_t index)
-    {
-        m_OccupiedMatrices.erase(index);
-        m_Matrices[index] = glm::mat4(1.0f);
-    }
-    void Scene::DeregisterMaterial(uint32_t index)
+    bool Scene::IsDefaultTexture(const Handle<Texture>& texture) const
     {
-        m_RegisteredMaterials.erase(m_Materials[index]->GetName());
-        m_GPUMaterials[index] = GPUMaterial{};
-        m_Materials[index]    = nullptr;
+        return texture->GetName() == AssetManager::Get().GetWhiteNonSRGBTexture()->GetName();
     }
+
     void Scene::DeregisterTexture(uint32_t index)
     {
+        m_OccupiedTextures.erase(index);
         m_RegisteredTextures.erase(m_Textures[index]->GetName());
         m_Textures[index] = nullptr;
     }
 
-    void Scene::UpdateMatrixBuffer(const VkCommandBuffer cmd, const std::vector<uint32_t>& changedMatrixIds)
+    void Scene::UpdateMatrixBuffer(const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedMatrixIds, BarrierBatch& barriers)
     {
         if (m_Matrices.size() == 0)
             return;
 
         bool updated = false;
 
-        m_GlobalMatricesBuffer->PipelineBarrier(
-            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-            cmd
-        );
-
         if (sizeof(glm::mat4) * m_Matrices.size() > m_GlobalMatricesBuffer->GetSize())
         {
             EN_LOG("MATRIX RESIZE");
@@ -800,7 +372,6 @@ namespace en
             uint32_t overflow = sizeof(glm::mat4) * m_Matrices.size() - m_GlobalMatricesBuffer->GetSize();
 
             m_GlobalMatricesBuffer->Resize((m_GlobalMatricesBuffer->GetSize() + overflow)*MATRICES_OVERFLOW_MULTIPLIER, cmd);
-            m_GlobalMatricesStagingBuffer->Resize(m_GlobalMatricesBuffer->GetSize(), cmd);
             m_GlobalDescriptorChanged = true;
 
             updated = true;
@@ -813,7 +384,7 @@ namespace en
         if ((float)changedMatrices / totalMatrices > MATRICES_UPDATE_THRESHOLD)
         {
             EN_LOG("TOTAL MATRIX UPDATE");
-            m_GlobalMatricesStagingBuffer->CopyTo(m_GlobalMatricesBuffer, sizeof(glm::mat4) * m_Matrices.size(), 0U, 0U, cmd);
+            staging.Upload(cmd, m_Matrices.data(), sizeof(glm::mat4) * m_Matrices.size(), m_GlobalMatricesBuffer->GetHandle());
         
             updated = true;
         }
@@ -822,7 +393,7 @@ namespace en
             for (const auto& changedMatrixId : changedMatrixIds)
             {
                 VkDeviceSize offset = changedMatrixId * sizeof(glm::mat4);
-                m_GlobalMatricesStagingBuffer->CopyTo(m_GlobalMatricesBuffer, sizeof(glm::mat4), offset, offset, cmd);
+                staging.Upload(cmd, &m_Matrices[changedMatrixId], sizeof(glm::mat4), m_GlobalMatricesBuffer->GetHandle(), offset);
           
                 updated = true;
             }
@@ -830,26 +401,19 @@ namespace en
 
         if (updated)
         {
-            m_GlobalMatricesBuffer->PipelineBarrier(
-                VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
-                cmd
+            barriers.Add(*m_GlobalMatricesBuffer,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT
             );
         }
     }
-    void Scene::UpdateMaterialBuffer(const VkCommandBuffer cmd, const std::vector<uint32_t>& changedMaterialIds)
+    void Scene::UpdateMaterialBuffer(const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedMaterialIds, BarrierBatch& barriers)
     {
         if (m_Materials.size() == 0)
             return;
     
         bool updated = false;
 
-        m_GlobalMaterialsBuffer->PipelineBarrier(
-            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-            cmd
-        );
-
         if (sizeof(GPUMaterial) * m_Materials.size() > m_GlobalMaterialsBuffer->GetSize())
         {
             EN_LOG("MATERIAL RESIZE");
@@ -857,7 +421,6 @@ namespace en
             uint32_t overflow = sizeof(GPUMaterial) * m_Materials.size() - m_GlobalMaterialsBuffer->GetSize();
 
             m_GlobalMaterialsBuffer->Resize((m_GlobalMaterialsBuffer->GetSize() + overflow) * MATERIALS_OVERFLOW_MULTIPLIER, cmd);
-            m_GlobalMaterialsStagingBuffer->Resize(m_GlobalMaterialsBuffer->GetSize(), cmd);
             m_GlobalDescriptorChanged = true;
 
             updated = true;
@@ -870,7 +433,7 @@ namespace en
         if ((float)changedMaterials / totalMaterials > MATERIALS_UPDATE_THRESHOLD)
         {
             EN_LOG("TOTAL MATERIAL UPDATE");
-            m_GlobalMaterialsStagingBuffer->CopyTo(m_GlobalMaterialsBuffer, sizeof(GPUMaterial) * m_Materials.size(), 0U, 0U, cmd);
+            staging.Upload(cmd, m_GPUMaterials.data(), sizeof(GPUMaterial) * m_Materials.size(), m_GlobalMaterialsBuffer->GetHandle());
        
             updated = true;
         }
@@ -879,7 +442,7 @@ namespace en
             for (const auto& changedMaterialId : changedMaterialIds)
             {
                 VkDeviceSize offset = changedMaterialId * sizeof(GPUMaterial);
-                m_GlobalMaterialsStagingBuffer->CopyTo(m_GlobalMaterialsBuffer, sizeof(GPUMaterial), offset, offset, cmd);
+                staging.Upload(cmd, &m_GPUMaterials[changedMaterialId], sizeof(GPUMaterial), m_GlobalMaterialsBuffer->GetHandle(), offset);
             
                 updated = true;
             }
@@ -887,31 +450,24 @@ namespace en
 
         if (updated)
         {
-            m_GlobalMaterialsBuffer->PipelineBarrier(
-                VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                cmd
+            barriers.Add(*m_GlobalMaterialsBuffer,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT
             );
         }
     }
-    void Scene::UpdateLightsBuffer(const VkCommandBuffer cmd, const std::vector<uint32_t>& changedPointLightsIDs, const std::vector<uint32_t>& changedSpotLightsIDs, const std::vector<uint32_t>& changedDirLightsIDs)
+    void Scene::UpdateLightsBuffer(const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedPointLightsIDs, const std::vector<uint32_t>& changedSpotLightsIDs, const std::vector<uint32_t>& changedDirLightsIDs, BarrierBatch& barriers)
     {
         uint32_t totalPointLights = MAX_POINT_LIGHTS;
         uint32_t changedPointLights = changedPointLightsIDs.size();
 
         bool updated = false;
 
-        m_LightsBuffer->PipelineBarrier(
-            VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-            cmd
-        );
-
         if ((float)changedPointLights / totalPointLights > POINT_LIGHTS_UPDATE_THRESHOLD)
         {
             EN_LOG("TOTAL POINT LIGHTS UPDATE");
             VkDeviceSize offset = (size_t)&m_GPULights.pointLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(m_GPULights.pointLights), offset, offset, cmd);
+            staging.Upload(cmd, m_GPULights.pointLights.data(), sizeof(m_GPULights.pointLights), m_LightsBuffer->GetHandle(), offset);
         
             updated = true;
         }
@@ -920,7 +476,7 @@ namespace en
             for (const auto& changedId : changedPointLightsIDs)
             {
                 VkDeviceSize offset = (size_t)&m_GPULights.pointLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(PointLight::Buffer), offset, offset, cmd);
+                staging.Upload(cmd, &m_GPULights.pointLights[changedId], sizeof(PointLight::Buffer), m_LightsBuffer->GetHandle(), offset);
                 
                 updated = true;
             }
@@ -933,7 +489,7 @@ namespace en
         {
             EN_LOG("TOTAL SPOT LIGHTS UPDATE");
             VkDeviceSize offset = (size_t)&m_GPULights.spotLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(m_GPULights.spotLights), offset, offset, cmd);
+            staging.Upload(cmd, m_GPULights.spotLights.data(), sizeof(m_GPULights.spotLights), m_LightsBuffer->GetHandle(), offset);
             
             updated = true;
         }
@@ -942,7 +498,7 @@ namespace en
             for (const auto& changedId : changedSpotLightsIDs)
             {
                 VkDeviceSize offset = (size_t)&m_GPULights.spotLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(SpotLight::Buffer), offset, offset, cmd);
+                staging.Upload(cmd, &m_GPULights.spotLights[changedId], sizeof(SpotLight::Buffer), m_LightsBuffer->GetHandle(), offset);
             
                 updated = true;
             }
@@ -955,7 +511,7 @@ namespace en
         {
             EN_LOG("TOTAL DIR LIGHTS UPDATE");
             VkDeviceSize offset = (size_t)&m_GPULights.dirLights - (size_t)&m_GPULights;
-            m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(m_GPULights.dirLights), offset, offset, cmd);
+            staging.Upload(cmd, m_GPULights.dirLights.data(), sizeof(m_GPULights.dirLights), m_LightsBuffer->GetHandle(), offset);
         
             updated = true;
         }
@@ -964,7 +520,7 @@ namespace en
             for (const auto& changedId : changedDirLightsIDs)
             {
                 VkDeviceSize offset = (size_t)&m_GPULights.dirLights[changedId] - (size_t)&m_GPULights;
-                m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sizeof(DirectionalLight::Buffer), offset, offset, cmd);
+                staging.Upload(cmd, &m_GPULights.dirLights[changedId], sizeof(DirectionalLight::Buffer), m_LightsBuffer->GetHandle(), offset);
             
                 updated = true;
             }
@@ -981,19 +537,137 @@ namespace en
             
             auto sceneLightingSize = sizeof(GPULights) - allLightsSize;
            
-            m_LightsStagingBuffer->CopyTo(m_LightsBuffer, sceneLightingSize, allLightsSize, allLightsSize, cmd);
+            staging.Upload(cmd, &m_GPULights.activePointLights, sceneLightingSize, m_LightsBuffer->GetHandle(), allLightsSize);
         
             updated = true;
         }
 
         if (updated)
         {
-            m_LightsBuffer->PipelineBarrier(
-                VK_ACCESS_MEMORY_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
-                cmd
+            barriers.Add(*m_LightsBuffer,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT
+            );
+        }
+    }
+    void Scene::UpdateGeometryBuffers(const VkCommandBuffer cmd, BarrierBatch& barriers)
+    {
+        if (!m_GeometryChanged)
+            return;
+
+        const VkDeviceSize verticesSize = std::max<VkDeviceSize>(m_GeometryVertexCount * sizeof(Vertex), sizeof(Vertex));
+        const VkDeviceSize indicesSize  = std::max<VkDeviceSize>(m_GeometryIndexCount * sizeof(uint32_t), sizeof(uint32_t));
+
+        // Compacted or outgrown, the frames in flight keep drawing from the old buffers
+        const bool compacted = m_UploadedVertexCount == 0U && m_UploadedIndexCount == 0U;
+
+        if (compacted || verticesSize > m_GeometryVertexBuffer->GetSize() || indicesSize > m_GeometryIndexBuffer->GetSize())
+        {
+            EN_LOG("GEOMETRY BUFFERS RESIZE");
+
+            Handle<MemoryBuffer> vertexBuffer = MakeHandle<MemoryBuffer>(
+                static_cast<VkDeviceSize>(verticesSize * GEOMETRY_OVERFLOW_MULTIPLIER),
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY
+            );
+            Handle<MemoryBuffer> indexBuffer = MakeHandle<MemoryBuffer>(
+                static_cast<VkDeviceSize>(indicesSize * GEOMETRY_OVERFLOW_MULTIPLIER),
+                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY
+            );
+
+            // The ranges that are there already move over as a whole, the earlier frames' copies into them have to be visible first
+            if (m_UploadedVertexCount > 0U || m_UploadedIndexCount > 0U)
+            {
+                BarrierBatch copyBarriers;
+                copyBarriers.Add(*m_GeometryVertexBuffer, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_COPY_BIT);
+                copyBarriers.Add(*m_GeometryIndexBuffer,  VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_COPY_BIT);
+                copyBarriers.Flush(cmd);
+
+                if (m_UploadedVertexCount > 0U)
+                    m_GeometryVertexBuffer->CopyTo(vertexBuffer, m_UploadedVertexCount * sizeof(Vertex), 0U, 0U, cmd);
+
+                if (m_UploadedIndexCount > 0U)
+                    m_GeometryIndexBuffer->CopyTo(indexBuffer, m_UploadedIndexCount * sizeof(uint32_t), 0U, 0U, cmd);
+            }
+
+            m_RetiredBuffers.emplace_back(std::move(m_GeometryVertexBuffer));
+            m_RetiredBuffers.emplace_back(std::move(m_GeometryIndexBuffer));
+
+            m_GeometryVertexBuffer = vertexBuffer;
+            m_GeometryIndexBuffer  = indexBuffer;
+        }
+
+        // Only the appended ranges, none of them overlap what the frames in flight draw
+        for (const auto& [key, range] : m_GeometryRanges)
+        {
+            if (static_cast<uint32_t>(range.vertexOffset) < m_UploadedVertexCount)
+                continue;
+
+            if (range.vertexBuffer->GetSize() > 0U)
+                range.vertexBuffer->CopyTo(m_GeometryVertexBuffer, range.vertexBuffer->GetSize(), 0U, range.vertexOffset * sizeof(Vertex), cmd);
+
+            if (range.indexBuffer->GetSize() > 0U)
+                range.indexBuffer->CopyTo(m_GeometryIndexBuffer, range.indexBuffer->GetSize(), 0U, range.firstIndex * sizeof(uint32_t), cmd);
+        }
+
+        m_UploadedVertexCount = m_GeometryVertexCount;
+        m_UploadedIndexCount  = m_GeometryIndexCount;
+
+        barriers.Add(*m_GeometryVertexBuffer,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT
+        );
+        barriers.Add(*m_GeometryIndexBuffer,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_INDEX_READ_BIT,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT
+        );
+
+        m_GeometryChanged = false;
+    }
+    void Scene::UpdateDrawBuffer(const VkCommandBuffer cmd, StagingRing& staging, BarrierBatch& barriers)
+    {
+        if (m_ChangedDrawIDs.empty() || m_Draws.empty())
+        {
+            m_ChangedDrawIDs.clear();
+            return;
+        }
+
+        const VkDeviceSize drawsSize = sizeof(GPUDraw) * m_Draws.size();
+
+        bool wholeCopy = static_cast<float>(m_ChangedDrawIDs.size()) / m_Draws.size() > DRAWS_UPDATE_THRESHOLD;
+
+        if (drawsSize > m_DrawsBuffer->GetSize())
+        {
+            EN_LOG("DRAWS RESIZE");
+
+            m_RetiredBuffers.emplace_back(std::move(m_DrawsBuffer));
+
+            m_DrawsBuffer = MakeHandle<MemoryBuffer>(
+                drawsSize * DRAWS_OVERFLOW_MULTIPLIER,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_MEMORY_USAGE_GPU_ONLY
             );
+
+            wholeCopy = true;
+        }
+
+        if (wholeCopy)
+            staging.Upload(cmd, m_Draws.data(), drawsSize, m_DrawsBuffer->GetHandle());
+        else
+        {
+            // The slots past the end were swap-removed since they changed
+            for (const auto& changedDrawId : m_ChangedDrawIDs)
+                if (changedDrawId < m_Draws.size())
+                    staging.Upload(cmd, &m_Draws[changedDrawId], sizeof(GPUDraw), m_DrawsBuffer->GetHandle(), changedDrawId * sizeof(GPUDraw));
         }
+
+        barriers.Add(*m_DrawsBuffer,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT
+        );
+
+        m_ChangedDrawIDs.clear();
     }
     void Scene::UpdateGlobalDescriptor()
     {
@@ -1045,6 +719,13 @@ namespace en
                     .type   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage  = VK_SHADER_STAGE_FRAGMENT_BIT,
                 },
+                DescriptorInfo::BufferInfo {
+                    .index  = 4U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size   = m_DrawsBuffer->GetSize(),
+                    .type   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage  = VK_SHADER_STAGE_VERTEX_BIT,
+                },
             }
         });
 
@@ -1078,6 +759,33 @@ namespace en
                     .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
                     .stage = VK_SHADER_STAGE_VERTEX_BIT,
                 },
+                DescriptorInfo::BufferInfo {
+                    .index = 2U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size = m_DrawsBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                },
+            }
+        });
+
+        m_DrawsDescriptorSet->Update(DescriptorInfo{
+            std::vector<DescriptorInfo::ImageInfo>{},
+            std::vector<DescriptorInfo::BufferInfo>{
+                DescriptorInfo::BufferInfo {
+                    .index = 0U,
+                    .buffer = m_DrawsBuffer->GetHandle(),
+                    .size = m_DrawsBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
+                DescriptorInfo::BufferInfo {
+                    .index = 1U,
+                    .buffer = m_GlobalMatricesBuffer->GetHandle(),
+                    .size = m_GlobalMatricesBuffer->GetSize(),
+                    .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                },
             }
         });
     }
@@ -7,124 +7,73 @@
 #include <unordered_set>
 
 #include <Renderer/Passes/GraphicsPass.hpp>
+#include <Renderer/BarrierBatch.hpp>
+#include <Renderer/Buffers/StagingRing.hpp>
 
-#include <Scene/SceneObject.hpp>
-#include <Renderer/Lights/PointLight.hpp>
-#include <Renderer/Lights/DirectionalLight.hpp>
-#include <Renderer/Lights/SpotLight.hpp>
+#include <Assets/AssetManager.hpp>
+#include <Scene/SceneState.hpp>
 
-#include <Renderer/Camera/Camera.hpp>
 #include <Renderer/Camera/CameraBuffer.hpp>
 
 namespace en
 {
-	class Scene
+	// Uploads the changes of the SceneState to the GPU and holds the buffers and descriptors the passes read them through
+	class Scene : public SceneState
 	{
 		friend class Renderer;
 
 	public:
 		Scene();
 
-		Handle<SceneObject> GetSceneObject(const std::string& name);
-
-		Handle<SceneObject> CreateSceneObject(const std::string& name, Handle <Mesh> mesh);
-		void DeleteSceneObject(const std::string& name);
-
-		//void RenameSceneObject(const std::string& oldName, const std::string& newName);
-
-		PointLight* CreatePointLight(const glm::vec3 position, const glm::vec3 color = glm::vec3(1.0f), const float intensity = 2.5f, const float radius = 10.0f, const bool active = true);
-		void DeletePointLight(const uint32_t index);
-
-		SpotLight* CreateSpotLight(const glm::vec3 position, const glm::vec3 direction, const glm::vec3 color = glm::vec3(1.0f), const float innerCutoff = 0.2f, const float outerCutoff = 0.4f, const float range = 8.0f, const float intensity = 2.5f, const bool active = true);
-		void DeleteSpotLight(const uint32_t index);
-
-		DirectionalLight* CreateDirectionalLight(const glm::vec3 direction, const glm::vec3 color = glm::vec3(1.0f), const float intensity = 2.5f, const bool active = true);
-		void DeleteDirectionalLight(const uint32_t index);
-
 		static VkDescriptorSetLayout GetGlobalDescriptorLayout();
 		static VkDescriptorSetLayout GetLightingDescriptorLayout();
 		static VkDescriptorSetLayout GetLightsBufferDescriptorLayout();
-
-		glm::vec3 m_AmbientColor = glm::vec3(0.0f);
-
-		std::vector<PointLight>		  m_PointLights;
-		std::vector<SpotLight>		  m_SpotLights;
-		std::vector<DirectionalLight> m_DirectionalLights;
-
-		Handle<Camera> m_MainCamera;
-
-		std::unordered_map<std::string, Handle<SceneObject>> m_SceneObjects;
+		static VkDescriptorSetLayout GetDrawsDescriptorLayout();
 
 	private:
+		// Grows the draws buffer's descriptor along with the draws
 		void UpdateSceneCPU();
-		void UpdateSceneGPU(const VkCommandBuffer cmd);
+		// The changed parts are copied from the CPU side through the frame's staging region
+		void UpdateSceneGPU(const VkCommandBuffer cmd, StagingRing& staging);
 
-		uint32_t RegisterMatrix(const glm::mat4& matrix = glm::mat4(1.0f));
-		uint32_t RegisterMaterial(Handle<Material> material);
-		uint32_t RegisterTexture(Handle<Texture> texture);
+		uint32_t RegisterTexture(Handle<Texture> texture) override;
+		bool IsDefaultTexture(const Handle<Texture>& texture) const override;
 
-		void DeregisterMatrix(uint32_t index);
-		void DeregisterMaterial(uint32_t index);
 		void DeregisterTexture(uint32_t index);
 
-		void UpdateMatrixBuffer	   (const VkCommandBuffer cmd, const std::vector<uint32_t>& changedMatrixIds);
-		void UpdateMaterialBuffer  (const VkCommandBuffer cmd, const std::vector<uint32_t>& changedMaterialIds);
+		// Add the barriers between their copies and the reads to the batch, UpdateSceneGPU() records them all at once
+		void UpdateMatrixBuffer	   (const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedMatrixIds, BarrierBatch& barriers);
+		void UpdateMaterialBuffer  (const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedMaterialIds, BarrierBatch& barriers);
 		void UpdateGlobalDescriptor();
-		void UpdateLightsBuffer    (const VkCommandBuffer cmd, const std::vector<uint32_t>& changedPointLightsIDs, const std::vector<uint32_t>& changedSpotLightsIDs, const std::vector<uint32_t>& changedDirLightsIDs);
-
-		struct GPUMaterial {
-			glm::vec3 color = glm::vec3(1.0f);
-			float _padding0{};
+		void UpdateLightsBuffer    (const VkCommandBuffer cmd, StagingRing& staging, const std::vector<uint32_t>& changedPointLightsIDs, const std::vector<uint32_t>& changedSpotLightsIDs, const std::vector<uint32_t>& changedDirLightsIDs, BarrierBatch& barriers);
 
-			float metalnessVal = 0.00f;
-			float roughnessVal = 0.75f;
-			float normalStrength = 1.00f;
-			float _padding1{};
+		void UpdateGeometryBuffers(const VkCommandBuffer cmd, BarrierBatch& barriers);
+		void UpdateDrawBuffer     (const VkCommandBuffer cmd, StagingRing& staging, BarrierBatch& barriers);
 
-			uint32_t albedoId{};
-			uint32_t roughnessId{};
-			uint32_t metalnessId{};
-			uint32_t normalId{};
-		};
-
-		struct GPULights {
-			std::array<PointLight::Buffer	   , MAX_POINT_LIGHTS> pointLights{};
-			std::array<SpotLight::Buffer	   , MAX_SPOT_LIGHTS > spotLights{};
-			std::array<DirectionalLight::Buffer, MAX_DIR_LIGHTS  > dirLights{};
-
-			uint32_t activePointLights = 0U;
-			uint32_t activeSpotLights = 0U;
-			uint32_t activeDirLights = 0U;
-			uint32_t _padding0{};
-
-			glm::vec3 ambientLight = glm::vec3(0.0f);
-			uint32_t _padding1{};
-		} m_GPULights;
-
-		std::vector<glm::mat4  > m_Matrices;
-		std::vector<GPUMaterial> m_GPUMaterials;
-
-		std::vector<Handle<Material>> m_Materials;
 		std::vector<Handle<Texture> > m_Textures;
 
-		std::unordered_set<uint32_t> m_OccupiedMatrices;
-		std::unordered_set<uint32_t> m_OccupiedMaterials;
 		std::unordered_set<uint32_t> m_OccupiedTextures;
 
 		std::unordered_map<std::string, uint32_t> m_RegisteredTextures;
-		std::unordered_map<std::string, uint32_t> m_RegisteredMaterials;
 
 		//std::array<Handle<MemoryBuffer>, FRAMES_IN_FLIGHT> m_LightsBuffer;
 		Handle<MemoryBuffer> m_LightsBuffer;
-		Handle<MemoryBuffer> m_LightsStagingBuffer;
 
 		//std::array<Handle<MemoryBuffer>, FRAMES_IN_FLIGHT> m_GlobalMaterialsBuffer;
 		Handle<MemoryBuffer> m_GlobalMaterialsBuffer;
-		Handle<MemoryBuffer> m_GlobalMaterialsStagingBuffer;
 
 		//std::array<Handle<MemoryBuffer>, FRAMES_IN_FLIGHT> m_GlobalMatricesBuffer;
 		Handle<MemoryBuffer> m_GlobalMatricesBuffer;
-		Handle<MemoryBuffer> m_GlobalMatricesStagingBuffer;
+
+		Handle<MemoryBuffer> m_DrawsBuffer;
+
+		// Every SubMesh used by the scene copied into a single vertex and index buffer. New ranges are appended after the ones that
+		// were copied already, the buffers are only laid out again when a mesh stops being used.
+		Handle<MemoryBuffer> m_GeometryVertexBuffer;
+		Handle<MemoryBuffer> m_GeometryIndexBuffer;
+
+		// Replaced while the frames in flight could still read them, the renderer keeps them alive until they finish
+		std::vector<Handle<MemoryBuffer>> m_RetiredBuffers;
 
 		//std::array<Handle<DescriptorSet>, FRAMES_IN_FLIGHT> m_GlobalDescriptorSet;
 		//std::array<Handle<DescriptorSet>, FRAMES_IN_FLIGHT> m_LightingDescriptorSet;
@@ -133,19 +82,8 @@ namespace en
 		Handle<DescriptorSet> m_GlobalDescriptorSet;
 		Handle<DescriptorSet> m_LightingDescriptorSet;
 		Handle<DescriptorSet> m_LightsBufferDescriptorSet;
+		Handle<DescriptorSet> m_DrawsDescriptorSet;
 
-		std::vector<uint32_t> m_ChangedMatrixIDs;
-		std::vector<uint32_t> m_ChangedMaterialIDs;
-
-		std::vector<uint32_t> m_ChangedPointLightsIDs;
-		std::vector<uint32_t> m_ChangedSpotLightsIDs;
-		std::vector<uint32_t> m_ChangedDirLightsIDs;
-
-		std::vector<uint32_t> m_ActivePointLightsShadowIDs;
-		std::vector<uint32_t> m_ActiveSpotLightsShadowIDs;
-		std::vector<uint32_t> m_ActiveDirLightsShadowIDs;
-
-		bool m_SceneLightingChanged = true;
 		bool m_GlobalDescriptorChanged = true;
 	};
 }
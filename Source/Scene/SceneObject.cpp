@@ -2,6 +2,28 @@
 
 namespace en
 {
+    void SceneObject::SetMesh(Handle<Mesh> mesh)
+    {
+        if (mesh != m_Mesh)
+            m_DrawsChanged = true;
+
+        m_Mesh = mesh;
+    }
+    void SceneObject::SetActive(const bool active)
+    {
+        if (active != m_Active)
+            m_DrawsChanged = true;
+
+        m_Active = active;
+    }
+    void SceneObject::SetStatic(const bool isStatic)
+    {
+        if (isStatic != m_Static)
+            m_DrawsChanged = true;
+
+        m_Static = isStatic;
+    }
+
     void SceneObject::SetPosition(const glm::vec3& position)
     {
         if (!m_TransformChanged && position != m_Position)
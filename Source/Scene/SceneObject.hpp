@@ -4,7 +4,6 @@
 #define EN_SCENEOBJECT_HPP
 
 #include <Assets/Mesh.hpp>
-#include <Assets/AssetManager.hpp>
 
 #include <Scene/SceneMember.hpp>
 
@@ -16,14 +15,21 @@ namespace en
 	class SceneObject : public SceneMember
 	{
 		friend class Scene;
+		friend class SceneState;
 
 	public:
 		SceneObject(Handle<Mesh> mesh, const std::string& name)
 			: m_Mesh(mesh), m_Name(name), SceneMember{ SceneMemberType::SceneObject }{};
 
-		Handle<Mesh> m_Mesh;
+		void SetMesh(Handle<Mesh> mesh);
+		const Handle<Mesh>& GetMesh() const { return m_Mesh; };
 
-		bool m_Active = true;
+		void SetActive(const bool active);
+		const bool IsActive() const { return m_Active; };
+
+		// Static objects are expected to stay in place, their shadows are cached apart from the dynamic ones
+		void SetStatic(const bool isStatic);
+		const bool IsStatic() const { return m_Static; };
 
 		void SetPosition(const glm::vec3& position);
 		void SetRotation(const glm::vec3& rotation);
@@ -42,10 +48,20 @@ namespace en
 		glm::vec3 m_Rotation = glm::vec3(0.0f);
 		glm::vec3 m_Scale	 = glm::vec3(1.0f);
 
+		Handle<Mesh> m_Mesh;
+
+		bool m_Active = true;
+		bool m_Static = false;
+
 		bool m_TransformChanged = true;
+		bool m_DrawsChanged		= true;
 
 		uint32_t m_MatrixIndex{};
 
+		// The mesh the object's draws were made for and their indices in the scene, one for each of its SubMeshes
+		Handle<Mesh>		  m_DrawnMesh;
+		std::vector<uint32_t> m_Draws;
+
 		std::string m_Name;
 	};
 }
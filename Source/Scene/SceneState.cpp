@@ -0,0 +1,782 @@
+#include "SceneState.hpp"
+
+#include <Core/Log.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm>
+
+namespace en
+{
+    // Rough share of the screen covered by a light's range, decides which lights get shadows and how detailed they are
+    float GetShadowImportance(const glm::vec3& position, const float range, const Handle<Camera>& camera)
+    {
+        const float distance = glm::distance(position, camera->m_Position);
+
+        if (distance <= range)
+            return 1.0f;
+
+        return std::min(range / (distance * std::tan(glm::radians(camera->m_Fov) * 0.5f)), 1.0f);
+    }
+
+    // The most recently released slot, or the one past the end when none is free
+    uint32_t AcquireSlot(std::vector<uint32_t>& freeSlots, std::unordered_set<uint32_t>& occupied)
+    {
+        uint32_t index = static_cast<uint32_t>(occupied.size());
+
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        occupied.insert(index);
+
+        return index;
+    }
+
+    template<typename Light>
+    void SceneState::SelectShadowCasters(std::vector<Light>& lights, std::vector<uint32_t>& casters, const uint32_t maxCasters)
+    {
+        const uint32_t casterCount = std::min(static_cast<uint32_t>(casters.size()), maxCasters);
+
+        std::partial_sort(casters.begin(), casters.begin() + casterCount, casters.end(), [&lights](uint32_t a, uint32_t b) {
+            return lights[a].m_ShadowImportance > lights[b].m_ShadowImportance;
+        });
+
+        for (uint32_t i = 0U; i < casterCount; i++)
+            lights[casters[i]].m_ShadowmapIndex = static_cast<int>(i);
+    }
+
+    SceneState::SceneState()
+    {
+        m_SceneObjects     .reserve(64);
+        m_PointLights      .reserve(64);
+        m_SpotLights       .reserve(64);
+        m_DirectionalLights.reserve(64);
+
+        m_Matrices    .resize(64);
+        m_Materials   .resize(64);
+        m_GPUMaterials.resize(64);
+
+        m_MainCamera = MakeHandle<Camera>();
+    }
+
+    Handle<SceneObject> SceneState::CreateSceneObject(const std::string& name, Handle<Mesh> mesh)
+    {
+        std::string finalName = name;
+
+        if (m_SceneObjects.contains(finalName))
+        {
+            EN_WARN("SceneState::CreateSceneObject() - Failed to create a SceneObject because a SceneObject called \"" + name + "\" already exists!");
+            return nullptr;
+        }
+
+        m_SceneObjects[finalName] = MakeHandle<SceneObject>(mesh, finalName);
+        
+        auto& newSceneObject = m_SceneObjects.at(finalName);
+
+        newSceneObject->m_MatrixIndex = RegisterMatrix();
+        for (auto& subMesh : newSceneObject->m_Mesh->m_SubMeshes)
+            subMesh.m_MaterialIndex = RegisterMaterial(subMesh.m_Material);
+
+        EN_LOG("Created a SceneObject called \"" + finalName + "\"");
+
+        return m_SceneObjects.at(finalName);
+    }
+    void SceneState::DeleteSceneObject(const std::string& name)
+    {
+        if (!m_SceneObjects.contains(name))
+        {
+            EN_WARN("SceneState::DeleteSceneObject() - Failed to delete a SceneObject because a SceneObject called \"" + name + "\" doesn't exist!");
+            return;
+        }
+
+        EN_LOG("Deleted a SceneObject called \"" + name + "\"");
+
+        DeregisterMatrix(m_SceneObjects.at(name)->GetMatrixIndex());
+
+        // Its draws are removed by the next update
+        m_DeletedSceneObjects.emplace_back(std::move(m_SceneObjects.at(name)));
+        m_SceneObjects.erase(name);
+    }
+
+    Handle<SceneObject> SceneState::GetSceneObject(const std::string& name)
+    {
+        if (!m_SceneObjects.contains(name))
+        {
+            EN_WARN("SceneState::GetSceneObject() - Failed to find a SceneObject named " + name + "!");
+
+            return nullptr;
+        }
+
+        return m_SceneObjects.at(name);
+    }
+    /*
+    void SceneState::RenameSceneObject(const std::string& oldName, const std::string& newName)
+    {
+        if (m_SceneObjects.contains(newName))
+            EN_WARN("Failed to rename " + oldName + " because a SceneObject with a name " + newName + " already exists!")
+        else
+        {
+            if (m_SceneObjects.contains(oldName))
+            {
+                m_SceneObjects[newName].swap(m_SceneObjects.at(oldName));
+                m_SceneObjects.at(newName)->m_Name = newName;
+                m_SceneObjects.erase(oldName);
+            }
+            else
+                EN_WARN("Failed to rename " + oldName + " because a SceneObject with that name doesn't exist!")
+        }
+    }
+    */
+    PointLight* SceneState::CreatePointLight(const glm::vec3 position, const glm::vec3 color, const float intensity, const float radius, const bool active)
+    {
+        if (m_PointLights.size() + 1 >= MAX_POINT_LIGHTS)
+        {
+            EN_WARN("Failed to create a new PointLight because you've reached the MAX_POINT_LIGHTS limit (" + std::to_string(MAX_POINT_LIGHTS) + ")!")
+            return nullptr;
+        }
+
+        m_PointLights.emplace_back(position, color, intensity, radius, active);
+
+        return &m_PointLights.at(m_PointLights.size()-1);
+    }
+    void SceneState::DeletePointLight(const uint32_t index)
+    {
+        m_PointLights.erase(m_PointLights.begin() + index);
+    }
+
+    SpotLight* SceneState::CreateSpotLight(const glm::vec3 position, const glm::vec3 direction, const glm::vec3 color, const float innerCutoff, const float outerCutoff, const float range, const float intensity, const bool active)
+    {
+        if (m_SpotLights.size() + 1 >= MAX_SPOT_LIGHTS)
+        {
+            EN_WARN("Failed to create a new SpotLight because you've reached the MAX_SPOT_LIGHTS limit (" + std::to_string(MAX_SPOT_LIGHTS) + ")!")
+            return nullptr;
+        }
+
+        m_SpotLights.emplace_back(position, direction, color, innerCutoff, outerCutoff, range, intensity, active);
+
+        return &m_SpotLights.at(m_SpotLights.size()-1);
+    }
+    void SceneState::DeleteSpotLight(const uint32_t index)
+    {
+        m_SpotLights.erase(m_SpotLights.begin() + index);
+    }
+
+    DirectionalLight* SceneState::CreateDirectionalLight(const glm::vec3 direction, const glm::vec3 color, const float intensity, const bool active)
+    {
+        if (m_DirectionalLights.size() + 1 >= MAX_DIR_LIGHTS)
+        {
+            EN_WARN("Failed to create a new DirectionalLight because you've reached the MAX_DIR_LIGHTS limit (" + std::to_string(MAX_DIR_LIGHTS) + ")!")
+            return nullptr;
+        }
+
+        m_DirectionalLights.emplace_back(direction, color, intensity, active);
+
+        return &m_DirectionalLights.back();
+    }
+    void SceneState::DeleteDirectionalLight(const uint32_t index)
+    {
+        m_DirectionalLights.erase(m_DirectionalLights.begin() + index);
+    }
+
+    void SceneState::UpdateSceneCPU()
+    {
+        EN_PROFILE_FUNCTION();
+
+        m_ActivePointLightsShadowIDs.clear();
+        m_ActiveSpotLightsShadowIDs.clear();
+        m_ActiveDirLightsShadowIDs.clear();
+
+        m_ChangedMatrixIDs.clear();
+        m_ChangedMaterialIDs.clear();
+
+        m_MovedStaticBounds .clear();
+        m_MovedDynamicBounds.clear();
+
+        for (auto& [name, sceneObject] : m_SceneObjects)
+        {
+            if (sceneObject->m_DrawsChanged)
+                m_ChangedSceneObjects.emplace_back(sceneObject.get());
+
+            if (sceneObject->m_TransformChanged)
+            {
+                glm::mat4 newMatrix = glm::translate(glm::mat4(1.0f), sceneObject->m_Position);
+                uint32_t changedMatrixId = sceneObject->m_MatrixIndex;
+
+                if (sceneObject->m_Rotation != glm::vec3(0.0f))
+                {
+                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.y), glm::vec3(0, 1, 0));
+                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.z), glm::vec3(0, 0, 1));
+                    newMatrix = glm::rotate(newMatrix, glm::radians(sceneObject->m_Rotation.x), glm::vec3(1, 0, 0));
+                }
+
+                newMatrix = glm::scale(newMatrix, sceneObject->m_Scale);
+
+                m_Matrices[changedMatrixId] = newMatrix;
+
+                m_ChangedMatrixIDs.push_back(changedMatrixId);
+                sceneObject->m_TransformChanged = false;
+
+                auto& movedBounds = sceneObject->m_Static ? m_MovedStaticBounds : m_MovedDynamicBounds;
+
+                // Only the object's own draws have to follow the new matrix, the hidden ones don't cast any shadows
+                for (const auto& i : sceneObject->m_Draws)
+                {
+                    const bool visible = m_Draws[i].indexCount > 0U;
+
+                    if (visible)
+                        movedBounds.emplace_back(m_DrawBounds[i]);
+
+                    m_DrawBounds[i] = m_DrawLocalBounds[i].Transform(newMatrix);
+
+                    if (visible)
+                        movedBounds.emplace_back(m_DrawBounds[i]);
+                }
+            }
+        }
+
+        UpdateDraws();
+
+        for (const auto& i : m_OccupiedMaterials)
+        {
+            auto& cpuMat = m_Materials[i];
+            auto& gpuMat = m_GPUMaterials[i];
+
+            if (cpuMat->m_Changed)
+            {
+                gpuMat.color = cpuMat->m_Color;
+
+                gpuMat.metalnessVal = IsDefaultTexture(cpuMat->GetMetalnessTexture()) ? cpuMat->GetMetalness() : 1.0f;
+                gpuMat.roughnessVal = IsDefaultTexture(cpuMat->GetRoughnessTexture()) ? cpuMat->GetRoughness() : 1.0f;
+                gpuMat.normalStrength = !IsDefaultTexture(cpuMat->GetNormalTexture()) ? cpuMat->GetNormalStrength() : 0.0f;
+
+                cpuMat->m_AlbedoIndex = RegisterTexture(cpuMat->GetAlbedoTexture());
+                cpuMat->m_RoughnessIndex = RegisterTexture(cpuMat->GetRoughnessTexture());
+                cpuMat->m_MetalnessIndex = RegisterTexture(cpuMat->GetMetalnessTexture());
+                cpuMat->m_NormalIndex = RegisterTexture(cpuMat->GetNormalTexture());
+
+                gpuMat.albedoId = cpuMat->GetAlbedoIndex();
+                gpuMat.roughnessId = cpuMat->GetRoughnessIndex();
+                gpuMat.metalnessId = cpuMat->GetMetalnessIndex();
+                gpuMat.normalId = cpuMat->GetNormalIndex();
+
+                m_ChangedMaterialIDs.push_back(i);
+                cpuMat->m_Changed = false;
+            }
+        }
+
+        m_SceneLightingChanged = false;
+        m_ChangedPointLightsIDs.clear();
+        m_ChangedSpotLightsIDs .clear();
+        m_ChangedDirLightsIDs  .clear();
+
+        uint32_t oldActivePointLights = m_GPULights.activePointLights;
+        uint32_t oldActiveSpotLights  = m_GPULights.activeSpotLights;
+        uint32_t oldActiveDirLights   = m_GPULights.activeDirLights;
+
+        m_GPULights.activePointLights = 0U;
+        m_GPULights.activeSpotLights  = 0U;
+        m_GPULights.activeDirLights   = 0U;
+
+        if (m_GPULights.ambientLight != m_AmbientColor)
+        {
+            m_GPULights.ambientLight = m_AmbientColor;
+            m_SceneLightingChanged = true;
+        }
+
+        for (auto& l : m_PointLights)
+            l.m_ShadowmapIndex = -1;
+        for (auto& l : m_SpotLights)
+            l.m_ShadowmapIndex = -1;
+        for (auto& l : m_DirectionalLights)
+            l.m_ShadowmapIndex = -1;
+
+        std::vector<uint32_t> pointShadowCasters;
+        std::vector<uint32_t> spotShadowCasters;
+
+        for (uint32_t i = 0U; i < m_PointLights.size(); i++)
+        {
+            auto& light = m_PointLights[i];
+
+            light.m_ShadowImportance = GetShadowImportance(light.m_Position, light.m_Radius, m_MainCamera);
+
+            if (light.m_CastShadows && light.m_Active && light.m_Intensity * light.m_Color != glm::vec3(0.0f) && light.m_Radius > 0.0f)
+                pointShadowCasters.push_back(i);
+        }
+        for (uint32_t i = 0U; i < m_SpotLights.size(); i++)
+        {
+            auto& light = m_SpotLights[i];
+
+            light.m_ShadowImportance = GetShadowImportance(light.m_Position, light.m_Range, m_MainCamera);
+
+            if (light.m_CastShadows && light.m_Active && light.m_Intensity * light.m_Color != glm::vec3(0.0f) && light.m_Range != 0.0f && light.m_OuterCutoff != 0.0f)
+                spotShadowCasters.push_back(i);
+        }
+
+        SelectShadowCasters(m_PointLights, pointShadowCasters, MAX_POINT_LIGHT_SHADOWS);
+        SelectShadowCasters(m_SpotLights, spotShadowCasters, MAX_SPOT_LIGHT_SHADOWS);
+
+        // Directional lights cover the whole screen, so they keep their order
+        uint32_t dirShadowCasters = 0U;
+
+        for (uint32_t i = 0U; auto& light : m_PointLights)
+        {
+            PointLight::Buffer& buffer = m_GPULights.pointLights[m_GPULights.activePointLights];
+
+            glm::vec3 lightCol = light.m_Color * (float)light.m_Active * light.m_Intensity;
+            float     lightRad = light.m_Radius * (float)light.m_Active;
+
+            i++;
+
+            if (lightCol == glm::vec3(0.0) || lightRad <= 0.0f)
+                continue;
+
+            if (light.m_ShadowmapIndex != -1)
+                m_ActivePointLightsShadowIDs.push_back(i - 1);
+
+
+            if (buffer.position != light.m_Position ||
+                buffer.color != lightCol ||
+                buffer.radius != lightRad ||
+                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
+                buffer.shadowSoftness != light.m_ShadowSoftness ||
+                buffer.pcfSampleRate != light.m_PCFSampleRate ||
+                buffer.bias != light.m_ShadowBias
+            ) {
+                m_ChangedPointLightsIDs.push_back(m_GPULights.activePointLights);
+
+                buffer.position = light.m_Position;
+                buffer.color = lightCol;
+                buffer.radius = lightRad;
+                buffer.shadowmapIndex = light.m_ShadowmapIndex;
+                buffer.shadowSoftness = light.m_ShadowSoftness;
+                buffer.pcfSampleRate = light.m_PCFSampleRate;
+                buffer.bias = light.m_ShadowBias;
+
+                if (light.m_ShadowmapIndex != -1)
+                {
+                    const glm::mat4 proj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, light.m_Radius);
+
+                    buffer.viewProj[0] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 1.0,  0.0,  0.0), glm::vec3(0.0, -1.0,  0.0));
+                    buffer.viewProj[1] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3(-1.0,  0.0,  0.0), glm::vec3(0.0, -1.0,  0.0));
+                    buffer.viewProj[2] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  1.0,  0.0), glm::vec3(0.0,  0.0,  1.0));
+                    buffer.viewProj[3] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0, -1.0,  0.0), glm::vec3(0.0,  0.0, -1.0));
+                    buffer.viewProj[4] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  0.0,  1.0), glm::vec3(0.0, -1.0,  0.0));
+                    buffer.viewProj[5] = proj * glm::lookAt(light.m_Position, light.m_Position + glm::vec3( 0.0,  0.0, -1.0), glm::vec3(0.0, -1.0,  0.0)); 
+
+                    light.m_ViewProj = buffer.viewProj;
+                }
+            }
+
+            m_GPULights.activePointLights++;
+        }
+        for (uint32_t i = 0U; auto& light : m_SpotLights)
+        {
+            SpotLight::Buffer& buffer = m_GPULights.spotLights[m_GPULights.activeSpotLights];
+
+            glm::vec3 lightColor = light.m_Color * (float)light.m_Active * light.m_Intensity;
+
+            i++;
+
+            if (light.m_Range == 0.0f || lightColor == glm::vec3(0.0) || light.m_OuterCutoff == 0.0f)
+                continue;
+
+            if (light.m_ShadowmapIndex != -1)
+                m_ActiveSpotLightsShadowIDs.push_back(i - 1);
+
+            if (buffer.color != lightColor ||
+                buffer.range != light.m_Range ||
+                buffer.outerCutoff != light.m_OuterCutoff ||
+                buffer.position != light.m_Position ||
+                buffer.innerCutoff != light.m_InnerCutoff ||
+                buffer.direction != -glm::normalize(light.m_Direction) ||
+                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
+                buffer.shadowSoftness != light.m_ShadowSoftness ||
+                buffer.pcfSampleRate != light.m_PCFSampleRate ||
+                buffer.bias != light.m_ShadowBias
+            ) {
+                m_ChangedSpotLightsIDs.push_back(m_GPULights.activeSpotLights);
+
+                buffer.color          = lightColor;
+                buffer.range          = light.m_Range;
+                buffer.outerCutoff    = light.m_OuterCutoff;
+                buffer.position       = light.m_Position;
+                buffer.innerCutoff    = light.m_InnerCutoff;
+                buffer.direction      = -glm::normalize(light.m_Direction);
+                buffer.shadowmapIndex = light.m_ShadowmapIndex;
+                buffer.shadowSoftness = light.m_ShadowSoftness;
+                buffer.pcfSampleRate  = light.m_PCFSampleRate;
+                buffer.bias           = light.m_ShadowBias;
+
+                if (light.m_ShadowmapIndex != -1)
+                {
+                    glm::mat4 view = glm::lookAt(light.m_Position, light.m_Position + light.m_Direction + glm::vec3(0.00000127f), glm::vec3(0.0, 1.0, 0.0));
+                    glm::mat4 proj = glm::perspective((light.m_OuterCutoff + 0.02f) * glm::pi<float>(), 1.0f, 0.01f, light.m_Range);
+                    buffer.lightMat = proj * view;
+
+                    light.m_ViewProj = buffer.lightMat;
+                }
+            }
+
+            m_GPULights.activeSpotLights++;
+        }
+        for (uint32_t i = 0U; auto& light : m_DirectionalLights)
+        {
+            DirectionalLight::Buffer& buffer = m_GPULights.dirLights[m_GPULights.activeDirLights];
+
+            glm::vec3 lightCol = light.m_Color * (float)light.m_Active * light.m_Intensity;
+
+            i++;
+
+            if (lightCol == glm::vec3(0.0f))
+                continue;
+
+            if (dirShadowCasters < MAX_DIR_LIGHT_SHADOWS && light.m_CastShadows)
+            {
+                light.m_ShadowmapIndex = dirShadowCasters++;
+                m_ActiveDirLightsShadowIDs.push_back(i - 1);
+            }
+
+            if (buffer.color != lightCol ||
+                buffer.shadowmapIndex != light.m_ShadowmapIndex ||
+                buffer.direction != glm::normalize(light.m_Direction) ||
+                buffer.shadowSoftness != light.m_ShadowSoftness ||
+                buffer.pcfSampleRate != light.m_PCFSampleRate ||
+                buffer.bias != light.m_ShadowBias
+            ) {
+                m_ChangedDirLightsIDs.push_back(m_GPULights.activeDirLights);
+
+                buffer.color          = lightCol;
+                buffer.shadowmapIndex = light.m_ShadowmapIndex;
+                buffer.direction      = glm::normalize(light.m_Direction);
+                buffer.shadowSoftness = light.m_ShadowSoftness;
+                buffer.pcfSampleRate  = light.m_PCFSampleRate;
+                buffer.bias           = light.m_ShadowBias;
+            }
+                
+            m_GPULights.activeDirLights++;
+        }
+
+        if (oldActivePointLights != m_GPULights.activePointLights ||
+            oldActiveSpotLights != m_GPULights.activeSpotLights ||
+            oldActiveDirLights != m_GPULights.activeDirLights
+        ) {
+            if(m_GPULights.activePointLights < oldActivePointLights)
+                m_ChangedPointLightsIDs.push_back(m_GPULights.activePointLights);
+
+            if (m_GPULights.activeSpotLights < oldActiveSpotLights)
+                m_ChangedSpotLightsIDs.push_back(m_GPULights.activeSpotLights);
+
+            m_SceneLightingChanged = true;
+        }
+
+        // Reset last (point/spot)light for clustered rendering
+        m_GPULights.pointLights[m_GPULights.activePointLights].color  = glm::vec3(0.0f);
+        m_GPULights.pointLights[m_GPULights.activePointLights].radius = 0.0f;
+
+        m_GPULights.spotLights[m_GPULights.activeSpotLights].color      = glm::vec3(0.0f);
+        m_GPULights.spotLights[m_GPULights.activeSpotLights].range      = 0.0f;
+        m_GPULights.spotLights[m_GPULights.activeSpotLights].direction  = glm::vec3(0.0f);
+        m_GPULights.spotLights[m_GPULights.activeSpotLights].outerCutoff = 0.0f;
+    }
+
+    uint32_t SceneState::RegisterMatrix(const glm::mat4& matrix)
+    {
+        const uint32_t index = AcquireSlot(m_FreeMatrices, m_OccupiedMatrices);
+
+        if (index > m_Matrices.size() - 1)
+            m_Matrices.resize(m_Matrices.size() * 2);
+
+        m_Matrices[index] = matrix;
+
+        return index;
+    }
+    uint32_t SceneState::RegisterMaterial(Handle<Material> material)
+    {
+        if (!m_RegisteredMaterials.contains(material->GetName()))
+        {
+            const uint32_t index = AcquireSlot(m_FreeMaterials, m_OccupiedMaterials);
+
+            if (index > m_Materials.size() - 1)
+            {
+                m_Materials.resize(m_Materials.size() * 2);
+                m_GPUMaterials.resize(m_GPUMaterials.size() * 2);
+            }
+
+            material->m_AlbedoIndex    = RegisterTexture(material->GetAlbedoTexture());
+            material->m_RoughnessIndex = RegisterTexture(material->GetRoughnessTexture());
+            material->m_MetalnessIndex = RegisterTexture(material->GetMetalnessTexture());
+            material->m_NormalIndex    = RegisterTexture(material->GetNormalTexture());
+
+            m_GPUMaterials[index] = GPUMaterial{};
+            m_Materials[index] = material;
+
+            m_RegisteredMaterials[material->GetName()] = index;
+        }
+
+        return m_RegisteredMaterials.at(material->GetName());
+    }
+    void SceneState::DeregisterMatrix(uint32_t index)
+    {
+        if (m_OccupiedMatrices.erase(index) == 0U)
+            return;
+
+        m_FreeMatrices.emplace_back(index);
+        m_Matrices[index] = glm::mat4(1.0f);
+    }
+    void SceneState::DeregisterMaterial(uint32_t index)
+    {
+        if (m_OccupiedMaterials.erase(index) == 0U)
+            return;
+
+        m_FreeMaterials.emplace_back(index);
+        m_RegisteredMaterials.erase(m_Materials[index]->GetName());
+        m_GPUMaterials[index] = GPUMaterial{};
+        m_Materials[index]    = nullptr;
+    }
+
+    void SceneState::UpdateDraws()
+    {
+        for (const auto& sceneObject : m_DeletedSceneObjects)
+            RemoveDraws(sceneObject.get());
+
+        m_DeletedSceneObjects.clear();
+
+        for (const auto& sceneObject : m_ChangedSceneObjects)
+        {
+            // A new mesh can have a different number of SubMeshes, its draws are made from scratch
+            if (sceneObject->m_DrawnMesh != sceneObject->m_Mesh)
+            {
+                RemoveDraws(sceneObject);
+                AppendDraws(sceneObject);
+            }
+            else
+                PatchDraws(sceneObject);
+
+            sceneObject->m_DrawsChanged = false;
+        }
+
+        m_ChangedSceneObjects.clear();
+
+        // Some SubMesh, its material or a whole mesh was toggled, there's no telling which objects use it
+        if (m_MeshVersion != Mesh::GetVersion())
+        {
+            m_MeshVersion = Mesh::GetVersion();
+
+            for (const auto& [name, sceneObject] : m_SceneObjects)
+                PatchDraws(sceneObject.get());
+        }
+
+        // The ranges of the removed objects' meshes would keep them alive otherwise
+        if (m_GeometryUnused)
+        {
+            CompactGeometry();
+
+            for (uint32_t i = 0U; i < m_Draws.size(); i++)
+            {
+                const DrawOwner& owner = m_DrawOwners[i];
+
+                const GeometryRange& range = m_GeometryRanges.at(owner.sceneObject->m_DrawnMesh->m_SubMeshes[owner.subMesh].m_GeometryID);
+
+                m_Draws[i].firstIndex    = range.firstIndex;
+                m_Draws[i].vertexOffset  = range.vertexOffset;
+                m_Draws[i].geometryIndex = range.index;
+
+                m_ChangedDrawIDs.emplace_back(i);
+            }
+        }
+    }
+    void SceneState::AppendDraws(SceneObject* sceneObject)
+    {
+        sceneObject->m_DrawnMesh = sceneObject->m_Mesh;
+
+        Mesh& mesh = *sceneObject->m_DrawnMesh;
+        const glm::mat4& matrix = m_Matrices[sceneObject->m_MatrixIndex];
+
+        auto& movedBounds = sceneObject->m_Static ? m_MovedStaticBounds : m_MovedDynamicBounds;
+
+        for (uint32_t i = 0U; i < mesh.m_SubMeshes.size(); i++)
+        {
+            auto& subMesh = mesh.m_SubMeshes[i];
+
+            UpdateMaterialIndex(subMesh);
+
+            if (!m_GeometryRanges.contains(subMesh.m_GeometryID))
+            {
+                // Appended, the ranges already in the buffers stay where they are
+                m_GeometryRanges[subMesh.m_GeometryID] = GeometryRange{
+                    .vertexBuffer = subMesh.m_VertexBuffer,
+                    .indexBuffer  = subMesh.m_IndexBuffer,
+                    .vertexCount  = subMesh.m_VertexCount,
+                    .indexCount   = subMesh.m_IndexCount,
+                    .vertexOffset = static_cast<int32_t>(m_GeometryVertexCount),
+                    .firstIndex   = m_GeometryIndexCount,
+                    .index        = static_cast<uint32_t>(m_GeometryRanges.size()),
+                };
+
+                m_GeometryVertexCount += subMesh.m_VertexCount;
+                m_GeometryIndexCount  += subMesh.m_IndexCount;
+
+                m_GeometryChanged = true;
+            }
+
+            GeometryRange& range = m_GeometryRanges.at(subMesh.m_GeometryID);
+            range.drawCount++;
+
+            const bool visible = sceneObject->m_Active && mesh.IsActive() && subMesh.m_Active;
+
+            const uint32_t drawIndex = static_cast<uint32_t>(m_Draws.size());
+
+            m_Draws.emplace_back(GPUDraw{
+                .boundingSphere = subMesh.m_BoundingSphere,
+                .matrixIndex    = sceneObject->m_MatrixIndex,
+                .materialIndex  = subMesh.m_MaterialIndex,
+                .indexCount     = visible ? subMesh.m_IndexCount : 0U,
+                .firstIndex     = range.firstIndex,
+                .vertexOffset   = range.vertexOffset,
+                .geometryIndex  = range.index,
+                .flags          = sceneObject->m_Static ? DRAW_FLAG_STATIC : 0U,
+            });
+
+            m_DrawLocalBounds.emplace_back(subMesh.m_BoundingBox);
+            m_DrawBounds     .emplace_back(subMesh.m_BoundingBox.Transform(matrix));
+
+            m_DrawOwners.emplace_back(DrawOwner{
+                .sceneObject = sceneObject,
+                .subMesh     = i,
+            });
+
+            sceneObject->m_Draws.emplace_back(drawIndex);
+            m_ChangedDrawIDs.emplace_back(drawIndex);
+
+            if (visible)
+                movedBounds.emplace_back(m_DrawBounds.back());
+        }
+    }
+    void SceneState::RemoveDraws(SceneObject* sceneObject)
+    {
+        // From the back, so none of the object's own draws gets moved into one of its other slots
+        std::sort(sceneObject->m_Draws.rbegin(), sceneObject->m_Draws.rend());
+
+        for (const auto& drawIndex : sceneObject->m_Draws)
+        {
+            const DrawOwner& owner = m_DrawOwners[drawIndex];
+
+            auto& range = m_GeometryRanges.at(sceneObject->m_DrawnMesh->m_SubMeshes[owner.subMesh].m_GeometryID);
+
+            if (--range.drawCount == 0U)
+                m_GeometryUnused = true;
+
+            // By the flags of the draw, the object could have been made static since
+            if (m_Draws[drawIndex].indexCount > 0U)
+                ((m_Draws[drawIndex].flags & DRAW_FLAG_STATIC) ? m_MovedStaticBounds : m_MovedDynamicBounds).emplace_back(m_DrawBounds[drawIndex]);
+
+            const uint32_t lastIndex = static_cast<uint32_t>(m_Draws.size()) - 1U;
+
+            if (drawIndex != lastIndex)
+            {
+                m_Draws          [drawIndex] = m_Draws          [lastIndex];
+                m_DrawLocalBounds[drawIndex] = m_DrawLocalBounds[lastIndex];
+                m_DrawBounds     [drawIndex] = m_DrawBounds     [lastIndex];
+                m_DrawOwners     [drawIndex] = m_DrawOwners     [lastIndex];
+
+                const DrawOwner& movedOwner = m_DrawOwners[drawIndex];
+                movedOwner.sceneObject->m_Draws[movedOwner.subMesh] = drawIndex;
+
+                m_ChangedDrawIDs.emplace_back(drawIndex);
+            }
+
+            m_Draws          .pop_back();
+            m_DrawLocalBounds.pop_back();
+            m_DrawBounds     .pop_back();
+            m_DrawOwners     .pop_back();
+        }
+
+        sceneObject->m_Draws.clear();
+        sceneObject->m_DrawnMesh = nullptr;
+    }
+    void SceneState::PatchDraws(SceneObject* sceneObject)
+    {
+        const uint32_t flags = sceneObject->m_Static ? DRAW_FLAG_STATIC : 0U;
+
+        for (uint32_t i = 0U; i < sceneObject->m_Draws.size(); i++)
+        {
+            auto& subMesh = sceneObject->m_DrawnMesh->m_SubMeshes[i];
+
+            const uint32_t drawIndex = sceneObject->m_Draws[i];
+            GPUDraw& draw = m_Draws[drawIndex];
+
+            UpdateMaterialIndex(subMesh);
+
+            const bool visible = sceneObject->m_Active && sceneObject->m_DrawnMesh->IsActive() && subMesh.m_Active;
+            const bool wasVisible = draw.indexCount > 0U;
+
+            const uint32_t indexCount = visible ? subMesh.m_IndexCount : 0U;
+
+            if (draw.materialIndex == subMesh.m_MaterialIndex && draw.indexCount == indexCount && draw.flags == flags)
+                continue;
+
+            // The caster appears in or disappears from the shadow maps, a static one that turned dynamic leaves the static caches
+            if (visible != wasVisible || draw.flags != flags)
+            {
+                if (wasVisible)
+                    ((draw.flags & DRAW_FLAG_STATIC) ? m_MovedStaticBounds : m_MovedDynamicBounds).emplace_back(m_DrawBounds[drawIndex]);
+
+                if (visible)
+                    ((flags & DRAW_FLAG_STATIC) ? m_MovedStaticBounds : m_MovedDynamicBounds).emplace_back(m_DrawBounds[drawIndex]);
+            }
+
+            draw.materialIndex = subMesh.m_MaterialIndex;
+            draw.indexCount    = indexCount;
+            draw.flags         = flags;
+
+            m_ChangedDrawIDs.emplace_back(drawIndex);
+        }
+    }
+    void SceneState::UpdateMaterialIndex(SubMesh& subMesh)
+    {
+        if (!subMesh.m_MaterialChanged)
+            return;
+
+        if (m_RegisteredMaterials.contains(subMesh.m_Material->m_Name))
+            subMesh.m_MaterialIndex = m_RegisteredMaterials.at(subMesh.m_Material->m_Name);
+        else
+            subMesh.m_MaterialIndex = RegisterMaterial(subMesh.m_Material);
+
+        subMesh.m_MaterialChanged = false;
+    }
+    void SceneState::CompactGeometry()
+    {
+        std::erase_if(m_GeometryRanges, [](const auto& range) { return range.second.drawCount == 0U; });
+
+        // In the order they were appended, so the remaining ranges keep their relative order
+        std::vector<GeometryRange*> ranges;
+        ranges.reserve(m_GeometryRanges.size());
+
+        for (auto& [key, range] : m_GeometryRanges)
+            ranges.emplace_back(&range);
+
+        std::sort(ranges.begin(), ranges.end(), [](const GeometryRange* a, const GeometryRange* b) { return a->vertexOffset < b->vertexOffset; });
+
+        m_GeometryVertexCount = 0U;
+        m_GeometryIndexCount  = 0U;
+
+        for (uint32_t i = 0U; i < ranges.size(); i++)
+        {
+            ranges[i]->vertexOffset = static_cast<int32_t>(m_GeometryVertexCount);
+            ranges[i]->firstIndex   = m_GeometryIndexCount;
+            ranges[i]->index        = i;
+
+            m_GeometryVertexCount += ranges[i]->vertexCount;
+            m_GeometryIndexCount  += ranges[i]->indexCount;
+        }
+
+        // Everything gets copied into new buffers
+        m_UploadedVertexCount = 0U;
+        m_UploadedIndexCount  = 0U;
+
+        m_GeometryChanged = true;
+        m_GeometryUnused  = false;
+    }
+}
\ No newline at end of file
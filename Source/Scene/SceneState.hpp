@@ -0,0 +1,227 @@
+#pragma once
+
+#ifndef EN_SCENESTATE_HPP
+#define EN_SCENESTATE_HPP
+
+#include "../../EruptionEngine.ini"
+
+#include <Renderer/Camera/Camera.hpp>
+
+#include <Scene/SceneObject.hpp>
+#include <Renderer/Lights/PointLight.hpp>
+#include <Renderer/Lights/DirectionalLight.hpp>
+#include <Renderer/Lights/SpotLight.hpp>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace en
+{
+	// The CPU side of a scene: its objects, lights, matrices, materials and draws, along with the lists of what changed since
+	// the last update. It doesn't need a VkDevice, the textures are the only GPU resources it refers to and they go through
+	// RegisterTexture(). Scene derives from it and uploads the changes, the headless benchmark uses a mock of the textures instead.
+	class SceneState
+	{
+	public:
+		SceneState();
+		virtual ~SceneState() = default;
+
+		Handle<SceneObject> GetSceneObject(const std::string& name);
+
+		Handle<SceneObject> CreateSceneObject(const std::string& name, Handle <Mesh> mesh);
+		void DeleteSceneObject(const std::string& name);
+
+		//void RenameSceneObject(const std::string& oldName, const std::string& newName);
+
+		PointLight* CreatePointLight(const glm::vec3 position, const glm::vec3 color = glm::vec3(1.0f), const float intensity = 2.5f, const float radius = 10.0f, const bool active = true);
+		void DeletePointLight(const uint32_t index);
+
+		SpotLight* CreateSpotLight(const glm::vec3 position, const glm::vec3 direction, const glm::vec3 color = glm::vec3(1.0f), const float innerCutoff = 0.2f, const float outerCutoff = 0.4f, const float range = 8.0f, const float intensity = 2.5f, const bool active = true);
+		void DeleteSpotLight(const uint32_t index);
+
+		DirectionalLight* CreateDirectionalLight(const glm::vec3 direction, const glm::vec3 color = glm::vec3(1.0f), const float intensity = 2.5f, const bool active = true);
+		void DeleteDirectionalLight(const uint32_t index);
+
+		const uint32_t GetDrawCount() const { return static_cast<uint32_t>(m_Draws.size()); };
+
+		glm::vec3 m_AmbientColor = glm::vec3(0.0f);
+
+		std::vector<PointLight>		  m_PointLights;
+		std::vector<SpotLight>		  m_SpotLights;
+		std::vector<DirectionalLight> m_DirectionalLights;
+
+		Handle<Camera> m_MainCamera;
+
+		std::unordered_map<std::string, Handle<SceneObject>> m_SceneObjects;
+
+	protected:
+		void UpdateSceneCPU();
+
+		uint32_t RegisterMatrix(const glm::mat4& matrix = glm::mat4(1.0f));
+		uint32_t RegisterMaterial(Handle<Material> material);
+
+		// Returns the index the texture already has when it's registered
+		virtual uint32_t RegisterTexture(Handle<Texture> texture) = 0;
+
+		// The white non-sRGB texture, the materials using it get their scalar metalness and roughness and no normal mapping
+		virtual bool IsDefaultTexture(const Handle<Texture>& texture) const = 0;
+
+		void DeregisterMatrix(uint32_t index);
+		void DeregisterMaterial(uint32_t index);
+
+		// Only touches the draws of the objects that changed, or of every object when a mesh did
+		void UpdateDraws();
+
+		void AppendDraws(SceneObject* sceneObject);
+		// Swap-removes them, the draws moved into their slots get their owners updated
+		void RemoveDraws(SceneObject* sceneObject);
+		// Rewrites only the parts of the object's draws that differ from its current state
+		void PatchDraws (SceneObject* sceneObject);
+
+		void UpdateMaterialIndex(SubMesh& subMesh);
+
+		// Lays the used ranges out from scratch, without the ones no draw uses anymore
+		void CompactGeometry();
+
+		// Hands out the shadow map slots to the most important of the casters, the slots follow the importance order
+		template<typename Light>
+		static void SelectShadowCasters(std::vector<Light>& lights, std::vector<uint32_t>& casters, const uint32_t maxCasters);
+
+		struct GPUMaterial {
+			glm::vec3 color = glm::vec3(1.0f);
+			float _padding0{};
+
+			float metalnessVal = 0.00f;
+			float roughnessVal = 0.75f;
+			float normalStrength = 1.00f;
+			float _padding1{};
+
+			uint32_t albedoId{};
+			uint32_t roughnessId{};
+			uint32_t metalnessId{};
+			uint32_t normalId{};
+		};
+
+		struct GPULights {
+			std::array<PointLight::Buffer	   , MAX_POINT_LIGHTS> pointLights{};
+			std::array<SpotLight::Buffer	   , MAX_SPOT_LIGHTS > spotLights{};
+			std::array<DirectionalLight::Buffer, MAX_DIR_LIGHTS  > dirLights{};
+
+			uint32_t activePointLights = 0U;
+			uint32_t activeSpotLights = 0U;
+			uint32_t activeDirLights = 0U;
+			uint32_t _padding0{};
+
+			glm::vec3 ambientLight = glm::vec3(0.0f);
+			uint32_t _padding1{};
+		} m_GPULights;
+
+		// One per SubMesh of every object, consumed by the draw culling compute pass and by the vertex shaders (through gl_InstanceIndex).
+		// Inactive objects, meshes and SubMeshes keep their slots with an indexCount of 0, so toggling them only patches the draw.
+		// The CPU culling skips them, the GPU one emits commands that draw nothing.
+		struct GPUDraw {
+			glm::vec4 boundingSphere{};
+
+			uint32_t matrixIndex{};
+			uint32_t materialIndex{};
+			uint32_t indexCount{};
+			uint32_t firstIndex{};
+
+			int32_t  vertexOffset{};
+			uint32_t geometryIndex{};
+			uint32_t flags{};
+			uint32_t _padding1{};
+		};
+
+		// GPUDraw::flags
+		static constexpr uint32_t DRAW_FLAG_STATIC = 1U;
+
+		struct GeometryRange {
+			Handle<MemoryBuffer> vertexBuffer;
+			Handle<MemoryBuffer> indexBuffer;
+
+			uint32_t vertexCount{};
+			uint32_t indexCount{};
+
+			int32_t  vertexOffset{};
+			uint32_t firstIndex{};
+
+			// Dense index used by the render queue keys
+			uint32_t index{};
+
+			// Draws referencing the range, the ones without any are dropped by the next compaction
+			uint32_t drawCount{};
+		};
+
+		struct DrawOwner {
+			SceneObject* sceneObject = nullptr;
+			uint32_t	 subMesh{};
+		};
+
+		// Flat list of the SubMeshes of every object in the scene. Objects append their draws when they are added and swap-remove
+		// them when they are deleted or their mesh changes, everything else is patched in place.
+		// The CPU only data lives in arrays parallel to m_Draws, so culling can stream through them without touching the objects.
+		std::vector<GPUDraw>   m_Draws;
+		std::vector<DrawOwner> m_DrawOwners;
+
+		// Bounding boxes of m_Draws in model and world space, the world ones are recalculated only for objects whose matrix changed
+		std::vector<AABB> m_DrawLocalBounds;
+		std::vector<AABB> m_DrawBounds;
+
+		// World bounds of the draws that moved during the last update, both before and after the move, so the renderer can tell which shadow maps are outdated
+		std::vector<AABB> m_MovedStaticBounds;
+		std::vector<AABB> m_MovedDynamicBounds;
+
+		// By SubMesh::m_GeometryID
+		std::unordered_map<uint32_t, GeometryRange> m_GeometryRanges;
+
+		std::vector<glm::mat4  > m_Matrices;
+		std::vector<GPUMaterial> m_GPUMaterials;
+
+		std::vector<Handle<Material>> m_Materials;
+
+		std::unordered_set<uint32_t> m_OccupiedMatrices;
+		std::unordered_set<uint32_t> m_OccupiedMaterials;
+
+		// Released slots, reused before the arrays grow. Every slot below the occupied plus free count is in one of the two.
+		std::vector<uint32_t> m_FreeMatrices;
+		std::vector<uint32_t> m_FreeMaterials;
+
+		std::unordered_map<std::string, uint32_t> m_RegisteredMaterials;
+
+		uint32_t m_GeometryVertexCount{};
+		uint32_t m_GeometryIndexCount{};
+
+		// How much of the ranges is in the GPU buffers already, everything past it gets copied by the next upload
+		uint32_t m_UploadedVertexCount{};
+		uint32_t m_UploadedIndexCount{};
+
+		std::vector<uint32_t> m_ChangedMatrixIDs;
+		std::vector<uint32_t> m_ChangedMaterialIDs;
+		std::vector<uint32_t> m_ChangedDrawIDs;
+
+		std::vector<SceneObject*> m_ChangedSceneObjects;
+
+		// Kept alive until the next update removes their draws
+		std::vector<Handle<SceneObject>> m_DeletedSceneObjects;
+
+		std::vector<uint32_t> m_ChangedPointLightsIDs;
+		std::vector<uint32_t> m_ChangedSpotLightsIDs;
+		std::vector<uint32_t> m_ChangedDirLightsIDs;
+
+		std::vector<uint32_t> m_ActivePointLightsShadowIDs;
+		std::vector<uint32_t> m_ActiveSpotLightsShadowIDs;
+		std::vector<uint32_t> m_ActiveDirLightsShadowIDs;
+
+		bool m_SceneLightingChanged = true;
+		bool m_GeometryChanged = false;
+		bool m_GeometryUnused = false;
+
+		uint32_t m_MeshVersion{};
+	};
+}
+
+#endif
\ No newline at end of file
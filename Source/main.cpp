@@ -1,12 +1,51 @@
 #include <Core/Eruption.hpp>
+#include <Core/Benchmark.hpp>
 
-int main()
+#include <cstring>
+
+int main(int argc, char** argv)
 {
-	Eruption engine;
-	
+	bool	 headless   = false;
+	uint32_t frameCount = 0U;
+
+	bool		benchmark	 = false;
+	bool		cpuBenchmark = false;
+	std::string benchmarkConfig;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--headless") == 0)
+			headless = true;
+		else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if (std::strcmp(argv[i], "--benchmark") == 0 || std::strcmp(argv[i], "--cpu-benchmark") == 0)
+		{
+			benchmark	 = true;
+			cpuBenchmark = std::strcmp(argv[i], "--cpu-benchmark") == 0;
+
+			// The config path is optional
+			if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0)
+				benchmarkConfig = argv[++i];
+		}
+		else
+			std::cout << "Unknown argument \"" << argv[i] << "\" was ignored\n";
+	}
+
 	try 
 	{
-		engine.Run();
+		if (cpuBenchmark)
+		{
+			Benchmark(benchmarkConfig).RunCPU();
+		}
+		else if (benchmark)
+		{
+			Benchmark(benchmarkConfig).Run();
+		}
+		else
+		{
+			Eruption engine;
+			engine.Run(headless, frameCount);
+		}
 	}
 	catch (const std::exception& e) 
 	{
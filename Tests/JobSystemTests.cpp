@@ -0,0 +1,227 @@
+#include <Core/JobSystem.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Each case is registered with ctest by CMakeLists.txt, without an argument all of them run
+#define CHECK(condition) if (!(condition)) throw std::runtime_error(std::string(__FILE__) + ":" + std::to_string(__LINE__) + " - CHECK(" #condition ") failed")
+
+namespace
+{
+	// The pool sizes every case is run with, 0 has the waiting thread run every job
+	constexpr uint32_t WORKER_COUNTS[] = { 0U, 1U, 4U };
+
+	void ParallelForVisitsEachIndexOnce(en::JobSystem& jobSystem)
+	{
+		for (const uint32_t count : { 0U, 1U, 7U, 1000U, 100003U })
+		{
+			for (const uint32_t chunkSize : { 0U, 1U, 13U, 100003U })
+			{
+				std::vector<std::atomic<uint32_t>> visits(count);
+
+				jobSystem.ParallelFor(count, [&](uint32_t begin, uint32_t end) {
+					CHECK(begin < end && end <= count);
+
+					for (uint32_t i = begin; i < end; i++)
+						visits[i]++;
+				}, chunkSize);
+
+				for (const auto& visit : visits)
+					CHECK(visit.load() == 1U);
+			}
+		}
+	}
+
+	void DependencyOrdering(en::JobSystem& jobSystem)
+	{
+		constexpr uint32_t JOB_COUNT = 64U;
+
+		std::atomic<uint32_t> firstFinished = 0U;
+		std::atomic<uint32_t> secondFinished = 0U;
+
+		en::JobCounter first;
+		en::JobCounter second;
+		en::JobCounter third;
+
+		for (uint32_t i = 0U; i < JOB_COUNT; i++)
+			jobSystem.Execute([&]() {
+				// Slow enough that the dependent jobs would overtake them if they weren't held back
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+				firstFinished++;
+			}, &first);
+
+		for (uint32_t i = 0U; i < JOB_COUNT; i++)
+			jobSystem.Execute([&]() {
+				CHECK(firstFinished.load() == JOB_COUNT);
+				secondFinished++;
+			}, &second, &first);
+
+		// Depends on a chain that is still running, and on one that is done by the time it's scheduled
+		jobSystem.Execute([&]() { CHECK(secondFinished.load() == JOB_COUNT); }, &third, &second);
+
+		jobSystem.Wait(third);
+
+		// Done already, only rethrows the failed checks of their jobs
+		jobSystem.Wait(second);
+		jobSystem.Wait(first);
+
+		bool ran = false;
+
+		jobSystem.Execute([&]() { ran = true; }, &third, &first);
+		jobSystem.Wait(third);
+
+		CHECK(ran);
+	}
+
+	void CounterReuse(en::JobSystem& jobSystem)
+	{
+		en::JobCounter counter;
+
+		for (uint32_t round = 1U; round <= 8U; round++)
+		{
+			std::atomic<uint32_t> sum = 0U;
+
+			for (uint32_t i = 0U; i < round * 16U; i++)
+				jobSystem.Execute([&]() { sum++; }, &counter);
+
+			jobSystem.Wait(counter);
+
+			CHECK(counter.IsDone());
+			CHECK(sum.load() == round * 16U);
+		}
+	}
+
+	void WaitRethrows(en::JobSystem& jobSystem)
+	{
+		constexpr uint32_t JOB_COUNT = 32U;
+
+		en::JobCounter counter;
+		std::atomic<uint32_t> finished = 0U;
+
+		for (uint32_t i = 0U; i < JOB_COUNT; i++)
+			jobSystem.Execute([&, i]() {
+				finished++;
+
+				if (i % 8U == 3U)
+					throw std::runtime_error("Job " + std::to_string(i));
+			}, &counter);
+
+		bool rethrown = false;
+
+		try
+		{
+			jobSystem.Wait(counter);
+		}
+		catch (const std::runtime_error& e)
+		{
+			rethrown = std::strncmp(e.what(), "Job ", 4) == 0;
+		}
+
+		// Only the first exception is kept, and the jobs that threw still count as finished
+		CHECK(rethrown);
+		CHECK(counter.IsDone());
+		CHECK(finished.load() == JOB_COUNT);
+
+		// The exception was cleared, so the counter is clean for the next batch
+		jobSystem.Execute([]() {}, &counter);
+		jobSystem.Wait(counter);
+
+		rethrown = false;
+
+		try
+		{
+			jobSystem.ParallelFor(1000U, [](uint32_t begin, uint32_t end) {
+				if (begin <= 500U && 500U < end)
+					throw std::runtime_error("Chunk");
+			}, 10U);
+		}
+		catch (const std::runtime_error& e)
+		{
+			rethrown = std::strcmp(e.what(), "Chunk") == 0;
+		}
+
+		CHECK(rethrown);
+	}
+
+	void ZeroWorkers(en::JobSystem& jobSystem)
+	{
+		CHECK(jobSystem.GetWorkerCount() == 0U);
+		CHECK(en::JobSystem::GetThreadIndex() == 0U);
+
+		// Nothing runs until someone waits
+		en::JobCounter counter;
+		bool ran = false;
+
+		jobSystem.Execute([&]() { ran = true; }, &counter);
+
+		CHECK(!ran && !counter.IsDone());
+
+		jobSystem.Wait(counter);
+
+		CHECK(ran);
+	}
+
+	struct TestCase
+	{
+		const char* name;
+		void (*function)(en::JobSystem&);
+
+		bool withoutWorkersOnly = false;
+	};
+
+	constexpr TestCase TEST_CASES[] = {
+		{ "ParallelForVisitsEachIndexOnce", ParallelForVisitsEachIndexOnce },
+		{ "DependencyOrdering",             DependencyOrdering             },
+		{ "CounterReuse",                   CounterReuse                   },
+		{ "WaitRethrows",                   WaitRethrows                   },
+		{ "ZeroWorkers",                    ZeroWorkers, true              },
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	uint32_t failed = 0U;
+	uint32_t ran = 0U;
+
+	for (const auto& testCase : TEST_CASES)
+	{
+		if (filter && std::strcmp(filter, testCase.name) != 0)
+			continue;
+
+		for (const uint32_t workerCount : WORKER_COUNTS)
+		{
+			if (testCase.withoutWorkersOnly && workerCount != 0U)
+				continue;
+
+			const std::string name = std::string(testCase.name) + " (" + std::to_string(workerCount) + " workers)";
+
+			try
+			{
+				en::JobSystem jobSystem(workerCount);
+				testCase.function(jobSystem);
+
+				std::cout << "PASSED " << name << '\n';
+			}
+			catch (const std::exception& e)
+			{
+				std::cout << "FAILED " << name << ": " << e.what() << '\n';
+				failed++;
+			}
+
+			ran++;
+		}
+	}
+
+	if (ran == 0U)
+	{
+		std::cout << "No test case is called \"" << filter << "\"\n";
+		return EXIT_FAILURE;
+	}
+
+	return failed == 0U ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file